@@ -0,0 +1,176 @@
+/// 性能测试公共部分, 各子项目的性能测试执行文件共用
+///
+/// 各子项目的性能测试源文件通过 `BENCH` 宏定义测试项, 并和 `common/bench/bench_main.cc` 一起编译
+#pragma once
+
+#ifndef __COMMON__BENCH__BENCH_H
+#define __COMMON__BENCH__BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+	/// @brief 单项性能测试结果
+	struct result {
+		std::string name; // 测试项名称, 以 `/` 分隔各级名称, 例如 `calculate_primes/1e7/sieve`
+		size_t ops;		  // 总操作次数
+		size_t bytes;	  // 总处理字节数
+		double ns;		  // 总耗时 (纳秒)
+
+		/// @brief 每次操作的平均耗时 (纳秒)
+		double ns_per_op() const { return ops ? ns / ops : 0; }
+
+		/// @brief 吞吐量 (GB/s)
+		double gb_per_s() const { return ns > 0 ? bytes / ns : 0; }
+	};
+
+	/// @brief 阻止编译器将 `val` 相关的计算优化掉
+	///
+	/// @param val 计算结果的引用
+	template <typename T>
+	inline void do_not_optimize(const T& val) {
+		asm volatile("" : : "r,m"(val) : "memory");
+	}
+
+	/// @brief 执行性能测试
+	///
+	/// 先执行一轮预热, 之后不断执行 `f`, 直到总耗时超过 `min_ns` 纳秒
+	///
+	/// @param name 测试项名称
+	/// @param ops 每轮执行的操作次数
+	/// @param bytes 每轮处理的字节数
+	/// @param f 测试函数, 每次调用执行一轮
+	/// @param min_ns 最少执行时间 (纳秒)
+	/// @return 测试结果
+	template <typename F>
+	result measure(std::string name, size_t ops, size_t bytes, F&& f, double min_ns = 2e8) {
+		using clock = std::chrono::steady_clock;
+
+		f();
+
+		result r{ std::move(name), 0, 0, 0 };
+		auto start = clock::now();
+		do {
+			f();
+			r.ops += ops;
+			r.bytes += bytes;
+			r.ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+		} while (r.ns < min_ns);
+
+		return r;
+	}
+
+	/// @brief 获取已输出的全部测试结果, 用于生成 JSON 文件
+	inline std::vector<result>& results() {
+		static std::vector<result> rs;
+		return rs;
+	}
+
+	/// @brief 输出测试结果, 并记录到结果集合中
+	///
+	/// @param r 测试结果
+	inline void report(result r) {
+		printf("%-48s %12.2f ns/op %10.3f GB/s\n", r.name.c_str(), r.ns_per_op(), r.gb_per_s());
+		results().push_back(std::move(r));
+	}
+
+	/// @brief 将全部测试结果以 JSON 格式写入文件
+	///
+	/// 文件格式为:
+	///
+	/// ```json
+	/// {
+	///   "context": { "date": "...", "compiler": "...", ... },
+	///   "results": [
+	///     { "name": "calculate_primes/1e7/sieve", "ns_per_op": 1.23, "gb_per_s": 4.56, "ops": 100, "bytes": 800 },
+	///     ...
+	///   ]
+	/// }
+	/// ```
+	///
+	/// 测试项名称和上下文信息中不包含需要转义的字符
+	///
+	/// @param path 文件路径
+	/// @param context 上下文信息键值对, 写入 `context` 字段
+	/// @return `0` 表示成功, `-1` 表示文件无法写入
+	inline int write_json(const char* path, const std::vector<std::pair<std::string, std::string>>& context) {
+		FILE* fp = fopen(path, "w");
+		if (!fp) {
+			perror("cannot open json file");
+			return -1;
+		}
+
+		fprintf(fp, "{\n  \"context\": {");
+		for (size_t i = 0; i < context.size(); i++) {
+			fprintf(fp, "%s\n    \"%s\": \"%s\"", i ? "," : "", context[i].first.c_str(), context[i].second.c_str());
+		}
+
+		fprintf(fp, "\n  },\n  \"results\": [");
+		const auto& rs = results();
+		for (size_t i = 0; i < rs.size(); i++) {
+			fprintf(fp, "%s\n    { \"name\": \"%s\", \"ns_per_op\": %.4f, \"gb_per_s\": %.4f, \"ops\": %zu, \"bytes\": %zu }",
+				i ? "," : "", rs[i].name.c_str(), rs[i].ns_per_op(), rs[i].gb_per_s(), rs[i].ops, rs[i].bytes);
+		}
+		fprintf(fp, "\n  ]\n}\n");
+
+		fclose(fp);
+		return 0;
+	}
+
+	/// @brief 性能测试函数类型
+	using bench_func = void (*)();
+
+	/// @brief 已注册的性能测试项
+	struct registry_entry {
+		const char* name;
+		bench_func func;
+	};
+
+	/// @brief 获取性能测试注册表
+	inline std::vector<registry_entry>& registry() {
+		static std::vector<registry_entry> entries;
+		return entries;
+	}
+
+	/// @brief 通过静态对象的构造器注册性能测试项
+	struct registrar {
+		registrar(const char* name, bench_func func) { registry().push_back({ name, func }); }
+	};
+
+	/// @brief 上下文信息的取值函数类型
+	using context_func = std::string (*)();
+
+	/// @brief 获取子项目注册的上下文信息, 写入 JSON 文件时追加在公共上下文信息之后
+	inline std::vector<std::pair<const char*, context_func>>& context_registry() {
+		static std::vector<std::pair<const char*, context_func>> entries;
+		return entries;
+	}
+
+	/// @brief 通过静态对象的构造器注册上下文信息
+	struct context_registrar {
+		context_registrar(const char* key, context_func func) { context_registry().push_back({ key, func }); }
+	};
+
+} // namespace bench
+
+/// @brief 定义性能测试项, 用法和 gtest 的 `TEST` 宏类似
+///
+/// 通过 `__BENCH_IMPL` 间接展开, 以保证 `suite` 参数为宏 (例如 `BENCH_SUITE_NAME`) 时能够被替换为实际名称
+#define BENCH(suite, name) __BENCH_IMPL(suite, name)
+
+#define __BENCH_IMPL(suite, name)                             \
+	static void suite##__##name();                            \
+	static ::bench::registrar suite##__##name##__reg( \
+		#suite "." #name, suite##__##name);                   \
+	static void suite##__##name()
+
+/// @brief 注册子项目特有的上下文信息 (例如是否支持 AVX2), `func` 在写入 JSON 文件时调用
+#define BENCH_CONTEXT(key, func) \
+	static ::bench::context_registrar __bench_context_##key##__reg(#key, func)
+
+#endif // __COMMON__BENCH__BENCH_H
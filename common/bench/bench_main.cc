@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "bench/bench.h"
+
+/// @brief 收集测试环境信息, 写入 JSON 文件的 `context` 字段, 便于对比不同版本的测试结果
+///
+/// 包括公共信息和子项目通过 `BENCH_CONTEXT` 注册的信息
+///
+/// @return 上下文信息键值对
+static std::vector<std::pair<std::string, std::string>> __context() {
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    std::vector<std::pair<std::string, std::string>> ctx = {
+        { "date", date },
+        { "compiler", __VERSION__ },
+#ifdef NDEBUG
+        { "build_type", "release" },
+#else
+        { "build_type", "debug" },
+#endif
+        { "cpus", std::to_string(sysconf(_SC_NPROCESSORS_ONLN)) },
+        { "l1d_bytes", std::to_string(sysconf(_SC_LEVEL1_DCACHE_SIZE)) },
+    };
+    for (const auto& [key, func] : bench::context_registry()) {
+        ctx.emplace_back(key, func());
+    }
+    return ctx;
+}
+
+/// @brief 主函数, 执行所有注册的性能测试项
+///
+/// ```bash
+/// <module>_bench [filter] [--json <file>]
+/// ```
+///
+/// - `filter`: 只执行名称中包含该字符串的测试项;
+/// - `--json`: 测试结果 JSON 文件路径, 默认为当前目录下的 `<module>_bench.json` (即执行文件名加 `.json` 后缀);
+int main(int argc, char* argv[]) {
+    const char* filter = "";
+    std::string name = argv[0];
+    std::string json = name.substr(name.rfind('/') + 1) + ".json";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json = argv[++i];
+        }
+        else {
+            filter = argv[i];
+        }
+    }
+
+    for (const auto& e : bench::registry()) {
+        if (strstr(e.name, filter)) {
+            printf("[ RUN      ] %s\n", e.name);
+            e.func();
+        }
+    }
+
+    return bench::write_json(json.c_str(), __context()) == 0 ? 0 : 1;
+}
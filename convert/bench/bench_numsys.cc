@@ -0,0 +1,157 @@
+#include <charconv>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "bench/bench.h"
+#include "numsys.h"
+
+#define BENCH_SUITE_NAME bench_convert__numsys
+
+using namespace convert;
+using namespace bench;
+
+/// @brief 每轮转换的整数个数
+static const size_t N_VALUES = 1 << 16;
+
+/// @brief 测试数据的分布
+struct distribution {
+    const char* name; // 分布名称
+    int lo;           // 最小值
+    int hi;           // 最大值
+};
+
+/// @brief 测试使用的三种数据分布
+///
+/// - `small`: 小整数, 转换结果只有 1 到 2 位;
+/// - `uniform`: 均匀分布的 32 位非负整数;
+/// - `negative`: 均匀分布的 32 位负整数;
+static const distribution DISTRIBUTIONS[] = {
+    { "small", 0, 99 },
+    { "uniform", 0, INT_MAX },
+    { "negative", INT_MIN + 1, -1 },
+};
+
+/// @brief 按指定分布产生随机整数
+///
+/// @param dist 数据分布
+/// @return 随机整数集合
+static std::vector<int> __values(const distribution& dist) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> ud(dist.lo, dist.hi);
+
+    std::vector<int> v(N_VALUES);
+    for (auto& n : v) {
+        n = ud(rng);
+    }
+    return v;
+}
+
+/// @brief 每个转换结果占用的槽位长度, 可容纳 32 位整数的二进制表示, 负号和 `\0` 结束符
+static const size_t SLOT = 40;
+
+/// @brief 测试一种转换实现, 吞吐量按输出的字符数计算
+///
+/// @param name 测试项名称
+/// @param values 待转换的整数集合
+/// @param f 转换函数, 形如 `size_t f(int num, char* buf)`, 返回写入的字符数
+template <typename F>
+static void __bench_impl(const std::string& name, const std::vector<int>& values, F&& f) {
+    std::vector<char> out(values.size() * SLOT);
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        bytes += f(values[i], out.data() + i * SLOT);
+    }
+
+    report(measure(name, values.size(), bytes, [&] {
+        char* p = out.data();
+        for (int v : values) {
+            do_not_optimize(f(v, p));
+            p += SLOT;
+        }
+    }));
+}
+
+/// @brief 将 `numsys` 中的转换函数包装为返回写入字符数的形式
+///
+/// @param r 转换函数的返回值
+/// @param buf 保存结果字符串的缓冲区
+/// @return 写入的字符数
+inline static size_t __len(int r, const char* buf) {
+    return r == 0 ? strlen(buf) : 0;
+}
+
+/// @brief 以符号加绝对值的形式通过 `snprintf` 输出十六进制, 和 `to_hex` 的格式保持一致
+///
+/// @param num 整数值
+/// @param buf 保存结果字符串的缓冲区
+/// @return 写入的字符数
+inline static size_t __snprintf_hex(int num, char* buf) {
+    unsigned u = num < 0 ? 0u - (unsigned)num : (unsigned)num;
+    return (size_t)snprintf(buf, SLOT, num < 0 ? "-%X" : "%X", u);
+}
+
+/// @brief 通过 `std::to_chars` 输出指定进制
+///
+/// @param num 整数值
+/// @param buf 保存结果字符串的缓冲区
+/// @param base 进制
+/// @return 写入的字符数
+inline static size_t __to_chars(int num, char* buf, int base) {
+    return (size_t)(std::to_chars(buf, buf + SLOT, num, base).ptr - buf);
+}
+
+BENCH(BENCH_SUITE_NAME, to_bin) {
+    for (const auto& dist : DISTRIBUTIONS) {
+        auto values = __values(dist);
+        std::string prefix = std::string("to_bin/") + dist.name;
+
+        __bench_impl(prefix + "/convert", values, [](int v, char* buf) {
+            return __len(to_bin(v, buf, SLOT), buf);
+        });
+        __bench_impl(prefix + "/to_chars", values, [](int v, char* buf) {
+            return __to_chars(v, buf, 2);
+        });
+        __bench_impl(prefix + "/fmt", values, [](int v, char* buf) {
+            return (size_t)(fmt::format_to(buf, "{:b}", v) - buf);
+        });
+    }
+}
+
+BENCH(BENCH_SUITE_NAME, to_hex) {
+    for (const auto& dist : DISTRIBUTIONS) {
+        auto values = __values(dist);
+        std::string prefix = std::string("to_hex/") + dist.name;
+
+        __bench_impl(prefix + "/convert", values, [](int v, char* buf) {
+            return __len(to_hex(v, buf, SLOT), buf);
+        });
+        __bench_impl(prefix + "/snprintf", values, __snprintf_hex);
+        __bench_impl(prefix + "/to_chars", values, [](int v, char* buf) {
+            return __to_chars(v, buf, 16);
+        });
+        __bench_impl(prefix + "/fmt", values, [](int v, char* buf) {
+            return (size_t)(fmt::format_to(buf, "{:X}", v) - buf);
+        });
+    }
+}
+
+/// Excel 列标识没有标准库对应实现, 只测试本模块的实现; 负数不是合法输入, 故跳过 `negative` 分布
+BENCH(BENCH_SUITE_NAME, to_excel_column) {
+    for (const auto& dist : DISTRIBUTIONS) {
+        if (dist.lo < 0) {
+            continue;
+        }
+
+        auto values = __values(dist);
+        __bench_impl(std::string("to_excel_column/") + dist.name + "/convert", values, [](int v, char* buf) {
+            return __len(to_excel_column(v, buf, SLOT), buf);
+        });
+    }
+}
@@ -0,0 +1,196 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/bench.h"
+#include "codec.h"
+#include "numsys.h"
+#include "radix.h"
+
+#define BENCH_SUITE_NAME bench_convert__radix
+
+using namespace convert;
+using namespace bench;
+
+// 编解码的性能取决于是否使用 AVX2 指令, 记录到测试结果的上下文信息中
+BENCH_CONTEXT(avx2, [] { return std::string(codec_has_avx2() ? "true" : "false"); });
+
+/// @brief 每轮转换的整数个数
+static const size_t N_VALUES = 1 << 16;
+
+/// @brief 编解码测试的数据长度
+static const size_t N_BYTES = 1 << 20;
+
+/// @brief 产生均匀分布的 64 位随机整数
+///
+/// @return 随机整数集合
+static const std::vector<uint64_t>& __values() {
+    static std::vector<uint64_t> values = [] {
+        std::mt19937_64 rng(42);
+        std::vector<uint64_t> v(N_VALUES);
+        for (auto& n : v) {
+            n = rng();
+        }
+        return v;
+    }();
+    return values;
+}
+
+/// @brief 朴素的逐位转换实现, 每产生一位数字执行一次运行时除法, 作为对比基准
+///
+/// @param u 整数值
+/// @param radix 进制
+/// @param out 保存结果字符串的指针
+/// @return 写入的字符个数
+static size_t __naive_format(uint64_t u, unsigned radix, char* out) {
+    char tmp[64];
+    size_t n = 0;
+    do {
+        tmp[n++] = RADIX_DIGITS[u % radix];
+        u /= radix;
+    } while (u > 0);
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+
+/// @brief 测试 `format_radix<R>` 转换 64 位整数的性能, 吞吐量按输出字符数计算
+///
+/// @tparam R 进制
+/// @param name 测试项名称
+template <unsigned R>
+static void __bench_format(const char* name) {
+    const auto& values = __values();
+    std::vector<char> out(values.size() * 65);
+
+    size_t bytes = 0;
+    for (uint64_t v : values) {
+        bytes += format_radix<R>(v, out.data());
+    }
+
+    report(measure(std::string(name) + "/convert", values.size(), bytes, [&] {
+        char* p = out.data();
+        for (uint64_t v : values) {
+            p += format_radix<R>(v, p);
+        }
+        do_not_optimize(p);
+    }));
+
+    report(measure(std::string(name) + "/naive", values.size(), bytes, [&] {
+        char* p = out.data();
+        for (uint64_t v : values) {
+            p += __naive_format(v, R, p);
+        }
+        do_not_optimize(p);
+    }));
+}
+
+/// @brief 测试 `from_radix<R>` 解析 64 位整数的性能, 吞吐量按输入字符数计算
+///
+/// @tparam R 进制
+/// @param name 测试项名称
+template <unsigned R>
+static void __bench_parse(const char* name) {
+    const auto& values = __values();
+
+    std::vector<std::string> strs;
+    size_t bytes = 0;
+    for (uint64_t v : values) {
+        char buf[80];
+        to_radix<R>(v, buf, sizeof(buf));
+        strs.emplace_back(buf);
+        bytes += strs.back().size();
+    }
+
+    report(measure(name, strs.size(), bytes, [&] {
+        uint64_t sum = 0;
+        for (const auto& s : strs) {
+            uint64_t n = 0;
+            from_radix<R>(s.data(), s.size(), &n);
+            sum += n;
+        }
+        do_not_optimize(sum);
+    }));
+}
+
+BENCH(BENCH_SUITE_NAME, format) {
+    __bench_format<2>("format_radix/base2");
+    __bench_format<8>("format_radix/base8");
+    __bench_format<10>("format_radix/base10");
+    __bench_format<16>("format_radix/base16");
+    __bench_format<36>("format_radix/base36");
+}
+
+BENCH(BENCH_SUITE_NAME, parse) {
+    __bench_parse<2>("from_radix/base2");
+    __bench_parse<10>("from_radix/base10");
+    __bench_parse<16>("from_radix/base16");
+    __bench_parse<36>("from_radix/base36");
+}
+
+/// @brief 产生随机字节数据
+///
+/// @return 随机数据
+static const std::vector<uint8_t>& __bytes() {
+    static std::vector<uint8_t> bytes = [] {
+        std::mt19937 rng(42);
+        std::vector<uint8_t> v(N_BYTES);
+        for (auto& b : v) {
+            b = (uint8_t)rng();
+        }
+        return v;
+    }();
+    return bytes;
+}
+
+/// @brief 测试 Base64 编解码性能, 吞吐量按原始数据字节数计算
+///
+/// @param impl 实现方式
+/// @param enc_name 编码测试项名称
+/// @param dec_name 解码测试项名称
+static void __bench_base64(codec_impl impl, const char* enc_name, const char* dec_name) {
+    const auto& data = __bytes();
+
+    std::string text(base64_encoded_len(data.size()) + 1, '\0');
+    std::vector<uint8_t> decoded(base64_decoded_len(text.size()));
+
+    size_t text_len = 0;
+    report(measure(enc_name, 1, data.size(), [&] {
+        base64_encode(data.data(), data.size(), text.data(), text.size(), &text_len, impl);
+        do_not_optimize(text_len);
+    }));
+
+    size_t out_len = 0;
+    report(measure(dec_name, 1, data.size(), [&] {
+        base64_decode(text.data(), text_len, decoded.data(), decoded.size(), &out_len, impl);
+        do_not_optimize(out_len);
+    }));
+}
+
+BENCH(BENCH_SUITE_NAME, base64) {
+    __bench_base64(codec_impl::scalar, "base64_encode/scalar", "base64_decode/scalar");
+    if (codec_has_avx2()) {
+        __bench_base64(codec_impl::avx2, "base64_encode/avx2", "base64_decode/avx2");
+    }
+}
+
+BENCH(BENCH_SUITE_NAME, base32) {
+    const auto& data = __bytes();
+
+    std::string text(base32_encoded_len(data.size()) + 1, '\0');
+    std::vector<uint8_t> decoded(base32_decoded_len(text.size()));
+
+    size_t text_len = 0;
+    report(measure("base32_encode", 1, data.size(), [&] {
+        base32_encode(data.data(), data.size(), text.data(), text.size(), &text_len);
+        do_not_optimize(text_len);
+    }));
+
+    size_t out_len = 0;
+    report(measure("base32_decode", 1, data.size(), [&] {
+        base32_decode(text.data(), text_len, decoded.data(), decoded.size(), &out_len);
+        do_not_optimize(out_len);
+    }));
+}
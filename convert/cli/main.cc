@@ -0,0 +1,396 @@
+/// 批量转换工具
+///
+/// 从文件 (或标准输入) 中读取每行一个的十进制整数, 转换为十六进制, 二进制, 36 进制或 Excel 列标识后输出
+///
+/// ```bash
+/// convert_cli [-t hex|bin|base36|excel] [-j threads] [-b block_mb] [-o output] [input]
+/// ```
+///
+/// - 输入为普通文件时通过 `mmap` 映射, 否则以大块 `read` 的方式流式读取;
+/// - 输入按块处理, 每块再按换行符切分给多个线程并行转换, 各线程的输出缓冲区在程序运行期间重复使用;
+/// - 每块的转换结果按顺序通过一次 `writev` 调用写出;
+/// - 结束时向标准错误输出吞吐量统计;
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "lines.h"
+
+using namespace convert;
+
+// 每块输入数据大小的上限 (MB), 换算为字节时不会溢出, 且各线程的输出缓冲区仍可分配
+static constexpr size_t MAX_BLOCK_MB = 1024;
+
+/// @brief 命令行参数
+struct options {
+    line_format fmt = line_format::hex; // 目标格式
+    size_t threads = 1;                 // 并行线程数
+    size_t block_size = 16 << 20;       // 每块输入数据的大小
+    const char* input = nullptr;        // 输入文件, `NULL` 表示标准输入
+    const char* output = nullptr;       // 输出文件, `NULL` 表示标准输出
+};
+
+/// @brief 转换器, 持有各线程可重复使用的输出缓冲区
+class converter {
+public:
+    /// @brief 参数构造器
+    ///
+    /// @param opts 命令行参数
+    /// @param out_fd 输出文件描述符
+    converter(const options& opts, int out_fd) :
+        _opts(opts), _out_fd(out_fd), _bufs(opts.threads), _lens(opts.threads), _offsets(opts.threads + 1) {
+        for (auto& buf : _bufs) {
+            buf.resize(convert_lines_bound(opts.block_size / opts.threads + opts.block_size % opts.threads));
+        }
+    }
+
+    /// @brief 转换一块以换行符结尾的数据, 并将结果写入输出文件
+    ///
+    /// @param data 数据指针
+    /// @param len 数据长度
+    /// @return `0` 表示成功, `-1` 表示写入失败
+    int process(const char* data, size_t len) {
+        size_t parts = split_lines(data, len, _opts.threads, _offsets.data());
+
+        // 单线程时直接在当前线程转换, 避免创建线程的开销
+        if (parts <= 1) {
+            _convert_part(0, data);
+        }
+        else {
+            std::vector<std::thread> workers;
+            workers.reserve(parts - 1);
+            for (size_t i = 1; i < parts; i++) {
+                workers.emplace_back(&converter::_convert_part, this, i, data);
+            }
+            _convert_part(0, data);
+
+            for (auto& t : workers) {
+                t.join();
+            }
+        }
+
+        // 按顺序通过一次 `writev` 调用写出所有分块的结果
+        std::vector<iovec> iov(parts);
+        for (size_t i = 0; i < parts; i++) {
+            iov[i] = { _bufs[i].data(), _lens[i] };
+        }
+        _bytes_in += len;
+        return _write_all(iov.data(), (int)parts);
+    }
+
+    /// @brief 已处理的输入字节数
+    size_t bytes_in() const { return _bytes_in; }
+
+    /// @brief 无法解析的行数
+    size_t invalid() const { return _invalid; }
+
+private:
+    const options& _opts;
+    int _out_fd;
+    std::vector<std::vector<char>> _bufs; // 各线程的输出缓冲区
+    std::vector<size_t> _lens;            // 各线程输出的字节数
+    std::vector<size_t> _offsets;         // 分块边界
+    size_t _bytes_in = 0;
+    size_t _invalid = 0;
+
+    /// @brief 转换第 `i` 个分块
+    ///
+    /// @param i 分块下标
+    /// @param data 整块数据指针
+    void _convert_part(size_t i, const char* data) {
+        size_t invalid = 0;
+        size_t len = _offsets[i + 1] - _offsets[i];
+
+        // 分块长度可能因对齐换行符而超过预估值, 此时扩大缓冲区
+        if (_bufs[i].size() < convert_lines_bound(len)) {
+            _bufs[i].resize(convert_lines_bound(len));
+        }
+
+        _lens[i] = convert_lines(data + _offsets[i], len, _bufs[i].data(), _opts.fmt, &invalid);
+        __atomic_add_fetch(&_invalid, invalid, __ATOMIC_RELAXED);
+    }
+
+    /// @brief 将 `iov` 中的全部数据写入输出文件, 处理部分写入的情况
+    ///
+    /// `writev` 单次最多接受 `IOV_MAX` 个 `iovec`, 超过时会以 `EINVAL` 失败, 故线程数较多时分批写出
+    ///
+    /// @param iov `iovec` 数组
+    /// @param n 数组长度
+    /// @return `0` 表示成功, `-1` 表示写入失败
+    int _write_all(iovec* iov, int n) {
+        while (n > 0) {
+            ssize_t w = writev(_out_fd, iov, n < IOV_MAX ? n : IOV_MAX);
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("cannot write output");
+                return -1;
+            }
+
+            // 跳过已完整写入的 `iovec`, 并调整部分写入的 `iovec`
+            while (n > 0 && (size_t)w >= iov->iov_len) {
+                w -= (ssize_t)iov->iov_len;
+                iov++;
+                n--;
+            }
+            if (n > 0) {
+                iov->iov_base = (char*)iov->iov_base + w;
+                iov->iov_len -= (size_t)w;
+            }
+        }
+        return 0;
+    }
+};
+
+/// @brief 通过 `mmap` 映射输入文件, 并按块进行转换
+///
+/// @param conv 转换器
+/// @param fd 输入文件描述符
+/// @param size 输入文件大小
+/// @param block_size 块大小
+/// @return `0` 表示成功, `-1` 表示失败
+static int __process_mapped(converter& conv, int fd, size_t size, size_t block_size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    const char* data = (const char*)mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        perror("cannot mmap input");
+        return -1;
+    }
+
+    // 提示内核按顺序读取, 以增大预读窗口
+    madvise((void*)data, size, MADV_SEQUENTIAL);
+
+    int rc = 0;
+    for (size_t pos = 0; rc == 0 && pos < size;) {
+        size_t end = pos + block_size < size ? pos + block_size : size;
+
+        // 将块结尾对齐到换行符
+        if (end < size) {
+            const char* nl = (const char*)memchr(data + end, '\n', size - end);
+            end = nl ? (size_t)(nl - data) + 1 : size;
+        }
+
+        rc = conv.process(data + pos, end - pos);
+        pos = end;
+    }
+
+    munmap((void*)data, size);
+    return rc;
+}
+
+/// @brief 通过 `read` 按块流式读取输入, 并进行转换
+///
+/// 每块结尾不完整的行会被移动到下一块的开头继续处理
+///
+/// @param conv 转换器
+/// @param fd 输入文件描述符
+/// @param block_size 块大小
+/// @return `0` 表示成功, `-1` 表示失败
+static int __process_stream(converter& conv, int fd, size_t block_size) {
+    std::vector<char> buf(block_size);
+    size_t filled = 0;
+
+    for (;;) {
+        // 当缓冲区中没有换行符时 (单行超过块大小), 扩大缓冲区
+        if (filled == buf.size()) {
+            buf.resize(buf.size() * 2);
+        }
+
+        ssize_t n = read(fd, buf.data() + filled, buf.size() - filled);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("cannot read input");
+            return -1;
+        }
+
+        if (n == 0) {
+            // 处理最后剩余的数据
+            return filled > 0 ? conv.process(buf.data(), filled) : 0;
+        }
+
+        filled += (size_t)n;
+
+        // 只处理到最后一个换行符为止
+        const char* nl = (const char*)memrchr(buf.data(), '\n', filled);
+        if (!nl) {
+            continue;
+        }
+
+        size_t len = (size_t)(nl - buf.data()) + 1;
+        if (conv.process(buf.data(), len) != 0) {
+            return -1;
+        }
+
+        memmove(buf.data(), buf.data() + len, filled - len);
+        filled -= len;
+    }
+}
+
+/// @brief 解析不超过 `max` 的十进制非负整数
+///
+/// @param text 参数文本
+/// @param max 允许的最大值
+/// @param value 保存解析结果的指针
+/// @return `true` 表示解析成功, 文本不是完整的十进制整数或超出范围时返回 `false`
+static bool __parse_count(const char* text, size_t max, size_t* value) {
+    // `strtoul` 会跳过前导空白并接受负号, 故要求首字符为数字
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+
+    char* end;
+    errno = 0;
+    unsigned long v = strtoul(text, &end, 10);
+    if (errno != 0 || *end != '\0' || v > max) {
+        return false;
+    }
+    *value = v;
+    return true;
+}
+
+/// @brief 解析目标格式名称
+///
+/// @param name 格式名称
+/// @param fmt 保存解析结果的指针
+/// @return `true` 表示解析成功
+static bool __parse_format(const char* name, line_format* fmt) {
+    static const struct {
+        const char* name;
+        line_format fmt;
+    } formats[] = {
+        { "hex", line_format::hex },
+        { "bin", line_format::bin },
+        { "base36", line_format::base36 },
+        { "excel", line_format::excel },
+    };
+
+    for (const auto& f : formats) {
+        if (strcmp(name, f.name) == 0) {
+            *fmt = f.fmt;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief 输出命令行用法
+///
+/// @param prog 程序名
+static void __usage(const char* prog) {
+    fprintf(stderr,
+        "usage: %s [-t hex|bin|base36|excel] [-j threads] [-b block_mb] [-o output] [input]\n"
+        "  -t  target format (default: hex)\n"
+        "  -j  number of worker threads, 0 means all CPUs, at most 4 per CPU (default: 1)\n"
+        "  -b  input block size in MB, at most %zu (default: 16)\n"
+        "  -o  output file (default: stdout)\n"
+        "  input file defaults to stdin\n",
+        prog, MAX_BLOCK_MB);
+}
+
+int main(int argc, char* argv[]) {
+    options opts;
+
+    // `hardware_concurrency` 无法确定 CPU 数时返回 `0`
+    size_t cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) {
+        cpus = 1;
+    }
+
+    int c;
+    while ((c = getopt(argc, argv, "t:j:b:o:h")) != -1) {
+        switch (c) {
+        case 't':
+            if (!__parse_format(optarg, &opts.fmt)) {
+                __usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 'j':
+            if (!__parse_count(optarg, 4 * cpus, &opts.threads)) {
+                __usage(argv[0]);
+                return 2;
+            }
+            if (opts.threads == 0) {
+                opts.threads = cpus;
+            }
+            break;
+        case 'b':
+            if (!__parse_count(optarg, MAX_BLOCK_MB, &opts.block_size)) {
+                __usage(argv[0]);
+                return 2;
+            }
+            opts.block_size <<= 20;
+            break;
+        case 'o':
+            opts.output = optarg;
+            break;
+        default:
+            __usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+
+    if (optind < argc) {
+        opts.input = argv[optind];
+    }
+    if (opts.threads == 0) {
+        opts.threads = 1;
+    }
+    if (opts.block_size == 0) {
+        opts.block_size = 1 << 20;
+    }
+
+    int in_fd = opts.input ? open(opts.input, O_RDONLY) : STDIN_FILENO;
+    if (in_fd < 0) {
+        perror("cannot open input");
+        return 1;
+    }
+
+    int out_fd = opts.output ? open(opts.output, O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+    if (out_fd < 0) {
+        perror("cannot open output");
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    converter conv(opts, out_fd);
+
+    // 普通文件通过 `mmap` 映射, 管道等其它类型通过 `read` 流式读取
+    struct stat st;
+    int rc = fstat(in_fd, &st) == 0 && S_ISREG(st.st_mode)
+        ? __process_mapped(conv, in_fd, (size_t)st.st_size, opts.block_size)
+        : __process_stream(conv, in_fd, opts.block_size);
+
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double mb = conv.bytes_in() / 1e6;
+
+    fprintf(stderr, "%.2f MB in %.3f s, %.2f MB/s, %zu invalid lines, %zu threads\n",
+        mb, sec, sec > 0 ? mb / sec : 0, conv.invalid(), opts.threads);
+
+    if (opts.input) {
+        close(in_fd);
+    }
+    if (opts.output) {
+        close(out_fd);
+    }
+    return rc == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef __CONVERT__CODEC_H
+#define __CONVERT__CODEC_H
+
+#include <stdint.h>
+
+#include "common.h"
+
+namespace convert {
+
+	/// @brief 编解码的实现方式
+	enum class codec_impl {
+		automatic, // 根据 CPU 特性自动选择
+		scalar,    // 标量实现
+		avx2,      // AVX2 实现, 若 CPU 不支持 AVX2, 则退化为标量实现
+	};
+
+	/// @brief 判断当前 CPU 是否支持 AVX2 指令集
+	///
+	/// @return `true` 表示支持
+	bool codec_has_avx2();
+
+	/// @brief 计算 Base64 编码后的字符串长度 (包含 `=` 填充, 不包含 `\0` 结束符)
+	///
+	/// @param len 原始数据长度
+	/// @return 编码后字符串长度
+	inline size_t base64_encoded_len(size_t len) { return (len + 2) / 3 * 4; }
+
+	/// @brief 计算 Base64 解码后数据的最大长度
+	///
+	/// @param len 编码字符串长度
+	/// @return 解码后数据的最大长度
+	inline size_t base64_decoded_len(size_t len) { return (len + 3) / 4 * 3; }
+
+	/// @brief 将数据编码为 Base64 字符串 (RFC 4648 标准字母表, 包含 `=` 填充)
+	///
+	/// AVX2 实现每次将 24 字节数据重排为 32 个 6 位索引, 再通过查表指令一次性转为 32 个字符,
+	/// 不足 28 字节的尾部数据通过标量实现处理
+	///
+	/// @param src 原始数据指针
+	/// @param len 原始数据长度
+	/// @param buf 保存结果字符串的缓冲区指针, 结果以 `\0` 结尾
+	/// @param buflen 保存结果字符串的缓冲区长度, 至少为 `base64_encoded_len(len) + 1`
+	/// @param out_len 保存结果字符串长度的指针, 可以为 `NULL`
+	/// @param impl 实现方式
+	/// @return `0` 表示成功, 非 `0` 表示缓冲区长度不足
+	int base64_encode(const void* src, size_t len, char* buf, size_t buflen, size_t* out_len,
+		codec_impl impl = codec_impl::automatic);
+
+	/// @brief 将 Base64 字符串解码为数据
+	///
+	/// 字符串结尾的 `=` 填充是可选的, 即同时支持有填充和无填充两种格式
+	///
+	/// AVX2 实现每次校验并转换 32 个字符, 再将得到的 32 个 6 位数值合并为 24 字节数据;
+	/// 当遇到非法字符时, 退化为标量实现处理剩余部分, 由标量实现报告错误
+	///
+	/// @param src Base64 字符串指针
+	/// @param len Base64 字符串长度
+	/// @param buf 保存结果数据的缓冲区指针
+	/// @param buflen 保存结果数据的缓冲区长度, 至少为 `base64_decoded_len(len)`
+	/// @param out_len 保存结果数据长度的指针, 可以为 `NULL`
+	/// @param impl 实现方式
+	/// @return `0` 表示成功, 非 `0` 表示缓冲区长度不足或字符串中包含非法字符
+	int base64_decode(const char* src, size_t len, void* buf, size_t buflen, size_t* out_len,
+		codec_impl impl = codec_impl::automatic);
+
+	/// @brief 计算 Base32 编码后的字符串长度 (包含 `=` 填充, 不包含 `\0` 结束符)
+	///
+	/// @param len 原始数据长度
+	/// @return 编码后字符串长度
+	inline size_t base32_encoded_len(size_t len) { return (len + 4) / 5 * 8; }
+
+	/// @brief 计算 Base32 解码后数据的最大长度
+	///
+	/// @param len 编码字符串长度
+	/// @return 解码后数据的最大长度
+	inline size_t base32_decoded_len(size_t len) { return (len + 7) / 8 * 5; }
+
+	/// @brief 将数据编码为 Base32 字符串 (RFC 4648 标准字母表, 包含 `=` 填充)
+	///
+	/// @param src 原始数据指针
+	/// @param len 原始数据长度
+	/// @param buf 保存结果字符串的缓冲区指针, 结果以 `\0` 结尾
+	/// @param buflen 保存结果字符串的缓冲区长度, 至少为 `base32_encoded_len(len) + 1`
+	/// @param out_len 保存结果字符串长度的指针, 可以为 `NULL`
+	/// @return `0` 表示成功, 非 `0` 表示缓冲区长度不足
+	int base32_encode(const void* src, size_t len, char* buf, size_t buflen, size_t* out_len);
+
+	/// @brief 将 Base32 字符串 (不区分大小写) 解码为数据
+	///
+	/// 字符串结尾的 `=` 填充是可选的
+	///
+	/// @param src Base32 字符串指针
+	/// @param len Base32 字符串长度
+	/// @param buf 保存结果数据的缓冲区指针
+	/// @param buflen 保存结果数据的缓冲区长度, 至少为 `base32_decoded_len(len)`
+	/// @param out_len 保存结果数据长度的指针, 可以为 `NULL`
+	/// @return `0` 表示成功, 非 `0` 表示缓冲区长度不足或字符串中包含非法字符
+	int base32_decode(const char* src, size_t len, void* buf, size_t buflen, size_t* out_len);
+
+} // namespace convert
+
+#endif // __CONVERT__CODEC_H
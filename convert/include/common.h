@@ -5,4 +5,11 @@
 
 #include <stdlib.h>
 
+// 定义错误码, 各转换函数返回 `0` 表示成功, 返回如下负数表示失败
+#define ERR_BUF_NOT_ENOUGH (-1)      // 缓冲区长度不足
+#define ERR_NUM_CANNOT_NEGATIVE (-2) // 数值不能为负数
+#define ERR_RADIX_OUT_OF_RANGE (-3)  // 进制超出 `[2, 36]` 范围
+#define ERR_INVALID_CHAR (-4)        // 字符串中包含非法字符
+#define ERR_NUM_OUT_OF_RANGE (-5)    // 解析结果超出目标类型范围
+
 #endif // __CONVERT__COMMON_H
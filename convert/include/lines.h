@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef __CONVERT__LINES_H
+#define __CONVERT__LINES_H
+
+#include "common.h"
+
+namespace convert {
+
+	/// @brief 按行转换时的目标格式
+	enum class line_format {
+		hex,    // 十六进制, 参见 `to_hex`
+		bin,    // 二进制, 参见 `to_bin`
+		base36, // 36 进制, 参见 `to_base36`
+		excel,  // Excel 列标识, 参见 `to_excel_column`
+	};
+
+	/// @brief 计算转换 `len` 字节输入所需的输出缓冲区长度上限
+	///
+	/// 每行十进制整数转为二进制后长度最多膨胀为约 `3.33` 倍, 加上负号和换行符, 输出长度不会超过输入长度的 `4` 倍,
+	/// 另外预留最后一行没有换行符时所需的空间
+	///
+	/// @param len 输入数据长度
+	/// @return 输出缓冲区长度上限
+	inline size_t convert_lines_bound(size_t len) { return len * 4 + 128; }
+
+	/// @brief 将每行一个十进制整数的文本转换为目标格式, 每行输出一个结果
+	///
+	/// - 行尾的 `\r` 会被忽略, 最后一行可以没有换行符;
+	/// - 无法解析的行 (包括空行, 超出 64 位范围的数值, 以及 Excel 格式下的负数) 输出为空行, 以保持输入输出行号对应;
+	///
+	/// @param in 输入数据指针
+	/// @param len 输入数据长度
+	/// @param out 输出缓冲区指针, 长度至少为 `convert_lines_bound(len)`
+	/// @param fmt 目标格式
+	/// @param invalid 用于累加无法解析行数的指针, 可以为 `NULL`
+	/// @return 写入输出缓冲区的字节数
+	size_t convert_lines(const char* in, size_t len, char* out, line_format fmt, size_t* invalid);
+
+	/// @brief 将数据按换行符切分为至多 `parts` 段长度接近的分块, 便于多线程并行处理
+	///
+	/// 每个分块 (最后一块除外) 均以 `\n` 结尾, 保证不会将一行拆分到两个分块中
+	///
+	/// @param data 数据指针
+	/// @param len 数据长度
+	/// @param parts 期望的分块数
+	/// @param offsets 保存分块边界的数组, 长度至少为 `parts + 1`, 第 `i` 块为 `[offsets[i], offsets[i + 1])`
+	/// @return 实际分块数, 当数据行数较少时可能小于 `parts`
+	size_t split_lines(const char* data, size_t len, size_t parts, size_t* offsets);
+
+} // namespace convert
+
+#endif // __CONVERT__LINES_H
@@ -4,14 +4,14 @@
 #define __CONVERT__NUMSYS_H
 
 #include "common.h"
-
-#define ERR_BUF_NOT_ENOUGH (-1)
-#define ERR_NUM_CANNOT_NEGATIVE (-2)
+#include "radix.h"
 
 namespace convert {
 
 	/// @brief 将整数转为二进制字符串
 	///
+	/// 本函数通过 `to_radix<2>` 实现, 参见 `radix.h`
+	///
 	/// @param num 整数值
 	/// @param buf 保存结果字符串的缓冲区指针
 	/// @param buflen 保存结果字符串的缓冲区长度
@@ -20,6 +20,8 @@ namespace convert {
 
 	/// @brief 将整数转为十六进制字符串
 	///
+	/// 本函数通过 `to_radix<16>` 实现, 参见 `radix.h`
+	///
 	/// @param num 整数值
 	/// @param buf 保存结果字符串的缓冲区指针
 	/// @param buflen 保存结果字符串的缓冲区长度
@@ -38,6 +40,40 @@ namespace convert {
 	/// @return `0` 表示成功, 非 `0` 表示缓冲区长度不足
 	int to_excel_column(int num, char* buf, size_t buflen);
 
+	/// @brief 将整数转为指定进制的字符串
+	///
+	/// 与 `to_radix` 模板函数不同, 本函数的进制在运行时指定, 内部通过函数表分派到对应进制的 `to_radix` 实例
+	///
+	/// @param num 整数值
+	/// @param radix 进制, 取值范围为 `[2, 36]`
+	/// @param buf 保存结果字符串的缓冲区指针
+	/// @param buflen 保存结果字符串的缓冲区长度
+	/// @return `0` 表示成功, 非 `0` 表示进制超出范围或缓冲区长度不足
+	int to_base(long long num, unsigned radix, char* buf, size_t buflen);
+
+	/// @brief 将指定进制的字符串解析为整数
+	///
+	/// @param s 字符串指针, 以 `\0` 结尾
+	/// @param radix 进制, 取值范围为 `[2, 36]`
+	/// @param out 保存解析结果的指针
+	/// @return `0` 表示成功, 非 `0` 表示进制超出范围, 存在非法字符或结果超出范围
+	int from_base(const char* s, unsigned radix, long long* out);
+
+	/// @brief 将非负整数转为 36 进制字符串, 用于生成短 ID
+	///
+	/// @param num 整数值, 不能为负数
+	/// @param buf 保存结果字符串的缓冲区指针
+	/// @param buflen 保存结果字符串的缓冲区长度
+	/// @return `0` 表示成功, 非 `0` 表示数值为负数或缓冲区长度不足
+	int to_base36(long long num, char* buf, size_t buflen);
+
+	/// @brief 将 36 进制字符串 (不区分大小写) 解析为非负整数
+	///
+	/// @param s 字符串指针, 以 `\0` 结尾
+	/// @param out 保存解析结果的指针
+	/// @return `0` 表示成功, 非 `0` 表示存在非法字符或结果超出范围
+	int from_base36(const char* s, long long* out);
+
 } // namespace convert
 
 #endif // __CONVERT_NUMSYS_H
@@ -0,0 +1,255 @@
+#pragma once
+
+#ifndef __CONVERT__RADIX_H
+#define __CONVERT__RADIX_H
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "common.h"
+
+/// 通用进制转换引擎
+///
+/// 朴素的进制转换每产生一位数字就要执行一次除法 (`num % R` 和 `num / R`), 而硬件除法指令的延迟往往高达数十个时钟周期
+///
+/// 本引擎的做法是: 先求出在一个机器字 (`radix_word`) 内能容纳的 `R` 的最大幂次 `R^k`, 然后每次用 `R^k` 对数值做除法,
+/// 一次除法即可切分出 `k` 位数字 (即一个 "块"), 块内的 `k` 位数字再通过除以编译期常量 `R` 得到, 编译器会将其优化为乘法和移位
+///
+/// 由于进制 `R` 为模板参数, `R^k` 同样为编译期常量, 故整个转换过程中不会产生真正的硬件除法指令
+namespace convert {
+
+	/// @brief 数字字符表, 支持 `2` 到 `36` 进制, 超过 `10` 的数字以大写字母表示
+	inline constexpr char RADIX_DIGITS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	/// @brief 机器字类型, 转换过程中的所有运算均在该类型上进行
+	using radix_word = uint64_t;
+
+	/// @brief 计算一个机器字内能容纳的 `R` 的最大幂次 `k`, 即一次除法最多可切分出的数字位数
+	///
+	/// @tparam R 进制
+	/// @return 幂次 `k`
+	template <unsigned R>
+	constexpr unsigned __chunk_digits() noexcept {
+		static_assert(R >= 2 && R <= 36, "radix must be in [2, 36]");
+
+		unsigned k = 0;
+		for (radix_word p = 1; p <= std::numeric_limits<radix_word>::max() / R; p *= R) {
+			++k;
+		}
+		return k;
+	}
+
+	/// @brief 计算 `R^n` 的值
+	///
+	/// @tparam R 进制
+	/// @param n 幂次
+	/// @return `R^n` 的值
+	template <unsigned R>
+	constexpr radix_word __radix_pow(unsigned n) noexcept {
+		radix_word p = 1;
+		while (n-- > 0) {
+			p *= R;
+		}
+		return p;
+	}
+
+	/// @brief 计算 `T` 类型整数转为 `R` 进制字符串后的最大长度 (包含负号, 不包含 `\0` 结束符)
+	///
+	/// @tparam R 进制
+	/// @tparam T 整数类型
+	/// @return 最大字符串长度
+	template <unsigned R, typename T>
+	constexpr size_t radix_max_len() noexcept {
+		static_assert(std::is_integral_v<T>, "T must be integral type");
+
+		// 计算 `T` 类型的最大绝对值, 有符号类型的最小值取绝对值后比最大值大 `1`
+		radix_word u = std::is_signed_v<T>
+			? static_cast<radix_word>(std::numeric_limits<T>::max()) + 1
+			: static_cast<radix_word>(std::numeric_limits<T>::max());
+
+		size_t len = 0;
+		do {
+			++len;
+			u /= R;
+		} while (u > 0);
+
+		return len + (std::is_signed_v<T> ? 1 : 0);
+	}
+
+	/// @brief 将无符号整数转为 `R` 进制字符串, 从 `end` 位置向前写入
+	///
+	/// @tparam R 进制
+	/// @param u 无符号整数值
+	/// @param end 写入位置的尾部指针, 字符串将写入 `[返回值, end)` 区间
+	/// @return 字符串的起始指针
+	template <unsigned R>
+	inline char* __format_unsigned(radix_word u, char* end) noexcept {
+		constexpr unsigned K = __chunk_digits<R>();
+		constexpr radix_word D = __radix_pow<R>(K);
+
+		char* p = end;
+
+		// 每次除以 `R^k` 切分出一个完整的块, 块内的 `k` 位数字需要保留前导 `0`
+		while (u >= D) {
+			radix_word q = u / D;
+			radix_word chunk = u - q * D;
+			for (unsigned i = 0; i < K; i++) {
+				*--p = RADIX_DIGITS[chunk % R];
+				chunk /= R;
+			}
+			u = q;
+		}
+
+		// 处理最高位的块, 该块不保留前导 `0`, 但数值为 `0` 时需要输出一位 `0`
+		do {
+			*--p = RADIX_DIGITS[u % R];
+			u /= R;
+		} while (u > 0);
+
+		return p;
+	}
+
+	/// @brief 将整数转为 `R` 进制字符串, 不进行缓冲区长度检查, 也不写入 `\0` 结束符
+	///
+	/// 该函数用于向大缓冲区中连续输出转换结果的场景, 调用方需保证 `out` 之后至少有
+	/// `radix_max_len<R, T>()` 字节的可用空间
+	///
+	/// @tparam R 进制
+	/// @tparam T 整数类型
+	/// @param num 整数值
+	/// @param out 保存结果字符串的缓冲区指针
+	/// @return 写入的字符个数
+	template <unsigned R, typename T>
+	inline size_t format_radix(T num, char* out) noexcept {
+		static_assert(std::is_integral_v<T>, "T must be integral type");
+
+		char tmp[radix_max_len<R, T>()];
+		char* end = tmp + sizeof(tmp);
+
+		// 取数值的绝对值, 通过无符号运算避免对最小负数取反时溢出
+		bool negative = false;
+		radix_word u = static_cast<radix_word>(num);
+		if constexpr (std::is_signed_v<T>) {
+			if (num < 0) {
+				negative = true;
+				u = radix_word(0) - u;
+			}
+		}
+
+		char* p = __format_unsigned<R>(u, end);
+		if (negative) {
+			*--p = '-';
+		}
+
+		size_t len = static_cast<size_t>(end - p);
+		memcpy(out, p, len);
+		return len;
+	}
+
+	/// @brief 将整数转为 `R` 进制字符串
+	///
+	/// @tparam R 进制, 取值范围为 `[2, 36]`
+	/// @tparam T 整数类型
+	/// @param num 整数值
+	/// @param buf 保存结果字符串的缓冲区指针
+	/// @param buflen 保存结果字符串的缓冲区长度
+	/// @return `0` 表示成功, 非 `0` 表示缓冲区长度不足
+	template <unsigned R, typename T>
+	int to_radix(T num, char* buf, size_t buflen) noexcept {
+		char tmp[radix_max_len<R, T>()];
+
+		size_t len = format_radix<R>(num, tmp);
+		if (len + 1 > buflen) {
+			return ERR_BUF_NOT_ENOUGH;
+		}
+
+		memcpy(buf, tmp, len);
+		buf[len] = '\0';
+
+		return 0;
+	}
+
+	/// @brief 字符到数字值的映射表, 不区分大小写, 非法字符映射为 `0xFF`
+	inline constexpr struct __digit_table {
+		uint8_t values[256];
+
+		constexpr __digit_table() : values() {
+			for (int c = 0; c < 256; c++) {
+				values[c] = 0xFF;
+			}
+			for (int c = '0'; c <= '9'; c++) {
+				values[c] = static_cast<uint8_t>(c - '0');
+			}
+			for (int c = 'A'; c <= 'Z'; c++) {
+				values[c] = static_cast<uint8_t>(c - 'A' + 10);
+				values[c - 'A' + 'a'] = static_cast<uint8_t>(c - 'A' + 10);
+			}
+		}
+	} __DIGIT_TABLE{};
+
+	/// @brief 将 `R` 进制字符串解析为整数
+	///
+	/// 和转换过程相对应, 解析时每次在机器字内累加 `k` 位数字, 之后再将整块合并到结果中,
+	/// 只有合并时需要进行溢出检查
+	///
+	/// @tparam R 进制, 取值范围为 `[2, 36]`
+	/// @tparam T 整数类型
+	/// @param s 字符串指针, 可以以 `-` 或 `+` 开头
+	/// @param len 字符串长度
+	/// @param out 保存解析结果的指针
+	/// @return `0` 表示成功, 非 `0` 表示存在非法字符或结果超出 `T` 类型范围
+	template <unsigned R, typename T>
+	int from_radix(const char* s, size_t len, T* out) noexcept {
+		static_assert(std::is_integral_v<T>, "T must be integral type");
+
+		constexpr unsigned K = __chunk_digits<R>();
+
+		bool negative = false;
+		if (len > 0 && (*s == '-' || *s == '+')) {
+			negative = *s == '-';
+			s++;
+			len--;
+		}
+
+		if (len == 0 || (negative && !std::is_signed_v<T>)) {
+			return ERR_INVALID_CHAR;
+		}
+
+		radix_word u = 0;
+		while (len > 0) {
+			unsigned n = len < K ? static_cast<unsigned>(len) : K;
+
+			// 在机器字内累加 `n` 位数字, 不会溢出
+			radix_word chunk = 0;
+			for (unsigned i = 0; i < n; i++) {
+				uint8_t d = __DIGIT_TABLE.values[static_cast<uint8_t>(s[i])];
+				if (d >= R) {
+					return ERR_INVALID_CHAR;
+				}
+				chunk = chunk * R + d;
+			}
+
+			// 将整块合并到结果中, 即 `u = u * R^n + chunk`
+			if (__builtin_mul_overflow(u, __radix_pow<R>(n), &u) || __builtin_add_overflow(u, chunk, &u)) {
+				return ERR_NUM_OUT_OF_RANGE;
+			}
+
+			s += n;
+			len -= n;
+		}
+
+		// 检查结果是否在 `T` 类型范围内
+		radix_word limit = static_cast<radix_word>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+		if (u > limit) {
+			return ERR_NUM_OUT_OF_RANGE;
+		}
+
+		*out = negative ? static_cast<T>(radix_word(0) - u) : static_cast<T>(u);
+		return 0;
+	}
+
+} // namespace convert
+
+#endif // __CONVERT__RADIX_H
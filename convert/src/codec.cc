@@ -0,0 +1,434 @@
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define _CODEC_X86 1
+#endif
+
+#include "codec.h"
+
+namespace convert {
+
+    /// @brief Base64 字母表
+    const char BASE64_TAB[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    /// @brief Base32 字母表
+    const char BASE32_TAB[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+    /// @brief 非法字符在反查表中的值
+    const uint8_t INVALID = 0xFF;
+
+    /// @brief 字符到编码值的反查表
+    ///
+    /// @tparam N 字母表长度
+    template <size_t N>
+    struct __decode_table {
+        uint8_t values[256];
+
+        /// @brief 通过字母表生成反查表
+        ///
+        /// @param tab 字母表
+        /// @param ignore_case 是否同时支持小写字母
+        constexpr __decode_table(const char(&tab)[N], bool ignore_case) : values() {
+            for (size_t c = 0; c < 256; c++) {
+                values[c] = INVALID;
+            }
+            for (size_t i = 0; i < N - 1; i++) {
+                uint8_t c = static_cast<uint8_t>(tab[i]);
+                values[c] = static_cast<uint8_t>(i);
+                if (ignore_case && c >= 'A' && c <= 'Z') {
+                    values[c - 'A' + 'a'] = static_cast<uint8_t>(i);
+                }
+            }
+        }
+    };
+
+    constexpr __decode_table<sizeof(BASE64_TAB)> BASE64_DECODE_TAB(BASE64_TAB, false);
+    constexpr __decode_table<sizeof(BASE32_TAB)> BASE32_DECODE_TAB(BASE32_TAB, true);
+
+    bool codec_has_avx2() {
+#ifdef _CODEC_X86
+        static const bool has = __builtin_cpu_supports("avx2");
+        return has;
+#else
+        return false;
+#endif
+    }
+
+    /// @brief 判断是否使用 AVX2 实现
+    ///
+    /// @param impl 要求的实现方式
+    /// @return `true` 表示使用 AVX2 实现
+    inline static bool __use_avx2(codec_impl impl) {
+        return impl != codec_impl::scalar && codec_has_avx2();
+    }
+
+    /// @brief 去除编码字符串结尾的 `=` 填充字符
+    ///
+    /// @param src 编码字符串指针
+    /// @param len 编码字符串长度
+    /// @param block 编码块长度, Base64 为 `4`, Base32 为 `8`
+    /// @param max_pad 最多允许的填充字符个数
+    /// @param out_len 保存去除填充后字符串长度的指针
+    /// @return `0` 表示成功, 非 `0` 表示填充格式错误
+    inline static int __strip_padding(const char* src, size_t len, size_t block, size_t max_pad, size_t* out_len) {
+        size_t n = len;
+        while (n > 0 && len - n < max_pad && src[n - 1] == '=') {
+            n--;
+        }
+
+        // 存在填充时, 字符串总长度必须是编码块长度的整数倍
+        if (n != len && len % block != 0) {
+            return ERR_INVALID_CHAR;
+        }
+
+        *out_len = n;
+        return 0;
+    }
+
+    /// @brief Base64 编码的标量实现, 每次将 3 字节转为 4 个字符
+    ///
+    /// @param src 原始数据指针
+    /// @param len 原始数据长度
+    /// @param out 保存结果字符串的指针
+    /// @return 写入的字符个数
+    static size_t __base64_encode_scalar(const uint8_t* src, size_t len, char* out) {
+        char* p = out;
+
+        for (; len >= 3; len -= 3, src += 3) {
+            uint32_t v = (uint32_t)src[0] << 16 | (uint32_t)src[1] << 8 | src[2];
+            *p++ = BASE64_TAB[(v >> 18) & 0x3F];
+            *p++ = BASE64_TAB[(v >> 12) & 0x3F];
+            *p++ = BASE64_TAB[(v >> 6) & 0x3F];
+            *p++ = BASE64_TAB[v & 0x3F];
+        }
+
+        if (len > 0) {
+            uint32_t v = (uint32_t)src[0] << 16 | (len > 1 ? (uint32_t)src[1] << 8 : 0);
+            *p++ = BASE64_TAB[(v >> 18) & 0x3F];
+            *p++ = BASE64_TAB[(v >> 12) & 0x3F];
+            *p++ = len > 1 ? BASE64_TAB[(v >> 6) & 0x3F] : '=';
+            *p++ = '=';
+        }
+
+        return static_cast<size_t>(p - out);
+    }
+
+    /// @brief Base64 解码的标量实现, 每次将 4 个字符转为 3 字节
+    ///
+    /// @param src 不包含填充的 Base64 字符串指针
+    /// @param len 不包含填充的 Base64 字符串长度
+    /// @param out 保存结果数据的指针
+    /// @param out_len 保存写入字节数的指针
+    /// @return `0` 表示成功, 非 `0` 表示存在非法字符
+    static int __base64_decode_scalar(const char* src, size_t len, uint8_t* out, size_t* out_len) {
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        const uint8_t* tab = BASE64_DECODE_TAB.values;
+        uint8_t* p = out;
+
+        for (; len >= 4; len -= 4, s += 4) {
+            uint32_t a = tab[s[0]], b = tab[s[1]], c = tab[s[2]], d = tab[s[3]];
+            // 合法值均小于 `64`, 故任一值的高 2 位不为 `0` 即表示存在非法字符
+            if ((a | b | c | d) & 0xC0) {
+                return ERR_INVALID_CHAR;
+            }
+
+            uint32_t v = a << 18 | b << 12 | c << 6 | d;
+            *p++ = (uint8_t)(v >> 16);
+            *p++ = (uint8_t)(v >> 8);
+            *p++ = (uint8_t)v;
+        }
+
+        // 处理尾部不足 4 个字符的部分, 2 个字符产生 1 字节, 3 个字符产生 2 字节
+        if (len == 1) {
+            return ERR_INVALID_CHAR;
+        }
+        if (len > 1) {
+            uint32_t a = tab[s[0]], b = tab[s[1]], c = len > 2 ? tab[s[2]] : 0;
+            if ((a | b | c) & 0xC0) {
+                return ERR_INVALID_CHAR;
+            }
+
+            uint32_t v = a << 18 | b << 12 | c << 6;
+            *p++ = (uint8_t)(v >> 16);
+            if (len > 2) {
+                *p++ = (uint8_t)(v >> 8);
+            }
+        }
+
+        *out_len = static_cast<size_t>(p - out);
+        return 0;
+    }
+
+#ifdef _CODEC_X86
+
+    /// @brief 将每个 128 位通道中的 12 字节数据重排为 16 个 6 位索引 (每个索引占 1 字节)
+    ///
+    /// 先通过 `shuffle` 指令将每 3 字节 `[a, b, c]` 排列为 `[b, a, c, b]`, 再通过 16 位乘法代替移位,
+    /// 将 4 个 6 位字段分别移动到 4 个字节的低位
+    ///
+    /// @param in 输入数据, 每个通道的低 12 字节有效
+    /// @return 6 位索引
+    __attribute__((target("avx2")))
+    inline static __m256i __base64_enc_reshuffle(__m256i in) {
+        in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+        ));
+
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        return _mm256_or_si256(t1, t3);
+    }
+
+    /// @brief 将 6 位索引转为 Base64 字符
+    ///
+    /// 字母表可分为 `A-Z`, `a-z`, `0-9`, `+`, `/` 五段, 每段内字符和索引的差值相同,
+    /// 故可先计算索引所在分段, 再通过查表得到差值并相加
+    ///
+    /// @param in 6 位索引
+    /// @return Base64 字符
+    __attribute__((target("avx2")))
+    inline static __m256i __base64_enc_translate(__m256i in) {
+        const __m256i lut = _mm256_setr_epi8(
+            65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+            65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0
+        );
+
+        __m256i indices = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+        __m256i mask = _mm256_cmpgt_epi8(in, _mm256_set1_epi8(25));
+        indices = _mm256_sub_epi8(indices, mask);
+        return _mm256_add_epi8(in, _mm256_shuffle_epi8(lut, indices));
+    }
+
+    /// @brief Base64 编码的 AVX2 实现
+    ///
+    /// 每次从两个 128 位通道分别加载 12 字节 (共 24 字节), 产生 32 个字符; 由于每个通道加载 16 字节,
+    /// 故剩余数据不少于 28 字节时才进入向量循环
+    ///
+    /// @param src 原始数据指针
+    /// @param len 原始数据长度
+    /// @param out 保存结果字符串的指针
+    /// @return 写入的字符个数
+    __attribute__((target("avx2")))
+    static size_t __base64_encode_avx2(const uint8_t* src, size_t len, char* out) {
+        char* p = out;
+
+        for (; len >= 28; len -= 24, src += 24, p += 32) {
+            __m256i in = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12)),
+                1
+            );
+            __m256i res = __base64_enc_translate(__base64_enc_reshuffle(in));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), res);
+        }
+
+        return static_cast<size_t>(p - out) + __base64_encode_scalar(src, len, p);
+    }
+
+    /// @brief Base64 解码的 AVX2 实现
+    ///
+    /// 每次通过两次查表校验并转换 32 个字符, 再通过 `maddubs` 和 `madd` 指令将 4 个 6 位数值合并为 24 位,
+    /// 最终排列为 24 字节数据; 一旦发现非法字符即退出向量循环, 由标量实现处理剩余部分并报告错误
+    ///
+    /// @param src 不包含填充的 Base64 字符串指针
+    /// @param len 不包含填充的 Base64 字符串长度
+    /// @param out 保存结果数据的指针
+    /// @param out_len 保存写入字节数的指针
+    /// @return `0` 表示成功, 非 `0` 表示存在非法字符
+    __attribute__((target("avx2")))
+    static int __base64_decode_avx2(const char* src, size_t len, uint8_t* out, size_t* out_len) {
+        const __m256i lut_lo = _mm256_setr_epi8(
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+        );
+        const __m256i lut_hi = _mm256_setr_epi8(
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+        );
+        const __m256i lut_roll = _mm256_setr_epi8(
+            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+        );
+        const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+
+        uint8_t* p = out;
+
+        for (; len >= 32; len -= 32, src += 32, p += 24) {
+            __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+
+            // 通过高低 4 位分别查表, 两者按位与不为 `0` 表示存在非法字符
+            __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+            __m256i lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(str, mask_2f));
+            __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+            if (!_mm256_testz_si256(lo, hi)) {
+                break;
+            }
+
+            // 根据高 4 位 (以及是否为 `/` 字符) 查表得到字符和数值的差值
+            __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+            __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+            str = _mm256_add_epi8(str, roll);
+
+            // 将每 4 个 6 位数值合并为 3 字节
+            __m256i merged = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+            merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+            merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+            ));
+            merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+            // 只写入有效的 24 字节, 避免越过缓冲区边界
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(merged));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(p + 16), _mm256_extracti128_si256(merged, 1));
+        }
+
+        size_t tail_len = 0;
+        int rc = __base64_decode_scalar(src, len, p, &tail_len);
+        *out_len = static_cast<size_t>(p - out) + tail_len;
+        return rc;
+    }
+
+#endif // _CODEC_X86
+
+    int base64_encode(const void* src, size_t len, char* buf, size_t buflen, size_t* out_len, codec_impl impl) {
+        size_t n = base64_encoded_len(len);
+        if (n + 1 > buflen) {
+            return ERR_BUF_NOT_ENOUGH;
+        }
+
+        const uint8_t* s = static_cast<const uint8_t*>(src);
+#ifdef _CODEC_X86
+        n = __use_avx2(impl) ? __base64_encode_avx2(s, len, buf) : __base64_encode_scalar(s, len, buf);
+#else
+        (void)impl;
+        n = __base64_encode_scalar(s, len, buf);
+#endif
+        buf[n] = '\0';
+
+        if (out_len) {
+            *out_len = n;
+        }
+        return 0;
+    }
+
+    int base64_decode(const char* src, size_t len, void* buf, size_t buflen, size_t* out_len, codec_impl impl) {
+        int rc = __strip_padding(src, len, 4, 2, &len);
+        if (rc != 0) {
+            return rc;
+        }
+
+        // 计算解码后的准确长度
+        size_t n = len / 4 * 3 + (len % 4 > 1 ? len % 4 - 1 : 0);
+        if (n > buflen) {
+            return ERR_BUF_NOT_ENOUGH;
+        }
+
+        uint8_t* p = static_cast<uint8_t*>(buf);
+#ifdef _CODEC_X86
+        rc = __use_avx2(impl) ? __base64_decode_avx2(src, len, p, &n) : __base64_decode_scalar(src, len, p, &n);
+#else
+        (void)impl;
+        rc = __base64_decode_scalar(src, len, p, &n);
+#endif
+
+        if (rc == 0 && out_len) {
+            *out_len = n;
+        }
+        return rc;
+    }
+
+    int base32_encode(const void* src, size_t len, char* buf, size_t buflen, size_t* out_len) {
+        size_t n = base32_encoded_len(len);
+        if (n + 1 > buflen) {
+            return ERR_BUF_NOT_ENOUGH;
+        }
+
+        const uint8_t* s = static_cast<const uint8_t*>(src);
+        char* p = buf;
+
+        // 每次将 5 字节 (40 位) 转为 8 个字符
+        for (; len >= 5; len -= 5, s += 5) {
+            uint64_t v = (uint64_t)s[0] << 32 | (uint64_t)s[1] << 24 | (uint64_t)s[2] << 16 | (uint64_t)s[3] << 8 | s[4];
+            for (int i = 35; i >= 0; i -= 5) {
+                *p++ = BASE32_TAB[(v >> i) & 0x1F];
+            }
+        }
+
+        // 处理尾部不足 5 字节的部分, 按 `n` 字节对应 `ceil(n * 8 / 5)` 个字符输出, 其余以 `=` 填充
+        if (len > 0) {
+            uint64_t v = 0;
+            for (size_t i = 0; i < len; i++) {
+                v |= (uint64_t)s[i] << (32 - i * 8);
+            }
+
+            size_t chars = (len * 8 + 4) / 5;
+            for (size_t i = 0; i < 8; i++) {
+                *p++ = i < chars ? BASE32_TAB[(v >> (35 - i * 5)) & 0x1F] : '=';
+            }
+        }
+
+        *p = '\0';
+        if (out_len) {
+            *out_len = n;
+        }
+        return 0;
+    }
+
+    int base32_decode(const char* src, size_t len, void* buf, size_t buflen, size_t* out_len) {
+        int rc = __strip_padding(src, len, 8, 6, &len);
+        if (rc != 0) {
+            return rc;
+        }
+
+        // 尾部字符个数只可能为 `0`, `2`, `4`, `5`, `7`, 分别对应 `0` 到 `4` 字节
+        static const int TAIL_BYTES[8] = { 0, -1, 1, -1, 2, 3, -1, 4 };
+
+        int tail = TAIL_BYTES[len % 8];
+        if (tail < 0) {
+            return ERR_INVALID_CHAR;
+        }
+
+        size_t n = len / 8 * 5 + (size_t)tail;
+        if (n > buflen) {
+            return ERR_BUF_NOT_ENOUGH;
+        }
+
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        const uint8_t* tab = BASE32_DECODE_TAB.values;
+        uint8_t* p = static_cast<uint8_t*>(buf);
+
+        while (len > 0) {
+            size_t chars = len < 8 ? len : 8;
+
+            // 将最多 8 个字符 (40 位) 合并为一个整数, 不足部分以 `0` 补齐
+            uint64_t v = 0;
+            for (size_t i = 0; i < 8; i++) {
+                uint8_t d = i < chars ? tab[s[i]] : 0;
+                if (d == INVALID) {
+                    return ERR_INVALID_CHAR;
+                }
+                v = v << 5 | d;
+            }
+
+            size_t bytes = chars == 8 ? 5 : (size_t)TAIL_BYTES[chars];
+            for (size_t i = 0; i < bytes; i++) {
+                *p++ = (uint8_t)(v >> (32 - i * 8));
+            }
+
+            s += chars;
+            len -= chars;
+        }
+
+        if (out_len) {
+            *out_len = n;
+        }
+        return 0;
+    }
+
+} // namespace convert
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstring>
+
+#include "lines.h"
+#include "numsys.h"
+
+namespace convert {
+
+    /// @brief 将一个整数按目标格式写入输出缓冲区
+    ///
+    /// @param num 整数值
+    /// @param out 输出缓冲区指针
+    /// @param fmt 目标格式
+    /// @return 写入的字节数, 数值无法以目标格式表示时返回 `0`
+    inline static size_t __format_line(int64_t num, char* out, line_format fmt) {
+        switch (fmt) {
+        case line_format::hex:
+            return format_radix<16>(num, out);
+        case line_format::bin:
+            return format_radix<2>(num, out);
+        case line_format::base36:
+            return num < 0 ? 0 : format_radix<36>(num, out);
+        case line_format::excel:
+            // `to_excel_column` 只支持 `int` 范围内的非负数, 其结果最多 7 个字符
+            if (num < 0 || num > INT32_MAX || to_excel_column((int)num, out, 8) != 0) {
+                return 0;
+            }
+            return strlen(out);
+        }
+        return 0;
+    }
+
+    size_t convert_lines(const char* in, size_t len, char* out, line_format fmt, size_t* invalid) {
+        const char* end = in + len;
+        char* p = out;
+        size_t bad = 0;
+
+        while (in < end) {
+            // 查找当前行的结尾, 最后一行可以没有换行符
+            const char* nl = static_cast<const char*>(memchr(in, '\n', static_cast<size_t>(end - in)));
+            const char* line_end = nl ? nl : end;
+
+            size_t line_len = static_cast<size_t>(line_end - in);
+            if (line_len > 0 && in[line_len - 1] == '\r') {
+                line_len--;
+            }
+
+            int64_t num = 0;
+            size_t n = 0;
+            if (from_radix<10>(in, line_len, &num) == 0) {
+                n = __format_line(num, p, fmt);
+            }
+            if (n == 0) {
+                bad++;
+            }
+
+            p += n;
+            *p++ = '\n';
+
+            in = nl ? nl + 1 : end;
+        }
+
+        if (invalid) {
+            *invalid += bad;
+        }
+        return static_cast<size_t>(p - out);
+    }
+
+    size_t split_lines(const char* data, size_t len, size_t parts, size_t* offsets) {
+        if (parts == 0) {
+            parts = 1;
+        }
+
+        size_t count = 0;
+        size_t pos = 0;
+        offsets[0] = 0;
+
+        while (count < parts && pos < len) {
+            // 以理想的切分位置为起点, 向后查找最近的换行符作为分块边界
+            size_t target = len / parts * (count + 1);
+            size_t cut = len;
+
+            if (count + 1 < parts && target < len) {
+                if (target < pos) {
+                    target = pos;
+                }
+                const char* nl = static_cast<const char*>(memchr(data + target, '\n', len - target));
+                cut = nl ? static_cast<size_t>(nl - data) + 1 : len;
+            }
+
+            offsets[++count] = cut;
+            pos = cut;
+        }
+
+        return count;
+    }
+
+} // namespace convert
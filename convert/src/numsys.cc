@@ -1,4 +1,7 @@
+#include <array>
 #include <cstddef>
+#include <cstring>
+#include <utility>
 #include <math.h>
 
 #include "numsys.h"
@@ -34,107 +37,84 @@ namespace convert {
     }
 
     int to_bin(int num, char* buf, size_t buflen) {
-        if (--buflen < 1) {
-            return ERR_BUF_NOT_ENOUGH;
-        }
+        return to_radix<2>(num, buf, buflen);
+    }
 
-        bool ne = num >= 0;
-        num = abs(num);
+    int to_hex(int num, char* buf, size_t buflen) {
+        return to_radix<16>(num, buf, buflen);
+    }
 
+    int to_excel_column(int num, char* buf, size_t buflen) {
+        if (num < 0) {
+            return ERR_NUM_CANNOT_NEGATIVE;
+        }
+
+        num += 1;
         size_t pos = 0;
+
         while (num > 0 && pos < buflen) {
-            int lo = num % 2;
-            buf[pos++] = lo + '0';
-            num /= 2;
+            int lo = (num - 1) % 26;
+            buf[pos++] = lo + 65;
+            num = (num - lo) / 26;
         }
 
         if (pos == buflen) {
             return ERR_BUF_NOT_ENOUGH;
         }
 
-        if (pos == 0) {
-            buf[pos++] = '0';
-        }
-
-        if (!ne) {
-            if (pos + 1 == buflen) {
-                return ERR_BUF_NOT_ENOUGH;
-            }
-            buf[pos++] = '-';
-        }
-
         __revert_str(buf, pos);
         buf[pos] = '\0';
 
         return 0;
     }
 
-    const char HEX_TAB[] = {
-        '0', '1', '2', '3', '4',
-        '5', '6', '7', '8', '9',
-        'A', 'B', 'C', 'D', 'E',
-        'F',
-    };
+    /// @brief 运行时进制转换函数类型
+    using to_radix_func = int (*)(long long, char*, size_t);
 
-    int to_hex(int num, char* buf, size_t buflen) {
-        if (--buflen < 1) {
-            return ERR_BUF_NOT_ENOUGH;
-        }
+    /// @brief 运行时进制解析函数类型
+    using from_radix_func = int (*)(const char*, size_t, long long*);
 
-        bool ne = num >= 0;
-        num = abs(num);
+    /// @brief 生成 `[2, 36]` 各进制对应的 `to_radix` 和 `from_radix` 实例函数表
+    ///
+    /// @tparam I 进制相对 `2` 的偏移量序列
+    /// @return 函数表, 下标 `i` 对应 `i + 2` 进制
+    template <size_t... I>
+    constexpr auto __make_radix_table(std::index_sequence<I...>) {
+        return std::make_pair(
+            std::array<to_radix_func, sizeof...(I)>{ &to_radix<I + 2, long long>... },
+            std::array<from_radix_func, sizeof...(I)>{ &from_radix<I + 2, long long>... }
+        );
+    }
 
-        size_t pos = 0;
+    /// @brief `[2, 36]` 各进制的函数表
+    constexpr auto RADIX_TABLE = __make_radix_table(std::make_index_sequence<35>{});
 
-        while (num > 0 && pos < buflen) {
-            int lo = num % 16;
-            buf[pos++] = HEX_TAB[lo];
-            num /= 16;
-        }
-
-        if (pos == buflen) {
-            return ERR_BUF_NOT_ENOUGH;
-        }
-
-        if (pos == 0) {
-            buf[pos++] = '0';
+    int to_base(long long num, unsigned radix, char* buf, size_t buflen) {
+        if (radix < 2 || radix > 36) {
+            return ERR_RADIX_OUT_OF_RANGE;
         }
+        return RADIX_TABLE.first[radix - 2](num, buf, buflen);
+    }
 
-        if (!ne) {
-            if (pos + 1 == buflen) {
-                return ERR_BUF_NOT_ENOUGH;
-            }
-            buf[pos++] = '-';
+    int from_base(const char* s, unsigned radix, long long* out) {
+        if (radix < 2 || radix > 36) {
+            return ERR_RADIX_OUT_OF_RANGE;
         }
-
-        __revert_str(buf, pos);
-        buf[pos] = '\0';
-
-        return 0;
+        return RADIX_TABLE.second[radix - 2](s, strlen(s), out);
     }
 
-    int to_excel_column(int num, char* buf, size_t buflen) {
+    int to_base36(long long num, char* buf, size_t buflen) {
         if (num < 0) {
             return ERR_NUM_CANNOT_NEGATIVE;
         }
+        return to_radix<36>(num, buf, buflen);
+    }
 
-        num += 1;
-        size_t pos = 0;
-
-        while (num > 0 && pos < buflen) {
-            int lo = (num - 1) % 26;
-            buf[pos++] = lo + 65;
-            num = (num - lo) / 26;
-        }
-
-        if (pos == buflen) {
-            return ERR_BUF_NOT_ENOUGH;
+    int from_base36(const char* s, long long* out) {
+        if (*s == '-') {
+            return ERR_NUM_CANNOT_NEGATIVE;
         }
-
-        __revert_str(buf, pos);
-        buf[pos] = '\0';
-
-        return 0;
+        return from_radix<36>(s, strlen(s), out);
     }
 
 } // namespace convert
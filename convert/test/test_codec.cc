@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test.h"
+#include "codec.h"
+
+#define TEST_SUITE_NAME test_convert__codec
+
+using namespace convert;
+
+/// @brief 测试 Base64 编码, 使用 RFC 4648 中的测试向量
+TEST(TEST_SUITE_NAME, base64_encode) {
+    const char* cases[][2] = {
+        { "", "" },
+        { "f", "Zg==" },
+        { "fo", "Zm8=" },
+        { "foo", "Zm9v" },
+        { "foob", "Zm9vYg==" },
+        { "fooba", "Zm9vYmE=" },
+        { "foobar", "Zm9vYmFy" },
+    };
+
+    char buf[32];
+    size_t len = 0;
+
+    for (auto& c : cases) {
+        int r = base64_encode(c[0], strlen(c[0]), buf, sizeof(buf), &len);
+        ASSERT_EQ(r, 0);
+        ASSERT_STREQ(buf, c[1]);
+        ASSERT_EQ(len, strlen(c[1]));
+    }
+
+    // 缓冲区需要额外容纳 `\0` 结束符
+    int r = base64_encode("foo", 3, buf, 4, &len);
+    ASSERT_EQ(r, ERR_BUF_NOT_ENOUGH);
+}
+
+/// @brief 测试 Base64 解码, 包括有填充, 无填充以及非法输入的情况
+TEST(TEST_SUITE_NAME, base64_decode) {
+    char buf[32];
+    size_t len = 0;
+
+    int r = base64_decode("Zm9vYg==", 8, buf, sizeof(buf), &len);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(std::string(buf, len), "foob");
+
+    r = base64_decode("Zm9vYmE", 7, buf, sizeof(buf), &len);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(std::string(buf, len), "fooba");
+
+    r = base64_decode("Zm9v", 4, buf, 2, &len);
+    ASSERT_EQ(r, ERR_BUF_NOT_ENOUGH);
+
+    r = base64_decode("Zm9=v", 5, buf, sizeof(buf), &len);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+
+    r = base64_decode("Zm9vY", 5, buf, sizeof(buf), &len);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+
+    r = base64_decode("Zm8==", 5, buf, sizeof(buf), &len);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+}
+
+/// @brief 测试 Base64 的标量实现和 AVX2 实现结果一致
+///
+/// 数据长度覆盖向量循环的边界, 并在向量处理范围内的各个位置注入非法字符
+TEST(TEST_SUITE_NAME, base64_scalar_and_avx2) {
+    std::mt19937 rng(42);
+
+    for (size_t n = 0; n < 300; n++) {
+        std::vector<uint8_t> data(n);
+        for (auto& b : data) {
+            b = (uint8_t)rng();
+        }
+
+        std::string scalar(base64_encoded_len(n) + 1, '\0'), avx2(base64_encoded_len(n) + 1, '\0');
+        size_t scalar_len = 0, avx2_len = 0;
+
+        ASSERT_EQ(base64_encode(data.data(), n, scalar.data(), scalar.size(), &scalar_len, codec_impl::scalar), 0);
+        ASSERT_EQ(base64_encode(data.data(), n, avx2.data(), avx2.size(), &avx2_len, codec_impl::avx2), 0);
+        ASSERT_EQ(scalar, avx2);
+        ASSERT_EQ(scalar_len, avx2_len);
+
+        for (codec_impl impl : { codec_impl::scalar, codec_impl::avx2 }) {
+            std::vector<uint8_t> decoded(base64_decoded_len(scalar_len));
+            size_t len = 0;
+
+            ASSERT_EQ(base64_decode(scalar.data(), scalar_len, decoded.data(), decoded.size(), &len, impl), 0);
+            ASSERT_EQ(len, n);
+            ASSERT_TRUE(std::equal(data.begin(), data.end(), decoded.begin()));
+
+            if (scalar_len > 0) {
+                std::string bad = scalar.substr(0, scalar_len);
+                bad[rng() % (scalar_len - 2)] = "!-_.~\x80"[rng() % 6];
+                ASSERT_EQ(base64_decode(bad.data(), bad.size(), decoded.data(), decoded.size(), &len, impl), ERR_INVALID_CHAR);
+            }
+        }
+    }
+}
+
+/// @brief 测试 Base32 编码和解码, 使用 RFC 4648 中的测试向量
+TEST(TEST_SUITE_NAME, base32) {
+    const char* cases[][2] = {
+        { "", "" },
+        { "f", "MY======" },
+        { "fo", "MZXQ====" },
+        { "foo", "MZXW6===" },
+        { "foob", "MZXW6YQ=" },
+        { "fooba", "MZXW6YTB" },
+        { "foobar", "MZXW6YTBOI======" },
+    };
+
+    char buf[32];
+    size_t len = 0;
+
+    for (auto& c : cases) {
+        int r = base32_encode(c[0], strlen(c[0]), buf, sizeof(buf), &len);
+        ASSERT_EQ(r, 0);
+        ASSERT_STREQ(buf, c[1]);
+        ASSERT_EQ(len, strlen(c[1]));
+
+        char out[32];
+        r = base32_decode(c[1], strlen(c[1]), out, sizeof(out), &len);
+        ASSERT_EQ(r, 0);
+        ASSERT_EQ(std::string(out, len), c[0]);
+    }
+
+    // 解码时不区分大小写, 且填充是可选的
+    int r = base32_decode("mzxw6ytboi", 10, buf, sizeof(buf), &len);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(std::string(buf, len), "foobar");
+
+    r = base32_decode("MZXW6YTB1", 9, buf, sizeof(buf), &len);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+
+    r = base32_decode("MZX", 3, buf, sizeof(buf), &len);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "test.h"
+#include "lines.h"
+
+#define TEST_SUITE_NAME test_convert__lines
+
+using namespace convert;
+
+/// @brief 按行转换文本, 返回转换结果
+///
+/// @param in 输入文本
+/// @param fmt 目标格式
+/// @param invalid 用于累加无法解析行数的指针
+/// @return 转换结果
+static std::string __convert(const std::string& in, line_format fmt, size_t* invalid) {
+    std::vector<char> out(convert_lines_bound(in.size()));
+    size_t n = convert_lines(in.data(), in.size(), out.data(), fmt, invalid);
+    return std::string(out.data(), n);
+}
+
+/// @brief 测试将每行一个十进制整数的文本转换为各种格式
+TEST(TEST_SUITE_NAME, convert_lines) {
+    size_t invalid = 0;
+
+    ASSERT_EQ(__convert("0\n255\n-255\n", line_format::hex, &invalid), "0\nFF\n-FF\n");
+    ASSERT_EQ(__convert("5\r\n-3", line_format::bin, &invalid), "101\n-11\n");
+    ASSERT_EQ(__convert("35\n1295\n", line_format::base36, &invalid), "Z\nZZ\n");
+    ASSERT_EQ(__convert("0\n26\n701\n", line_format::excel, &invalid), "A\nAA\nZZ\n");
+    ASSERT_EQ(invalid, 0);
+
+    // 无法解析的行输出为空行, 并计入 `invalid`
+    ASSERT_EQ(__convert("1\n\nabc\n-1\n99999999999999999999\n2\n", line_format::excel, &invalid), "B\n\n\n\n\nC\n");
+    ASSERT_EQ(invalid, 4);
+
+    // 最坏情况下的输出长度不超过 `convert_lines_bound` 计算的上限
+    std::string worst;
+    for (int i = 0; i < 1000; i++) {
+        worst += "9\n";
+    }
+    ASSERT_LE(__convert(worst, line_format::bin, nullptr).size(), convert_lines_bound(worst.size()));
+}
+
+/// @brief 测试按换行符切分数据
+TEST(TEST_SUITE_NAME, split_lines) {
+    std::string data = "1\n22\n333\n4444\n55555\n";
+    size_t offsets[5];
+
+    size_t parts = split_lines(data.data(), data.size(), 4, offsets);
+    ASSERT_GT(parts, 1);
+    ASSERT_LE(parts, 4);
+    ASSERT_EQ(offsets[0], 0);
+    ASSERT_EQ(offsets[parts], data.size());
+
+    // 除第一块外, 每块均从一行的开头开始
+    for (size_t i = 1; i < parts; i++) {
+        ASSERT_GT(offsets[i], offsets[i - 1]);
+        ASSERT_EQ(data[offsets[i] - 1], '\n');
+    }
+
+    // 数据只有一行时, 只能切分为一块
+    parts = split_lines("12345", 5, 4, offsets);
+    ASSERT_EQ(parts, 1);
+    ASSERT_EQ(offsets[1], 5);
+
+    parts = split_lines("", 0, 4, offsets);
+    ASSERT_EQ(parts, 0);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cstring>
+
 #include "test.h"
 #include "numsys.h"
 
@@ -105,3 +107,145 @@ TEST(TEST_SUITE_NAME, to_excel_column) {
     ASSERT_EQ(r, 0);
     ASSERT_STREQ(buf, "ZZ");
 }
+
+/// @brief 测试通过模板指定进制, 将整数转为字符串
+TEST(TEST_SUITE_NAME, to_radix) {
+    char buf[80] = "";
+
+    int r = to_radix<8>(511, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "777");
+
+    r = to_radix<10>(-1234567890, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "-1234567890");
+
+    // 测试超过一个块长度的数值, 确认块内的前导 `0` 被保留
+    r = to_radix<10>(UINT64_MAX, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "18446744073709551615");
+
+    r = to_radix<10>(10000000000000000000ULL, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "10000000000000000000");
+
+    r = to_radix<2>(INT64_MIN, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "-1000000000000000000000000000000000000000000000000000000000000000");
+
+    r = to_radix<16>(INT32_MIN, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "-80000000");
+
+    // 缓冲区长度恰好容纳结果和 `\0` 结束符
+    r = to_radix<16>(255, buf, 3);
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "FF");
+
+    r = to_radix<16>(256, buf, 3);
+    ASSERT_EQ(r, ERR_BUF_NOT_ENOUGH);
+}
+
+/// @brief 测试通过模板指定进制, 将字符串解析为整数
+TEST(TEST_SUITE_NAME, from_radix) {
+    int64_t n = 0;
+
+    int r = from_radix<10>("-9223372036854775808", 20, &n);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(n, INT64_MIN);
+
+    r = from_radix<10>("9223372036854775808", 19, &n);
+    ASSERT_EQ(r, ERR_NUM_OUT_OF_RANGE);
+
+    r = from_radix<16>("+7fffFFFF", 9, &n);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(n, INT32_MAX);
+
+    r = from_radix<2>("1012", 4, &n);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+
+    r = from_radix<10>("-", 1, &n);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+
+    uint64_t u = 0;
+    r = from_radix<10>("18446744073709551615", 20, &u);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(u, UINT64_MAX);
+
+    r = from_radix<10>("18446744073709551616", 20, &u);
+    ASSERT_EQ(r, ERR_NUM_OUT_OF_RANGE);
+
+    r = from_radix<10>("-1", 2, &u);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+
+    // 确认各进制的转换和解析结果一致
+    char buf[80];
+    for (int64_t v : std::initializer_list<int64_t>{ INT64_MIN, -1000000007, -1, 0, 1, 35, 36, 1000000007, INT64_MAX }) {
+        ASSERT_EQ(to_radix<3>(v, buf, sizeof(buf)), 0);
+        ASSERT_EQ(from_radix<3>(buf, strlen(buf), &n), 0);
+        ASSERT_EQ(n, v);
+
+        ASSERT_EQ(to_radix<36>(v, buf, sizeof(buf)), 0);
+        ASSERT_EQ(from_radix<36>(buf, strlen(buf), &n), 0);
+        ASSERT_EQ(n, v);
+    }
+}
+
+/// @brief 测试在运行时指定进制进行转换和解析
+TEST(TEST_SUITE_NAME, to_base) {
+    char buf[80] = "";
+
+    int r = to_base(35, 36, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "Z");
+
+    r = to_base(-100, 7, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "-202");
+
+    r = to_base(100, 37, buf, sizeof(buf));
+    ASSERT_EQ(r, ERR_RADIX_OUT_OF_RANGE);
+
+    r = to_base(100, 1, buf, sizeof(buf));
+    ASSERT_EQ(r, ERR_RADIX_OUT_OF_RANGE);
+
+    long long n = 0;
+    r = from_base("-202", 7, &n);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(n, -100);
+
+    r = from_base("8", 8, &n);
+    ASSERT_EQ(r, ERR_INVALID_CHAR);
+}
+
+/// @brief 测试 36 进制短 ID 的转换和解析
+TEST(TEST_SUITE_NAME, base36) {
+    char buf[32] = "";
+
+    int r = to_base36(0, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "0");
+
+    r = to_base36(1295, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "ZZ");
+
+    r = to_base36(INT64_MAX, buf, sizeof(buf));
+    ASSERT_EQ(r, 0);
+    ASSERT_STREQ(buf, "1Y2P0IJ32E8E7");
+
+    r = to_base36(-1, buf, sizeof(buf));
+    ASSERT_EQ(r, ERR_NUM_CANNOT_NEGATIVE);
+
+    long long n = 0;
+    r = from_base36("zz", &n);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(n, 1295);
+
+    r = from_base36("1Y2P0IJ32E8E7", &n);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(n, INT64_MAX);
+
+    r = from_base36("-1", &n);
+    ASSERT_EQ(r, ERR_NUM_CANNOT_NEGATIVE);
+}
@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench/bench.h"
+#include "iterator/dynamic_array.h"
+
+#define BENCH_SUITE_NAME bench_cplusplus_iterator__dynamic_array
+
+using namespace bench;
+using cxx::iterator::dynamic_array;
+
+/// @brief 每轮添加的元素个数
+static const size_t N = 1 << 20;
+
+/// @brief 可平凡复制的 64 字节元素, 扩容时通过 `memcpy` 转移
+struct pod64 {
+    uint64_t v[8];
+};
+
+/// @brief 逐个添加元素, 可选择预留容量
+///
+/// @tparam _Array 数组类型
+/// @tparam _Make 元素生成函数类型
+/// @param reserve 是否预先预留全部容量
+/// @param make 根据下标生成元素的函数
+template <typename _Array, typename _Make>
+static void __fill(bool reserve, _Make&& make) {
+    _Array arr;
+    if (reserve) {
+        arr.reserve(N);
+    }
+    for (size_t i = 0; i < N; i++) {
+        arr.emplace_back(make(i));
+    }
+    do_not_optimize(arr.data());
+}
+
+/// @brief 以 `dynamic_array` 和 `std::vector` 分别测试逐个添加元素
+///
+/// @param type 元素类型名称
+/// @param make 根据下标生成元素的函数
+template <typename T, typename _Make>
+static void __bench_push_back(const char* type, _Make make) {
+    for (bool reserve : { false, true }) {
+        std::string prefix = std::string("push_back/") + type + (reserve ? "/reserved" : "/growing");
+        report(measure(prefix + "/dynamic_array", N, N * sizeof(T), [&] {
+            __fill<dynamic_array<T>>(reserve, make);
+        }));
+        report(measure(prefix + "/std_vector", N, N * sizeof(T), [&] {
+            __fill<std::vector<T>>(reserve, make);
+        }));
+    }
+}
+
+/// 对比 `dynamic_array` 和 `std::vector` 逐个添加元素的耗时, 包括扩容时转移元素的开销
+///
+/// - `int` / `pod64`: 可平凡复制, 扩容时通过 `memcpy` 转移;
+/// - `string`: 移动构造器为 `noexcept`, 扩容时逐个移动;
+BENCH(BENCH_SUITE_NAME, push_back) {
+    __bench_push_back<int>("int", [](size_t i) { return (int)i; });
+    __bench_push_back<pod64>("pod64", [](size_t i) { return pod64{ { i } }; });
+    __bench_push_back<std::string>("string", [](size_t i) { return std::string(32, (char)('a' + i % 26)); });
+}
+
+/// @brief 调整数组长度后写入全部元素, 模拟将数组作为输出缓冲区的场景
+///
+/// @tparam _Array 数组类型
+/// @tparam _Resize 调整长度的函数类型
+/// @param n 数组长度
+/// @param resize 调整数组长度的函数
+template <typename _Array, typename _Resize>
+static void __resize_and_write(size_t n, _Resize&& resize) {
+    _Array arr;
+    resize(arr, n);
+    for (size_t i = 0; i < n; i++) {
+        arr[i] = (int)i;
+    }
+    do_not_optimize(arr.data());
+}
+
+/// 对比调整数组长度时, 值初始化 (新增元素置 `0`) 和默认初始化 (新增元素不写入) 的耗时
+///
+/// 调整长度后立即写入全部元素; 默认初始化省去了一次对整个数组的写入
+BENCH(BENCH_SUITE_NAME, resize) {
+    const size_t n = 16 << 20;
+
+    report(measure("resize/int/value_init/dynamic_array", n, n * sizeof(int), [&] {
+        __resize_and_write<dynamic_array<int>>(n, [](auto& arr, size_t n) { arr.resize(n); });
+    }));
+    report(measure("resize/int/value_init/std_vector", n, n * sizeof(int), [&] {
+        __resize_and_write<std::vector<int>>(n, [](auto& arr, size_t n) { arr.resize(n); });
+    }));
+    report(measure("resize/int/default_init/dynamic_array", n, n * sizeof(int), [&] {
+        __resize_and_write<dynamic_array<int>>(n, [](auto& arr, size_t n) { arr.resize_for_overwrite(n); });
+    }));
+}
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "bench/bench.h"
+#include "iterator/dynamic_array.h"
+
+#define BENCH_SUITE_NAME bench_cplusplus_iterator__iterator
+
+using namespace bench;
+using cxx::iterator::dynamic_array;
+
+/// @brief 参与测试的元素个数
+static const size_t N = 1 << 20;
+
+/// @brief 生成 `n` 个随机整数
+static dynamic_array<int> __random_ints(size_t n) {
+    std::mt19937 rng(42);
+    dynamic_array<int> arr;
+    arr.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        arr.push_back((int)rng());
+    }
+    return arr;
+}
+
+/// 对比通过 `dynamic_array` 迭代器和原生指针执行 `std::copy` 的耗时
+///
+/// libstdc++ (至少到 GCC 12) 只对原生指针将 `std::copy` 转为 `memmove`, 自定义迭代器逐个元素复制; 迭代器为
+/// `contiguous_iterator` 时, 可通过 `std::to_address` 将其转为原生指针, 得到和原生指针相同的性能
+BENCH(BENCH_SUITE_NAME, copy) {
+    // 分别测试可放入 L1 缓存和超出 L2 缓存的数据量
+    for (size_t n : { (size_t)4 << 10, N }) {
+        dynamic_array<int> src = __random_ints(n);
+        dynamic_array<int> dst(n);
+
+        std::string prefix = "copy/int/" + std::to_string(n);
+        report(measure(prefix + "/dynamic_array", n, n * sizeof(int), [&] {
+            std::copy(src.begin(), src.end(), dst.begin());
+            do_not_optimize(dst.data());
+        }));
+        report(measure(prefix + "/to_address", n, n * sizeof(int), [&] {
+            std::copy(std::to_address(src.begin()), std::to_address(src.end()), std::to_address(dst.begin()));
+            do_not_optimize(dst.data());
+        }));
+        report(measure(prefix + "/raw_pointer", n, n * sizeof(int), [&] {
+            std::copy(src.data(), src.data() + n, dst.data());
+            do_not_optimize(dst.data());
+        }));
+    }
+}
+
+/// 对比通过 `dynamic_array` 迭代器和原生指针执行 `std::sort` 的耗时
+///
+/// 每轮先将随机数据复制到待排序数组 (两种方式相同), 再进行排序
+BENCH(BENCH_SUITE_NAME, sort) {
+    dynamic_array<int> src = __random_ints(N);
+    dynamic_array<int> arr(N);
+
+    report(measure("sort/int/dynamic_array", N, N * sizeof(int), [&] {
+        std::memcpy(arr.data(), src.data(), N * sizeof(int));
+        std::sort(arr.begin(), arr.end());
+        do_not_optimize(arr.data());
+    }));
+    report(measure("sort/int/raw_pointer", N, N * sizeof(int), [&] {
+        std::memcpy(arr.data(), src.data(), N * sizeof(int));
+        std::sort(arr.data(), arr.data() + N);
+        do_not_optimize(arr.data());
+    }));
+}
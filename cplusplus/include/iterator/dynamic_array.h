@@ -3,17 +3,36 @@
 #ifndef __CPLUSPLUS_ITERATOR__DYNAMIC_ARRAY_H
 #define __CPLUSPLUS_ITERATOR__DYNAMIC_ARRAY_H
 
+#include <array>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+
 #include "iterator.h"
 
 namespace cxx::iterator {
 
 	/// @brief 定义动态数组类型, 可以按需调整数组长度
 	///
+	/// 数组维护长度 (`size`) 和容量 (`capacity`) 两个值, 长度超过容量时按几何级数 (2 倍) 扩大容量,
+	/// 故连续 `push_back` / `emplace_back` 的均摊复杂度为 `O(1)`
+	///
+	/// 扩容时需要将已有元素转移 (relocate) 到新内存:
+	///
+	/// - 对于可平凡复制 (trivially copyable) 的元素类型, 直接通过 `memcpy` 复制内存;
+	/// - 对于移动构造器声明为 `noexcept` (或不可复制) 的元素类型, 逐个移动元素;
+	/// - 其它元素类型逐个复制元素, 复制过程中抛出异常时原数组保持不变 (强异常安全保证);
+	///
+	/// 扩容会令所有迭代器, 指针和引用失效
+	///
 	/// @tparam T 数组元素类型
 	template <typename T, typename _Alloc = std::allocator<T>>
 	class dynamic_array {
-		using __self = dynamic_array<T>;
+		using __self = dynamic_array<T, _Alloc>;
+		using __alloc_traits = std::allocator_traits<_Alloc>;
 	public:
+		using value_type = T;
+		using size_type = size_t;
 		using iterator = ptr_based_iterator<T>;
 		using reverse_iterator = ptr_based_reverse_iterator<T>;
 		using const_iterator = ptr_based_iterator<const T>;
@@ -21,13 +40,14 @@ namespace cxx::iterator {
 		using allocator_type = _Alloc;
 
 		/// @brief 默认构造器
-		dynamic_array() : _data(nullptr), _size(0) { }
+		dynamic_array() noexcept : _data(nullptr), _size(0), _capacity(0) { }
 
 		/// @brief 初始化数组
 		///
 		/// @param size 数据长度
 		dynamic_array(size_t size, const T& val = T()) {
 			std::uninitialized_fill_n(__alloc_n(size), size, val);
+			_size = size;
 		}
 
 		/// @brief 参数构造器
@@ -36,6 +56,7 @@ namespace cxx::iterator {
 		/// @param size 数据长度
 		dynamic_array(const T* data, size_t size) {
 			std::uninitialized_copy_n(data, size, __alloc_n(size));
+			_size = size;
 		}
 
 		/// @brief 参数构造器
@@ -43,6 +64,7 @@ namespace cxx::iterator {
 		/// @param init_list 初始化列表对象
 		dynamic_array(std::initializer_list<T> init_list) {
 			std::uninitialized_copy_n(init_list.begin(), init_list.size(), __alloc_n(init_list.size()));
+			_size = init_list.size();
 		}
 
 		/// @brief 参数构造器
@@ -51,6 +73,7 @@ namespace cxx::iterator {
 		template <size_t N>
 		dynamic_array(const std::array<T, N>& arr) {
 			std::uninitialized_copy_n(arr.begin(), N, __alloc_n(N));
+			_size = N;
 		}
 
 		/// @brief 参数构造器
@@ -60,19 +83,23 @@ namespace cxx::iterator {
 		template <size_t N>
 		dynamic_array(const T arr[N]) {
 			std::uninitialized_copy_n(arr, N, __alloc_n(N));
+			_size = N;
 		}
 
 		/// @brief 拷贝构造器
 		///
+		/// 新数组的容量和原数组的长度相同
+		///
 		/// @param o 另一个对象
 		dynamic_array(const __self& o) {
 			std::uninitialized_copy_n(o._data, o._size, __alloc_n(o._size));
+			_size = o._size;
 		}
 
 		/// @brief 移动构造器
 		///
 		/// @param o 其它对象右值引用
-		dynamic_array(__self&& o) noexcept { __move(std::forward(o)); }
+		dynamic_array(__self&& o) noexcept { __move(std::move(o)); }
 
 		/// @brief 析构函数
 		virtual ~dynamic_array() { __free(); }
@@ -85,6 +112,7 @@ namespace cxx::iterator {
 			if (this != &o) {
 				__free();
 				std::uninitialized_copy_n(o._data, o._size, __alloc_n(o._size));
+				_size = o._size;
 			}
 			return *this;
 		}
@@ -96,7 +124,7 @@ namespace cxx::iterator {
 		__self& operator=(__self&& o) noexcept {
 			if (this != &o) {
 				__free();
-				__move(std::forward(o));
+				__move(std::move(o));
 			}
 			return *this;
 		}
@@ -107,6 +135,124 @@ namespace cxx::iterator {
 		T* data() { return _data; }
 		const T* data() const { return _data; }
 
+		/// @brief 获取数组长度
+		///
+		/// @return 数组中的元素个数
+		size_t size() const noexcept { return _size; }
+
+		/// @brief 获取数组容量
+		///
+		/// @return 不重新分配内存时最多可容纳的元素个数
+		size_t capacity() const noexcept { return _capacity; }
+
+		/// @brief 判断数组是否为空
+		///
+		/// @return 数组长度是否为 `0`
+		bool empty() const noexcept { return _size == 0; }
+
+		/// @brief 重载下标运算符, 不检查下标范围
+		///
+		/// @param n 下标值
+		/// @return 对应下标的元素引用
+		T& operator[](size_t n) { return _data[n]; }
+		const T& operator[](size_t n) const { return _data[n]; }
+
+		/// @brief 获取指定下标的元素, 下标超出范围时抛出 `std::out_of_range` 异常
+		///
+		/// @param n 下标值
+		/// @return 对应下标的元素引用
+		T& at(size_t n) { return n < _size ? _data[n] : throw std::out_of_range("dynamic_array::at"); }
+		const T& at(size_t n) const { return n < _size ? _data[n] : throw std::out_of_range("dynamic_array::at"); }
+
+		/// @brief 获取最后一个元素, 数组不能为空
+		///
+		/// @return 最后一个元素的引用
+		T& back() { return _data[_size - 1]; }
+		const T& back() const { return _data[_size - 1]; }
+
+		/// @brief 预留容量, 令之后添加元素时不必重新分配内存
+		///
+		/// `n` 不超过当前容量时不做任何操作
+		///
+		/// @param n 期望的最小容量
+		void reserve(size_t n) {
+			if (n > _capacity) {
+				__reallocate(n);
+			}
+		}
+
+		/// @brief 释放多余的容量, 令容量和长度相同
+		void shrink_to_fit() {
+			if (_capacity > _size) {
+				__reallocate(_size);
+			}
+		}
+
+		/// @brief 在数组末尾原地构造元素
+		///
+		/// 参数可以引用数组中已有的元素, 扩容时先构造新元素再转移已有元素
+		///
+		/// @tparam _Args 参数类型
+		/// @param args 元素构造器参数
+		/// @return 新元素的引用
+		template <typename... _Args>
+		T& emplace_back(_Args&&... args) {
+			if (_size < _capacity) {
+				__alloc_traits::construct(_alloc, _data + _size, std::forward<_Args>(args)...);
+			}
+			else {
+				__grow_and_emplace(std::forward<_Args>(args)...);
+			}
+			return _data[_size++];
+		}
+
+		/// @brief 在数组末尾添加元素的副本
+		///
+		/// @param val 元素值
+		void push_back(const T& val) { emplace_back(val); }
+
+		/// @brief 将元素移动到数组末尾
+		///
+		/// @param val 元素值
+		void push_back(T&& val) { emplace_back(std::move(val)); }
+
+		/// @brief 移除最后一个元素, 数组不能为空
+		void pop_back() { __alloc_traits::destroy(_alloc, _data + --_size); }
+
+		/// @brief 移除全部元素, 容量保持不变
+		void clear() noexcept { __destroy(0); }
+
+		/// @brief 调整数组长度, 新增的元素进行值初始化 (value-initialize, 例如 `int` 元素为 `0`)
+		///
+		/// @param n 新的数组长度
+		void resize(size_t n) {
+			__resize(n, [](T* p, size_t cnt) { std::uninitialized_value_construct_n(p, cnt); });
+		}
+
+		/// @brief 调整数组长度, 新增的元素为 `val` 的副本
+		///
+		/// @param n 新的数组长度
+		/// @param val 新增元素的值
+		void resize(size_t n, const T& val) {
+			// `val` 可能引用数组中的元素, 故先复制一份, 扩容后原元素的地址会失效
+			if (n > _size && &val >= _data && &val < _data + _size) {
+				T copy(val);
+				resize(n, copy);
+				return;
+			}
+			__resize(n, [&val](T* p, size_t cnt) { std::uninitialized_fill_n(p, cnt, val); });
+		}
+
+		/// @brief 调整数组长度, 新增的元素进行默认初始化 (default-initialize)
+		///
+		/// 对于 `int` 等平凡类型, 新增元素不会被写入 (其值不确定), 适用于随后即会整体覆盖新增元素的场景 (例如作为
+		/// `read` 等函数的输出缓冲区), 可以省去一次对内存的写入
+		///
+		/// @param n 新的数组长度
+		void resize_for_overwrite(size_t n) {
+			__resize(n, [](T* p, size_t cnt) { std::uninitialized_default_construct_n(p, cnt); });
+		}
+
 		/// @brief 获取起始迭代器对象
 		///
 		/// @return 迭代器对象
@@ -150,34 +296,143 @@ namespace cxx::iterator {
 	private:
 		T* _data;
 		size_t _size;
+		size_t _capacity;
 
 		allocator_type _alloc;
 
-		/// @brief 分配地址
+		/// @brief 分配可容纳 `size` 个元素的内存作为数组内存, 数组长度置为 `0`
 		///
-		/// @param size 要分配的地址大小
-		/// @return
+		/// @param size 要分配的元素个数
+		/// @return 数据指针
 		T* __alloc_n(size_t size) {
 			_data = size ? _alloc.allocate(size) : nullptr;
-			_size = size;
+			_size = 0;
+			_capacity = size;
 			return _data;
 		}
 
+		/// @brief 计算容纳 `n` 个元素所需的新容量, 至少为当前容量的 2 倍
+		///
+		/// @param n 需要容纳的元素个数
+		/// @return 新容量
+		size_t __grow_capacity(size_t n) const noexcept {
+			size_t cap = _capacity ? _capacity * 2 : 1;
+			return cap < n ? n : cap;
+		}
+
+		/// @brief 将 `n` 个元素从 `src` 转移到未初始化的内存 `dst`, 并销毁 `src` 中的元素
+		///
+		/// 复制过程中抛出异常时, `dst` 中已构造的元素会被销毁, `src` 保持不变
+		///
+		/// @param dst 目标内存
+		/// @param src 源元素
+		/// @param n 元素个数
+		static void __relocate(T* dst, T* src, size_t n) {
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				if (n) {
+					std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+				}
+			}
+			else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+				std::uninitialized_move_n(src, n, dst);
+				std::destroy_n(src, n);
+			}
+			else {
+				std::uninitialized_copy_n(src, n, dst);
+				std::destroy_n(src, n);
+			}
+		}
+
+		/// @brief 将数组容量调整为 `cap`, 数组长度不变
+		///
+		/// @param cap 新容量, 不能小于数组长度
+		void __reallocate(size_t cap) {
+			T* data = cap ? _alloc.allocate(cap) : nullptr;
+			try {
+				__relocate(data, _data, _size);
+			}
+			catch (...) {
+				_alloc.deallocate(data, cap);
+				throw;
+			}
+
+			if (_data) {
+				_alloc.deallocate(_data, _capacity);
+			}
+			_data = data;
+			_capacity = cap;
+		}
+
+		/// @brief 扩容并在新内存的末尾构造元素, 数组长度不变
+		///
+		/// @tparam _Args 参数类型
+		/// @param args 元素构造器参数
+		template <typename... _Args>
+		void __grow_and_emplace(_Args&&... args) {
+			size_t cap = __grow_capacity(_size + 1);
+			T* data = _alloc.allocate(cap);
+
+			// 先构造新元素, 参数引用的原有元素在转移之前仍然有效
+			try {
+				__alloc_traits::construct(_alloc, data + _size, std::forward<_Args>(args)...);
+			}
+			catch (...) {
+				_alloc.deallocate(data, cap);
+				throw;
+			}
+
+			try {
+				__relocate(data, _data, _size);
+			}
+			catch (...) {
+				__alloc_traits::destroy(_alloc, data + _size);
+				_alloc.deallocate(data, cap);
+				throw;
+			}
+
+			if (_data) {
+				_alloc.deallocate(_data, _capacity);
+			}
+			_data = data;
+			_capacity = cap;
+		}
+
+		/// @brief 调整数组长度, 通过 `init` 构造新增的元素
+		///
+		/// @tparam _Init 构造函数类型, 形如 `void(T* p, size_t n)`
+		/// @param n 新的数组长度
+		/// @param init 在 `p` 处构造 `n` 个元素的函数
+		template <typename _Init>
+		void __resize(size_t n, _Init&& init) {
+			if (n <= _size) {
+				__destroy(n);
+				return;
+			}
+			if (n > _capacity) {
+				__reallocate(__grow_capacity(n));
+			}
+			init(_data + _size, n - _size);
+			_size = n;
+		}
+
+		/// @brief 销毁下标 `n` 及其之后的元素, 数组长度置为 `n`
+		///
+		/// @param n 保留的元素个数
+		void __destroy(size_t n) noexcept {
+			std::destroy(_data + n, _data + _size);
+			_size = n;
+		}
+
 		/// @brief 将另一个对象进行移动
 		///
 		/// @param o 另一个对象的右值引用
 		void __move(__self&& o) noexcept {
-#if __ge_cxx17
-			if (_size = std::exchange(o._size, 0); _size > 0) {
-#else
+			_data = std::exchange(o._data, nullptr);
 			_size = std::exchange(o._size, 0);
-			if (_size > 0) {
-#endif
-				_data = std::exchange(o._data, nullptr);
-			}
+			_capacity = std::exchange(o._capacity, 0);
 		}
 
-		/// @brief 销毁当前数据指针
+		/// @brief 销毁全部元素并释放当前数据指针
 		void __free() {
 #if __ge_cxx17
 			if (T* data = std::exchange(_data, nullptr); data) {
@@ -185,9 +440,10 @@ namespace cxx::iterator {
 			T* data = std::exchange(_data, nullptr);
 			if (data) {
 #endif
-				_alloc.deallocate(data, _size);
-				_data = nullptr;
+				std::destroy_n(data, _size);
+				_alloc.deallocate(data, _capacity);
 				_size = 0;
+				_capacity = 0;
 			}
 		}
 	};
@@ -6,10 +6,7 @@
 #include <type_traits>
 #include <memory>
 #include <utility>
-
-#if !__ge_cxx17
 #include <iterator>
-#endif
 
 /// 测试迭代器
 ///
@@ -61,42 +58,14 @@ namespace cxx::iterator {
 		/// @param ptr 指针值
 		__iterator_type_define(pointer ptr) noexcept : _ptr(ptr) { }
 
-		/// @brief 拷贝构造器
-		///
-		/// @param 其它对象引用
-		__iterator_type_define(const __self& o) noexcept :
-			__iterator_type_define(o._ptr) { }
-
-		/// @brief 移动构造器
-		///
-		/// @param o 其它对象右值引用
-		__iterator_type_define(__self&& o) noexcept :
-			_ptr(std::exchange(o._ptr, nullptr)) { }
-
-		/// @brief 析构函数
-		virtual ~__iterator_type_define() = default;
+		// 复制, 移动和析构均使用编译器生成的默认实现: 迭代器不含虚函数 (没有虚表指针, 大小和原生指针相同),
+		// 且可平凡复制 (trivially copyable), 标准库算法和编译器可以像对待原生指针一样对待迭代器
+		__iterator_type_define(const __self&) noexcept = default;
+		__iterator_type_define(__self&&) noexcept = default;
+		~__iterator_type_define() = default;
 	public:
-		/// @brief 赋值运算符重载
-		///
-		/// @param  其它对象引用
-		/// @return 当前对象引用
-		__self& operator=(const __self& o) noexcept {
-			if (this != &o) {
-				_ptr = o._ptr;
-			}
-			return *this;
-		};
-
-		/// @brief 移动赋值运算符重载
-		///
-		/// @param o 其它对象右值引用
-		/// @return 当前对象引用
-		__self& operator=(__self&& o) noexcept {
-			if (this != &o) {
-				_ptr = std::exchange(o._ptr, nullptr);
-			}
-			return *this;
-		}
+		__self& operator=(const __self&) noexcept = default;
+		__self& operator=(__self&&) noexcept = default;
 
 		/// @brief 重载判等运算符
 		///
@@ -111,6 +80,13 @@ namespace cxx::iterator {
 		/// @return 当前指针指向的值的可变引用
 		reference operator*() const { return *_ptr; }
 
+		/// @brief 成员访问运算符重载, 获取指针值
+		///
+		/// `std::to_address` 通过该运算符获取迭代器指向的地址, 是 `std::contiguous_iterator` 的要求之一
+		///
+		/// @return 当前指针值
+		pointer operator->() const noexcept { return _ptr; }
+
 		/// @brief 重载下标运算符, 根据索引值获取对应元素引用
 		///
 		/// clang++ 要求要求随机迭代器具备通过下标返回任意位置元素引用, 且必须修饰为 `const` 方法
@@ -152,6 +128,12 @@ namespace cxx::iterator {
 		using pointer = typename __base::pointer;
 		using reference = typename __base::reference;
 		using iterator_category = typename __base::iterator_category;
+
+#if __ge_cxx20
+		// 元素在内存中连续存放, 和标准库容器 (如 `std::vector`) 一致, `iterator_category` 保持为
+		// `random_access_iterator_tag`, 通过 `iterator_concept` 表达 `contiguous_iterator` 特性
+		using iterator_concept = std::contiguous_iterator_tag;
+#endif
 	public:
 		/// @brief 默认构造器
 		ptr_based_iterator() : __base(nullptr) { }
@@ -162,14 +144,10 @@ namespace cxx::iterator {
 		explicit ptr_based_iterator(pointer ptr) : __base(ptr) { }
 
 		/// @brief 拷贝构造器
-		///
-		/// @param 其它对象引用
-		ptr_based_iterator(const __self& o) noexcept : __base(o) { };
+		ptr_based_iterator(const __self&) noexcept = default;
 
-		/// @brief 移动构造器
-		///
-		/// @param o 其它对象右值引用
-		ptr_based_iterator(__self&& o) noexcept : __base(std::move(o)) { }
+		/// @brief 移动构造器, 和复制相同, 原对象保持不变
+		ptr_based_iterator(__self&&) noexcept = default;
 
 		/// @brief 析构函数
 		~ptr_based_iterator() = default;
@@ -333,14 +311,10 @@ namespace cxx::iterator {
 		explicit ptr_based_reverse_iterator(pointer ptr) noexcept : __base(ptr) { }
 
 		/// @brief 拷贝构造器
-		///
-		/// @param o 其它对象引用
-		ptr_based_reverse_iterator(const __self& o) noexcept : __base(o) { }
+		ptr_based_reverse_iterator(const __self&) noexcept = default;
 
-		/// @brief 移动构造器
-		///
-		/// @param o 其它对象右值引用
-		ptr_based_reverse_iterator(__self&& o) noexcept : __base(std::move(o)) { }
+		/// @brief 移动构造器, 和复制相同, 原对象保持不变
+		ptr_based_reverse_iterator(__self&&) noexcept = default;
 
 		/// @brief 析构函数
 		~ptr_based_reverse_iterator() = default;
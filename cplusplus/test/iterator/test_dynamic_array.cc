@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "iterator/dynamic_array.h"
+
+#define TEST_SUITE_NAME test_cplusplus_iterator__dynamic_array
+
+using namespace cxx::iterator;
+
+/// @brief 记录构造, 复制, 移动和析构次数的元素类型
+///
+/// @tparam _nothrow_move 移动构造器是否声明为 `noexcept`
+template <bool _nothrow_move>
+struct tracked {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    static inline int alive = 0;
+
+    int value;
+
+    tracked(int v = 0) : value(v) { ++alive; }
+    tracked(const tracked& o) : value(o.value) { ++copies, ++alive; }
+    tracked(tracked&& o) noexcept(_nothrow_move) : value(o.value) { ++moves, ++alive; }
+    ~tracked() { --alive; }
+
+    tracked& operator=(const tracked&) = default;
+
+    /// @brief 清零计数
+    static void reset() { copies = moves = 0; }
+};
+
+/// @brief 测试 `push_back` 按几何级数扩容
+TEST(TEST_SUITE_NAME, push_back) {
+    dynamic_array<int> da;
+    ASSERT_TRUE(da.empty());
+    ASSERT_EQ(da.capacity(), 0);
+
+    // 记录容量变化的次数, 添加 1000 个元素只需扩容 11 次 (1, 2, 4, ..., 1024)
+    int grows = 0;
+    for (int i = 0; i < 1000; i++) {
+        size_t cap = da.capacity();
+        da.push_back(i);
+        if (da.capacity() != cap) {
+            ASSERT_EQ(da.capacity(), cap ? cap * 2 : 1);
+            grows++;
+        }
+    }
+    ASSERT_EQ(grows, 11);
+    ASSERT_EQ(da.size(), 1000);
+    ASSERT_EQ(da.capacity(), 1024);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(da[i], i);
+    }
+    ASSERT_EQ(da.back(), 999);
+    ASSERT_THROW(da.at(1000), std::out_of_range);
+
+    da.pop_back();
+    ASSERT_EQ(da.size(), 999);
+    ASSERT_EQ(da.back(), 998);
+
+    // `clear` 保留容量
+    da.clear();
+    ASSERT_TRUE(da.empty());
+    ASSERT_EQ(da.capacity(), 1024);
+}
+
+/// @brief 测试 `reserve` 和 `shrink_to_fit`
+TEST(TEST_SUITE_NAME, reserve) {
+    dynamic_array<std::string> da;
+    da.reserve(100);
+    ASSERT_EQ(da.capacity(), 100);
+
+    // 容量足够时不会重新分配内存
+    const std::string* data = da.data();
+    for (int i = 0; i < 100; i++) {
+        da.emplace_back(std::to_string(i));
+    }
+    ASSERT_EQ(da.data(), data);
+
+    // 小于当前容量的 `reserve` 不做任何操作
+    da.reserve(10);
+    ASSERT_EQ(da.capacity(), 100);
+
+    da.resize(10);
+    ASSERT_EQ(da.capacity(), 100);
+    da.shrink_to_fit();
+    ASSERT_EQ(da.size(), 10);
+    ASSERT_EQ(da.capacity(), 10);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(da[i], std::to_string(i));
+    }
+
+    da.clear();
+    da.shrink_to_fit();
+    ASSERT_EQ(da.capacity(), 0);
+    ASSERT_EQ(da.data(), nullptr);
+}
+
+/// @brief 测试 `resize` 的值初始化, 填充和默认初始化三种方式
+TEST(TEST_SUITE_NAME, resize) {
+    dynamic_array<int> da{ 1, 2, 3 };
+
+    // 值初始化, 新增元素为 `0`
+    da.resize(6);
+    ASSERT_EQ(da.size(), 6);
+    ASSERT_EQ(da[2], 3);
+    ASSERT_EQ(da[3], 0);
+    ASSERT_EQ(da[5], 0);
+
+    // 以指定值填充, 参数引用数组中的元素时结果仍然正确
+    da.resize(100, da[0]);
+    ASSERT_EQ(da.size(), 100);
+    ASSERT_EQ(da[99], 1);
+
+    // 默认初始化, 只调整长度, 由调用方写入新增元素
+    da.resize_for_overwrite(200);
+    ASSERT_EQ(da.size(), 200);
+    for (size_t i = 100; i < 200; i++) {
+        da[i] = (int)i;
+    }
+    ASSERT_EQ(da[150], 150);
+
+    // 缩小长度时销毁多余的元素
+    dynamic_array<tracked<true>> dt(10);
+    ASSERT_EQ(tracked<true>::alive, 10);
+    dt.resize(4);
+    ASSERT_EQ(dt.size(), 4);
+    ASSERT_EQ(tracked<true>::alive, 4);
+    dt.resize(8);
+    ASSERT_EQ(tracked<true>::alive, 8);
+}
+
+/// @brief 测试扩容时通过 `noexcept` 移动构造器或复制构造器转移元素
+TEST(TEST_SUITE_NAME, relocate) {
+    {
+        // 移动构造器为 `noexcept` 时, 扩容只移动元素
+        using T = tracked<true>;
+        dynamic_array<T> da;
+        T::reset();
+        for (int i = 0; i < 100; i++) {
+            da.emplace_back(i);
+        }
+        ASSERT_EQ(T::copies, 0);
+        ASSERT_GT(T::moves, 0);
+        ASSERT_EQ(T::alive, 100);
+        ASSERT_EQ(da[99].value, 99);
+    }
+    ASSERT_EQ(tracked<true>::alive, 0);
+
+    {
+        // 移动构造器可能抛出异常时, 为保证扩容失败时原数组不变, 扩容只复制元素
+        using T = tracked<false>;
+        dynamic_array<T> da;
+        T::reset();
+        for (int i = 0; i < 100; i++) {
+            da.emplace_back(i);
+        }
+        ASSERT_GT(T::copies, 0);
+        ASSERT_EQ(T::moves, 0);
+        ASSERT_EQ(T::alive, 100);
+        ASSERT_EQ(da[99].value, 99);
+    }
+    ASSERT_EQ(tracked<false>::alive, 0);
+
+    // 不可复制的元素类型通过移动转移
+    dynamic_array<std::unique_ptr<int>> dp;
+    for (int i = 0; i < 100; i++) {
+        dp.push_back(std::make_unique<int>(i));
+    }
+    ASSERT_EQ(*dp[0], 0);
+    ASSERT_EQ(*dp[99], 99);
+}
+
+/// @brief 测试 `emplace_back` 的参数引用数组中的元素, 且恰好需要扩容的情况
+TEST(TEST_SUITE_NAME, emplace_back_self_reference) {
+    dynamic_array<std::string> da{ "hello" };
+    ASSERT_EQ(da.size(), da.capacity());
+
+    da.push_back(da[0]);
+    da.emplace_back(da[1], 1, 3);
+    ASSERT_EQ(da.size(), 3);
+    ASSERT_EQ(da[0], "hello");
+    ASSERT_EQ(da[1], "hello");
+    ASSERT_EQ(da[2], "ell");
+}
+
+/// @brief 测试复制和移动数组
+TEST(TEST_SUITE_NAME, copy_and_move) {
+    dynamic_array<std::string> da;
+    for (int i = 0; i < 10; i++) {
+        da.push_back(std::to_string(i));
+    }
+
+    // 复制得到的数组容量和长度相同
+    dynamic_array<std::string> copy(da);
+    ASSERT_EQ(copy.size(), 10);
+    ASSERT_EQ(copy.capacity(), 10);
+    ASSERT_EQ(copy[9], "9");
+
+    dynamic_array<std::string> moved(std::move(da));
+    ASSERT_EQ(moved.size(), 10);
+    ASSERT_EQ(moved.capacity(), 16);
+    ASSERT_EQ(da.size(), 0);
+    ASSERT_EQ(da.data(), nullptr);
+
+    // 被移动的数组仍然可用
+    da.push_back("a");
+    ASSERT_EQ(da[0], "a");
+
+    copy = std::move(moved);
+    ASSERT_EQ(copy.size(), 10);
+    moved = copy;
+    ASSERT_EQ(moved[5], "5");
+}
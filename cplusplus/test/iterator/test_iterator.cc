@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "iterator/dynamic_array.h"
@@ -263,9 +265,38 @@ TEST(TEST_SUITE_NAME, iterator_movement) {
     // 执行移动赋值运算
     it2 = std::move(it1);
 
-    // 迭代器内部指针已经从 `it1` 移动到 `it2`
-    ASSERT_FALSE(it1);
+    // 迭代器和原生指针一样, 移动即为复制, `it1` 仍指向原位置
+    ASSERT_TRUE(it1);
     ASSERT_TRUE(it2);
+    ASSERT_TRUE(it1 == it2);
 
     ASSERT_EQ(*it2, 1);
 }
+
+/// @brief 测试迭代器和原生指针具有相同的内存布局和复制语义
+///
+/// 迭代器不含虚函数且可平凡复制, 标准库算法可以像处理原生指针一样处理迭代器
+TEST(TEST_SUITE_NAME, trivially_copyable_iterator) {
+    using iterator_type = dynamic_array<int>::iterator;
+    using reverse_iterator_type = dynamic_array<int>::reverse_iterator;
+
+    ASSERT_EQ(sizeof(iterator_type), sizeof(int*));
+    ASSERT_EQ(sizeof(reverse_iterator_type), sizeof(int*));
+
+    ASSERT_TRUE(std::is_trivially_copyable_v<iterator_type>);
+    ASSERT_TRUE(std::is_trivially_copyable_v<dynamic_array<int>::const_iterator>);
+    ASSERT_TRUE(std::is_trivially_copyable_v<reverse_iterator_type>);
+    ASSERT_FALSE(std::has_virtual_destructor_v<iterator_type>);
+
+#if __ge_cxx20
+    // 正向迭代器为 `contiguous_iterator`, 可以通过 `std::to_address` 获取元素地址
+    ASSERT_TRUE(std::contiguous_iterator<iterator_type>);
+    ASSERT_TRUE(std::contiguous_iterator<dynamic_array<int>::const_iterator>);
+    ASSERT_FALSE(std::contiguous_iterator<reverse_iterator_type>);
+    ASSERT_TRUE(std::random_access_iterator<reverse_iterator_type>);
+
+    dynamic_array<int> da{ 1, 2, 3, 4, 5 };
+    ASSERT_EQ(std::to_address(da.begin()), da.data());
+    ASSERT_EQ(std::to_address(da.begin() + 2), da.data() + 2);
+#endif
+}
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <string>
+
+#include "bench/bench.h"
+#include "coro.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_coro__executor
+
+using namespace bench;
+
+/// @brief 参与测试的子进程命令及其名称
+static const struct {
+    const char* name;
+    const char* script; // 通过 `/bin/sh -c` 执行的脚本
+    size_t jobs;        // 每轮运行的子进程数
+} JOBS[] = {
+    { "echo", "echo hello", 1000 },
+    { "sleep_10ms", "sleep 0.01; echo hello", 200 },
+};
+
+/// 对比在一个线程中运行大量子进程并读取其标准输出的两种方式
+///
+/// - `sequential`: 通过 `exec_capture` 逐个运行子进程, 每个子进程结束后再运行下一个
+/// - `coro`: 通过协程执行器同时运行全部子进程, 由 epoll 等待管道和 pidfd
+BENCH(BENCH_SUITE_NAME, exec) {
+    fflush(stdout);
+
+    for (const auto& j : JOBS) {
+        char* argv[] = { (char*)"sh", (char*)"-c", (char*)j.script, nullptr };
+
+        std::string name = std::string("exec/") + j.name + "/sequential";
+        report(measure(name.c_str(), j.jobs, 0, [&] {
+            for (size_t i = 0; i < j.jobs; i++) {
+                exec_output out;
+                if (exec_capture("/bin/sh", argv, -1, &out) == 0) {
+                    do_not_optimize(out.out_len);
+                    exec_output_free(&out);
+                }
+            }
+        }));
+
+        name = std::string("exec/") + j.name + "/coro";
+        report(measure(name.c_str(), j.jobs, 0, [&] {
+            coro::executor ex;
+            size_t total = 0;
+
+            // 协程通过 lambda 对象访问捕获的变量, 故 lambda 对象的生命周期必须覆盖协程的执行
+            auto job = [&]() -> coro::task<void> {
+                coro::child_result r = co_await ex.exec("/bin/sh", argv);
+                total += r.out.size();
+            };
+            for (size_t i = 0; i < j.jobs; i++) {
+                ex.spawn(job());
+            }
+            ex.run();
+            do_not_optimize(total);
+        }));
+    }
+}
@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_process__exec
+
+using namespace bench;
+
+/// @brief 参与测试的主进程内存占用及其名称
+static const struct {
+    const char* name;
+    size_t bytes;
+} SIZES[] = {
+    { "100MB", (size_t)100 << 20 },
+    { "1GB", (size_t)1 << 30 },
+    { "10GB", (size_t)10 << 30 },
+};
+
+/// @brief 主进程内存占用的默认上限, 可通过环境变量 `LINUX_BENCH_RSS_MAX` 调整 (单位为字节)
+static const size_t DEFAULT_RSS_MAX = (size_t)1 << 30;
+
+/// @brief 每轮启动的子进程数
+static const size_t N_SPAWNS = 20;
+
+/// 对比 `fork` + `execv` 和 `posix_spawn` 两种方式在主进程占用不同内存时启动子进程的延迟
+///
+/// 每个子进程运行 `/usr/bin/true`, 计时包括启动和等待子进程结束
+BENCH(BENCH_SUITE_NAME, spawn) {
+    const char* env = getenv("LINUX_BENCH_RSS_MAX");
+    size_t rss_max = env ? strtoull(env, nullptr, 10) : DEFAULT_RSS_MAX;
+
+    const char* const argv[] = { "/usr/bin/true", nullptr };
+    const exec_cmd cmd = { argv[0], (char* const*)argv };
+
+    // 子进程通过 `exit` 结束时会再次输出从主进程继承的 `stdio` 缓冲区, 故先刷新
+    fflush(stdout);
+
+    for (const auto& s : SIZES) {
+        if (s.bytes > rss_max) {
+            continue;
+        }
+
+        // 分配内存并逐页写入, 令其全部计入主进程的 RSS
+        void* mem = mmap(nullptr, s.bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            continue;
+        }
+        memset(mem, 1, s.bytes);
+
+        const struct {
+            const char* name;
+            spawn_backend backend;
+        } backends[] = {
+            { "fork", SPAWN_FORK },
+            { "posix_spawn", SPAWN_POSIX },
+        };
+
+        for (const auto& b : backends) {
+            std::string name = std::string("exec/") + s.name + "/" + b.name;
+            report(measure(name.c_str(), N_SPAWNS, 0, [&] {
+                for (size_t i = 0; i < N_SPAWNS; i++) {
+                    pid_t pid;
+                    if (spawn_process(b.backend, cmd.path, cmd.argv, &pid) == 0) {
+                        int stat;
+                        waitpid(pid, &stat, 0);
+                    }
+                }
+            }));
+        }
+
+        // 批量启动, 各子进程并发执行
+        std::vector<exec_cmd> cmds(N_SPAWNS, cmd);
+        std::vector<int> stats(N_SPAWNS);
+        std::string name = std::string("exec/") + s.name + "/batch";
+        report(measure(name.c_str(), N_SPAWNS, 0, [&] {
+            forked_execv_batch(cmds.data(), N_SPAWNS, stats.data());
+        }));
+
+        munmap(mem, s.bytes);
+    }
+}
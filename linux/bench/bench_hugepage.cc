@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "alloc.h"
+#include "thread.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_alloc__hugepage
+
+using namespace bench;
+
+/// @brief 分配的内存大小
+static const size_t SIZE = (size_t)256 << 20;
+
+/// @brief 测量 `f` 并输出每轮平均的缺页中断次数
+template <typename F>
+static void __measure_faults(const std::string& name, size_t bytes, F&& f) {
+    page_faults before, after;
+    page_faults_self(&before);
+    result r = measure(name, 1, bytes, f, 0);
+    page_faults_self(&after);
+
+    report(r);
+
+    // `measure` 先执行一轮预热, 故总轮数为 `ops + 1`
+    printf("%-48s %12.0f faults/op\n", "", (double)(after.minor - before.minor) / (double)(r.ops + 1));
+}
+
+/// 对比普通页面和大页在分配并逐页写入大块内存时的耗时及缺页中断次数
+BENCH(BENCH_SUITE_NAME, touch) {
+    __measure_faults("hugepage/256MB/calloc", SIZE, [&] {
+        char* p = (char*)calloc(SIZE, 1);
+        for (size_t off = 0; off < SIZE; off += 4096) {
+            p[off] = 1;
+        }
+        do_not_optimize(p);
+        free(p);
+    });
+
+    for (int flags : { 0, (int)HUGE_PREFAULT }) {
+        std::string name = flags ? "hugepage/256MB/huge_prefault" : "hugepage/256MB/huge";
+        __measure_faults(name, SIZE, [&] {
+            char* p = (char*)huge_alloc(SIZE, flags);
+            for (size_t off = 0; off < SIZE; off += 4096) {
+                p[off] = 1;
+            }
+            do_not_optimize(p);
+            huge_free(p);
+        });
+    }
+}
+
+/// 统计 `calculate_primes` 的耗时及缺页中断次数, 结果数组和各分组的结果数组使用大页内存
+BENCH(BENCH_SUITE_NAME, calculate_primes) {
+    const size_t max = 1000000000;
+    __measure_faults("hugepage/calculate_primes/1e9", max, [&] {
+        prime_result result{ NULL, 0 };
+        calculate_primes(max, &result);
+        do_not_optimize(result.count);
+        free_result(&result);
+    });
+}
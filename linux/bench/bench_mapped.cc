@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "io.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_io__mapped
+
+using namespace bench;
+
+/// @brief 测试文件大小的默认值, 可通过环境变量 `LINUX_BENCH_MAPPED_SIZE` 调整 (单位为字节)
+static const size_t DEFAULT_FILE_SIZE = (size_t)512 << 20;
+
+/// @brief 创建由若干行组成的测试文件, 位于当前目录所在的本地文件系统
+///
+/// @param size 文件大小
+/// @return 文件路径, 失败时返回空字符串
+static std::string __create_file(size_t size) {
+    char path[] = "bench_mapped_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return "";
+    }
+
+    std::string chunk;
+    for (size_t i = 0; chunk.size() < (1 << 20); i++) {
+        chunk.append(i % 120, 'x');
+        chunk.push_back('\n');
+    }
+
+    for (size_t off = 0; off < size; off += chunk.size()) {
+        if (write(fd, chunk.data(), chunk.size()) != (ssize_t)chunk.size()) {
+            close(fd);
+            unlink(path);
+            return "";
+        }
+    }
+    close(fd);
+    return path;
+}
+
+/// @brief 统计 `\n` 的个数, 模拟按行解析
+static size_t __count_lines(const char* data, size_t len) {
+    size_t n = 0;
+    const char* end = data + len;
+    while ((data = (const char*)memchr(data, '\n', (size_t)(end - data))) != nullptr) {
+        n++;
+        data++;
+    }
+    return n;
+}
+
+/// 对比通过 `read` 和映射文件顺序扫描整个文件的吞吐量, 每次扫描都包括打开和关闭文件
+///
+/// 文件内容位于页缓存中, 测试结果反映的是复制数据和缺页中断的开销
+BENCH(BENCH_SUITE_NAME, scan) {
+    const char* env = getenv("LINUX_BENCH_MAPPED_SIZE");
+    size_t size = env ? strtoull(env, nullptr, 10) : DEFAULT_FILE_SIZE;
+
+    std::string path = __create_file(size);
+    if (path.empty()) {
+        return;
+    }
+
+    // 文件按整行写入, 实际大小略大于 `size`
+    struct stat st;
+    stat(path.c_str(), &st);
+    size = (size_t)st.st_size;
+
+    for (size_t buf_size : { (size_t)64 << 10, (size_t)1 << 20 }) {
+        std::vector<char> buf(buf_size);
+        std::string name = "mapped/read/" + std::to_string(buf_size >> 10) + "KB";
+
+        report(measure(name.c_str(), 1, size, [&] {
+            int fd = open(path.c_str(), O_RDONLY);
+            size_t lines = 0;
+            ssize_t n;
+            while ((n = read(fd, buf.data(), buf.size())) > 0) {
+                lines += __count_lines(buf.data(), (size_t)n);
+            }
+            close(fd);
+            do_not_optimize(lines);
+        }));
+    }
+
+    const struct {
+        const char* name;
+        size_t window;
+        int flags;
+    } variants[] = {
+        { "mapped/mmap", 0, 0 },
+        { "mapped/mmap/populate", 0, MAPPED_POPULATE },
+        { "mapped/mmap/sequential", 0, MAPPED_SEQUENTIAL | MAPPED_WILLNEED },
+        { "mapped/mmap/hugepage", 0, MAPPED_SEQUENTIAL | MAPPED_HUGEPAGE },
+        { "mapped/window64MB", (size_t)64 << 20, MAPPED_SEQUENTIAL | MAPPED_WILLNEED },
+        { "mapped/window64MB/populate", (size_t)64 << 20, MAPPED_POPULATE },
+    };
+
+    for (const auto& v : variants) {
+        report(measure(v.name, 1, size, [&] {
+            mapped_file mf;
+            if (mapped_open(&mf, path.c_str(), v.window, v.flags) != 0) {
+                abort();
+            }
+
+            // 按 4MB 的块扫描, 和并行解析时交给各线程的块大小相当
+            mapped_iter it;
+            mapped_iter_init(&it, &mf, (size_t)4 << 20);
+
+            size_t lines = 0;
+            const char* data;
+            size_t len;
+            while (mapped_iter_next(&it, &data, &len) == 0 && len > 0) {
+                lines += __count_lines(data, len);
+            }
+
+            mapped_close(&mf);
+            do_not_optimize(lines);
+        }));
+    }
+
+    unlink(path.c_str());
+}
@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <cstdio>
+
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_process__mutex
+
+using namespace bench;
+
+/// @brief 参与竞争的进程数
+static const int N_PROCS = 4;
+
+/// @brief 每个进程的加锁次数
+static const int N_LOOPS = 100000;
+
+/// @brief 放置在共享内存中的锁和计数器
+struct shared_lock {
+    shm_mutex shm;
+    pthread_mutex_t pthread;
+    uint64_t counter;
+};
+
+/// @brief 创建 `N_PROCS` 个子进程, 各自执行 `N_LOOPS` 次加锁, 累加计数器, 解锁
+template <typename Lock, typename Unlock>
+static void __contend(shared_lock* s, Lock&& lock, Unlock&& unlock) {
+    pid_t pids[N_PROCS];
+
+    for (int i = 0; i < N_PROCS; i++) {
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            for (int k = 0; k < N_LOOPS; k++) {
+                lock(s);
+                s->counter++;
+                unlock(s);
+            }
+            _exit(0);
+        }
+    }
+    for (int i = 0; i < N_PROCS; i++) {
+        waitpid(pids[i], nullptr, 0);
+    }
+}
+
+/// @brief 初始化进程间共享的 `pthread_mutex_t`
+///
+/// @param m 互斥锁指针
+/// @param robust 是否为 robust 互斥锁
+static void __init_pthread_mutex(pthread_mutex_t* m, bool robust) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    if (robust) {
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    }
+    pthread_mutex_init(m, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/// 对比多个进程竞争同一把锁时, `shm_mutex` 和 `PTHREAD_PROCESS_SHARED` 的 `pthread_mutex_t` 的每次加解锁开销
+BENCH(BENCH_SUITE_NAME, contention) {
+    shm_segment seg;
+    if (shm_segment_create(&seg, sizeof(shared_lock)) != 0) {
+        return;
+    }
+    shared_lock* s = (shared_lock*)seg.addr;
+
+    fflush(stdout);
+
+    report(measure("mutex/contention/shm_mutex", N_PROCS * N_LOOPS, 0, [&] {
+        __contend(s, [](shared_lock* p) { shm_mutex_lock(&p->shm); }, [](shared_lock* p) { shm_mutex_unlock(&p->shm); });
+    }));
+
+    for (bool robust : { false, true }) {
+        __init_pthread_mutex(&s->pthread, robust);
+
+        fflush(stdout);
+
+        report(measure(robust ? "mutex/contention/pthread_robust" : "mutex/contention/pthread", N_PROCS * N_LOOPS, 0, [&] {
+            __contend(s, [](shared_lock* p) { pthread_mutex_lock(&p->pthread); },
+                [](shared_lock* p) { pthread_mutex_unlock(&p->pthread); });
+        }));
+
+        pthread_mutex_destroy(&s->pthread);
+    }
+
+    // 单进程无竞争时的加解锁开销
+    report(measure("mutex/uncontended/shm_mutex", N_LOOPS, 0, [&] {
+        for (int k = 0; k < N_LOOPS; k++) {
+            shm_mutex_lock(&s->shm);
+            s->counter++;
+            shm_mutex_unlock(&s->shm);
+        }
+    }));
+
+    __init_pthread_mutex(&s->pthread, false);
+    report(measure("mutex/uncontended/pthread", N_LOOPS, 0, [&] {
+        for (int k = 0; k < N_LOOPS; k++) {
+            pthread_mutex_lock(&s->pthread);
+            s->counter++;
+            pthread_mutex_unlock(&s->pthread);
+        }
+    }));
+    pthread_mutex_destroy(&s->pthread);
+
+    do_not_optimize(s->counter);
+    shm_segment_free(&seg);
+}
@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "thread.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_thread__pool
+
+using namespace bench;
+
+/// @brief 每轮执行的任务数
+static const size_t N_TASKS = 1000;
+
+/// @brief 空任务函数, 只累加一个计数器, 用于测试任务调度本身的开销
+static void __count(void* arg) {
+    __atomic_add_fetch((uint64_t*)arg, 1, __ATOMIC_RELAXED);
+}
+
+/// @brief 空线程函数, 和 `__count` 相同
+static void* __count_thread(void* arg) {
+    __count(arg);
+    return nullptr;
+}
+
+/// 对比通过线程池执行任务和为每个任务创建一个线程 (即线程池引入之前 `calculate_primes` 的做法) 的开销
+BENCH(BENCH_SUITE_NAME, dispatch) {
+    uint64_t counter = 0;
+
+    thread_pool* pool = thread_pool_default();
+    std::vector<pool_task> tasks(N_TASKS);
+
+    report(measure("pool/dispatch/default", N_TASKS, 0, [&] {
+        pool_group group = POOL_GROUP_INIT;
+        for (auto& t : tasks) {
+            t.func = __count;
+            t.arg = &counter;
+            thread_pool_submit(pool, &t, &group);
+        }
+        pool_group_wait(pool, &group);
+    }));
+
+    std::vector<pthread_t> tids(N_TASKS);
+
+    report(measure("pool/dispatch/pthread_create", N_TASKS, 0, [&] {
+        for (auto& tid : tids) {
+            pthread_create(&tid, nullptr, __count_thread, &counter);
+        }
+        for (auto& tid : tids) {
+            pthread_join(tid, nullptr);
+        }
+    }));
+
+    do_not_optimize(counter);
+}
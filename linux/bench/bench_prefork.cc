@@ -0,0 +1,82 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_process__prefork
+
+using namespace bench;
+
+/// @brief 每轮执行的任务数
+static const size_t N_TASKS = 200;
+
+/// @brief 进程池的请求处理函数, 按原样返回请求内容
+static int __echo(const char* req, size_t len, frame_buf* resp, void*) {
+    return frame_buf_append(resp, req, len);
+}
+
+/// @brief `execute_worker` 的子进程入口函数, 向主进程发送一条消息
+static int __fork_main(int pwfd) {
+    fork_msg msg = {};
+    msg.s_pid = getpid();
+    return write(pwfd, &msg, MSG_SIZE) == (ssize_t)MSG_SIZE ? 0 : 1;
+}
+
+/// 对比通过进程池分发任务和为每个任务创建一个子进程 (即 `execute_worker` 的做法) 的开销
+BENCH(BENCH_SUITE_NAME, dispatch) {
+    prefork_pool* pool = nullptr;
+    if (prefork_create(&pool, 0, __echo, nullptr) != 0) {
+        return;
+    }
+
+    std::string msg(MSG_SIZE, 'x');
+    frame_buf resp = {};
+    int status = 0;
+
+    report(measure("prefork/dispatch/call", N_TASKS, N_TASKS * MSG_SIZE, [&] {
+        for (size_t i = 0; i < N_TASKS; i++) {
+            prefork_call(pool, msg.data(), msg.size(), &resp, &status);
+        }
+    }));
+
+    std::vector<prefork_req> reqs(N_TASKS, prefork_req{ msg.data(), msg.size() });
+    std::vector<frame_buf> resps(N_TASKS, frame_buf{});
+    std::vector<int> statuses(N_TASKS);
+
+    report(measure("prefork/dispatch/batch", N_TASKS, N_TASKS * MSG_SIZE, [&] {
+        prefork_batch(pool, reqs.data(), N_TASKS, resps.data(), statuses.data());
+    }));
+
+    // `execute_worker` 的子进程通过 `exit` 结束, 会再次输出从主进程继承的 `stdio` 缓冲区, 故先刷新
+    fflush(stdout);
+
+    report(measure("prefork/dispatch/execute_worker", N_TASKS, N_TASKS * MSG_SIZE, [&] {
+        for (size_t i = 0; i < N_TASKS; i++) {
+            fork_msg m;
+            worker_t w = execute_worker(__fork_main, &m);
+            do_not_optimize(w);
+        }
+    }));
+
+    // 大请求的吞吐量, 主要开销为 socket 的数据复制
+    std::string big(1 << 20, 'y');
+
+    report(measure("prefork/throughput/1MB", 1, 2 * big.size(), [&] {
+        prefork_call(pool, big.data(), big.size(), &resp, &status);
+    }));
+
+    for (auto& r : resps) {
+        frame_buf_free(&r);
+    }
+    frame_buf_free(&resp);
+    prefork_destroy(pool);
+}
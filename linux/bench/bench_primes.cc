@@ -0,0 +1,136 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "thread.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_thread__primes
+
+using namespace bench;
+
+/// @brief 参与测试的质数上限及其名称
+static const struct {
+    const char* name;
+    size_t max;
+} LIMITS[] = {
+    { "1e7", 10000000 },
+    { "1e8", 100000000 },
+    { "1e9", 1000000000 },
+};
+
+/// @brief 试除法对比基准的默认上限
+///
+/// 试除法的耗时为 `O(n·sqrt(n))`, 上限为 `1e8` 时已需要数分钟, `1e9` 时需要数小时, 故默认只对 `1e7` 执行;
+/// 可通过环境变量 `LINUX_BENCH_TRIAL_MAX` 调整
+static const size_t DEFAULT_TRIAL_MAX = 10000000;
+
+/// @brief 使用试除法计算 `[begin, end)` 之间的质数, 和分段筛之前 `_calculate_primes_each_group` 函数的实现一致
+///
+/// @param begin 起始值
+/// @param end 结束值 (不包含)
+/// @param out 保存结果的集合
+static void __trial_division_group(size_t begin, size_t end, std::vector<uint32_t>* out) {
+    for (size_t n = begin < 2 ? 2 : begin; n < end; n++) {
+        bool is_prime = true;
+        for (size_t k = 2; k * k <= n; k++) {
+            if (n % k == 0) {
+                is_prime = false;
+                break;
+            }
+        }
+        if (is_prime) {
+            out->push_back((uint32_t)n);
+        }
+    }
+}
+
+/// @brief 使用试除法计算 `[2, max)` 之间的质数, 和原实现一样每个分组启动一个线程
+///
+/// @param max 质数上限
+/// @return 质数个数
+static size_t __trial_division_primes(size_t max) {
+    size_t group_count = (max + GROUP_SIZE - 1) / GROUP_SIZE;
+
+    std::vector<std::vector<uint32_t>> results(group_count);
+    std::vector<std::thread> workers;
+    workers.reserve(group_count);
+
+    for (size_t n = 0; n < group_count; n++) {
+        size_t end = (n + 1) * GROUP_SIZE < max ? (n + 1) * GROUP_SIZE : max;
+        workers.emplace_back(__trial_division_group, n * GROUP_SIZE, end, &results[n]);
+    }
+
+    size_t count = 0;
+    for (size_t n = 0; n < group_count; n++) {
+        workers[n].join();
+        count += results[n].size();
+    }
+    return count;
+}
+
+/// @brief 流式计算的回调函数, 只累加质数个数
+static int __count_primes(const uint32_t*, size_t count, void* ctx) {
+    *(size_t*)ctx += count;
+    return 0;
+}
+
+/// 吞吐量按筛选范围计算, 每个整数记为 1 字节
+BENCH(BENCH_SUITE_NAME, calculate_primes) {
+    const char* env = getenv("LINUX_BENCH_TRIAL_MAX");
+    size_t trial_max = env ? strtoull(env, nullptr, 10) : DEFAULT_TRIAL_MAX;
+
+    for (const auto& limit : LIMITS) {
+        std::string prefix = std::string("calculate_primes/") + limit.name;
+
+        report(measure(prefix + "/sieve", 1, limit.max, [&] {
+            prime_result result{ NULL, 0 };
+            if (calculate_primes(limit.max, &result) != 0) {
+                fprintf(stderr, "calculate_primes(%zu) failed\n", limit.max);
+                exit(1);
+            }
+            do_not_optimize(result.count);
+            free_result(&result);
+        }, 0));
+
+        report(measure(prefix + "/stream", 1, limit.max, [&] {
+            size_t count = 0;
+            if (calculate_primes_stream(limit.max, __count_primes, &count) != 0) {
+                fprintf(stderr, "calculate_primes_stream(%zu) failed\n", limit.max);
+                exit(1);
+            }
+            do_not_optimize(count);
+        }, 0));
+
+        report(measure(prefix + "/count", 1, limit.max, [&] {
+            uint64_t count = 0;
+            if (count_primes(limit.max, &count) != 0) {
+                fprintf(stderr, "count_primes(%zu) failed\n", limit.max);
+                exit(1);
+            }
+            do_not_optimize(count);
+        }, 0));
+
+        report(measure(prefix + "/for_each", 1, limit.max, [&] {
+            size_t count = 0;
+            if (for_each_prime(0, limit.max, __count_primes, &count) != 0) {
+                fprintf(stderr, "for_each_prime(%zu) failed\n", limit.max);
+                exit(1);
+            }
+            do_not_optimize(count);
+        }, 0));
+
+        if (limit.max <= trial_max) {
+            report(measure(prefix + "/trial_division", 1, limit.max, [&] {
+                do_not_optimize(__trial_division_primes(limit.max));
+            }, 0));
+        }
+    }
+}
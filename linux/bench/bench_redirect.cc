@@ -0,0 +1,191 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "io.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_io__redirect
+
+using namespace bench;
+
+/// @brief 参与测试的输出长度及其名称
+static const struct {
+    const char* name;
+    size_t bytes;
+} SIZES[] = {
+    { "1MB", (size_t)1 << 20 },
+    { "16MB", (size_t)16 << 20 },
+    { "256MB", (size_t)256 << 20 },
+    { "1GB", (size_t)1 << 30 },
+};
+
+/// @brief 输出长度的默认上限, 可通过环境变量 `LINUX_BENCH_CAPTURE_MAX` 调整 (单位为字节)
+static const size_t DEFAULT_CAPTURE_MAX = (size_t)1 << 30;
+
+/// @brief 每次写入的字节数
+static const size_t CHUNK = 64 * 1024;
+
+/// @brief 向标准输出写入 `total` 字节
+static void __write_out(const std::vector<char>& chunk, size_t total) {
+    for (size_t off = 0; off < total; off += chunk.size()) {
+        if (write(STDOUT_FILENO, chunk.data(), chunk.size()) != (ssize_t)chunk.size()) {
+            abort();
+        }
+    }
+}
+
+/// @brief 获取系统允许的最大管道容量
+static size_t __pipe_max_size() {
+    size_t n = 64 * 1024;
+    FILE* fp = fopen("/proc/sys/fs/pipe-max-size", "r");
+    if (fp) {
+        if (fscanf(fp, "%zu", &n) != 1) {
+            n = 64 * 1024;
+        }
+        fclose(fp);
+    }
+    return n;
+}
+
+/// 对比捕获标准输出的几种方式: 管道 (结束时读取, 只适用于不超过管道容量的输出), 管道 + 后台线程持续读取, 以及匿名内存文件
+BENCH(BENCH_SUITE_NAME, capture) {
+    const char* env = getenv("LINUX_BENCH_CAPTURE_MAX");
+    size_t capture_max = env ? strtoull(env, nullptr, 10) : DEFAULT_CAPTURE_MAX;
+
+    std::vector<char> chunk(CHUNK, 'x');
+    size_t pipe_max = __pipe_max_size();
+
+    for (const auto& s : SIZES) {
+        if (s.bytes > capture_max) {
+            continue;
+        }
+
+        std::string prefix = std::string("redirect/") + s.name;
+        size_t len = 0;
+
+        fflush(stdout);
+
+        // 结束时才读取管道的方式, 输出超过管道容量时写入方会一直阻塞, 故只测试不超过管道容量的长度
+        if (s.bytes <= pipe_max) {
+            auto r = measure(prefix + "/pipe", 1, s.bytes, [&] {
+                void* h = fd_redirect_to_memory_begin(STDOUT_FILENO);
+                __write_out(chunk, s.bytes);
+                free(fd_redirect_to_memory_end(h, &len));
+            });
+            report(r);
+            fflush(stdout);
+        }
+
+        auto r = measure(prefix + "/pipe_async", 1, s.bytes, [&] {
+            void* h = fd_redirect_to_memory_async_begin(STDOUT_FILENO);
+            __write_out(chunk, s.bytes);
+            free(fd_redirect_to_memory_end(h, &len));
+        });
+        report(r);
+        fflush(stdout);
+
+        r = measure(prefix + "/memfd", 1, s.bytes, [&] {
+            void* h = fd_redirect_to_memfd_begin(STDOUT_FILENO);
+            __write_out(chunk, s.bytes);
+            char* res = fd_redirect_to_memfd_end(h, &len);
+
+            // 读取映射的每一页, 计入缺页的开销, 和另外两种方式得到可直接读取的结果一致
+            uint64_t sum = 0;
+            for (size_t i = 0; i < len; i += 4096) {
+                sum += (unsigned char)res[i];
+            }
+            do_not_optimize(sum);
+            fd_redirect_memfd_free(res, len);
+        });
+        report(r);
+    }
+}
+
+/// @brief 转发到文件测试的输出长度
+static const size_t FILE_BYTES = (size_t)256 << 20;
+
+/// @brief 创建已删除名称的临时文件
+static int __temp_file() {
+    char path[] = "/tmp/bench_redirect_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        unlink(path);
+    }
+    return fd;
+}
+
+/// 对比将标准输出转发到文件的几种方式: `splice`, `splice` + `tee` 到另一个管道, 以及捕获到内存后再 `write` 到文件
+BENCH(BENCH_SUITE_NAME, to_file) {
+    std::vector<char> chunk(CHUNK, 'x');
+    int fd = __temp_file();
+    if (fd < 0) {
+        return;
+    }
+
+    fd_splice_stats stats = {};
+
+    fflush(stdout);
+    report(measure("redirect/file/splice", 1, FILE_BYTES, [&] {
+        ftruncate(fd, 0);
+        void* h = fd_redirect_to_file_begin(STDOUT_FILENO, fd);
+        __write_out(chunk, FILE_BYTES);
+        fd_redirect_to_file_end(h, &stats);
+    }));
+    printf("%-48s %12.3f GB/s (fd_splice_stats)\n", "redirect/file/splice", stats.bytes_per_sec / 1e9);
+
+    fflush(stdout);
+    report(measure("redirect/file/splice_tee", 1, FILE_BYTES, [&] {
+        ftruncate(fd, 0);
+
+        // 第二个消费者只读取并丢弃数据
+        int tap[2];
+        if (pipe(tap) != 0) {
+            abort();
+        }
+        std::thread reader([&] {
+            std::vector<char> buf(CHUNK);
+            while (read(tap[0], buf.data(), buf.size()) > 0) {
+            }
+        });
+
+        void* h = fd_tee_begin(STDOUT_FILENO, fd, tap[1]);
+        __write_out(chunk, FILE_BYTES);
+        fd_redirect_to_file_end(h, &stats);
+
+        close(tap[1]);
+        reader.join();
+        close(tap[0]);
+    }));
+    printf("%-48s %12.3f GB/s (fd_splice_stats)\n", "redirect/file/splice_tee", stats.bytes_per_sec / 1e9);
+
+    fflush(stdout);
+    report(measure("redirect/file/capture_write", 1, FILE_BYTES, [&] {
+        ftruncate(fd, 0);
+
+        size_t len = 0;
+        void* h = fd_redirect_to_memory_async_begin(STDOUT_FILENO);
+        __write_out(chunk, FILE_BYTES);
+        char* res = fd_redirect_to_memory_end(h, &len);
+
+        for (size_t off = 0; off < len;) {
+            ssize_t n = pwrite(fd, res + off, len - off, (off_t)off);
+            if (n <= 0) {
+                abort();
+            }
+            off += (size_t)n;
+        }
+        free(res);
+    }));
+
+    close(fd);
+}
@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_process__shared
+
+using namespace bench;
+
+/// @brief 每轮由子进程传递给父进程的总字节数
+static const size_t TOTAL_BYTES = 64 << 20;
+
+/// @brief 每块的字节数
+static const size_t CHUNK = 64 * 1024;
+
+/// @brief 逐缓存行读取数据, 模拟父进程对结果的处理
+static uint64_t __touch(const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < len; i += 64) {
+        sum += p[i];
+    }
+    return sum;
+}
+
+/// @brief 子进程通过管道发送 `TOTAL_BYTES` 字节, 每次写入 `chunk` 字节, 父进程读取到缓冲区中
+///
+/// @param chunk 每次写入的字节数, 为 `MSG_SIZE` 时即现有 `fork_msg` 的传递方式
+/// @return 父进程对数据的处理结果
+static uint64_t __via_pipe(size_t chunk) {
+    int pfds[2];
+    if (pipe(pfds) != 0) {
+        return 0;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(pfds[0]);
+        std::vector<char> buf(chunk);
+        for (size_t sent = 0; sent < TOTAL_BYTES; sent += chunk) {
+            memset(buf.data(), (int)(sent & 0xff), chunk);
+            for (size_t off = 0; off < chunk;) {
+                ssize_t n = write(pfds[1], buf.data() + off, chunk - off);
+                if (n <= 0) {
+                    _exit(1);
+                }
+                off += (size_t)n;
+            }
+        }
+        _exit(0);
+    }
+
+    close(pfds[1]);
+
+    std::vector<char> buf(CHUNK);
+    uint64_t sum = 0;
+    ssize_t n;
+    while ((n = read(pfds[0], buf.data(), buf.size())) > 0) {
+        sum += __touch(buf.data(), (size_t)n);
+    }
+
+    close(pfds[0]);
+    waitpid(pid, nullptr, 0);
+    return sum;
+}
+
+/// @brief 子进程直接在环形缓冲区中生成 `TOTAL_BYTES` 字节, 父进程直接在缓冲区中读取
+///
+/// @param ring 环形缓冲区
+/// @return 父进程对数据的处理结果
+static uint64_t __via_ring(shm_ring* ring) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (size_t sent = 0; sent < TOTAL_BYTES; sent += CHUNK) {
+            void* p = shm_ring_reserve(ring, CHUNK);
+            memset(p, (int)(sent & 0xff), CHUNK);
+            shm_ring_commit(ring, CHUNK);
+        }
+        shm_ring_close(ring);
+        _exit(0);
+    }
+
+    uint64_t sum = 0;
+    size_t len;
+    const void* p;
+    while ((p = shm_ring_peek(ring, &len)) != nullptr) {
+        sum += __touch(p, len);
+        shm_ring_consume(ring, len);
+    }
+
+    waitpid(pid, nullptr, 0);
+    return sum;
+}
+
+/// 对比子进程通过共享内存环形缓冲区和通过管道向父进程传递大量结果的吞吐量
+BENCH(BENCH_SUITE_NAME, throughput) {
+    fflush(stdout);
+
+    report(measure("shm/pipe/fork_msg", 1, TOTAL_BYTES, [] {
+        do_not_optimize(__via_pipe(MSG_SIZE));
+    }));
+
+    report(measure("shm/pipe/64KB", 1, TOTAL_BYTES, [] {
+        do_not_optimize(__via_pipe(CHUNK));
+    }));
+
+    report(measure("shm/ring/64KB", 1, TOTAL_BYTES, [] {
+        // 每轮使用新的缓冲区, 读写位置和关闭标志从头开始
+        shm_ring ring;
+        if (shm_ring_create(&ring, 4 * CHUNK) != 0) {
+            return;
+        }
+        do_not_optimize(__via_ring(&ring));
+        shm_ring_free(&ring);
+    }));
+}
@@ -0,0 +1,177 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bench/bench.h"
+
+// 引入 C 语言头文件
+extern "C" {
+#include "io.h"
+}
+
+#define BENCH_SUITE_NAME bench_linux_io__uring
+
+using namespace bench;
+
+/// @brief 测试文件大小
+static const size_t FILE_SIZE = (size_t)256 << 20;
+
+/// @brief 队列深度
+static const uint32_t QUEUE_DEPTH = 64;
+
+/// @brief 参与测试的读取方式及其名称
+static const struct {
+    const char* name;
+    uint32_t block; // 读取块大小
+    bool random;    // 是否随机读取
+    bool direct;    // 是否通过 `O_DIRECT` 绕过页缓存
+    size_t limit;   // 最多读取的块数, 为 `0` 表示读取整个文件
+} PATTERNS[] = {
+    { "rand4k", 4096, true, false, 0 },
+    { "seq128k", 128 * 1024, false, false, 0 },
+    { "direct/rand4k", 4096, true, true, 8192 },
+    { "direct/seq128k", 128 * 1024, false, true, 0 },
+};
+
+/// @brief 创建测试文件, 文件位于当前目录所在的本地文件系统, 关闭后自动删除
+///
+/// @return 文件描述符, 失败时返回 `-1`
+static int __create_file() {
+    char path[] = "bench_uring_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return -1;
+    }
+    unlink(path);
+
+    std::vector<char> chunk(1 << 20, 'x');
+    for (size_t off = 0; off < FILE_SIZE; off += chunk.size()) {
+        if (write(fd, chunk.data(), chunk.size()) != (ssize_t)chunk.size()) {
+            close(fd);
+            return -1;
+        }
+    }
+    fsync(fd);
+    return fd;
+}
+
+/// @brief 生成读取偏移量, 随机读取时为文件内按块对齐的随机位置
+static std::vector<uint64_t> __offsets(uint32_t block, bool random, size_t limit) {
+    size_t n = FILE_SIZE / block;
+    std::vector<uint64_t> offs(limit && limit < n ? limit : n);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < offs.size(); i++) {
+        if (random) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            offs[i] = x % n * block;
+        }
+        else {
+            offs[i] = i * block;
+        }
+    }
+    return offs;
+}
+
+/// @brief 通过异步 IO 队列读取全部偏移量, 保持 `QUEUE_DEPTH` 个请求同时进行
+static void __read_all(uring* ring, const std::vector<uint64_t>& offs, uint32_t block, char* bufs) {
+    std::vector<uring_req> reqs(QUEUE_DEPTH);
+    uring_completion cs[QUEUE_DEPTH];
+
+    // 空闲的缓冲区下标, 请求完成后回收
+    std::vector<uint32_t> free_bufs;
+    for (uint32_t i = 0; i < QUEUE_DEPTH; i++) {
+        free_bufs.push_back(i);
+    }
+
+    size_t next = 0;
+    while (next < offs.size() || uring_inflight(ring) > 0) {
+        size_t n = 0;
+        while (!free_bufs.empty() && next < offs.size()) {
+            uint32_t b = free_bufs.back();
+            free_bufs.pop_back();
+            reqs[n++] = uring_req{ URING_OP_READ, 0, true, 0, bufs + (size_t)b * block, block, offs[next++], b };
+        }
+
+        size_t submitted = 0;
+        uring_submit(ring, reqs.data(), n, &submitted);
+
+        size_t count = 0;
+        uring_poll(ring, cs, QUEUE_DEPTH, 1, &count);
+        for (size_t i = 0; i < count; i++) {
+            if (cs[i].res != (int32_t)block) {
+                abort();
+            }
+            free_bufs.push_back((uint32_t)cs[i].user_data);
+        }
+    }
+}
+
+/// 对比同步 `pread` 和两种异步 IO 实现方式读取本地文件的吞吐量
+///
+/// 不使用 `O_DIRECT` 时文件内容位于页缓存中, 测试结果反映的是系统调用和调度开销;
+/// 使用 `O_DIRECT` 时每次读取都访问设备, 异步 IO 可以令多个请求同时在设备上进行
+BENCH(BENCH_SUITE_NAME, read) {
+    int cached = __create_file();
+    if (cached < 0) {
+        return;
+    }
+
+    // 通过 `/proc/self/fd` 以 `O_DIRECT` 方式重新打开同一文件, 文件系统不支持时跳过相应测试
+    std::string path = "/proc/self/fd/" + std::to_string(cached);
+    int direct = open(path.c_str(), O_RDONLY | O_DIRECT);
+
+    for (const auto& p : PATTERNS) {
+        int fd = p.direct ? direct : cached;
+        if (fd < 0) {
+            continue;
+        }
+
+        std::vector<uint64_t> offs = __offsets(p.block, p.random, p.limit);
+        size_t bytes = offs.size() * p.block;
+
+        // `O_DIRECT` 要求缓冲区按块对齐
+        size_t buf_size = (size_t)p.block * QUEUE_DEPTH;
+        char* bufs = (char*)aligned_alloc(4096, buf_size);
+        std::string prefix = std::string("uring/") + p.name;
+
+        report(measure((prefix + "/pread").c_str(), offs.size(), bytes, [&] {
+            for (uint64_t off : offs) {
+                if (pread(fd, bufs, p.block, (off_t)off) != (ssize_t)p.block) {
+                    abort();
+                }
+            }
+        }));
+
+        for (uring_backend backend : { URING_KERNEL, URING_POOL }) {
+            uring* ring = nullptr;
+            if (uring_create(&ring, QUEUE_DEPTH, backend) != 0) {
+                continue;
+            }
+
+            struct iovec iov = { bufs, buf_size };
+            uring_register_buffers(ring, &iov, 1);
+            uring_register_files(ring, &fd, 1);
+
+            const char* name = uring_backend_of(ring) == URING_KERNEL ? "/io_uring" : "/pool";
+            report(measure((prefix + name).c_str(), offs.size(), bytes, [&] {
+                __read_all(ring, offs, p.block, bufs);
+            }));
+
+            uring_destroy(ring);
+        }
+
+        free(bufs);
+    }
+
+    if (direct >= 0) {
+        close(direct);
+    }
+    close(cached);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef __LINUX__ALLOC_H
+#define __LINUX__ALLOC_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// `hugepage.c` 实现函数
+
+/// @brief 大页内存的分配选项, 可按位组合
+typedef enum __huge_flags {
+	HUGE_PREFAULT = 1 << 0, // 分配时预先写入全部页面, 之后访问不再产生缺页中断
+	HUGE_NO_HUGETLB = 1 << 1, // 不尝试 `MAP_HUGETLB`, 直接使用透明大页
+} huge_flags;
+
+/// @brief 大页内存实际使用的页面类型
+typedef enum __huge_backing {
+	HUGE_BACKING_PAGES = 0, // 普通页面, 分配的内存不足半个大页, 或内核不支持透明大页
+	HUGE_BACKING_HUGETLB,	// 通过 `MAP_HUGETLB` 从预留的大页池 (`/proc/sys/vm/nr_hugepages`) 中分配
+	HUGE_BACKING_THP,		// 通过 `madvise(MADV_HUGEPAGE)` 请求的透明大页, 内核无法凑出连续物理内存时仍可能使用普通页面
+} huge_backing;
+
+/// @brief 当前进程的缺页中断次数
+typedef struct __page_faults {
+	uint64_t minor; // 无需读取磁盘的缺页中断次数, 匿名内存的首次访问属于此类
+	uint64_t major; // 需要读取磁盘的缺页中断次数
+} page_faults;
+
+/// @brief 获取大页大小, 读取自 `/proc/meminfo` 的 `Hugepagesize` 项
+///
+/// @return 大页大小 (字节), 无法读取时为 `2MB`
+size_t huge_page_size(void);
+
+/// @brief 分配按大页对齐的内存, 内容已清零
+///
+/// 依次尝试 `MAP_HUGETLB` 和 `madvise(MADV_HUGEPAGE)`; 使用大页时, 每个大页只产生一次缺页中断, 且只占用一个 TLB 项
+///
+/// 不足半个大页的内存直接使用普通页面, 按页对齐; 其余内存按大页对齐, 大小向上取整为大页大小的整数倍,
+/// 内存信息保存在映射之外, 故恰好为 `N` 个大页的请求只占用 `N` 个大页
+///
+/// @param size 内存大小
+/// @param flags 分配选项, 为 `huge_flags` 的组合
+/// @return 内存指针, 需通过 `huge_free` 函数释放; 分配失败时返回 `NULL`
+void* huge_alloc(size_t size, int flags);
+
+/// @brief 调整通过 `huge_alloc` 函数分配的内存大小, 原有内容保持不变
+///
+/// 已分配的映射足够容纳 `size` 时原地调整; 否则分配新的内存, 复制原有内容后释放原内存
+///
+/// @param ptr 内存指针, 为 `NULL` 时相当于 `huge_alloc`
+/// @param size 新的内存大小
+/// @param flags 需要重新分配时使用的分配选项
+/// @return 内存指针, 失败时返回 `NULL`, 此时原内存保持不变
+void* huge_realloc(void* ptr, size_t size, int flags);
+
+/// @brief 释放通过 `huge_alloc` 或 `huge_realloc` 函数分配的内存
+///
+/// @param ptr 内存指针, 为 `NULL` 时不执行任何操作
+void huge_free(void* ptr);
+
+/// @brief 获取内存实际使用的页面类型
+///
+/// @param ptr 通过 `huge_alloc` 或 `huge_realloc` 函数分配的内存指针
+/// @return 页面类型
+huge_backing huge_backing_of(const void* ptr);
+
+/// @brief 获取当前进程 (包括全部线程) 累计的缺页中断次数, 读取自 `getrusage(RUSAGE_SELF)`
+///
+/// @param faults 指向 `page_faults` 结构体实例的指针
+/// @return `0` 表示成功, 其它值表示失败
+int page_faults_self(page_faults* faults);
+
+#endif // __LINUX__ALLOC_H
@@ -0,0 +1,397 @@
+#pragma once
+
+#ifndef __LINUX__CORO_H
+#define __LINUX__CORO_H
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <queue>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace coro {
+
+	template <typename T = void>
+	class task;
+
+	namespace detail {
+
+		/// @brief 协程结束时恢复等待者 (即 `co_await` 该协程的协程) 的 awaiter
+		///
+		/// 通过对称转移 (symmetric transfer) 直接切换到等待者; 开启编译优化时编译器将其实现为尾调用, 不会随 `co_await` 链增长调用栈
+		struct final_awaiter {
+			bool await_ready() const noexcept { return false; }
+
+			template <typename _Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<_Promise> h) const noexcept {
+				std::coroutine_handle<> next = h.promise().continuation;
+				return next ? next : std::noop_coroutine();
+			}
+
+			void await_resume() const noexcept { }
+		};
+
+		/// @brief `task<T>` 的 promise 公共部分
+		struct promise_base {
+			std::coroutine_handle<> continuation; // 等待者, 协程结束后恢复
+			std::exception_ptr error;			  // 协程中未捕获的异常, 由等待者重新抛出
+
+			std::suspend_always initial_suspend() const noexcept { return {}; }
+			final_awaiter final_suspend() const noexcept { return {}; }
+			void unhandled_exception() noexcept { error = std::current_exception(); }
+		};
+
+		/// @brief `task<T>` 的 promise, 保存协程返回值
+		template <typename T>
+		struct promise : promise_base {
+			std::optional<T> value;
+
+			task<T> get_return_object() noexcept;
+
+			template <typename _U>
+			void return_value(_U&& v) { value.emplace(std::forward<_U>(v)); }
+
+			T result() {
+				if (error) {
+					std::rethrow_exception(error);
+				}
+				return std::move(*value);
+			}
+		};
+
+		/// @brief `task<void>` 的 promise
+		template <>
+		struct promise<void> : promise_base {
+			task<void> get_return_object() noexcept;
+
+			void return_void() const noexcept { }
+
+			void result() {
+				if (error) {
+					std::rethrow_exception(error);
+				}
+			}
+		};
+
+	} // namespace detail
+
+	/// @brief 惰性执行的协程任务
+	///
+	/// 任务创建后不会执行, 直到被 `co_await` (或通过 `executor::spawn`/`executor::block_on` 启动); 任务结束后恢复等待者,
+	/// 并将返回值 (或未捕获的异常) 交给等待者
+	///
+	/// 任务对象持有协程帧, 析构时销毁协程帧, 故任务对象的生命周期必须覆盖协程的执行
+	///
+	/// @tparam T 协程返回值类型
+	template <typename T>
+	class task {
+		using __self = task<T>;
+	public:
+		using promise_type = detail::promise<T>;
+		using handle_type = std::coroutine_handle<promise_type>;
+
+		/// @brief 由协程句柄构造任务
+		explicit task(handle_type h) noexcept : _h(h) { }
+
+		task(const __self&) = delete;
+		__self& operator=(const __self&) = delete;
+
+		/// @brief 移动构造器
+		task(__self&& o) noexcept : _h(std::exchange(o._h, nullptr)) { }
+
+		/// @brief 移动赋值运算符重载
+		__self& operator=(__self&& o) noexcept {
+			if (this != &o) {
+				__destroy();
+				_h = std::exchange(o._h, nullptr);
+			}
+			return *this;
+		}
+
+		/// @brief 析构函数, 销毁协程帧
+		~task() { __destroy(); }
+
+		/// @brief 协程是否已执行完毕
+		bool done() const noexcept { return !_h || _h.done(); }
+
+		/// @brief 等待任务执行完毕, 获取其返回值
+		auto operator co_await() && noexcept {
+			struct awaiter {
+				handle_type h;
+
+				bool await_ready() const noexcept { return !h || h.done(); }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiter) noexcept {
+					h.promise().continuation = waiter;
+					return h;
+				}
+
+				T await_resume() { return h.promise().result(); }
+			};
+			return awaiter{ _h };
+		}
+
+	private:
+		handle_type _h;
+
+		/// @brief 销毁协程帧
+		void __destroy() noexcept {
+			if (_h) {
+				std::exchange(_h, nullptr).destroy();
+			}
+		}
+	};
+
+	namespace detail {
+
+		template <typename T>
+		inline task<T> promise<T>::get_return_object() noexcept {
+			return task<T>(std::coroutine_handle<promise<T>>::from_promise(*this));
+		}
+
+		inline task<void> promise<void>::get_return_object() noexcept {
+			return task<void>(std::coroutine_handle<promise<void>>::from_promise(*this));
+		}
+
+		/// @brief 立即执行, 执行完毕后自行销毁协程帧的协程, 用于执行器驱动通过 `spawn` 启动的任务
+		struct detached {
+			struct promise_type {
+				detached get_return_object() const noexcept { return {}; }
+				std::suspend_never initial_suspend() const noexcept { return {}; }
+				std::suspend_never final_suspend() const noexcept { return {}; }
+				void return_void() const noexcept { }
+				void unhandled_exception() const noexcept { std::terminate(); }
+			};
+		};
+
+		/// @brief 获取当前协程句柄的 awaiter, 不会挂起协程
+		struct current_handle {
+			std::coroutine_handle<> h;
+
+			bool await_ready() const noexcept { return false; }
+			bool await_suspend(std::coroutine_handle<> self) noexcept {
+				h = self;
+				return false;
+			}
+			std::coroutine_handle<> await_resume() const noexcept { return h; }
+		};
+
+	} // namespace detail
+
+	/// @brief 子进程的执行结果
+	struct child_result {
+		std::string out; // 子进程标准输出的内容
+		int status;		 // 子进程状态值, 可通过 `WIFEXITED` 等宏解析
+	};
+
+	/// @brief 基于 epoll 的单线程协程执行器
+	///
+	/// 所有协程都在调用 `run` (或 `block_on`) 的线程中执行; 协程等待 IO, 子进程或定时器时挂起, 由执行器在事件就绪时恢复,
+	/// 故一个线程可以同时等待数千个管道和子进程
+	///
+	/// 执行器不是线程安全的, 只能在创建它的线程中使用
+	class executor {
+	public:
+		using clock = std::chrono::steady_clock;
+
+		/// @brief 创建执行器, 失败时抛出 `std::system_error`
+		executor();
+
+		executor(const executor&) = delete;
+		executor& operator=(const executor&) = delete;
+
+		/// @brief 析构函数
+		///
+		/// 销毁仍处于挂起状态 (例如 `run` 因异常提前返回) 的任务, 这些任务不会再被恢复
+		~executor();
+
+		/// @brief 启动一个任务, 执行到第一次挂起时返回, 之后由 `run` 继续执行
+		///
+		/// 执行器接管任务对象; 任务中未捕获的异常会由 `run` 重新抛出
+		///
+		/// @param t 任务
+		void spawn(task<void> t);
+
+		/// @brief 执行事件循环, 直到通过 `spawn` 启动的全部任务执行完毕
+		///
+		/// 所有任务都在等待, 但既没有被监视的句柄也没有定时器时, 任务永远无法恢复, 此时抛出 `std::logic_error`
+		void run();
+
+		/// @brief 启动任务, 执行事件循环直到全部任务执行完毕, 并返回该任务的返回值
+		///
+		/// @tparam T 任务返回值类型
+		/// @param t 任务
+		/// @return 任务返回值
+		template <typename T>
+		T block_on(task<T> t) {
+			if constexpr (std::is_void_v<T>) {
+				spawn(std::move(t));
+				run();
+			}
+			else {
+				std::optional<T> result;
+				spawn(__store(std::move(t), result));
+				run();
+				return std::move(*result);
+			}
+		}
+
+		/// @brief 已启动但尚未执行完毕的任务数
+		size_t pending() const noexcept { return _pending; }
+
+		/// @brief 等待句柄就绪的 awaiter, 同一句柄同一时刻只能有一个协程等待
+		class fd_awaiter;
+
+		/// @brief 等待定时器到期的 awaiter
+		class timer_awaiter;
+
+		/// @brief 等待句柄可读
+		///
+		/// 句柄必须支持 epoll (例如管道, 套接字, pidfd 等), 普通文件会导致 `co_await` 抛出 `std::system_error`
+		///
+		/// @param fd 句柄
+		/// @return awaiter, `co_await` 的结果为就绪的 epoll 事件
+		fd_awaiter readable(int fd);
+
+		/// @brief 等待句柄可写
+		///
+		/// @param fd 句柄
+		/// @return awaiter, `co_await` 的结果为就绪的 epoll 事件
+		fd_awaiter writable(int fd);
+
+		/// @brief 等待指定时长
+		///
+		/// @param d 时长
+		/// @return awaiter
+		timer_awaiter sleep_for(clock::duration d);
+
+		/// @brief 等待到指定时刻
+		///
+		/// @param deadline 时刻
+		/// @return awaiter
+		timer_awaiter sleep_until(clock::time_point deadline);
+
+		/// @brief 从非阻塞句柄读取数据, 没有数据时挂起等待
+		///
+		/// @param fd 非阻塞句柄 (设置了 `O_NONBLOCK`)
+		/// @param buf 读取缓冲区
+		/// @param len 缓冲区长度
+		/// @return 读取的字节数, 为 `0` 表示读到 EOF; 读取失败时抛出 `std::system_error`
+		task<size_t> read(int fd, void* buf, size_t len);
+
+		/// @brief 从非阻塞句柄读取全部数据, 直到 EOF
+		///
+		/// @param fd 非阻塞句柄 (设置了 `O_NONBLOCK`)
+		/// @return 读取的全部数据
+		task<std::string> read_all(int fd);
+
+		/// @brief 等待子进程退出并回收子进程
+		///
+		/// 通过 pidfd 等待子进程退出; 内核不支持 pidfd (低于 5.3) 时, 每隔 10 毫秒检查一次
+		///
+		/// @param pid 子进程 ID, 必须为当前进程的子进程
+		/// @return 子进程状态值
+		task<int> wait_exit(pid_t pid);
+
+		/// @brief 在子进程中运行可执行文件, 读取其标准输出并等待其退出
+		///
+		/// 子进程通过 `posix_spawn` 创建, 标准错误和主进程相同
+		///
+		/// @param path 可执行文件路径
+		/// @param argv 命令行参数列表, 以 `NULL` 结尾
+		/// @return 子进程的标准输出和状态值; 无法创建子进程时抛出 `std::system_error`
+		task<child_result> exec(const char* path, char* const argv[]);
+
+	private:
+		/// @brief 挂起的协程及其等待的事件
+		struct waiter {
+			std::coroutine_handle<> handle; // 挂起的协程
+			int fd;							// 等待的句柄, 等待定时器时为 `-1`
+			uint32_t events;				// 就绪的 epoll 事件
+		};
+
+		/// @brief 定时器
+		struct timer {
+			clock::time_point deadline; // 到期时刻
+			uint64_t seq;				// 添加顺序, 到期时刻相同时先添加的先到期
+			waiter* w;					// 等待定时器的协程
+
+			bool operator>(const timer& o) const noexcept {
+				return deadline != o.deadline ? deadline > o.deadline : seq > o.seq;
+			}
+		};
+
+		int _epfd;											  // epoll 句柄
+		size_t _pending;									  // 尚未执行完毕的任务数
+		size_t _watching;									  // 正在等待的句柄数
+		uint64_t _timer_seq;								  // 下一个定时器的添加顺序
+		std::priority_queue<timer, std::vector<timer>, std::greater<timer>> _timers; // 按到期时刻排列的定时器
+		std::exception_ptr _error;							  // 第一个任务中未捕获的异常
+		std::unordered_set<void*> _drivers;					  // 尚未执行完毕的任务的驱动协程帧地址
+
+		/// @brief 令协程等待句柄就绪
+		void __watch(waiter* w, uint32_t events);
+
+		/// @brief 令协程等待定时器到期
+		void __add_timer(waiter* w, clock::time_point deadline);
+
+		/// @brief 恢复全部已到期定时器的协程
+		///
+		/// @return 距下一个定时器到期的毫秒数, 没有定时器时返回 `-1`
+		int __fire_timers();
+
+		/// @brief 执行任务, 并在执行完毕后减少未完成的任务数
+		detail::detached __drive(task<void> t);
+
+		/// @brief 执行任务并保存其返回值, 用于 `block_on`
+		template <typename T>
+		static task<void> __store(task<T> t, std::optional<T>& out) {
+			out.emplace(co_await std::move(t));
+		}
+	};
+
+	class executor::fd_awaiter {
+	public:
+		fd_awaiter(executor& ex, int fd, uint32_t events) noexcept : _ex(ex), _w{ nullptr, fd, events } { }
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> h) {
+			_w.handle = h;
+			_ex.__watch(&_w, _w.events);
+		}
+		uint32_t await_resume() const noexcept { return _w.events; }
+
+	private:
+		executor& _ex;
+		waiter _w;
+	};
+
+	class executor::timer_awaiter {
+	public:
+		timer_awaiter(executor& ex, clock::time_point deadline) noexcept
+			: _ex(ex), _deadline(deadline), _w{ nullptr, -1, 0 } { }
+
+		bool await_ready() const noexcept { return _deadline <= clock::now(); }
+		void await_suspend(std::coroutine_handle<> h) {
+			_w.handle = h;
+			_ex.__add_timer(&_w, _deadline);
+		}
+		void await_resume() const noexcept { }
+
+	private:
+		executor& _ex;
+		clock::time_point _deadline;
+		waiter _w;
+	};
+
+} // namespace coro
+
+#endif // __LINUX__CORO_H
@@ -0,0 +1,122 @@
+#pragma once
+
+#ifndef __LINUX__CPU_H
+#define __LINUX__CPU_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// `placement.c` 实现函数
+
+/// @brief 工作线程 (或工作进程) 在 CPU 上的放置方式
+typedef enum __placement_mode {
+	PLACEMENT_NONE = 0, // 不绑定 CPU, 由调度器决定
+	PLACEMENT_COMPACT,	// 紧凑放置: 依次占满同一节点, 同一物理核心的各个超线程, 适合共享数据较多的工作者
+	PLACEMENT_SCATTER,	// 分散放置: 轮流使用各节点, 先占满物理核心再使用超线程, 适合相互独立的计算密集型工作者
+} placement_mode;
+
+/// @brief 单个 CPU 的拓扑信息
+typedef struct __cpu_info {
+	int cpu;	 // CPU 编号
+	int node;	 // 所属 NUMA 节点, 无法获取时为 `0`
+	int package; // 所属物理 CPU (插槽)
+	int core;	 // 物理核心编号, 同一物理核心的各个超线程相同
+} cpu_info;
+
+/// @brief 当前进程可用 CPU 的布局
+typedef struct __cpu_layout {
+	size_t count;	  // 可用 CPU 数, 即 `sched_getaffinity` 返回的 CPU 数量
+	size_t usable;	  // 实际可同时运行的线程数, 为 `count` 和 cgroup CPU 配额中的较小值
+	cpu_info* cpus;	  // 可用 CPU 的拓扑信息, 按紧凑放置的顺序 (节点, 插槽, 物理核心, CPU 编号) 排列
+	size_t* scatter;  // 分散放置时依次使用的 `cpus` 数组下标
+} cpu_layout;
+
+/// @brief 读取当前进程所在 cgroup 的 CPU 配额, 相当于 `cgroup_cpu_quota_at("/sys/fs/cgroup", "/proc/self/cgroup")`
+///
+/// @return CPU 配额 (向上取整), 未设置配额时返回 `0`
+size_t cgroup_cpu_quota(void);
+
+/// @brief 读取指定 cgroup 文件系统中, 进程所在 cgroup 的 CPU 配额
+///
+/// 从 `self_cgroup` 文件 (格式同 `/proc/self/cgroup`) 中获取进程所在的 cgroup 路径: cgroup v2 为 `0::<path>` 行,
+/// 读取 `<root>/<path>` 及其各级父目录中的 `cpu.max` 文件 (格式为 `<quota> <period>` 或 `max <period>`);
+/// cgroup v1 为包含 `cpu` 控制器的行, 读取 `<root>/cpu/<path>` 及其各级父目录中的
+/// `cpu.cfs_quota_us`/`cpu.cfs_period_us` 文件. 父级的配额同样限制子级, 故取各级配额中的最小值
+///
+/// 例如 systemd 服务通过 `CPUQuota=` 设置的配额位于服务自身的 cgroup 目录中, 而非 cgroup 挂载点
+///
+/// @param root cgroup 文件系统的挂载点, 例如 `/sys/fs/cgroup`
+/// @param self_cgroup 描述进程所在 cgroup 的文件, 例如 `/proc/self/cgroup`
+/// @return CPU 配额 (向上取整), 未设置配额时返回 `0`
+size_t cgroup_cpu_quota_at(const char* root, const char* self_cgroup);
+
+/// @brief 获取当前进程可用的 CPU 数量
+///
+/// 取 `sched_getaffinity` 返回的 CPU 数量和 cgroup CPU 配额之间的较小值
+///
+/// @return 可用的 CPU 数量, 至少为 `1`
+size_t available_cpus(void);
+
+/// @brief 读取当前进程可用 CPU 的布局
+///
+/// 拓扑信息读取自 `/sys/devices/system/cpu/cpu<N>/topology` 目录, 所属节点通过 `cpu<N>/node<M>` 目录项确定
+///
+/// @param layout 指向 `cpu_layout` 结构体实例的指针
+/// @return `0` 表示成功, 其它值表示失败
+int cpu_layout_init(cpu_layout* layout);
+
+/// @brief 根据给定的 CPU 拓扑信息构建布局, 计算紧凑和分散两种放置方式的 CPU 顺序
+///
+/// @param layout 指向 `cpu_layout` 结构体实例的指针
+/// @param cpus CPU 拓扑信息数组, 顺序任意
+/// @param count CPU 个数
+/// @param quota cgroup CPU 配额, 为 `0` 表示不限制
+/// @return `0` 表示成功, 其它值表示失败
+int cpu_layout_build(cpu_layout* layout, const cpu_info* cpus, size_t count, size_t quota);
+
+/// @brief 释放 CPU 布局占用的内存
+///
+/// @param layout 指向 `cpu_layout` 结构体实例的指针
+void cpu_layout_free(cpu_layout* layout);
+
+/// @brief 按放置方式为第 `index` 个工作者选择 CPU
+///
+/// 工作者数超过 `usable` 时循环使用前 `usable` 个 CPU
+///
+/// @param layout 指向 `cpu_layout` 结构体实例的指针
+/// @param mode 放置方式
+/// @param index 工作者下标
+/// @return CPU 编号, `mode` 为 `PLACEMENT_NONE` 时返回 `-1`
+int cpu_layout_pick(const cpu_layout* layout, placement_mode mode, size_t index);
+
+/// @brief 获取默认的放置方式
+///
+/// 读取环境变量 `LINUX_PLACEMENT`, 可选值为 `none`, `compact` 和 `scatter`, 未设置或无法识别时为 `none` (不绑定 CPU);
+/// 绑定 CPU 只能通过该环境变量或显式传入放置方式开启
+///
+/// @return 放置方式
+placement_mode placement_default(void);
+
+/// @brief 将当前线程绑定到指定的 CPU
+///
+/// 在多线程程序中, `sched_setaffinity(0, ...)` 只作用于调用线程, 故本函数也可用于工作进程的主线程
+///
+/// @param cpu CPU 编号, 为负数时不进行绑定
+/// @return `0` 表示成功, 其它值表示失败
+int pin_current(int cpu);
+
+/// @brief 分配内存, 并在当前线程中逐页写入, 令物理页按 first-touch 策略分配在当前线程所在的 NUMA 节点上
+///
+/// 应在工作者完成 CPU 绑定之后, 由工作者自身调用
+///
+/// @param size 内存大小
+/// @return 内存指针, 已清零, 分配失败时返回 `NULL`
+void* alloc_local(size_t size);
+
+/// @brief 释放通过 `alloc_local` 函数分配的内存
+///
+/// @param ptr 内存指针
+/// @param size 内存大小, 必须和分配时相同
+void free_local(void* ptr, size_t size);
+
+#endif // __LINUX__CPU_H
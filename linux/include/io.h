@@ -3,7 +3,10 @@
 #ifndef __LINUX__IO_H
 #define __LINUX__IO_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <sys/uio.h>
 
 // `io.redirect.c` 实现函数
 
@@ -24,15 +27,300 @@ void* fd_redirect_to_memory_begin(int fileno);
 ///
 /// 该函数的执行流程为:
 ///
-/// 1. 创建一个 "内存数据流", 得到该数据流的 `FILE*` 指针;
-/// 2. 从 "读管道" 读取数据, 这些数据被写入到原始文件描述符, 并被重定向到 "写管道";
-/// 3. 将读取的数据写入到 "内存数据流", 直到所有数据被读取;
-/// 4. 恢复原始文件描述符原本的指向, 相当于恢复其重定向;
-/// 5. 关闭相关的文件描述符和 "内存数据流";
+/// 1. 从 "读管道" 读取数据, 这些数据被写入到原始文件描述符, 并被重定向到 "写管道";
+/// 2. 将读取的数据直接读入按倍数扩容的捕获缓冲区, 直到所有数据被读取 (由 `fd_redirect_to_memory_async_begin`
+///    函数创建的重定向, 则等待后台线程读取完毕);
+/// 3. 恢复原始文件描述符原本的指向, 相当于恢复其重定向;
+/// 4. 关闭相关的文件描述符, 将捕获缓冲区作为结果返回;
 ///
 /// @param h 句柄指针, 本质上为 `memory_redirect` 结构体实例指针
-/// @return 字符串指针, 指向被重定向 IO 输出的内容
+/// @param result_len 用于保存输出内容长度的指针
+/// @return 字符串指针, 指向被重定向 IO 输出的内容, 需通过 `free` 函数释放; 失败时返回 `NULL`
 char* fd_redirect_to_memory_end(void* h, size_t* result_len);
 
+/// @brief 开始将指定的输出 IO 的文件描述符重定向到内存空间, 并由后台线程持续读取
+///
+/// `fd_redirect_to_memory_begin` 函数在结束前不读取管道, 输出内容超过管道容量后写入方会一直阻塞;
+/// 本函数创建的重定向在整个过程中持续读取管道, 可以捕获任意长度的输出
+///
+/// 该函数的执行流程为:
+///
+/// 1. 和 `fd_redirect_to_memory_begin` 函数相同, 将 `fileno` 重定向到 "写管道", 并通过 `F_SETPIPE_SZ` 增大管道容量;
+/// 2. 启动后台线程, 以阻塞模式从 "读管道" 读取数据, 直接读入按倍数扩容的捕获缓冲区中;
+///
+/// 结束时同样调用 `fd_redirect_to_memory_end` 函数, 该函数先恢复原始文件描述符并关闭 "写管道",
+/// 待后台线程读取完剩余数据后返回结果; 若重定向期间创建的子进程仍持有 `fileno`, 则需等待子进程关闭该描述符.
+/// 后台线程读取失败 (例如内存不足) 后仍会读取并丢弃其余数据, 不会令写入方阻塞, 此时 `fd_redirect_to_memory_end` 返回 `NULL`
+///
+/// @param fileno 输出 IO 文件描述符
+/// @return 句柄指针, 本质上为 `memory_redirect` 结构体实例指针, 失败时返回 `NULL`
+void* fd_redirect_to_memory_async_begin(int fileno);
+
+/// @brief 开始将指定的输出 IO 的文件描述符重定向到匿名内存文件 (`memfd_create`)
+///
+/// 和重定向到管道相比, 写入方直接写入内存文件的页缓存, 不会因无人读取而阻塞, 也不需要读取线程;
+/// 结束时将内存文件映射到地址空间中, 不再复制数据
+///
+/// 该函数的执行流程为:
+///
+/// 1. 复制 `fileno` 参数表示的文件描述符, 用于在结束时恢复;
+/// 2. 通过 `memfd_create` 创建匿名内存文件, 并将 `fileno` 重定向到该文件;
+///
+/// @param fileno 输出 IO 文件描述符
+/// @return 句柄指针, 本质上为 `memfd_redirect` 结构体实例指针, 失败时返回 `NULL`
+void* fd_redirect_to_memfd_begin(int fileno);
+
+/// @brief 结束重定向到匿名内存文件, 返回内存文件内容的只读映射
+///
+/// 该函数的执行流程为:
+///
+/// 1. 恢复原始文件描述符原本的指向;
+/// 2. 将匿名内存文件以只读方式映射到地址空间中, 之后关闭文件 (映射保持文件内容有效);
+///
+/// 注意返回的内容不以 `\0` 结尾
+///
+/// @param h 句柄指针, 本质上为 `memfd_redirect` 结构体实例指针
+/// @param result_len 用于保存输出内容长度的指针
+/// @return 输出内容的只读映射, 需通过 `fd_redirect_memfd_free` 函数释放; 失败时返回 `NULL`
+char* fd_redirect_to_memfd_end(void* h, size_t* result_len);
+
+/// @brief 释放 `fd_redirect_to_memfd_end` 函数返回的映射
+///
+/// @param data 映射地址
+/// @param len 输出内容长度
+void fd_redirect_memfd_free(char* data, size_t len);
+
+/// @brief 通过 `splice`/`tee` 转发重定向输出的统计信息
+typedef struct __fd_splice_stats {
+	uint64_t bytes;		  // 转发到目标文件的字节数
+	double seconds;		  // 从开始重定向到转发完毕的时间 (秒)
+	double bytes_per_sec; // 平均每秒转发的字节数
+} fd_splice_stats;
+
+/// @brief 开始将指定的输出 IO 的文件描述符重定向到文件, 同时复制一份到另一个管道
+///
+/// 该函数的执行流程为:
+///
+/// 1. 复制 `fileno` 参数表示的文件描述符, 用于在结束时恢复, 并将 `fileno` 重定向到 "写管道";
+/// 2. 启动后台线程, 通过 `tee` 将 "读管道" 中的数据复制到 `tap_fd` 管道, 再通过 `splice` 将同样的数据移动到 `file_fd`;
+///
+/// 数据始终在内核中移动, 不经过用户空间; `tap_fd` 的读取方需及时读取, 否则管道写满后转发线程会阻塞
+/// `tap_fd` 的读取方关闭管道后, 停止复制, 其余数据仍转发到 `file_fd`, 不会产生 `SIGPIPE`
+///
+/// @param fileno 输出 IO 文件描述符
+/// @param file_fd 目标文件描述符, 不支持 `splice` 的文件 (例如以 `O_APPEND` 方式打开) 会改为经由用户空间复制
+/// @param tap_fd 第二个消费者的管道 "写" 句柄, 必须为管道; 为 `-1` 时只转发到目标文件
+/// @return 句柄指针, 本质上为 `splice_redirect` 结构体实例指针, 失败时返回 `NULL`
+void* fd_tee_begin(int fileno, int file_fd, int tap_fd);
+
+/// @brief 开始将指定的输出 IO 的文件描述符重定向到文件, 相当于 `fd_tee_begin(fileno, file_fd, -1)`
+///
+/// 和直接通过 `dup2` 令 `fileno` 指向文件相比, 写入方只写入管道, 不会因文件系统的写入延迟而阻塞
+///
+/// @param fileno 输出 IO 文件描述符
+/// @param file_fd 目标文件描述符
+/// @return 句柄指针, 本质上为 `splice_redirect` 结构体实例指针, 失败时返回 `NULL`
+void* fd_redirect_to_file_begin(int fileno, int file_fd);
+
+/// @brief 结束由 `fd_redirect_to_file_begin` 或 `fd_tee_begin` 函数开始的重定向
+///
+/// 恢复原始文件描述符, 等待后台线程转发完剩余数据; 不关闭 `file_fd` 和 `tap_fd`
+///
+/// @param h 句柄指针, 本质上为 `splice_redirect` 结构体实例指针
+/// @param stats 用于保存统计信息的指针, 可以为 `NULL`
+/// @return `0` 表示成功, 其它值表示转发过程中发生的错误
+int fd_redirect_to_file_end(void* h, fd_splice_stats* stats);
+
+// `io.uring.c` 实现函数
+
+/// @brief 异步文件 IO 的实现方式
+typedef enum __uring_backend {
+	URING_AUTO = 0, // 使用 `uring_backend_default` 函数返回的方式
+	URING_KERNEL,	// 内核 io_uring, 通过 `io_uring_setup`/`io_uring_enter`/`io_uring_register` 系统调用直接使用, 不依赖 liburing
+	URING_POOL,		// 线程池, 各请求由工作线程通过 `pread`/`pwrite` 完成, 用于内核不支持 (或禁用了) io_uring 的情况
+} uring_backend;
+
+/// @brief 异步请求的操作类型
+typedef enum __uring_op {
+	URING_OP_READ = 0, // 读取, 相当于 `pread`
+	URING_OP_WRITE,	   // 写入, 相当于 `pwrite`
+} uring_op;
+
+/// @brief 异步 IO 请求
+typedef struct __uring_req {
+	uring_op op;		// 操作类型
+	int fd;				// 文件句柄, `fixed_file` 为 `true` 时为 `uring_register_files` 注册的文件下标
+	bool fixed_file;	// `fd` 是否为已注册文件的下标
+	int buf_index;		// `buf` 所属的已注册缓冲区下标 (参见 `uring_register_buffers` 函数), 为 `-1` 表示未注册
+	void* buf;			// 读写缓冲区, 在请求完成前不能释放
+	uint32_t len;		// 读写字节数
+	uint64_t offset;	// 文件偏移量
+	uint64_t user_data; // 调用方数据, 原样返回在对应的 `uring_completion` 中
+} uring_req;
+
+/// @brief 异步 IO 请求的完成结果
+typedef struct __uring_completion {
+	uint64_t user_data; // 对应请求的 `user_data` 字段
+	int32_t res;		// 实际读写的字节数, 失败时为负的错误值 (`-errno`)
+} uring_completion;
+
+/// @brief 异步 IO 队列, 具体定义参见 `uring.c`
+///
+/// 队列不是线程安全的, 同一时刻只能由一个线程提交请求和获取结果
+typedef struct __uring uring;
+
+/// @brief 获取异步 IO 的默认实现方式
+///
+/// 读取环境变量 `LINUX_URING`, 值为 `pool` 时为 `URING_POOL`, 否则为 `URING_KERNEL`
+///
+/// @return 实现方式
+uring_backend uring_backend_default(void);
+
+/// @brief 创建异步 IO 队列
+///
+/// 使用 `URING_KERNEL` 方式时, 若内核不支持 io_uring (或不支持 `IORING_OP_READ`/`IORING_OP_WRITE` 操作),
+/// 自动改用 `URING_POOL` 方式, 实际使用的方式可通过 `uring_backend_of` 函数获取
+///
+/// @param ring 用于保存队列指针的指针
+/// @param entries 队列深度, 即最多同时提交的请求数, 向上取整为 `2` 的幂
+/// @param backend 实现方式
+/// @return `0` 表示成功, 其它值表示失败
+int uring_create(uring** ring, uint32_t entries, uring_backend backend);
+
+/// @brief 销毁异步 IO 队列, 等待已提交的请求全部完成, 之后调用方才可以释放请求使用的缓冲区
+///
+/// @param ring 队列指针
+void uring_destroy(uring* ring);
+
+/// @brief 获取队列实际使用的实现方式
+///
+/// @param ring 队列指针
+/// @return 实现方式, 为 `URING_KERNEL` 或 `URING_POOL`
+uring_backend uring_backend_of(const uring* ring);
+
+/// @brief 注册缓冲区, 内核预先固定缓冲区所在的内存页, 之后的请求无需每次映射
+///
+/// 只能注册一次; `URING_POOL` 方式下只记录缓冲区个数, 用于检查请求的 `buf_index` 字段
+///
+/// @param ring 队列指针
+/// @param iovs 缓冲区数组, 请求的 `buf` 和 `len` 字段必须位于 `iovs[buf_index]` 范围内
+/// @param n 缓冲区个数
+/// @return `0` 表示成功, 其它值表示失败
+int uring_register_buffers(uring* ring, const struct iovec* iovs, uint32_t n);
+
+/// @brief 注册文件, 之后的请求可通过下标引用文件, 内核无需每次查找文件句柄
+///
+/// 只能注册一次
+///
+/// @param ring 队列指针
+/// @param fds 文件句柄数组
+/// @param n 文件个数
+/// @return `0` 表示成功, 其它值表示失败
+int uring_register_files(uring* ring, const int* fds, uint32_t n);
+
+/// @brief 批量提交请求, 一次系统调用提交全部请求
+///
+/// 已提交但尚未通过 `uring_poll` 函数取走结果的请求数不能超过队列深度, 超出的请求不会被提交
+///
+/// @param ring 队列指针
+/// @param reqs 请求数组
+/// @param n 请求个数
+/// @param submitted 用于保存实际提交的请求数的指针; 失败时为失败前已提交的请求数, 这些请求仍需通过 `uring_poll` 函数取走结果
+/// @return `0` 表示成功, 其它值表示失败
+int uring_submit(uring* ring, const uring_req* reqs, size_t n, size_t* submitted);
+
+/// @brief 获取已完成请求的结果
+///
+/// 完成的顺序和提交的顺序无关, 需通过 `user_data` 字段区分请求
+///
+/// @param ring 队列指针
+/// @param out 用于保存结果的数组
+/// @param max `out` 数组的长度
+/// @param min 至少等待的结果数, 为 `0` 时不等待; 超过未完成的请求数时按未完成的请求数等待
+/// @param count 用于保存实际获取的结果数的指针
+/// @return `0` 表示成功, 其它值表示失败
+int uring_poll(uring* ring, uring_completion* out, size_t max, size_t min, size_t* count);
+
+/// @brief 获取已提交但尚未取走结果的请求数
+///
+/// @param ring 队列指针
+/// @return 请求数
+size_t uring_inflight(const uring* ring);
+
+// `io.mapped.c` 实现函数
+
+/// @brief 映射文件时的选项, 可按位组合
+typedef enum __mapped_flags {
+	MAPPED_POPULATE = 1 << 0,	// 通过 `MAP_POPULATE` 在映射时预先读入全部页面, 之后访问不再产生缺页中断
+	MAPPED_SEQUENTIAL = 1 << 1, // 通过 `madvise(MADV_SEQUENTIAL)` 提示内核加大预读, 并尽早回收已访问的页面
+	MAPPED_WILLNEED = 1 << 2,	// 通过 `madvise(MADV_WILLNEED)` 令内核立即在后台预读映射范围
+	MAPPED_HUGEPAGE = 1 << 3,	// 通过 `madvise(MADV_HUGEPAGE)` 请求使用透明大页, 需内核支持文件页的透明大页, 否则没有效果
+} mapped_flags;
+
+/// @brief 以只读方式映射的文件
+///
+/// 文件大小不超过地址空间预算 (`window`) 时映射整个文件; 否则每次只映射一个窗口, 访问窗口以外的范围时重新映射
+typedef struct __mapped_file {
+	int fd;			 // 文件句柄
+	uint64_t size;	 // 文件大小
+	size_t window;	 // 窗口大小, 即最多同时映射的字节数, 按页大小对齐; 映射整个文件时等于文件大小
+	int flags;		 // 映射选项, 为 `mapped_flags` 的组合
+	char* addr;		 // 当前窗口的映射地址, 没有映射时为 `NULL`
+	uint64_t offset; // 当前窗口在文件中的起始偏移量
+	size_t len;		 // 当前窗口的长度
+} mapped_file;
+
+/// @brief 打开并映射文件
+///
+/// @param mf 指向 `mapped_file` 结构体实例的指针
+/// @param path 文件路径
+/// @param window 地址空间预算 (字节), 为 `0` 表示不限制, 即映射整个文件; 不能小于 `2` 个页面
+/// @param flags 映射选项, 为 `mapped_flags` 的组合
+/// @return `0` 表示成功, 其它值表示失败
+int mapped_open(mapped_file* mf, const char* path, size_t window, int flags);
+
+/// @brief 解除映射并关闭文件
+///
+/// @param mf 指向 `mapped_file` 结构体实例的指针
+void mapped_close(mapped_file* mf);
+
+/// @brief 获取文件中指定范围的内容, 范围不在当前窗口内时重新映射窗口
+///
+/// 重新映射后, 之前通过本函数 (或 `mapped_iter_next` 函数) 获取的指针失效
+///
+/// @param mf 指向 `mapped_file` 结构体实例的指针
+/// @param offset 范围在文件中的起始偏移量
+/// @param len 范围长度, 不能超出文件末尾, 且加上页对齐的偏差后不能超过窗口大小
+/// @param data 用于保存内容指针的指针
+/// @return `0` 表示成功, `E2BIG` 表示范围超过窗口大小, 其它值表示失败
+int mapped_view(mapped_file* mf, uint64_t offset, size_t len, const char** data);
+
+/// @brief 按行边界切分文件的迭代器
+typedef struct __mapped_iter {
+	mapped_file* mf; // 被迭代的文件
+	uint64_t pos;	 // 下一块的起始偏移量
+	size_t chunk;	 // 期望的块大小
+} mapped_iter;
+
+/// @brief 初始化迭代器
+///
+/// @param it 指向 `mapped_iter` 结构体实例的指针
+/// @param mf 指向 `mapped_file` 结构体实例的指针
+/// @param chunk 期望的块大小, 超过窗口大小时按窗口大小处理
+void mapped_iter_init(mapped_iter* it, mapped_file* mf, size_t chunk);
+
+/// @brief 获取下一块内容
+///
+/// 除文件最后一块外, 每块都以 `\n` 结尾, 即每块都包含若干完整的行, 可以交给不同的线程独立解析;
+/// 块在期望大小以内的最后一个 `\n` 处结束, 若其中没有 `\n`, 则延长到下一个 `\n`
+///
+/// 映射整个文件时, 各块的指针在 `mapped_close` 之前一直有效; 按窗口映射时, 下一次调用可能令之前的指针失效
+///
+/// @param it 指向 `mapped_iter` 结构体实例的指针
+/// @param data 用于保存块内容指针的指针
+/// @param len 用于保存块长度的指针, 已到达文件末尾时设置为 `0`
+/// @return `0` 表示成功, `E2BIG` 表示一行的长度超过窗口大小, 其它值表示失败
+int mapped_iter_next(mapped_iter* it, const char** data, size_t* len);
+
 #endif // !__LINUX__IO_H
 
@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef __LINUX__PERF_H
+#define __LINUX__PERF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// `counter.c` 实现函数
+
+/// @brief 性能计数器
+typedef enum __perf_counter_id {
+	PERF_CYCLES = 0,	   // CPU 周期数 (硬件计数器)
+	PERF_INSTRUCTIONS,	   // 执行的指令数 (硬件计数器)
+	PERF_CACHE_MISSES,	   // 末级缓存未命中次数 (硬件计数器)
+	PERF_BRANCH_MISSES,	   // 分支预测失败次数 (硬件计数器)
+	PERF_TASK_CLOCK,	   // 占用 CPU 的时间, 单位为纳秒 (软件计数器)
+	PERF_PAGE_FAULTS,	   // 缺页中断次数 (软件计数器)
+	PERF_CONTEXT_SWITCHES, // 上下文切换次数 (软件计数器)
+	PERF_COUNTER_COUNT,	   // 计数器个数
+} perf_counter_id;
+
+/// @brief 一组性能计数器
+///
+/// 虚拟机和容器中通常无法使用硬件计数器, 此时只有软件计数器可用, 可通过 `perf_counter_available` 函数判断
+typedef struct __perf_counters {
+	int fds[PERF_COUNTER_COUNT];		  // 各计数器的 `perf_event_open` 句柄, 不可用时为 `-1`
+	uint64_t values[PERF_COUNTER_COUNT];  // 各计数器在最近一次 `perf_counters_start` 和 `perf_counters_stop` 之间的计数
+} perf_counters;
+
+/// @brief 获取计数器名称, 和 `perf stat` 命令输出的名称相同
+///
+/// @param id 计数器
+/// @return 计数器名称
+const char* perf_counter_name(perf_counter_id id);
+
+/// @brief 打开当前进程 (包括其中全部线程) 的性能计数器
+///
+/// 各计数器相互独立, 部分计数器无法打开时 (例如没有硬件计数器, 或 `perf_event_paranoid` 的限制) 其余计数器仍可使用
+///
+/// @param pc 指向 `perf_counters` 结构体实例的指针
+/// @param inherit 是否同时统计打开计数器之后创建的子进程和线程
+/// @return `0` 表示至少一个计数器可用, 否则为最后一个计数器打开失败的错误值
+int perf_counters_open(perf_counters* pc, bool inherit);
+
+/// @brief 关闭性能计数器
+///
+/// @param pc 指向 `perf_counters` 结构体实例的指针
+void perf_counters_close(perf_counters* pc);
+
+/// @brief 判断计数器是否可用
+///
+/// @param pc 指向 `perf_counters` 结构体实例的指针
+/// @param id 计数器
+/// @return 是否可用
+bool perf_counter_available(const perf_counters* pc, perf_counter_id id);
+
+/// @brief 清零并开始计数, 和 `perf_counters_stop` 函数构成一个计数范围
+///
+/// @param pc 指向 `perf_counters` 结构体实例的指针
+void perf_counters_start(perf_counters* pc);
+
+/// @brief 停止计数, 并将计数保存到 `values` 字段
+///
+/// 计数器数量超过硬件支持的数量时, 内核会分时复用硬件计数器, 此时按实际计数时间的比例估算计数
+///
+/// @param pc 指向 `perf_counters` 结构体实例的指针
+void perf_counters_stop(perf_counters* pc);
+
+/// @brief 将可用计数器的计数格式化为一行文本, 并在硬件计数器可用时附加 IPC (每周期指令数) 等推导指标
+///
+/// 例如 `task-clock=1.234ms page-faults=12 context-switches=0 cycles=4567 instructions=8901 IPC=1.95`
+///
+/// @param pc 指向 `perf_counters` 结构体实例的指针
+/// @param buf 输出缓冲区
+/// @param len 输出缓冲区长度
+/// @return 完整输出所需的字符数 (不包括结尾的 `\0`), 和 `snprintf` 相同
+int perf_counters_format(const perf_counters* pc, char* buf, size_t len);
+
+#endif // __LINUX__PERF_H
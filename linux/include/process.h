@@ -3,6 +3,7 @@
 #ifndef __LINUX__PROCESS_H
 #define __LINUX__PROCESS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -37,6 +38,11 @@ worker_t execute_worker(worker_func worker, fork_msg* msg);
 
 /// @brief 按组创建子进程
 ///
+/// 每个子进程使用独立的管道, 通过事件循环 (参见 `reactor_create` 函数) 同时收集各子进程的消息并回收子进程,
+/// 运行较慢的子进程不会阻塞其它子进程的消息收集
+///
+/// 每次调用都会重新创建全部子进程, 且最多 `16` 个; 需要反复分发任务时, 参见 `prefork_create` 等函数
+///
 /// @param worker `worker_func` 类型回调函数指针, 表示子进程入口函数
 /// @param proc_n 要创建的子进程个数
 /// @param msgs 各子进程发送的消息内容
@@ -45,6 +51,9 @@ worker_t multiple_process_worker(worker_func worker, size_t proc_n, fork_msg* ms
 
 // `exec.c` 实现函数
 
+/// @brief 可执行文件无法执行时返回的状态值, 和 `fork` 方式下子进程 `exit(-1)` 的状态值相同
+#define EXEC_FAILED_STATUS (0xff << 8)
+
 /// @brief 通过命令行和命令行参数, 在子进程中执行可执行文件
 ///
 /// 在 Linux 中, 可以通过 `execv` 函数执行可执行文件, 需要指定可执行文件的路径和命令行参数,
@@ -59,14 +68,437 @@ worker_t multiple_process_worker(worker_func worker, size_t proc_n, fork_msg* ms
 /// int execv(const char *path, char *const *argv);
 /// ```
 ///
+/// 子进程通过 `spawn_process` 函数以默认方式 (参见 `spawn_backend_default` 函数) 创建;
+/// 可执行文件无法执行时, 输出错误信息并返回 `EXEC_FAILED_STATUS`
+///
 /// @param path 可执行文件路径
 /// @param arg 命令行第一个参数
 /// @param ... 命令行的后续参数
-/// @return 命令行执行结果
+/// @return 子进程的状态值 (参见 `waitpid` 函数); 可执行文件无法执行 (包括创建子进程失败) 时返回 `EXEC_FAILED_STATUS`,
+///         参数过多或等待子进程失败时返回 `-1`
 int forked_execl(const char* path, const char* arg, ...);
 
+/// @brief 创建子进程运行可执行文件的方式
+typedef enum __spawn_backend {
+	SPAWN_AUTO = 0, // 使用 `spawn_backend_default` 函数返回的方式
+	SPAWN_FORK,		// `fork` + `execv`, 需复制父进程的页表, 开销随父进程占用的内存增长
+	SPAWN_POSIX,	// `posix_spawn`, 由 glibc 通过 `clone(CLONE_VM | CLONE_VFORK)` 实现, 开销和父进程占用的内存无关
+} spawn_backend;
+
+/// @brief 获取创建子进程的默认方式
+///
+/// 读取环境变量 `LINUX_SPAWN`, 值为 `fork` 时为 `SPAWN_FORK`, 否则为 `SPAWN_POSIX`
+///
+/// @return 创建子进程的方式
+spawn_backend spawn_backend_default(void);
+
+/// @brief 创建子进程运行可执行文件, 不等待其结束
+///
+/// 两种方式的结果相同: 可执行文件无法执行时返回 `execv` 的错误值 (例如 `ENOENT`), 不产生子进程.
+/// `SPAWN_FORK` 方式和 glibc 的 `posix_spawn` 相同, 子进程通过以 `O_CLOEXEC` 打开的管道将错误值传回父进程
+///
+/// @param backend 创建子进程的方式
+/// @param path 可执行文件路径
+/// @param argv 命令行参数列表, 以 `NULL` 结尾
+/// @param pid 用于保存子进程 ID 的指针
+/// @return `0` 表示成功; 其它值表示失败, 包括可执行文件无法执行的情况
+int spawn_process(spawn_backend backend, const char* path, char* const argv[], pid_t* pid);
+
+/// @brief 批量执行的一条命令
+typedef struct __exec_cmd {
+	const char* path;	// 可执行文件路径
+	char* const* argv;	// 命令行参数列表, 以 `NULL` 结尾
+} exec_cmd;
+
+/// @brief 同时启动多条命令, 并等待全部命令执行结束
+///
+/// @param cmds 命令数组
+/// @param n 命令条数
+/// @param stats 用于保存各命令执行结果的数组, 长度为 `n`, 含义和 `forked_execl` 函数的返回值相同
+/// @return `0` 表示全部命令都已启动, 否则为第一个启动失败的错误值
+int forked_execv_batch(const exec_cmd* cmds, size_t n, int* stats);
+
+/// @brief 通过 `exec_capture` 函数执行命令的结果
+typedef struct __exec_output {
+	char* out;		// 子进程标准输出的内容, 以 `\0` 结尾, 没有输出时为空字符串
+	size_t out_len; // 子进程标准输出的字节数
+	char* err;		// 子进程标准错误的内容, 以 `\0` 结尾, 没有输出时为空字符串
+	size_t err_len; // 子进程标准错误的字节数
+	int status;		// 子进程状态值, 含义和 `forked_execl` 函数的返回值相同
+	bool timed_out; // 是否因超时而结束子进程
+} exec_output;
+
+/// @brief 在子进程中执行可执行文件, 并获取其标准输出, 标准错误和状态值
+///
+/// 子进程的标准输出和标准错误分别重定向到独立的管道, 主进程通过 `poll` 同时读取两个管道,
+/// 任一管道的输出量都不会导致子进程阻塞; 主进程自身的标准输出和标准错误不受影响
+///
+/// 超时后通过 `SIGKILL` 结束子进程, 此时 `res` 中保存超时前已读取的内容
+///
+/// @param path 可执行文件路径
+/// @param argv 命令行参数列表, 以 `NULL` 结尾
+/// @param timeout_ms 超时时间 (毫秒), 为负数表示不限制
+/// @param res 指向 `exec_output` 结构体实例的指针, 用于保存执行结果, 需通过 `exec_output_free` 函数释放
+/// @return `0` 表示成功, `ETIMEDOUT` 表示超时, 其它值表示失败 (例如可执行文件无法执行)
+int exec_capture(const char* path, char* const argv[], int timeout_ms, exec_output* res);
+
+/// @brief 释放 `exec_output` 结构体实例中的输出内容
+///
+/// @param res 指向 `exec_output` 结构体实例的指针
+void exec_output_free(exec_output* res);
+
 // `shared.c` 实现函数
 
-void shared_memory(int* result, size_t size);
+/// @brief 共享内存段
+///
+/// 通过 `memfd_create` (不支持时通过 `shm_open`) 创建匿名文件, 并以 `MAP_SHARED` 方式映射; 映射在 `fork` 时被子进程继承,
+/// 父子进程通过同一地址访问同一物理内存
+typedef struct __shm_segment {
+	void* addr;	 // 映射地址
+	size_t size; // 映射大小
+	int fd;		 // 匿名文件句柄
+} shm_segment;
+
+/// @brief 创建共享内存段, 内容初始化为 `0`
+///
+/// @param seg 指向 `shm_segment` 结构体实例的指针
+/// @param size 共享内存大小
+/// @return `0` 表示成功, 其它值表示失败
+int shm_segment_create(shm_segment* seg, size_t size);
+
+/// @brief 解除共享内存段的映射并关闭匿名文件, 父子进程需各自调用
+///
+/// @param seg 指向 `shm_segment` 结构体实例的指针
+void shm_segment_free(shm_segment* seg);
+
+/// @brief 共享内存中的单生产者单消费者环形缓冲区头部, 具体定义参见 `shared.c`
+typedef struct __shm_ring_header shm_ring_header;
+
+/// @brief 单生产者单消费者环形缓冲区, 用于子进程 (生产者) 向父进程 (消费者) 传递大块数据而不经过管道
+///
+/// 数据区被连续映射两次, 故任意位置开始的不超过容量的区域在地址上都是连续的, 生产者可以直接在缓冲区中写入结果,
+/// 消费者也可以直接读取, 无需额外复制; 读写位置通过原子操作同步, 只在缓冲区满或空时通过 futex 等待
+///
+/// 缓冲区不记录对方进程, 对方未调用 `shm_ring_close` 就退出 (例如被 `SIGKILL` 结束) 时, `shm_ring_reserve` 和
+/// `shm_ring_peek` 会一直等待; 对方可能异常退出时, 应使用带超时的 `shm_ring_reserve_timed` 和 `shm_ring_peek_timed`,
+/// 超时后检查对方是否仍在运行 (例如通过 `waitpid` 或 pidfd), 再决定继续等待或放弃
+typedef struct __shm_ring {
+	shm_ring_header* header; // 共享内存中的头部 (读写位置等)
+	char* data;				 // 数据区起始地址
+	size_t capacity;		 // 数据区容量, 为页大小的 `2` 的幂次倍
+	size_t map_size;		 // 映射的总大小
+	int fd;					 // 匿名文件句柄
+} shm_ring;
+
+/// @brief 创建环形缓冲区, 需在 `fork` 之前创建, 子进程继承同一映射
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+/// @param capacity 最小容量, 实际容量向上取整为页大小的 `2` 的幂次倍
+/// @return `0` 表示成功, 其它值表示失败
+int shm_ring_create(shm_ring* ring, size_t capacity);
+
+/// @brief 解除环形缓冲区的映射并关闭匿名文件, 父子进程需各自调用
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+void shm_ring_free(shm_ring* ring);
+
+/// @brief (生产者) 等待缓冲区中有 `len` 字节的空闲空间, 并返回其地址
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+/// @param len 需要的字节数
+/// @return 可写入的连续空间地址, `len` 超过容量时返回 `NULL`
+void* shm_ring_reserve(shm_ring* ring, size_t len);
+
+/// @brief (生产者) 等待缓冲区中有 `len` 字节的空闲空间, 至多等待 `timeout_ms` 毫秒
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+/// @param len 需要的字节数
+/// @param timeout_ms 超时时间 (毫秒), 为负数表示不超时
+/// @param out 用于保存可写入的连续空间地址的指针, 失败时设置为 `NULL`
+/// @return `0` 表示成功, `ETIMEDOUT` 表示超时, `EINVAL` 表示 `len` 超过容量
+int shm_ring_reserve_timed(shm_ring* ring, size_t len, int timeout_ms, void** out);
+
+/// @brief (生产者) 提交通过 `shm_ring_reserve` 函数写入的 `len` 字节, 使其对消费者可见
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+/// @param len 提交的字节数, 不能超过预留的字节数
+void shm_ring_commit(shm_ring* ring, size_t len);
+
+/// @brief (生产者) 关闭缓冲区, 消费者读取完剩余数据后得到结束标志
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+void shm_ring_close(shm_ring* ring);
+
+/// @brief (消费者) 等待缓冲区中有数据, 并返回全部可读数据的地址
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+/// @param len 用于保存可读字节数的指针
+/// @return 可读数据的连续地址, 缓冲区已关闭且没有剩余数据时返回 `NULL`
+const void* shm_ring_peek(shm_ring* ring, size_t* len);
+
+/// @brief (消费者) 等待缓冲区中有数据, 至多等待 `timeout_ms` 毫秒
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+/// @param timeout_ms 超时时间 (毫秒), 为负数表示不超时
+/// @param out 用于保存可读数据的连续地址的指针, 缓冲区已关闭且没有剩余数据或超时时设置为 `NULL`
+/// @param len 用于保存可读字节数的指针
+/// @return `0` 表示成功 (包括缓冲区已关闭), `ETIMEDOUT` 表示超时
+int shm_ring_peek_timed(shm_ring* ring, int timeout_ms, const void** out, size_t* len);
+
+/// @brief (消费者) 释放已读取的 `len` 字节, 使其可被生产者重新写入
+///
+/// @param ring 指向 `shm_ring` 结构体实例的指针
+/// @param len 释放的字节数, 不能超过 `shm_ring_peek` 返回的字节数
+void shm_ring_consume(shm_ring* ring, size_t len);
+
+// `prefork.c` 实现函数
+
+/// @brief 可增长的帧缓冲区, 用于保存请求和响应帧的内容
+typedef struct __frame_buf {
+	char* data; // 缓冲区指针
+	size_t len; // 内容长度
+	size_t cap; // 缓冲区容量
+} frame_buf;
+
+/// @brief 保证帧缓冲区的容量不小于 `cap`, 扩容时保留原有内容
+///
+/// @param buf 指向 `frame_buf` 结构体实例的指针
+/// @param cap 需要的容量
+/// @return `0` 表示成功, `ENOMEM` 表示内存分配失败
+int frame_buf_reserve(frame_buf* buf, size_t cap);
+
+/// @brief 向帧缓冲区追加内容
+///
+/// @param buf 指向 `frame_buf` 结构体实例的指针
+/// @param data 要追加的内容
+/// @param len 内容长度
+/// @return `0` 表示成功, `ENOMEM` 表示内存分配失败
+int frame_buf_append(frame_buf* buf, const void* data, size_t len);
+
+/// @brief 释放帧缓冲区占用的内存
+///
+/// @param buf 指向 `frame_buf` 结构体实例的指针
+void frame_buf_free(frame_buf* buf);
+
+/// @brief 在工作进程中处理请求的回调函数
+///
+/// @param req 请求内容
+/// @param len 请求长度
+/// @param resp 响应缓冲区, 调用前已清空 (`len` 为 `0`), 缓冲区在各请求之间重复使用
+/// @param ctx 创建进程池时传入的上下文指针 (`fork` 时复制到工作进程中)
+/// @return 响应状态值, 原样返回给调用方
+typedef int (*prefork_handler)(const char* req, size_t len, frame_buf* resp, void* ctx);
+
+/// @brief 预先创建的进程池, 具体定义参见 `prefork.c`
+///
+/// 每个工作进程通过各自的 `socketpair` 和主进程通信, 请求和响应均为带长度前缀的变长帧;
+/// 工作进程在各次调用之间重复使用, 异常退出的工作进程会在下次被选中时重新创建
+typedef struct __prefork_pool prefork_pool;
+
+/// @brief 批量调用时的一个请求
+typedef struct __prefork_req {
+	const void* data; // 请求内容
+	size_t len;		  // 请求长度
+} prefork_req;
+
+/// @brief 创建进程池, 并启动全部工作进程
+///
+/// 工作进程按 `placement_default()` 的放置方式绑定 CPU (默认不绑定)
+///
+/// @param pool 用于保存进程池指针的指针
+/// @param size 工作进程数, 为 `0` 时使用 `available_cpus()` 的返回值
+/// @param handler 处理请求的回调函数
+/// @param ctx 传递给回调函数的上下文指针
+/// @return `0` 表示成功, 其它值表示失败
+int prefork_create(prefork_pool** pool, size_t size, prefork_handler handler, void* ctx);
+
+/// @brief 关闭所有工作进程的通信通道, 等待工作进程退出, 并释放进程池
+///
+/// @param pool 进程池指针
+void prefork_destroy(prefork_pool* pool);
+
+/// @brief 获取进程池的工作进程数
+///
+/// @param pool 进程池指针
+/// @return 工作进程数
+size_t prefork_size(const prefork_pool* pool);
+
+/// @brief 获取第 `i` 个工作进程当前的进程 ID
+///
+/// @param pool 进程池指针
+/// @param i 工作进程下标
+/// @return 进程 ID
+pid_t prefork_pid(const prefork_pool* pool, size_t i);
+
+/// @brief 将一个请求交给空闲的工作进程处理, 并等待响应
+///
+/// 可以在多个线程中并发调用, 没有空闲工作进程时等待
+///
+/// @param pool 进程池指针
+/// @param req 请求内容
+/// @param len 请求长度
+/// @param resp 用于保存响应内容的缓冲区
+/// @param status 用于保存响应状态值的指针, 即回调函数的返回值
+/// @return `0` 表示成功, `EPIPE` 表示工作进程在处理期间退出, 其它值表示失败
+int prefork_call(prefork_pool* pool, const void* req, size_t len, frame_buf* resp, int* status);
+
+/// @brief 将一批请求分发给多个工作进程处理, 并等待全部响应
+///
+/// 每个工作进程处理完一个请求后立即分配下一个请求, 通过 `poll` 同时等待多个工作进程的响应
+///
+/// @param pool 进程池指针
+/// @param reqs 请求数组
+/// @param n 请求个数
+/// @param resps 响应缓冲区数组, 长度为 `n`
+/// @param statuses 响应状态值数组, 长度为 `n`
+/// @return `0` 表示全部成功, 否则为第一个失败的错误值, 此时未完成请求的状态值为 `-1`
+int prefork_batch(prefork_pool* pool, const prefork_req* reqs, size_t n, frame_buf* resps, int* statuses);
+
+// `reactor.c` 实现函数
+
+/// @brief 子进程事件回调函数集合
+typedef struct __child_handler {
+	/// @brief 收到子进程通过管道发送的数据时调用, 数据按到达顺序分块传递, 不保证和子进程的单次写入对应; 可以为 `NULL`
+	void (*on_data)(pid_t pid, const char* data, size_t len, void* ctx);
+
+	/// @brief 子进程的管道数据全部读取完毕, 且子进程已被回收时调用, `stat` 为 `waitpid` 返回的状态值; 可以为 `NULL`
+	void (*on_exit)(pid_t pid, int stat, void* ctx);
+
+	void* ctx; // 传递给回调函数的上下文指针
+} child_handler;
+
+/// @brief 子进程事件循环, 具体定义参见 `reactor.c`
+///
+/// 通过 epoll 同时等待所有子进程的管道和 pidfd, 任一子进程的数据或退出事件都不会因其它子进程未就绪而延迟;
+/// 内核不支持 pidfd 时, 在子进程的管道关闭后再回收子进程
+typedef struct __reactor reactor;
+
+/// @brief 创建事件循环
+///
+/// @param r 用于保存事件循环指针的指针
+/// @return `0` 表示成功, 其它值表示失败
+int reactor_create(reactor** r);
+
+/// @brief 销毁事件循环, 尚未结束的子进程会被强制结束并回收, 不再调用其回调函数
+///
+/// @param r 事件循环指针
+void reactor_destroy(reactor* r);
+
+/// @brief 创建子进程执行回调函数, 并将其加入事件循环
+///
+/// 子进程通过 `worker` 参数得到的管道 "写" 句柄向主进程发送数据, `worker` 的返回值作为子进程的退出状态值
+///
+/// @param r 事件循环指针
+/// @param worker 子进程入口函数
+/// @param cpu 子进程绑定的 CPU, 为负数时不进行绑定
+/// @param handler 子进程事件回调函数, 其内容会被复制
+/// @param pid 用于保存子进程 ID 的指针, 可以为 `NULL`
+/// @return `0` 表示成功, 其它值表示失败; 子进程创建后才失败时, 子进程已被结束并回收
+int reactor_spawn(reactor* r, worker_func worker, int cpu, const child_handler* handler, pid_t* pid);
+
+/// @brief 获取尚未完成 (即尚未调用 `on_exit`) 的子进程数
+///
+/// @param r 事件循环指针
+/// @return 子进程数
+size_t reactor_pending(const reactor* r);
+
+/// @brief 处理子进程事件, 直到全部子进程完成或超时
+///
+/// 回调函数在本函数的调用线程中执行, 回调函数中可以调用 `reactor_spawn` 加入新的子进程
+///
+/// @param r 事件循环指针
+/// @param timeout_ms 超时时间 (毫秒), 为负数时不超时
+/// @return `0` 表示全部子进程已完成, `ETIMEDOUT` 表示超时, 其它值表示失败
+int reactor_run(reactor* r, int timeout_ms);
+
+// `mutex.c` 实现函数
+
+/// @brief 进程间互斥锁, 需放置在共享内存 (参见 `shm_segment_create` 函数) 中
+///
+/// 基于 futex 实现, 锁字保存持有者的线程 ID; 加锁时先短暂自旋, 之后通过 futex 休眠.
+/// 持有期间锁链接在持有者线程的内核 robust 链表 (参见 `set_robust_list`) 中, 持有者异常退出时由内核标记锁字并唤醒一个等待者,
+/// 等待者接管锁并返回 `EOWNERDEAD`, 语义和 `PTHREAD_MUTEX_ROBUST` 相同.
+/// 每个线程只能注册一个 robust 链表, 故线程持有本锁期间会临时替换 glibc 注册的链表, 全部解锁后再恢复 (各需一次系统调用);
+/// 线程在持有本锁的同时持有 `PTHREAD_MUTEX_ROBUST` 的 pthread 互斥锁并退出时, 后者不会被内核标记
+typedef struct __shm_mutex {
+	void* next;		// robust 链表中的后继节点, 只由持有者读写, 参见 `mutex.c`
+	void* prev;		// robust 链表中的前驱节点
+	uint32_t word;	// 锁字, 低 30 位为持有者的线程 ID, 最高位表示有等待者, 次高位表示持有者已退出
+	uint32_t state; // 锁的状态, 参见 `mutex.c`
+} shm_mutex;
+
+/// @brief 进程间互斥锁的初始值, 全部为 `0` 的共享内存即为已初始化的互斥锁
+#define SHM_MUTEX_INIT { NULL, NULL, 0, 0 }
+
+/// @brief 进程间条件变量, 需放置在共享内存中
+typedef struct __shm_cond {
+	uint32_t seq; // 通知序号, 每次通知时递增, 同时作为 futex 等待的地址
+} shm_cond;
+
+/// @brief 进程间条件变量的初始值, 全部为 `0` 的共享内存即为已初始化的条件变量
+#define SHM_COND_INIT { 0 }
+
+/// @brief 进程间屏障, 需放置在共享内存中
+typedef struct __shm_barrier {
+	uint32_t count;		 // 参与者数量
+	uint32_t arrived;	 // 本轮已到达的参与者数量
+	uint32_t generation; // 轮次, 最后一个参与者到达时递增, 同时作为 futex 等待的地址
+} shm_barrier;
+
+/// @brief 加锁
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+/// @return `0` 表示成功; `EOWNERDEAD` 表示前一个持有者已退出, 此时已持有锁, 但受保护的数据可能不一致,
+///         修复后需调用 `shm_mutex_consistent` 函数, 否则解锁后锁将不可用; `ENOTRECOVERABLE` 表示锁已不可用
+int shm_mutex_lock(shm_mutex* m);
+
+/// @brief 尝试加锁, 不等待
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+/// @return `0` 表示成功, `EBUSY` 表示锁已被持有; `EOWNERDEAD` 和 `ENOTRECOVERABLE` 参见 `shm_mutex_lock` 函数
+int shm_mutex_trylock(shm_mutex* m);
+
+/// @brief 解锁
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+/// @return `0` 表示成功, `EPERM` 表示当前线程不是持有者
+int shm_mutex_unlock(shm_mutex* m);
+
+/// @brief 在 `shm_mutex_lock` 返回 `EOWNERDEAD` 后, 将锁标记为一致状态, 之后锁可正常使用
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+/// @return `0` 表示成功, `EINVAL` 表示锁不处于需要恢复的状态, 或当前线程不是持有者
+int shm_mutex_consistent(shm_mutex* m);
+
+/// @brief 释放互斥锁并等待通知, 被唤醒后重新加锁
+///
+/// 和 `pthread_cond_wait` 相同, 可能发生虚假唤醒, 调用方需在循环中检查条件
+///
+/// @param c 指向 `shm_cond` 结构体实例的指针
+/// @param m 指向 `shm_mutex` 结构体实例的指针, 调用前必须已持有
+/// @return 重新加锁的结果, 参见 `shm_mutex_lock` 函数
+int shm_cond_wait(shm_cond* c, shm_mutex* m);
+
+/// @brief 唤醒一个等待者
+///
+/// @param c 指向 `shm_cond` 结构体实例的指针
+void shm_cond_signal(shm_cond* c);
+
+/// @brief 唤醒全部等待者
+///
+/// @param c 指向 `shm_cond` 结构体实例的指针
+void shm_cond_broadcast(shm_cond* c);
+
+/// @brief 初始化进程间屏障
+///
+/// @param b 指向 `shm_barrier` 结构体实例的指针
+/// @param count 参与者数量
+void shm_barrier_init(shm_barrier* b, uint32_t count);
+
+/// @brief 等待全部参与者到达屏障, 屏障可重复使用
+///
+/// @param b 指向 `shm_barrier` 结构体实例的指针
+/// @return 最后到达的参与者返回 `1`, 其余返回 `0`
+int shm_barrier_wait(shm_barrier* b);
 
 #endif // __LINUX__PROCESS_H
@@ -6,9 +6,13 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "cpu.h"
+
 // `pthread.c` 实现函数
 
 /// @brief 定义素数计算结果结构体
+///
+/// `data` 通过 `huge_alloc` 函数分配 (参见 `alloc.h`), 初始值应为 `{ NULL, 0 }`, 并通过 `free_result` 函数释放
 typedef struct __prime_result
 {
 	uint32_t* data; // 质数计算结果集合
@@ -20,18 +24,201 @@ typedef struct __prime_result
 
 /// @brief 计算 `[2, max)` 之间的的所有质数
 ///
-/// 本函数利用 `pthread_create` 函数创建多个现场进行并行计算, 以加快质数计算速度
+/// 本函数利用多个线程进行并行计算, 以加快质数计算速度
 ///
 /// 本函数将 `[2, max)` 之间的整数按照每组 `GROUP_SIZE` 个进行分组, 然后交由不同的线程进行计算
 ///
-/// @param max 要求解的最大质数上限
-/// @param result 指向保存计算结果结构体实例的指针
+/// 各分组作为任务提交到默认线程池 (参见 `thread_pool_default` 函数) 中执行, 线程数不随分组数增长;
+/// 各分组共享同一份基础质数表 (参见 `sieve_base_init` 函数), 并按 `sieve_segment_bytes` 大小的分段对本组范围执行分段筛
+///
+/// 计算完毕后, 按各分组结果数量的前缀和一次性分配结果数组, 再并行复制各分组的结果
+///
+/// @param max 要求解的最大质数上限, 由于结果以 `uint32_t` 类型存储, 故不能超过 `2^32`
+/// @param result 指向保存计算结果结构体实例的指针, 计算结果追加到其原有内容之后
 /// @return `0` 表示成功, 其它值表示失败
 int calculate_primes(size_t max, prime_result* result);
 
+/// @brief 质数回调函数, 用于流式接收计算结果
+///
+/// @param primes 一批按升序排列的质数, 仅在回调函数执行期间有效
+/// @param count 本批质数的个数
+/// @param ctx 调用方传入的上下文指针
+/// @return `0` 表示继续, 其它值表示停止计算, 该值会作为计算函数的返回值
+typedef int (*prime_callback)(const uint32_t* primes, size_t count, void* ctx);
+
+/// @brief 计算 `[2, max)` 之间的所有质数, 并按升序分批交给回调函数, 不保存全部结果
+///
+/// 各分组在线程池中并行计算, 但回调函数总是在调用线程中按分组顺序执行; 同时进行的分组数不超过线程池线程数的 `2` 倍,
+/// 故占用的内存和结果总数无关
+///
+/// @param max 要求解的最大质数上限, 不能超过 `2^32`
+/// @param callback 质数回调函数
+/// @param ctx 传递给回调函数的上下文指针
+/// @return `0` 表示成功, 回调函数返回的非 `0` 值, 或其它表示失败的值
+int calculate_primes_stream(size_t max, prime_callback callback, void* ctx);
+
+/// @brief 统计 `[2, max)` 之间的质数个数, 即 `pi(max - 1)`, 不保存任何质数
+///
+/// 在默认线程池中按线程数启动任务, 各任务动态领取 `GROUP_SIZE` 大小的分组, 对其分段筛选后通过位图的 popcount 计数,
+/// 占用的内存只有基础质数表和各任务的分段位图
+///
+/// @param max 计数上限, 不能超过 `UINT32_MAX * UINT32_MAX`
+/// @param count 用于保存质数个数的指针
+/// @return `0` 表示成功, 其它值表示失败
+int count_primes(uint64_t max, uint64_t* count);
+
 /// @brief 释放 `result` 中存储质数结果的数组内存
 ///
 /// @param result 指向保存计算结果结构体实例的指针
 void free_result(prime_result* result);
 
+// `sieve.c` 实现函数
+
+/// @brief 分段筛使用的基础质数表
+///
+/// 要筛出 `[2, max)` 之间的质数, 只需用 `sqrt(max)` 以内的质数划去它们的倍数即可, 这部分质数称为 "基础质数"
+///
+/// 基础质数表只需计算一次, 之后各线程以只读方式共享
+typedef struct __sieve_base {
+	uint32_t* primes; // `[3, sqrt(max)]` 之间的奇质数
+	size_t count;	  // 奇质数个数
+	uint64_t max;	  // 筛选上限
+} sieve_base;
+
+/// @brief 计算筛选 `[2, max)` 所需的基础质数表
+///
+/// @param base 指向 `sieve_base` 结构体实例的指针
+/// @param max 筛选上限
+/// @return `0` 表示成功, 其它值表示失败
+int sieve_base_init(sieve_base* base, uint64_t max);
+
+/// @brief 释放基础质数表占用的内存
+///
+/// @param base 指向 `sieve_base` 结构体实例的指针
+void sieve_base_free(sieve_base* base);
+
+/// @brief 获取分段筛每个分段位图的字节数
+///
+/// 位图只记录奇数, 每个奇数占 1 位, 故每个分段覆盖 `sieve_segment_bytes() * 16` 个整数
+///
+/// 分段大小取 L1 数据缓存的大小 (通过 `sysconf` 获取), 以保证划去倍数时对位图的随机写入都能命中缓存
+///
+/// @return 分段位图的字节数, 为 `8` 的整数倍
+size_t sieve_segment_bytes(void);
+
+/// @brief 对分段 `[lo, hi)` 执行筛选, 将其中的奇合数在位图中标记为 `1`
+///
+/// 位图的第 `i` 位表示奇数 `lo + 1 + 2i`
+///
+/// @param base 指向基础质数表的指针, 其上限不能小于 `hi`
+/// @param lo 分段起始值, 必须为偶数
+/// @param hi 分段结束值 (不包含)
+/// @param bits 分段位图, 长度至少为 `(hi - lo) / 2` 位
+void sieve_mark(const sieve_base* base, uint64_t lo, uint64_t hi, uint64_t* bits);
+
+/// @brief 从已筛选的分段位图中收集质数
+///
+/// @param bits 经过 `sieve_mark` 函数标记的分段位图
+/// @param lo 分段起始值, 必须为偶数
+/// @param hi 分段结束值 (不包含)
+/// @param out 保存质数的数组
+/// @param cap `out` 数组的容量, 超出部分不会写入
+/// @return 分段中的质数个数, 若大于 `cap` 则表示 `out` 容量不足
+size_t sieve_collect(const uint64_t* bits, uint64_t lo, uint64_t hi, uint32_t* out, size_t cap);
+
+/// @brief 统计已筛选的分段位图中的质数个数
+///
+/// @param bits 经过 `sieve_mark` 函数标记的分段位图
+/// @param lo 分段起始值, 必须为偶数
+/// @param hi 分段结束值 (不包含)
+/// @return 分段中的质数个数
+size_t sieve_count(const uint64_t* bits, uint64_t lo, uint64_t hi);
+
+/// @brief 按升序遍历 `[lo, hi)` 之间的所有质数, 每个分段的质数作为一批直接交给回调函数
+///
+/// 在调用线程中逐个分段执行筛选, 占用的内存只有基础质数表, 一个分段的位图以及一个分段的质数缓冲区;
+/// 需要多线程并行计算时, 参见 `calculate_primes_stream` 函数
+///
+/// @param lo 起始值
+/// @param hi 结束值 (不包含), 不能超过 `2^32`
+/// @param callback 质数回调函数
+/// @param ctx 传递给回调函数的上下文指针
+/// @return `0` 表示成功, 回调函数返回的非 `0` 值, 或其它表示失败的值
+int for_each_prime(uint64_t lo, uint64_t hi, prime_callback callback, void* ctx);
+
+// `pool.c` 实现函数
+
+/// @brief 线程池任务
+///
+/// 任务结构体由调用方分配, 线程池只保存其指针, 故在任务执行完毕 (即所属任务组的 `pool_group_wait` 函数返回) 之前,
+/// 调用方不能释放任务结构体
+typedef struct __pool_task {
+	void (*func)(void* arg);	 // 任务函数
+	void* arg;					 // 任务函数参数
+	struct __pool_group* group;	 // 任务所属的任务组, 由 `thread_pool_submit` 函数设置
+	struct __pool_task* next;	 // 在线程池全局队列中的后继任务, 由线程池内部使用
+} pool_task;
+
+/// @brief 线程池任务组, 用于等待一批任务全部执行完毕
+///
+/// 使用前需初始化为 `POOL_GROUP_INIT`
+typedef struct __pool_group {
+	uint32_t pending; // 尚未执行完毕的任务数, 同时作为 futex 等待的地址
+} pool_group;
+
+/// @brief 任务组的初始值
+#define POOL_GROUP_INIT { 0 }
+
+/// @brief 线程池, 具体定义参见 `pool.c`
+///
+/// 每个工作线程持有一个 Chase-Lev 双端队列, 工作线程内提交的任务进入自身队列的底部, 空闲的工作线程从其它队列的顶部窃取任务;
+/// 工作线程以外提交的任务进入全局队列, 由工作线程成批取走; 没有任务时工作线程通过 futex 休眠
+typedef struct __thread_pool thread_pool;
+
+/// @brief 创建线程池
+///
+/// 放置方式不为 `PLACEMENT_NONE` 时, 第 `i` 个工作线程在启动后将自身绑定到 `cpu_layout_pick(layout, mode, i)` 返回的 CPU 上
+///
+/// @param pool 用于保存线程池指针的指针
+/// @param size 工作线程数, 为 `0` 时使用 `available_cpus()` 的返回值
+/// @param mode 工作线程的放置方式
+/// @return `0` 表示成功, 其它值表示失败
+int thread_pool_create(thread_pool** pool, size_t size, placement_mode mode);
+
+/// @brief 销毁线程池
+///
+/// 工作线程会先执行完已提交的全部任务, 之后退出
+///
+/// @param pool 线程池指针
+void thread_pool_destroy(thread_pool* pool);
+
+/// @brief 获取进程内共享的默认线程池, 首次调用时创建, 工作线程数为 `available_cpus()`, 放置方式为 `placement_default()`
+///
+/// 默认线程池在进程结束前不会销毁; `fork` 产生的子进程中不存在父进程的工作线程, 故子进程会丢弃继承的默认线程池,
+/// 并在子进程首次调用本函数时重新创建; 创建失败时下次调用会再次尝试
+///
+/// @return 线程池指针, 创建失败时返回 `NULL`
+thread_pool* thread_pool_default(void);
+
+/// @brief 获取线程池的工作线程数
+///
+/// @param pool 线程池指针
+/// @return 工作线程数
+size_t thread_pool_size(const thread_pool* pool);
+
+/// @brief 向线程池提交任务
+///
+/// @param pool 线程池指针
+/// @param task 任务指针, 需设置 `func` 和 `arg` 字段
+/// @param group 任务所属的任务组
+void thread_pool_submit(thread_pool* pool, pool_task* task, pool_group* group);
+
+/// @brief 等待任务组中的全部任务执行完毕
+///
+/// 在工作线程中调用时, 等待期间会执行线程池中的其它任务, 避免所有工作线程都在等待而导致死锁
+///
+/// @param pool 线程池指针
+/// @param group 任务组指针
+void pool_group_wait(thread_pool* pool, pool_group* group);
+
 #endif // __LINUX__THREAD_H
@@ -0,0 +1,331 @@
+#define _GNU_SOURCE
+
+#include "alloc.h"
+
+#include <unistd.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+/// @brief 一个映射的信息, 保存在映射之外的表中, 令用户内存即为映射本身, 按大页对齐且不占用额外的页面
+typedef struct __huge_entry {
+	char* base;			  // 映射地址, 即用户内存指针; 为 `NULL` 表示空闲表项
+	size_t map_len;		  // 映射长度
+	size_t size;		  // 用户请求的内存大小
+	huge_backing backing; // 页面类型
+} huge_entry;
+
+// 以映射地址为键的开放寻址哈希表 (线性探测), 容量为 `2` 的幂, 装载率不超过一半
+static huge_entry* _entries = NULL;
+static size_t _entries_cap = 0;
+static size_t _entries_len = 0;
+static pthread_mutex_t _entries_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t _entries_atfork_once = PTHREAD_ONCE_INIT;
+
+/// @brief `fork` 前持有哈希表的锁, 保证子进程中的哈希表处于一致状态
+static void _atfork_prepare(void) {
+	pthread_mutex_lock(&_entries_lock);
+}
+
+/// @brief `fork` 后在父进程中释放哈希表的锁
+static void _atfork_parent(void) {
+	pthread_mutex_unlock(&_entries_lock);
+}
+
+/// @brief `fork` 后在子进程中重新初始化哈希表的锁, 子进程只有调用 `fork` 的线程, 继承的映射和哈希表仍然有效
+static void _atfork_child(void) {
+	pthread_mutex_init(&_entries_lock, NULL);
+}
+
+/// @brief 注册 `fork` 处理函数
+static void _register_atfork(void) {
+	pthread_atfork(_atfork_prepare, _atfork_parent, _atfork_child);
+}
+
+/// @brief 计算映射地址在哈希表中的起始下标; 映射地址按页对齐, 先去掉低位再混合
+inline static size_t _slot_of(const void* base, size_t cap) {
+	uint64_t h = (uint64_t)(uintptr_t)base >> 12;
+	h *= 0x9e3779b97f4a7c15ull;
+	return (size_t)(h >> 32) & (cap - 1);
+}
+
+/// @brief 查找映射地址对应的表项, 需持有 `_entries_lock`
+///
+/// @param base 映射地址
+/// @return 表项指针, 不存在时返回 `NULL`
+static huge_entry* _find(const void* base) {
+	if (_entries_cap == 0) {
+		return NULL;
+	}
+	for (size_t i = _slot_of(base, _entries_cap);; i = (i + 1) & (_entries_cap - 1)) {
+		if (_entries[i].base == base) {
+			return &_entries[i];
+		}
+		if (!_entries[i].base) {
+			return NULL;
+		}
+	}
+}
+
+/// @brief 将表项放入哈希表, 不检查容量, 需持有 `_entries_lock`
+static void _place(huge_entry* table, size_t cap, const huge_entry* e) {
+	size_t i = _slot_of(e->base, cap);
+	while (table[i].base) {
+		i = (i + 1) & (cap - 1);
+	}
+	table[i] = *e;
+}
+
+/// @brief 记录新的映射, 装载率超过一半时扩容
+///
+/// @param e 映射信息
+/// @return `0` 表示成功, `ENOMEM` 表示内存不足
+static int _insert(const huge_entry* e) {
+	pthread_once(&_entries_atfork_once, _register_atfork);
+	pthread_mutex_lock(&_entries_lock);
+
+	if ((_entries_len + 1) * 2 > _entries_cap) {
+		size_t cap = _entries_cap ? _entries_cap * 2 : 64;
+		huge_entry* table = (huge_entry*)calloc(cap, sizeof(huge_entry));
+		if (!table) {
+			pthread_mutex_unlock(&_entries_lock);
+			return ENOMEM;
+		}
+		for (size_t i = 0; i < _entries_cap; i++) {
+			if (_entries[i].base) {
+				_place(table, cap, &_entries[i]);
+			}
+		}
+		free((void*)_entries);
+		_entries = table;
+		_entries_cap = cap;
+	}
+
+	_place(_entries, _entries_cap, e);
+	_entries_len++;
+
+	pthread_mutex_unlock(&_entries_lock);
+	return 0;
+}
+
+/// @brief 取出并删除映射的记录
+///
+/// 线性探测的删除: 将之后同一探测序列中的表项前移填补空位, 无需墓碑标记
+///
+/// @param base 映射地址
+/// @param out 用于保存映射信息的指针
+/// @return 是否存在该映射
+static bool _remove(const void* base, huge_entry* out) {
+	pthread_mutex_lock(&_entries_lock);
+
+	huge_entry* e = _find(base);
+	if (!e) {
+		pthread_mutex_unlock(&_entries_lock);
+		return false;
+	}
+	*out = *e;
+
+	size_t mask = _entries_cap - 1;
+	size_t hole = (size_t)(e - _entries);
+	for (size_t i = (hole + 1) & mask; _entries[i].base; i = (i + 1) & mask) {
+		// 表项的起始下标不在 `(hole, i]` 范围内时, 才能前移到空位
+		size_t home = _slot_of(_entries[i].base, _entries_cap);
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			_entries[hole] = _entries[i];
+			hole = i;
+		}
+	}
+	_entries[hole].base = NULL;
+	_entries_len--;
+
+	pthread_mutex_unlock(&_entries_lock);
+	return true;
+}
+
+/// @brief 将 `n` 向上对齐到 `align` 的整数倍, `align` 必须为 `2` 的幂
+#define _align_up(n, align) (((n) + (align) - 1) & ~((size_t)(align) - 1))
+
+size_t huge_page_size(void) {
+	static size_t size = 0;
+	if (size != 0) {
+		return size;
+	}
+
+	size_t kb = 2048;
+	FILE* fp = fopen("/proc/meminfo", "r");
+	if (fp) {
+		char line[128];
+		while (fgets(line, sizeof(line), fp)) {
+			if (sscanf(line, "Hugepagesize: %zu kB", &kb) == 1) {
+				break;
+			}
+		}
+		fclose(fp);
+	}
+
+	size = kb * 1024;
+	return size;
+}
+
+/// @brief 预先写入映射中的全部页面
+///
+/// 优先使用 `MADV_POPULATE_WRITE` (内核 5.14 及以上), 一次系统调用完成; 否则逐页写入
+///
+/// @param base 映射地址
+/// @param len 映射长度
+static void _prefault(char* base, size_t len) {
+#ifdef MADV_POPULATE_WRITE
+	if (madvise(base, len, MADV_POPULATE_WRITE) == 0) {
+		return;
+	}
+#endif
+
+	// 透明大页可能退化为普通页面, 故按普通页面逐页写入; 内存已清零, 写入 `0` 不改变内容
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	for (size_t off = 0; off < len; off += page) {
+		((volatile char*)base)[off] = 0;
+	}
+}
+
+/// @brief 通过 `MAP_HUGETLB` 从预留的大页池中分配映射
+///
+/// @param len 映射长度, 为大页大小的整数倍
+/// @param flags 分配选项
+/// @return 映射地址, 大页池不足时返回 `NULL`
+static char* _map_hugetlb(size_t len, int flags) {
+	int mflags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | ((flags & HUGE_PREFAULT) ? MAP_POPULATE : 0);
+	void* p = mmap(NULL, len, PROT_READ | PROT_WRITE, mflags, -1, 0);
+	return p == MAP_FAILED ? NULL : (char*)p;
+}
+
+/// @brief 分配按大页对齐的普通匿名映射
+///
+/// 透明大页只能用于按大页对齐的范围, 故多映射一个大页, 再解除首尾多余的部分
+///
+/// @param len 映射长度, 为大页大小的整数倍
+/// @param hp 大页大小
+/// @return 映射地址, 失败时返回 `NULL`
+static char* _map_aligned(size_t len, size_t hp) {
+	void* p = mmap(NULL, len + hp, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED) {
+		return NULL;
+	}
+
+	// 映射范围为 `[raw, raw + len + hp)`, 保留其中按大页对齐的 `[base, base + len)`
+	char* raw = (char*)p;
+	char* base = (char*)_align_up((uintptr_t)raw, hp);
+	if (base > raw) {
+		munmap(raw, (size_t)(base - raw));
+	}
+	munmap(base + len, (size_t)(raw + hp - base));
+	return base;
+}
+
+void* huge_alloc(size_t size, int flags) {
+	size_t hp = huge_page_size();
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+	char* base = NULL;
+	size_t len;
+	huge_backing backing = HUGE_BACKING_PAGES;
+
+	if (size < hp / 2) {
+		// 不足半个大页, 使用大页只会浪费内存
+		len = _align_up(size ? size : 1, page);
+		void* p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		base = p == MAP_FAILED ? NULL : (char*)p;
+	}
+	else {
+		// 内存信息保存在映射之外, 恰好为 `N` 个大页的请求只占用 `N` 个大页
+		len = _align_up(size, hp);
+
+		if (!(flags & HUGE_NO_HUGETLB)) {
+			base = _map_hugetlb(len, flags);
+			backing = HUGE_BACKING_HUGETLB;
+		}
+
+		if (!base) {
+			base = _map_aligned(len, hp);
+			backing = HUGE_BACKING_PAGES;
+
+			// 透明大页设置为 `never` 或内核不支持时 `madvise` 失败, 此时使用普通页面
+			if (base && madvise(base, len, MADV_HUGEPAGE) == 0) {
+				backing = HUGE_BACKING_THP;
+			}
+		}
+	}
+
+	if (!base) {
+		return NULL;
+	}
+
+	huge_entry e = { base, len, size, backing };
+	if (_insert(&e) != 0) {
+		munmap(base, len);
+		return NULL;
+	}
+
+	if ((flags & HUGE_PREFAULT) && backing != HUGE_BACKING_HUGETLB) {
+		_prefault(base, len);
+	}
+	return base;
+}
+
+void* huge_realloc(void* ptr, size_t size, int flags) {
+	if (!ptr) {
+		return huge_alloc(size, flags);
+	}
+
+	pthread_mutex_lock(&_entries_lock);
+	huge_entry* e = _find(ptr);
+	size_t old_size = e->size;
+	bool fits = size <= e->map_len;
+	if (fits) {
+		e->size = size;
+	}
+	pthread_mutex_unlock(&_entries_lock);
+
+	if (fits) {
+		return ptr;
+	}
+
+	void* p = huge_alloc(size, flags);
+	if (!p) {
+		return NULL;
+	}
+
+	memcpy(p, ptr, old_size);
+	huge_free(ptr);
+	return p;
+}
+
+void huge_free(void* ptr) {
+	huge_entry e;
+	if (ptr && _remove(ptr, &e)) {
+		munmap(e.base, e.map_len);
+	}
+}
+
+huge_backing huge_backing_of(const void* ptr) {
+	pthread_mutex_lock(&_entries_lock);
+	huge_backing backing = _find(ptr)->backing;
+	pthread_mutex_unlock(&_entries_lock);
+	return backing;
+}
+
+int page_faults_self(page_faults* faults) {
+	struct rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru) != 0) {
+		return errno;
+	}
+
+	faults->minor = (uint64_t)ru.ru_minflt;
+	faults->major = (uint64_t)ru.ru_majflt;
+	return 0;
+}
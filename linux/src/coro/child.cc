@@ -0,0 +1,96 @@
+#include "coro.h"
+
+#include <cerrno>
+#include <chrono>
+#include <system_error>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+// 当前进程的环境变量, 传递给 `posix_spawn`
+extern char** environ;
+
+namespace coro {
+
+	/// @brief 打开子进程的 pidfd, 子进程退出时 pidfd 变为可读
+	///
+	/// @param pid 子进程 ID
+	/// @return pidfd, 失败时 (例如内核版本低于 5.3) 返回 `-1`
+	static int __pidfd_open(pid_t pid) {
+#ifdef SYS_pidfd_open
+		return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+		(void)pid;
+		errno = ENOSYS;
+		return -1;
+#endif
+	}
+
+	/// @brief 在作用域结束时关闭句柄
+	struct fd_guard {
+		int fd;
+
+		~fd_guard() {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+	};
+
+	task<int> executor::wait_exit(pid_t pid) {
+		fd_guard pidfd{ __pidfd_open(pid) };
+		if (pidfd.fd >= 0) {
+			co_await readable(pidfd.fd);
+		}
+
+		int status = 0;
+		for (;;) {
+			// pidfd 可读时子进程已退出, `waitpid` 不会阻塞; 不支持 pidfd 时定期检查
+			pid_t r = waitpid(pid, &status, pidfd.fd >= 0 ? 0 : WNOHANG);
+			if (r == pid) {
+				break;
+			}
+			if (r < 0 && errno != EINTR) {
+				throw std::system_error(errno, std::generic_category(), "waitpid");
+			}
+			if (r == 0) {
+				co_await sleep_for(std::chrono::milliseconds(10));
+			}
+		}
+		co_return status;
+	}
+
+	task<child_result> executor::exec(const char* path, char* const argv[]) {
+		int pfds[2];
+		if (pipe2(pfds, O_CLOEXEC) != 0) {
+			throw std::system_error(errno, std::generic_category(), "pipe2");
+		}
+		fd_guard rfd{ pfds[0] };
+		fd_guard wfd{ pfds[1] };
+		fcntl(rfd.fd, F_SETFL, fcntl(rfd.fd, F_GETFL) | O_NONBLOCK);
+
+		// `dup2` 会清除子进程中标准输出的 `FD_CLOEXEC` 标志, 管道的其余句柄在 `exec` 时自动关闭
+		posix_spawn_file_actions_t fa;
+		posix_spawn_file_actions_init(&fa);
+		posix_spawn_file_actions_adddup2(&fa, wfd.fd, STDOUT_FILENO);
+
+		pid_t pid;
+		int rc = posix_spawn(&pid, path, &fa, nullptr, argv, environ);
+		posix_spawn_file_actions_destroy(&fa);
+		if (rc != 0) {
+			throw std::system_error(rc, std::generic_category(), "posix_spawn");
+		}
+
+		// 关闭主进程中的 "写" 句柄, 子进程退出后管道即读到 EOF
+		close(std::exchange(wfd.fd, -1));
+
+		child_result res;
+		res.out = co_await read_all(rfd.fd);
+		res.status = co_await wait_exit(pid);
+		co_return res;
+	}
+
+} // namespace coro
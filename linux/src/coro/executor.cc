@@ -0,0 +1,168 @@
+#include "coro.h"
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+
+namespace coro {
+
+	// 单次 `epoll_wait` 处理的最大事件数
+	static const int MAX_EVENTS = 256;
+
+	/// @brief 抛出表示系统调用失败的异常
+	///
+	/// @param what 失败的操作
+	[[noreturn]] static void __throw_errno(const char* what) {
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	executor::executor() : _epfd(epoll_create1(EPOLL_CLOEXEC)), _pending(0), _watching(0), _timer_seq(0) {
+		if (_epfd < 0) {
+			__throw_errno("epoll_create1");
+		}
+	}
+
+	executor::~executor() {
+		// 销毁驱动协程时, 其持有的任务对象随之析构, 进而销毁整个 `co_await` 链上的协程帧
+		for (void* frame : _drivers) {
+			std::coroutine_handle<>::from_address(frame).destroy();
+		}
+		close(_epfd);
+	}
+
+	detail::detached executor::__drive(task<void> t) {
+		std::coroutine_handle<> self = co_await detail::current_handle{};
+		_drivers.insert(self.address());
+
+		try {
+			co_await std::move(t);
+		}
+		catch (...) {
+			if (!_error) {
+				_error = std::current_exception();
+			}
+		}
+		_drivers.erase(self.address());
+		_pending--;
+	}
+
+	void executor::spawn(task<void> t) {
+		_pending++;
+		__drive(std::move(t));
+	}
+
+	void executor::__watch(waiter* w, uint32_t events) {
+		// 每次等待单独注册一次, 事件就绪后立即移除, 协程恢复后可以关闭句柄或改为等待其它事件
+		struct epoll_event ev;
+		ev.events = events;
+		ev.data.ptr = w;
+		if (epoll_ctl(_epfd, EPOLL_CTL_ADD, w->fd, &ev) != 0) {
+			__throw_errno("epoll_ctl");
+		}
+		_watching++;
+	}
+
+	void executor::__add_timer(waiter* w, clock::time_point deadline) {
+		_timers.push(timer{ deadline, _timer_seq++, w });
+	}
+
+	int executor::__fire_timers() {
+		while (!_timers.empty()) {
+			clock::time_point now = clock::now();
+			const timer& t = _timers.top();
+			if (t.deadline > now) {
+				// 向上取整, 避免在到期前被唤醒后空转
+				auto rest = std::chrono::ceil<std::chrono::milliseconds>(t.deadline - now);
+				return (int)rest.count();
+			}
+
+			waiter* w = t.w;
+			_timers.pop();
+			w->handle.resume();
+		}
+		return -1;
+	}
+
+	void executor::run() {
+		struct epoll_event events[MAX_EVENTS];
+
+		while (_pending > 0) {
+			int timeout = __fire_timers();
+			if (_pending == 0) {
+				break;
+			}
+			if (timeout < 0 && _watching == 0) {
+				throw std::logic_error("coro::executor: all tasks are suspended without any pending event");
+			}
+
+			int n = epoll_wait(_epfd, events, MAX_EVENTS, timeout);
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				__throw_errno("epoll_wait");
+			}
+
+			for (int i = 0; i < n; i++) {
+				waiter* w = (waiter*)events[i].data.ptr;
+				epoll_ctl(_epfd, EPOLL_CTL_DEL, w->fd, nullptr);
+				_watching--;
+
+				w->events = events[i].events;
+				w->handle.resume();
+			}
+		}
+
+		if (_error) {
+			std::rethrow_exception(std::exchange(_error, nullptr));
+		}
+	}
+
+	executor::fd_awaiter executor::readable(int fd) { return fd_awaiter(*this, fd, EPOLLIN); }
+
+	executor::fd_awaiter executor::writable(int fd) { return fd_awaiter(*this, fd, EPOLLOUT); }
+
+	executor::timer_awaiter executor::sleep_for(clock::duration d) { return timer_awaiter(*this, clock::now() + d); }
+
+	executor::timer_awaiter executor::sleep_until(clock::time_point deadline) { return timer_awaiter(*this, deadline); }
+
+	task<size_t> executor::read(int fd, void* buf, size_t len) {
+		for (;;) {
+			// 先直接读取, 已有数据时无需经过 epoll
+			ssize_t n = ::read(fd, buf, len);
+			if (n >= 0) {
+				co_return (size_t)n;
+			}
+			if (errno == EAGAIN) {
+				co_await readable(fd);
+			}
+			else if (errno != EINTR) {
+				__throw_errno("read");
+			}
+		}
+	}
+
+	task<std::string> executor::read_all(int fd) {
+		std::string data;
+		size_t len = 0;
+
+		for (;;) {
+			if (data.size() - len < 4096) {
+				data.resize(data.empty() ? 4096 : data.size() * 2);
+			}
+
+			size_t n = co_await read(fd, data.data() + len, data.size() - len);
+			if (n == 0) {
+				break;
+			}
+			len += n;
+		}
+
+		data.resize(len);
+		co_return data;
+	}
+
+} // namespace coro
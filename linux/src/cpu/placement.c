@@ -0,0 +1,436 @@
+#define _GNU_SOURCE
+
+#include "cpu.h"
+
+#include <sched.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <memory.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/mman.h>
+
+// 求最大值/最小值的宏
+#define _max(a, b) ((a) > (b) ? (a) : (b))
+#define _min(a, b) ((a) < (b) ? (a) : (b))
+
+/// @brief 将配额和周期换算为 CPU 数 (向上取整)
+///
+/// @param quota 每个周期内可用的 CPU 时间
+/// @param period 周期
+/// @return CPU 数, 未设置配额时返回 `0`
+static size_t _quota_cpus(long long quota, long long period) {
+	if (quota <= 0 || period <= 0) {
+		return 0;
+	}
+	return (size_t)((quota + period - 1) / period);
+}
+
+/// @brief 读取 cgroup v2 目录中的 `cpu.max` 文件 (格式为 `<quota> <period>` 或 `max <period>`)
+///
+/// @param dir cgroup 目录
+/// @return CPU 配额 (向上取整), 未设置配额时返回 `0`
+static size_t _read_cpu_max(const char* dir) {
+	char path[PATH_MAX];
+	if (snprintf(path, sizeof(path), "%s/cpu.max", dir) >= (int)sizeof(path)) {
+		return 0;
+	}
+
+	long long quota = -1, period = 0;
+	FILE* fp = fopen(path, "r");
+	if (fp) {
+		char buf[32];
+		if (fscanf(fp, "%31s %lld", buf, &period) == 2 && strcmp(buf, "max") != 0) {
+			quota = atoll(buf);
+		}
+		fclose(fp);
+	}
+	return _quota_cpus(quota, period);
+}
+
+/// @brief 读取 cgroup v1 目录中的整数文件
+///
+/// @param dir cgroup 目录
+/// @param name 文件名
+/// @return 文件中的整数值, 无法读取时返回 `-1`
+static long long _read_cgroup_ll(const char* dir, const char* name) {
+	char path[PATH_MAX];
+	if (snprintf(path, sizeof(path), "%s/%s", dir, name) >= (int)sizeof(path)) {
+		return -1;
+	}
+
+	long long val = -1;
+	FILE* fp = fopen(path, "r");
+	if (fp) {
+		if (fscanf(fp, "%lld", &val) != 1) {
+			val = -1;
+		}
+		fclose(fp);
+	}
+	return val;
+}
+
+/// @brief 读取 cgroup v1 目录中的 `cpu.cfs_quota_us`/`cpu.cfs_period_us` 文件
+///
+/// @param dir cgroup 目录
+/// @return CPU 配额 (向上取整), 未设置配额时返回 `0`
+static size_t _read_cfs_quota(const char* dir) {
+	return _quota_cpus(_read_cgroup_ll(dir, "cpu.cfs_quota_us"), _read_cgroup_ll(dir, "cpu.cfs_period_us"));
+}
+
+/// @brief 从进程所在的 cgroup 开始逐级向上直到挂载点, 取各级配额中的最小值
+///
+/// 父级的配额同样限制子级, 故进程实际可用的配额为路径上各级配额的最小值
+///
+/// @param mount cgroup 层级的挂载点
+/// @param path 进程在该层级中的路径, 以 `/` 开头
+/// @param read 读取一级 cgroup 目录配额的函数
+/// @return CPU 配额 (向上取整), 各级都未设置配额时返回 `0`
+static size_t _walk_quota(const char* mount, const char* path, size_t (*read)(const char*)) {
+	char dir[PATH_MAX];
+	size_t root_len = strlen(mount);
+	size_t len = (size_t)snprintf(dir, sizeof(dir), "%s%s", mount, path);
+	if (len >= sizeof(dir)) {
+		return 0;
+	}
+	while (len > root_len && dir[len - 1] == '/') {
+		dir[--len] = 0;
+	}
+
+	size_t quota = 0;
+	for (;;) {
+		size_t q = read(dir);
+		if (q > 0 && (quota == 0 || q < quota)) {
+			quota = q;
+		}
+
+		char* slash = strrchr(dir + root_len, '/');
+		if (!slash) {
+			break;
+		}
+		*slash = 0;
+	}
+	return quota;
+}
+
+/// @brief 判断 cgroup v1 的控制器列表 (以 `,` 分隔) 中是否包含 `cpu` 控制器
+///
+/// @param controllers 控制器列表
+/// @return 是否包含
+static bool _has_cpu_controller(const char* controllers) {
+	for (const char* p = controllers; *p;) {
+		size_t n = strcspn(p, ",");
+		if (n == 3 && strncmp(p, "cpu", 3) == 0) {
+			return true;
+		}
+		p += p[n] ? n + 1 : n;
+	}
+	return false;
+}
+
+size_t cgroup_cpu_quota_at(const char* root, const char* self_cgroup) {
+	FILE* fp = fopen(self_cgroup, "r");
+	if (!fp) {
+		return 0;
+	}
+
+	// 每行的格式为 `<层级 ID>:<控制器列表>:<路径>`; cgroup v2 只有一行 `0::<路径>`,
+	// cgroup v1 中 `cpu` 控制器所在层级挂载于 `<root>/cpu` (通常是指向 `cpu,cpuacct` 的符号链接)
+	char mount[PATH_MAX];
+	char line[PATH_MAX + 128];
+	size_t quota = 0;
+
+	while (fgets(line, sizeof(line), fp)) {
+		line[strcspn(line, "\n")] = 0;
+
+		char* controllers = strchr(line, ':');
+		if (!controllers) {
+			continue;
+		}
+		*controllers++ = 0;
+
+		char* path = strchr(controllers, ':');
+		if (!path) {
+			continue;
+		}
+		*path++ = 0;
+
+		size_t q = 0;
+		if (strcmp(line, "0") == 0 && *controllers == 0) {
+			q = _walk_quota(root, path, _read_cpu_max);
+		}
+		else if (_has_cpu_controller(controllers)
+				 && snprintf(mount, sizeof(mount), "%s/cpu", root) < (int)sizeof(mount)) {
+			q = _walk_quota(mount, path, _read_cfs_quota);
+		}
+
+		if (q > 0 && (quota == 0 || q < quota)) {
+			quota = q;
+		}
+	}
+	fclose(fp);
+	return quota;
+}
+
+size_t cgroup_cpu_quota(void) {
+	return cgroup_cpu_quota_at("/sys/fs/cgroup", "/proc/self/cgroup");
+}
+
+size_t available_cpus(void) {
+	size_t n = 0;
+
+	// 当前进程允许运行的 CPU 数量
+	cpu_set_t set;
+	if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+		n = (size_t)CPU_COUNT(&set);
+	}
+	if (n == 0) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		n = online > 0 ? (size_t)online : 1;
+	}
+
+	// cgroup 配额限制了可以同时运行的线程数
+	size_t quota = cgroup_cpu_quota();
+	if (quota > 0) {
+		n = _min(n, quota);
+	}
+	return _max(n, 1);
+}
+
+/// @brief 读取 `/sys/devices/system/cpu/cpu<N>/topology` 目录下的整数文件
+///
+/// @param cpu CPU 编号
+/// @param name 文件名
+/// @return 文件中的整数值, 无法读取时返回 `0`
+static int _read_topology(int cpu, const char* name) {
+	char path[128];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+
+	int val = 0;
+	FILE* fp = fopen(path, "r");
+	if (fp) {
+		if (fscanf(fp, "%d", &val) != 1) {
+			val = 0;
+		}
+		fclose(fp);
+	}
+	return val;
+}
+
+/// @brief 通过 `/sys/devices/system/cpu/cpu<N>` 目录中的 `node<M>` 目录项获取 CPU 所属的 NUMA 节点
+///
+/// @param cpu CPU 编号
+/// @return 节点编号, 无法获取时返回 `0`
+static int _read_node(int cpu) {
+	char path[64];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+
+	int node = 0;
+	DIR* dir = opendir(path);
+	if (dir) {
+		struct dirent* ent;
+		while ((ent = readdir(dir)) != NULL) {
+			if (sscanf(ent->d_name, "node%d", &node) == 1) {
+				break;
+			}
+		}
+		closedir(dir);
+	}
+	return node;
+}
+
+/// @brief 按紧凑放置的顺序比较两个 CPU: 节点, 插槽, 物理核心, CPU 编号
+static int _compare_compact(const void* a, const void* b) {
+	const cpu_info* x = (const cpu_info*)a;
+	const cpu_info* y = (const cpu_info*)b;
+
+	if (x->node != y->node) {
+		return x->node < y->node ? -1 : 1;
+	}
+	if (x->package != y->package) {
+		return x->package < y->package ? -1 : 1;
+	}
+	if (x->core != y->core) {
+		return x->core < y->core ? -1 : 1;
+	}
+	return x->cpu < y->cpu ? -1 : (x->cpu > y->cpu);
+}
+
+/// @brief 分散放置时用于排序的键
+typedef struct {
+	size_t sibling; // 在所属物理核心中的超线程序号
+	size_t core;	// 所属物理核心在节点中的序号
+	size_t node;	// 所属节点的序号
+	size_t index;	// 在 `cpus` 数组中的下标
+} _scatter_key;
+
+/// @brief 按分散放置的顺序比较两个 CPU: 超线程序号, 物理核心序号, 节点序号
+static int _compare_scatter(const void* a, const void* b) {
+	const _scatter_key* x = (const _scatter_key*)a;
+	const _scatter_key* y = (const _scatter_key*)b;
+
+	if (x->sibling != y->sibling) {
+		return x->sibling < y->sibling ? -1 : 1;
+	}
+	if (x->core != y->core) {
+		return x->core < y->core ? -1 : 1;
+	}
+	return x->node < y->node ? -1 : (x->node > y->node);
+}
+
+int cpu_layout_build(cpu_layout* layout, const cpu_info* cpus, size_t count, size_t quota) {
+	layout->count = count;
+	layout->usable = 0;
+	layout->cpus = (cpu_info*)malloc(sizeof(cpu_info) * _max(count, 1));
+	layout->scatter = (size_t*)malloc(sizeof(size_t) * _max(count, 1));
+
+	_scatter_key* keys = (_scatter_key*)malloc(sizeof(_scatter_key) * _max(count, 1));
+	if (!layout->cpus || !layout->scatter || !keys) {
+		free((void*)keys);
+		cpu_layout_free(layout);
+		return ENOMEM;
+	}
+
+	// 按紧凑放置的顺序排列
+	memcpy(layout->cpus, cpus, sizeof(cpu_info) * count);
+	qsort(layout->cpus, count, sizeof(cpu_info), _compare_compact);
+
+	// 在紧凑顺序上依次计算各 CPU 的节点序号, 节点内物理核心序号, 以及核心内超线程序号
+	size_t node = 0, core = 0, sibling = 0;
+	for (size_t i = 0; i < count; i++) {
+		const cpu_info* cur = &layout->cpus[i];
+		const cpu_info* prev = i > 0 ? &layout->cpus[i - 1] : NULL;
+
+		if (prev && cur->node != prev->node) {
+			node++;
+			core = 0;
+			sibling = 0;
+		}
+		else if (prev && (cur->package != prev->package || cur->core != prev->core)) {
+			core++;
+			sibling = 0;
+		}
+		else if (prev) {
+			sibling++;
+		}
+
+		keys[i] = (_scatter_key){ sibling, core, node, i };
+	}
+
+	// 分散放置: 先按超线程序号分层, 层内轮流使用各节点的物理核心
+	qsort(keys, count, sizeof(_scatter_key), _compare_scatter);
+	for (size_t i = 0; i < count; i++) {
+		layout->scatter[i] = keys[i].index;
+	}
+	free((void*)keys);
+
+	layout->usable = quota > 0 ? _min(count, quota) : count;
+	layout->usable = _max(layout->usable, 1);
+	return 0;
+}
+
+int cpu_layout_init(cpu_layout* layout) {
+	layout->count = 0;
+	layout->usable = 0;
+	layout->cpus = NULL;
+	layout->scatter = NULL;
+
+	cpu_set_t set;
+	if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+		return errno;
+	}
+
+	size_t count = (size_t)CPU_COUNT(&set);
+	cpu_info* cpus = (cpu_info*)malloc(sizeof(cpu_info) * _max(count, 1));
+	if (!cpus) {
+		return ENOMEM;
+	}
+
+	// 读取可用 CPU 的拓扑信息
+	size_t n = 0;
+	for (int cpu = 0; cpu < CPU_SETSIZE && n < count; cpu++) {
+		if (CPU_ISSET(cpu, &set)) {
+			cpu_info* info = &cpus[n++];
+			info->cpu = cpu;
+			info->node = _read_node(cpu);
+			info->package = _read_topology(cpu, "physical_package_id");
+			info->core = _read_topology(cpu, "core_id");
+		}
+	}
+
+	int rc = cpu_layout_build(layout, cpus, n, cgroup_cpu_quota());
+	free((void*)cpus);
+	return rc;
+}
+
+void cpu_layout_free(cpu_layout* layout) {
+	free((void*)layout->cpus);
+	free((void*)layout->scatter);
+	layout->cpus = NULL;
+	layout->scatter = NULL;
+	layout->count = 0;
+	layout->usable = 0;
+}
+
+int cpu_layout_pick(const cpu_layout* layout, placement_mode mode, size_t index) {
+	if (mode == PLACEMENT_NONE || layout->count == 0) {
+		return -1;
+	}
+
+	// 受 cgroup 配额限制时, 只使用排在前面的 `usable` 个 CPU, 以保持工作者之间的局部性
+	size_t i = index % _min(layout->usable, layout->count);
+	return mode == PLACEMENT_COMPACT ? layout->cpus[i].cpu : layout->cpus[layout->scatter[i]].cpu;
+}
+
+placement_mode placement_default(void) {
+	// 绑定 CPU 需要显式开启: 同一台机器上的多个进程各自绑定时, 会集中在布局中排在前面的少数 CPU 上
+	const char* env = getenv("LINUX_PLACEMENT");
+	if (env) {
+		if (strcmp(env, "compact") == 0) {
+			return PLACEMENT_COMPACT;
+		}
+		if (strcmp(env, "scatter") == 0) {
+			return PLACEMENT_SCATTER;
+		}
+	}
+	return PLACEMENT_NONE;
+}
+
+int pin_current(int cpu) {
+	if (cpu < 0) {
+		return 0;
+	}
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return sched_setaffinity(0, sizeof(set), &set) == 0 ? 0 : errno;
+}
+
+void* alloc_local(size_t size) {
+	long page = sysconf(_SC_PAGESIZE);
+	if (page <= 0) {
+		page = 4096;
+	}
+
+	void* ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptr == MAP_FAILED) {
+		return NULL;
+	}
+
+	// 匿名映射的物理页在首次写入时才分配, 在当前线程中逐页写入, 令物理页分配在当前线程所在的节点上
+	for (size_t off = 0; off < size; off += (size_t)page) {
+		((volatile char*)ptr)[off] = 0;
+	}
+	return ptr;
+}
+
+void free_local(void* ptr, size_t size) {
+	if (ptr) {
+		munmap(ptr, size);
+	}
+}
@@ -0,0 +1,219 @@
+#define _GNU_SOURCE
+
+#include "io.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/// @brief 获取页大小
+static size_t _page_size(void) {
+	static size_t page = 0;
+	if (page == 0) {
+		page = (size_t)sysconf(_SC_PAGESIZE);
+	}
+	return page;
+}
+
+/// @brief 按映射选项对映射范围调用 `madvise`
+///
+/// 提示失败 (例如内核不支持 `MADV_HUGEPAGE`) 不影响映射本身, 故忽略返回值
+///
+/// @param mf 指向 `mapped_file` 结构体实例的指针
+static void _advise(const mapped_file* mf) {
+	if (mf->flags & MAPPED_SEQUENTIAL) {
+		madvise(mf->addr, mf->len, MADV_SEQUENTIAL);
+	}
+	if (mf->flags & MAPPED_WILLNEED) {
+		madvise(mf->addr, mf->len, MADV_WILLNEED);
+	}
+#ifdef MADV_HUGEPAGE
+	if (mf->flags & MAPPED_HUGEPAGE) {
+		madvise(mf->addr, mf->len, MADV_HUGEPAGE);
+	}
+#endif
+}
+
+/// @brief 映射以 `offset` 为起点的窗口, 并解除之前的映射
+///
+/// @param mf 指向 `mapped_file` 结构体实例的指针
+/// @param offset 窗口起始偏移量, 按页大小对齐
+/// @return `0` 表示成功, 其它值表示失败
+static int _map_window(mapped_file* mf, uint64_t offset) {
+	if (mf->addr) {
+		munmap(mf->addr, mf->len);
+		mf->addr = NULL;
+		mf->len = 0;
+	}
+
+	size_t len = mf->size - offset < mf->window ? (size_t)(mf->size - offset) : mf->window;
+	int flags = MAP_SHARED | ((mf->flags & MAPPED_POPULATE) ? MAP_POPULATE : 0);
+
+	void* addr = mmap(NULL, len, PROT_READ, flags, mf->fd, (off_t)offset);
+	if (addr == MAP_FAILED) {
+		return errno;
+	}
+
+	mf->addr = (char*)addr;
+	mf->offset = offset;
+	mf->len = len;
+	_advise(mf);
+	return 0;
+}
+
+int mapped_open(mapped_file* mf, const char* path, size_t window, int flags) {
+	memset(mf, 0, sizeof(mapped_file));
+
+	size_t page = _page_size();
+	if (window != 0 && window < 2 * page) {
+		return EINVAL;
+	}
+
+	mf->fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (mf->fd < 0) {
+		return errno;
+	}
+
+	struct stat st;
+	if (fstat(mf->fd, &st) != 0) {
+		int rc = errno;
+		close(mf->fd);
+		return rc;
+	}
+
+	mf->size = (uint64_t)st.st_size;
+	mf->flags = flags;
+
+	// 窗口按页大小向下对齐; 文件不超过窗口大小时映射整个文件
+	window &= ~(page - 1);
+	mf->window = window == 0 || window >= mf->size ? (size_t)mf->size : window;
+
+	// 空文件无法映射, 之后的访问都返回空内容
+	if (mf->size == 0) {
+		return 0;
+	}
+
+	int rc = _map_window(mf, 0);
+	if (rc != 0) {
+		close(mf->fd);
+		return rc;
+	}
+	return 0;
+}
+
+void mapped_close(mapped_file* mf) {
+	if (mf->addr) {
+		munmap(mf->addr, mf->len);
+	}
+	close(mf->fd);
+	memset(mf, 0, sizeof(mapped_file));
+	mf->fd = -1;
+}
+
+int mapped_view(mapped_file* mf, uint64_t offset, size_t len, const char** data) {
+	if (offset > mf->size || len > mf->size - offset) {
+		return EINVAL;
+	}
+	if (len == 0) {
+		*data = "";
+		return 0;
+	}
+
+	// 范围位于当前窗口内, 无需重新映射
+	if (mf->addr && offset >= mf->offset && offset + len <= mf->offset + mf->len) {
+		*data = mf->addr + (offset - mf->offset);
+		return 0;
+	}
+
+	// `mmap` 的偏移量必须按页大小对齐
+	uint64_t start = offset & ~(uint64_t)(_page_size() - 1);
+	if (offset - start + len > mf->window) {
+		return E2BIG;
+	}
+
+	int rc = _map_window(mf, start);
+	if (rc != 0) {
+		return rc;
+	}
+
+	*data = mf->addr + (offset - start);
+	return 0;
+}
+
+void mapped_iter_init(mapped_iter* it, mapped_file* mf, size_t chunk) {
+	// 按窗口映射时, 块的起始位置可能位于页中间, 故块大小最多为窗口大小减去一个页面
+	size_t page = _page_size();
+	size_t limit = mf->window < mf->size ? mf->window - page : (size_t)mf->size;
+
+	it->mf = mf;
+	it->pos = 0;
+	it->chunk = chunk == 0 ? 1 : chunk > limit ? limit : chunk;
+}
+
+int mapped_iter_next(mapped_iter* it, const char** data, size_t* len) {
+	mapped_file* mf = it->mf;
+	uint64_t rest = mf->size - it->pos;
+
+	*len = 0;
+	if (rest == 0) {
+		*data = "";
+		return 0;
+	}
+
+	// 剩余内容不超过期望的块大小, 作为最后一块
+	const char* p;
+	size_t want = it->chunk;
+	if (rest <= want) {
+		int rc = mapped_view(mf, it->pos, (size_t)rest, &p);
+		if (rc != 0) {
+			return rc;
+		}
+
+		*data = p;
+		*len = (size_t)rest;
+		it->pos += rest;
+		return 0;
+	}
+
+	int rc = mapped_view(mf, it->pos, want, &p);
+	if (rc != 0) {
+		return rc;
+	}
+
+	size_t n = 0;
+	const char* q = (const char*)memrchr(p, '\n', want);
+	if (q) {
+		n = (size_t)(q - p) + 1;
+	}
+	else {
+		// 期望的块大小内没有 `\n`, 在窗口允许的最大范围内向后查找
+		size_t ext = mf->window - (size_t)(it->pos & (_page_size() - 1));
+		if (ext > rest) {
+			ext = (size_t)rest;
+		}
+
+		rc = mapped_view(mf, it->pos, ext, &p);
+		if (rc != 0) {
+			return rc;
+		}
+
+		q = (const char*)memchr(p + want, '\n', ext - want);
+		if (q) {
+			n = (size_t)(q - p) + 1;
+		}
+		else if (ext == rest) {
+			n = ext;
+		}
+		else {
+			return E2BIG;
+		}
+	}
+
+	*data = p;
+	*len = n;
+	it->pos += n;
+	return 0;
+}
@@ -1,9 +1,29 @@
+#define _GNU_SOURCE
+
 #include "io.h"
 
 #include <unistd.h>
 #include <fcntl.h>
 #include <stdio.h>
-#include <assert.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <signal.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+// 重定向管道的期望容量, 通过 `F_SETPIPE_SZ` 设置; 容量越大, 写入方在读取方处理数据期间越不容易阻塞
+#define PIPE_SIZE (1024 * 1024)
+
+// 捕获缓冲区的初始容量, 之后按倍数扩容
+#define CAPTURE_INIT_SIZE (1024 * 1024)
+
+// 每次读取前保证捕获缓冲区中至少有这么多空闲空间, 令每次 `read` 都能读走管道中的全部数据
+#define CAPTURE_MIN_READ (64 * 1024)
+
+// 每次 `splice`/`tee` 调用移动的最大字节数, 不超过管道容量即可一次移动管道中的全部数据
+#define SPLICE_CHUNK PIPE_SIZE
 
 /// @brief 定义结构体, 保存 IO 重定向到文件的信息
 typedef struct __file_redirect {
@@ -46,6 +66,12 @@ inline static void _close_file_redirect(file_redirect* fr) {
 typedef struct __memory_redirect {
 	struct __file_redirect _fr; // 基础自 `file_redirect` 结构体实例
 	int fd[2]; // 定义一对管道文件描述符, 其中 `fd[1]` 将用于 IO 重定向, `fd[0]` 用于读取写入到 IO 中的内容
+	bool async;		  // 是否由后台线程持续读取管道
+	pthread_t thread; // 后台读取线程
+	char* data;		  // 捕获缓冲区
+	size_t len;		  // 捕获缓冲区中的数据长度
+	size_t cap;		  // 捕获缓冲区容量
+	int rc;			  // 读取过程中发生的错误
 } memory_redirect;
 
 /// @brief 关闭 `memory_redirect` 结构体中存储的文件描述符
@@ -58,14 +84,15 @@ typedef struct __memory_redirect {
 /// @param mr 指向 `memory_redirect` 结构体实例的指针
 inline static void _close_memory_redirect(memory_redirect* mr) {
 	if (mr) {
-		if (mr->fd[0]) {
+		if (mr->fd[0] >= 0) {
 			// 关闭管道读文件描述符
 			close(mr->fd[0]);
 		}
-		if (mr->fd[1]) {
+		if (mr->fd[1] >= 0) {
 			// 关闭管道写文件描述符
 			close(mr->fd[1]);
 		}
+		free(mr->data);
 		_close_file_redirect((file_redirect*)mr);
 	}
 }
@@ -102,22 +129,39 @@ inline static int _duplicate_fileno(file_redirect* fr, int fileno) {
 	return 0;
 }
 
-void* fd_redirect_to_memory_begin(int fileno) {
+/// @brief 创建 `memory_redirect` 结构体实例, 并将 `fileno` 重定向到管道
+///
+/// @param fileno 输出 IO 文件描述符
+/// @param async 是否由后台线程持续读取管道, 为 `true` 时 "读管道" 保持阻塞模式
+/// @return 指向 `memory_redirect` 结构体实例的指针, 失败时返回 `NULL`
+static memory_redirect* _redirect_to_pipe(int fileno, bool async) {
 	// 分配内存地址, 指向 `memory_redirect` 结构体实例
 	memory_redirect* mr = (memory_redirect*)calloc(1, sizeof(memory_redirect));
+	if (!mr) {
+		return NULL;
+	}
+	mr->fd[0] = mr->fd[1] = -1;
+	mr->async = async;
 
 	// 将 `fileno` 变量表示的文件描述符和其副本存储到 `memory_redirect` 结构体实例中
 	if (_duplicate_fileno(&mr->_fr, fileno) != 0) {
 		_close_memory_redirect(mr);
+		return NULL;
 	}
 
 	// 创建一对管道, 将管道描述符存入 `memory_redirect` 结构体实例的 `fd` 字段中
-	if (pipe(mr->fd) < 0) {
+	if (pipe2(mr->fd, O_CLOEXEC) < 0) {
 		_close_memory_redirect(mr);
+		return NULL;
 	}
 
-	// 将 "读管道" 设置为 "非阻塞"
-	fcntl(mr->fd[0], F_SETFL, fcntl(mr->fd[0], F_GETFL) | O_NONBLOCK);
+	// 增大管道容量, 默认容量 (64KB) 很快会被写满; 超过 `/proc/sys/fs/pipe-max-size` 时设置失败, 保持默认容量即可
+	fcntl(mr->fd[1], F_SETPIPE_SZ, PIPE_SIZE);
+
+	if (!async) {
+		// 将 "读管道" 设置为 "非阻塞"
+		fcntl(mr->fd[0], F_SETFL, fcntl(mr->fd[0], F_GETFL) | O_NONBLOCK);
+	}
 
 	// 修改 `fileno` 变量存储文件描述符的指向, 令其指向 "写管道"
 	//
@@ -128,43 +172,79 @@ void* fd_redirect_to_memory_begin(int fileno) {
 	return mr;
 }
 
-/// @brief 将文件描述符指向的文件内容写入到指定的文件中
+void* fd_redirect_to_memory_begin(int fileno) {
+	return _redirect_to_pipe(fileno, false);
+}
+
+/// @brief 从 "读管道" 读取数据, 追加到捕获缓冲区中
 ///
-/// 本函通过 `read` 函数从 `fd` 文件描述符指向的文件中读取数据,
-/// 并将读取到的数据写入到 `fp` 指针指向的文件流中
+/// 数据直接读入捕获缓冲区, 缓冲区按倍数扩容 (较大的内存块由 `mremap` 扩容, 无需复制); 每次读取前保证有
+/// `CAPTURE_MIN_READ` 字节以上的空闲空间, 令读取次数和管道容量相当, 而非和数据量成正比
 ///
-/// 不断重复上述过程, 直到 `fd` 文件描述符指向的文件读取到末尾
+/// 在阻塞模式下读取到 EOF 为止, 在非阻塞模式下读取到管道为空为止
 ///
-/// 由于数据写入的目标是文件流 (`fp` 参数), 故调用该函数后,
-/// 要让数据立即写入文件, 需要通过 `fflush` 函数对文件流进行刷新,
-/// 或通过 `fclose` 函数关闭文件流
+/// @param mr 指向 `memory_redirect` 结构体实例的指针
+/// @return `0` 表示成功, 其它值表示失败
+static int _drain_pipe(memory_redirect* mr) {
+	for (;;) {
+		// 额外保留 `1` 字节, 用于在结束时添加字符串结束符
+		if (mr->cap - mr->len < CAPTURE_MIN_READ + 1) {
+			size_t cap = mr->cap ? mr->cap * 2 : CAPTURE_INIT_SIZE;
+			char* p = (char*)realloc(mr->data, cap);
+			if (!p) {
+				return ENOMEM;
+			}
+			mr->data = p;
+			mr->cap = cap;
+		}
+
+		ssize_t n = read(mr->fd[0], mr->data + mr->len, mr->cap - mr->len - 1);
+		if (n > 0) {
+			mr->len += (size_t)n;
+		}
+		else if (n == 0 || errno == EAGAIN) {
+			return 0;
+		}
+		else if (errno != EINTR) {
+			return errno;
+		}
+	}
+}
+
+/// @brief 后台读取线程入口函数, 持续读取 "读管道" 直到 "写管道" 全部关闭
+///
+/// 读取失败 (例如捕获缓冲区扩容失败) 时记录错误, 之后继续读取并丢弃数据直到 EOF; 否则管道写满后写入方会一直阻塞,
+/// `fd_redirect_to_memory_end` 函数也无法等到本线程结束
 ///
-/// @param fd 表示一个文件描述符, 将通过该描述符, 读取对应文件的内容
-/// @param fp 表示一个文件流, 会将读取到的内容写入到该描述符中
-/// @return 总共写入的数据长度
-size_t _copy_fd_into_file(int fd, FILE* fp) {
-	char buf[128] = "\0";
-	ssize_t n, len = 0;
+/// @param arg 指向 `memory_redirect` 结构体实例的指针
+/// @return 总是返回 `NULL`
+static void* _drain_thread(void* arg) {
+	memory_redirect* mr = (memory_redirect*)arg;
 
-	// 从 `fd` 文件描述符指向的文件读取数据, 每次最大读取 `128` 个字符,
-	// 并写入 `buf` 数组中
-	// 如果 `read` 函数返回 `0`, 则 `fd` 文件描述符指向的文件已经读取到末尾
-	// (`EOF`), 否则返回实际读取到的数据长度
-	//
-	// 对于 `STDOUT_FILENO` 文件描述符 (即标准输出文件描述符, 值为 `1`),
-	// 如果该文件描述符为阻塞模式, 则 `read` 函数不会返回 `0` 值,
-	// 而是发生阻塞, 直到有新的可读取数据被读取; 此时可将文件描述符设置为
-	// "非阻塞", 从而保证 `read` 函数可以返回 `0` 值,
-	// 表示已经将之前输出的数据全部读取
-	while ((n = read(fd, buf, sizeof(buf))) > 0) {
-		// 将读取到的数据写入文件流中
-		fwrite(buf, 1, n, fp);
+	mr->rc = _drain_pipe(mr);
+	if (mr->rc != 0) {
+		char scratch[64 * 1024];
+		for (;;) {
+			ssize_t n = read(mr->fd[0], scratch, sizeof(scratch));
+			if (n == 0 || (n < 0 && errno != EINTR)) {
+				break;
+			}
+		}
+	}
+	return NULL;
+}
 
-		// 计算总体读取到的数据长度
-		len += n;
+void* fd_redirect_to_memory_async_begin(int fileno) {
+	memory_redirect* mr = _redirect_to_pipe(fileno, true);
+	if (!mr) {
+		return NULL;
 	}
 
-	return len;
+	if (pthread_create(&mr->thread, NULL, _drain_thread, mr) != 0) {
+		_close_memory_redirect(mr);
+		return NULL;
+	}
+	return mr;
 }
 
 char* fd_redirect_to_memory_end(void* h, size_t* res_len) {
@@ -174,21 +254,286 @@ char* fd_redirect_to_memory_end(void* h, size_t* res_len) {
 
 	memory_redirect* mr = (memory_redirect*)h;
 
-	// 创建一个内存流, 返回表示该流的 `FILE*` 指针
-	char* res = NULL;
-	FILE* fp = open_memstream(&res, res_len);
+	if (mr->async) {
+		// 先恢复原始文件描述符并关闭 "写管道", 令后台线程读取完剩余数据后读到 EOF 并结束
+		dup2(mr->_fr.dup, mr->_fr.fno);
+		close(mr->fd[1]);
+		mr->fd[1] = -1;
 
-	// 将数据从读管道读取后写入内存流
-	size_t cp_len = _copy_fd_into_file(mr->fd[0], fp);
+		pthread_join(mr->thread, NULL);
+	}
+	else {
+		// 将数据从读管道读取到捕获缓冲区, 直到管道为空
+		mr->rc = _drain_pipe(mr);
+	}
 
-	// 关闭内存流
-	fclose(fp);
+	// 没有捕获到任何数据时, 返回空字符串
+	if (mr->rc == 0 && !mr->data) {
+		mr->data = (char*)malloc(1);
+		mr->rc = mr->data ? 0 : ENOMEM;
+	}
+
+	char* res = NULL;
+	*res_len = 0;
+	if (mr->rc == 0) {
+		// 将捕获缓冲区的所有权转移给调用方, 并添加字符串结束符
+		res = mr->data;
+		res[mr->len] = 0;
+		*res_len = mr->len;
+		mr->data = NULL;
+	}
 
 	// 关闭 `memory_redirect` 结构体实例
 	_close_memory_redirect(mr);
 
-	// 确认拷贝数据的长度和内存数据流分配的长度一致
-	assert(*res_len == cp_len);
+	return res;
+}
+
+/// @brief 定义结构体, 用于将 IO 重定向到 memfd 文件
+typedef struct __memfd_redirect {
+	struct __file_redirect _fr; // 基础自 `file_redirect` 结构体实例
+	int mfd;					// 通过 `memfd_create` 创建的匿名内存文件
+} memfd_redirect;
+
+void* fd_redirect_to_memfd_begin(int fileno) {
+	memfd_redirect* mr = (memfd_redirect*)calloc(1, sizeof(memfd_redirect));
+	if (!mr) {
+		return NULL;
+	}
+
+	if (_duplicate_fileno(&mr->_fr, fileno) != 0) {
+		free(mr);
+		return NULL;
+	}
+
+	// 匿名内存文件位于内存中 (tmpfs), 写入不会阻塞, 容量只受内存限制
+	mr->mfd = memfd_create("fd_redirect", MFD_CLOEXEC);
+	if (mr->mfd < 0) {
+		_close_file_redirect(&mr->_fr);
+		return NULL;
+	}
+
+	// 令 `fileno` 指向匿名内存文件, 之后写入 `fileno` 的数据直接进入该文件的页缓存
+	dup2(mr->mfd, fileno);
+
+	return mr;
+}
+
+char* fd_redirect_to_memfd_end(void* h, size_t* result_len) {
+	if (!h) {
+		return NULL;
+	}
+
+	memfd_redirect* mr = (memfd_redirect*)h;
+
+	// 先恢复原始文件描述符, 之后文件大小不再变化
+	dup2(mr->_fr.dup, mr->_fr.fno);
+
+	char* res = NULL;
+	struct stat st;
+
+	*result_len = 0;
+	if (fstat(mr->mfd, &st) == 0) {
+		if (st.st_size == 0) {
+			// 长度为 `0` 的映射无效, 返回空字符串
+			res = (char*)"";
+		}
+		else {
+			// 直接映射匿名内存文件的页, 无需复制; 通过 `MAP_POPULATE` 一次性建立页表, 避免之后逐页缺页
+			// 映射建立后即可关闭文件, 映射会保持文件内容有效
+			void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED | MAP_POPULATE, mr->mfd, 0);
+			if (p != MAP_FAILED) {
+				res = (char*)p;
+				*result_len = (size_t)st.st_size;
+			}
+		}
+	}
+
+	close(mr->mfd);
+	_close_file_redirect(&mr->_fr);
 
 	return res;
 }
+
+void fd_redirect_memfd_free(char* data, size_t len) {
+	if (data && len > 0) {
+		munmap(data, len);
+	}
+}
+
+/// @brief 定义结构体, 用于将 IO 通过管道转发到文件, 以及可选的第二个管道
+typedef struct __splice_redirect {
+	struct __file_redirect _fr; // 基础自 `file_redirect` 结构体实例
+	int fd[2];					// 重定向使用的管道, `fd[1]` 用于 IO 重定向, `fd[0]` 由后台线程转发
+	int file_fd;				// 目标文件
+	int tap_fd;					// 第二个消费者的管道 "写" 句柄, 为 `-1` 表示不需要
+	pthread_t thread;			// 后台转发线程
+	bool copy;					// 目标文件不支持 `splice`, 改为经由用户空间复制
+	uint64_t bytes;				// 已转发到目标文件的字节数
+	struct timespec start;		// 开始重定向的时间
+	int rc;						// 转发过程中发生的错误
+} splice_redirect;
+
+/// @brief 从管道向目标文件转发恰好 `len` 字节, 目标文件不支持 `splice` 时改为通过 `read`/`write` 复制
+///
+/// @param sr 指向 `splice_redirect` 结构体实例的指针
+/// @param len 转发的字节数, 为 `0` 时转发到 EOF 为止
+/// @return `0` 表示成功, 其它值表示失败
+static int _splice_to_file(splice_redirect* sr, size_t len) {
+	bool until_eof = len == 0;
+
+	while (until_eof || len > 0) {
+		ssize_t n = -1;
+		if (!sr->copy) {
+			n = splice(sr->fd[0], NULL, sr->file_fd, NULL, until_eof ? SPLICE_CHUNK : len, SPLICE_F_MOVE | SPLICE_F_MORE);
+
+			// 例如以 `O_APPEND` 方式打开的文件不支持 `splice`, 此时只能经由用户空间复制
+			sr->copy = n < 0 && errno == EINVAL;
+		}
+		if (sr->copy) {
+			char buf[64 * 1024];
+			n = read(sr->fd[0], buf, until_eof || len > sizeof(buf) ? sizeof(buf) : len);
+			for (ssize_t off = 0; n > 0 && off < n;) {
+				ssize_t w = write(sr->file_fd, buf + off, (size_t)(n - off));
+				if (w < 0) {
+					return errno;
+				}
+				off += w;
+			}
+		}
+		if (n == 0) {
+			return 0;
+		}
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return errno;
+		}
+
+		sr->bytes += (uint64_t)n;
+		if (!until_eof) {
+			len -= (size_t)n;
+		}
+	}
+	return 0;
+}
+
+/// @brief 后台转发线程入口函数, 持续将管道中的数据转发到目标文件 (以及第二个管道), 直到 "写管道" 全部关闭
+///
+/// 需要第二个消费者时, 先通过 `tee` 将管道中的数据复制到第二个管道 (只增加页的引用计数, 不复制数据),
+/// 再通过 `splice` 将同样长度的数据移动到目标文件
+///
+/// 第二个消费者关闭读端后, `tee` 失败并返回 `EPIPE`, 此时停止复制, 其余数据只转发到目标文件
+///
+/// @param arg 指向 `splice_redirect` 结构体实例的指针
+/// @return 总是返回 `NULL`
+static void* _splice_thread(void* arg) {
+	splice_redirect* sr = (splice_redirect*)arg;
+
+	// 向已关闭读端的管道写入会产生 `SIGPIPE`, 默认行为是终止整个进程; 只在本线程中屏蔽该信号, 改为处理 `EPIPE` 错误
+	sigset_t set;
+	sigemptyset(&set);
+	sigaddset(&set, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+	while (sr->tap_fd >= 0) {
+		ssize_t n = tee(sr->fd[0], sr->tap_fd, SPLICE_CHUNK, 0);
+		if (n == 0) {
+			return NULL;
+		}
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno != EPIPE) {
+				sr->rc = errno;
+			}
+			break;
+		}
+
+		sr->rc = _splice_to_file(sr, (size_t)n);
+		if (sr->rc != 0) {
+			return NULL;
+		}
+	}
+
+	// 不需要 (或已无法) 复制到第二个管道, 其余数据只转发到目标文件; 保留 `tee` 失败的错误
+	int rc = _splice_to_file(sr, 0);
+	if (sr->rc == 0) {
+		sr->rc = rc;
+	}
+	return NULL;
+}
+
+void* fd_tee_begin(int fileno, int file_fd, int tap_fd) {
+	// `tee` 只能在两个管道之间复制数据
+	struct stat st;
+	if (tap_fd >= 0 && (fstat(tap_fd, &st) != 0 || !S_ISFIFO(st.st_mode))) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	splice_redirect* sr = (splice_redirect*)calloc(1, sizeof(splice_redirect));
+	if (!sr) {
+		return NULL;
+	}
+	sr->file_fd = file_fd;
+	sr->tap_fd = tap_fd;
+
+	if (_duplicate_fileno(&sr->_fr, fileno) != 0) {
+		free(sr);
+		return NULL;
+	}
+
+	if (pipe2(sr->fd, O_CLOEXEC) < 0) {
+		_close_file_redirect(&sr->_fr);
+		return NULL;
+	}
+	fcntl(sr->fd[1], F_SETPIPE_SZ, PIPE_SIZE);
+
+	clock_gettime(CLOCK_MONOTONIC, &sr->start);
+
+	if (pthread_create(&sr->thread, NULL, _splice_thread, sr) != 0) {
+		close(sr->fd[0]);
+		close(sr->fd[1]);
+		_close_file_redirect(&sr->_fr);
+		return NULL;
+	}
+
+	// 令 `fileno` 指向 "写管道"
+	dup2(sr->fd[1], fileno);
+
+	return sr;
+}
+
+void* fd_redirect_to_file_begin(int fileno, int file_fd) {
+	return fd_tee_begin(fileno, file_fd, -1);
+}
+
+int fd_redirect_to_file_end(void* h, fd_splice_stats* stats) {
+	if (!h) {
+		return EINVAL;
+	}
+
+	splice_redirect* sr = (splice_redirect*)h;
+
+	// 恢复原始文件描述符并关闭 "写管道", 令后台线程转发完剩余数据后读到 EOF 并结束
+	dup2(sr->_fr.dup, sr->_fr.fno);
+	close(sr->fd[1]);
+	pthread_join(sr->thread, NULL);
+	close(sr->fd[0]);
+
+	if (stats) {
+		struct timespec end;
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		stats->bytes = sr->bytes;
+		stats->seconds = (double)(end.tv_sec - sr->start.tv_sec) + (double)(end.tv_nsec - sr->start.tv_nsec) / 1e9;
+		stats->bytes_per_sec = stats->seconds > 0 ? (double)sr->bytes / stats->seconds : 0;
+	}
+
+	int rc = sr->rc;
+	_close_file_redirect(&sr->_fr);
+	return rc;
+}
@@ -0,0 +1,563 @@
+#define _GNU_SOURCE
+
+#include "io.h"
+#include "thread.h"
+
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// 线程池方式的工作线程数, IO 密集型任务不受 CPU 数量限制, 线程数决定了同时进行的 `pread` 调用数
+#define POOL_THREADS 8
+
+/// @brief 线程池方式下, 一个已提交请求所占用的槽位
+typedef struct __uring_slot {
+	pool_task task;				// 线程池任务, 参数为槽位自身
+	uring_req req;				// 请求内容, 文件下标已转换为文件句柄
+	struct __uring* ring;		// 所属队列
+	struct __uring_slot* next;	// 空闲槽位链表中的后继槽位
+} uring_slot;
+
+/// @brief 异步 IO 队列
+struct __uring {
+	uring_backend backend; // 实际使用的实现方式
+	size_t capacity;	   // 最多同时未取走结果的请求数
+	size_t inflight;	   // 已提交但尚未取走结果的请求数
+	uint32_t n_buffers;	   // 已注册的缓冲区个数
+
+	// `URING_KERNEL` 方式
+	int fd;							 // io_uring 句柄
+	void* sq_ptr;					 // 提交队列的映射地址
+	size_t sq_map_size;				 // 提交队列的映射大小
+	void* cq_ptr;					 // 完成队列的映射地址, 内核支持 `IORING_FEAT_SINGLE_MMAP` 时和 `sq_ptr` 相同
+	size_t cq_map_size;				 // 完成队列的映射大小
+	struct io_uring_sqe* sqes;		 // 提交队列项数组
+	size_t sqes_size;				 // 提交队列项数组的映射大小
+	uint32_t* sq_head;				 // 提交队列头部, 由内核更新
+	uint32_t* sq_tail;				 // 提交队列尾部, 由本进程更新
+	uint32_t* sq_array;				 // 提交队列, 保存 `sqes` 数组下标
+	uint32_t sq_mask;				 // 提交队列下标掩码
+	uint32_t* cq_head;				 // 完成队列头部, 由本进程更新
+	uint32_t* cq_tail;				 // 完成队列尾部, 由内核更新
+	struct io_uring_cqe* cqes;		 // 完成队列项数组
+	uint32_t cq_mask;				 // 完成队列下标掩码
+
+	// `URING_POOL` 方式
+	thread_pool* pool;			// 执行请求的线程池
+	pool_group group;			// 全部已提交请求所属的任务组
+	pthread_mutex_t mut;		// 保护空闲槽位链表和已完成结果队列
+	pthread_cond_t cond;		// 有新的结果时通知
+	uring_slot* slots;			// 槽位数组, 长度为 `capacity`
+	uring_slot* free_slots;		// 空闲槽位链表
+	uring_completion* done;		// 已完成结果的环形队列, 长度为 `capacity`
+	size_t done_head;			// 已完成结果队列的头部
+	size_t done_len;			// 已完成结果队列的长度
+	int* files;					// 已注册的文件句柄
+	uint32_t n_files;			// 已注册的文件个数
+};
+
+static int _io_uring_setup(uint32_t entries, struct io_uring_params* p) {
+	return (int)syscall(SYS_io_uring_setup, entries, p);
+}
+
+static int _io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+	return (int)syscall(SYS_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int _io_uring_register(int fd, uint32_t opcode, const void* arg, uint32_t n) {
+	return (int)syscall(SYS_io_uring_register, fd, opcode, arg, n);
+}
+
+uring_backend uring_backend_default(void) {
+	static uring_backend backend = URING_AUTO;
+
+	if (backend == URING_AUTO) {
+		const char* env = getenv("LINUX_URING");
+		backend = env && strcmp(env, "pool") == 0 ? URING_POOL : URING_KERNEL;
+	}
+	return backend;
+}
+
+/// @brief 确认内核支持 `IORING_OP_READ` 和 `IORING_OP_WRITE` 操作 (内核 5.6 及以上)
+///
+/// @param fd io_uring 句柄
+/// @return 是否支持
+static bool _probe_ops(int fd) {
+	size_t size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+	struct io_uring_probe* probe = (struct io_uring_probe*)calloc(1, size);
+	if (!probe) {
+		return false;
+	}
+
+	bool ok = _io_uring_register(fd, IORING_REGISTER_PROBE, probe, 256) == 0
+		&& probe->last_op >= IORING_OP_WRITE
+		&& (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)
+		&& (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+
+	free((void*)probe);
+	return ok;
+}
+
+/// @brief 释放 `URING_KERNEL` 方式的资源
+///
+/// @param r 队列指针
+static void _kernel_free(uring* r) {
+	if (r->sqes) {
+		munmap(r->sqes, r->sqes_size);
+	}
+	if (r->cq_ptr && r->cq_ptr != r->sq_ptr) {
+		munmap(r->cq_ptr, r->cq_map_size);
+	}
+	if (r->sq_ptr) {
+		munmap(r->sq_ptr, r->sq_map_size);
+	}
+	if (r->fd >= 0) {
+		close(r->fd);
+	}
+}
+
+/// @brief 创建内核 io_uring, 并映射提交队列和完成队列
+///
+/// @param r 队列指针
+/// @param entries 队列深度
+/// @return `0` 表示成功, 其它值表示失败
+static int _kernel_init(uring* r, uint32_t entries) {
+	struct io_uring_params p;
+	memset(&p, 0, sizeof(p));
+
+	r->fd = _io_uring_setup(entries, &p);
+	if (r->fd < 0) {
+		r->fd = -1;
+		return errno;
+	}
+	if (!_probe_ops(r->fd)) {
+		close(r->fd);
+		r->fd = -1;
+		return EOPNOTSUPP;
+	}
+
+	r->sq_map_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+	r->cq_map_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+
+	// 内核支持 `IORING_FEAT_SINGLE_MMAP` 时 (内核 5.4 及以上), 提交队列和完成队列位于同一映射中
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		if (r->cq_map_size > r->sq_map_size) {
+			r->sq_map_size = r->cq_map_size;
+		}
+		r->cq_map_size = r->sq_map_size;
+	}
+
+	r->sq_ptr = mmap(NULL, r->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+	if (r->sq_ptr == MAP_FAILED) {
+		r->sq_ptr = NULL;
+		goto fail;
+	}
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		r->cq_ptr = r->sq_ptr;
+	}
+	else {
+		r->cq_ptr = mmap(NULL, r->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+		if (r->cq_ptr == MAP_FAILED) {
+			r->cq_ptr = NULL;
+			goto fail;
+		}
+	}
+
+	r->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	r->sqes = (struct io_uring_sqe*)mmap(NULL, r->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd,
+										 IORING_OFF_SQES);
+	if (r->sqes == MAP_FAILED) {
+		r->sqes = NULL;
+		goto fail;
+	}
+
+	char* sq = (char*)r->sq_ptr;
+	r->sq_head = (uint32_t*)(sq + p.sq_off.head);
+	r->sq_tail = (uint32_t*)(sq + p.sq_off.tail);
+	r->sq_array = (uint32_t*)(sq + p.sq_off.array);
+	r->sq_mask = *(uint32_t*)(sq + p.sq_off.ring_mask);
+
+	char* cq = (char*)r->cq_ptr;
+	r->cq_head = (uint32_t*)(cq + p.cq_off.head);
+	r->cq_tail = (uint32_t*)(cq + p.cq_off.tail);
+	r->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+	r->cq_mask = *(uint32_t*)(cq + p.cq_off.ring_mask);
+
+	// 未取走结果的请求数不超过提交队列深度, 故完成队列 (深度为提交队列的 `2` 倍) 不会溢出
+	r->capacity = p.sq_entries;
+	return 0;
+
+fail:;
+	int rc = errno;
+	_kernel_free(r);
+	return rc;
+}
+
+/// @brief 释放 `URING_POOL` 方式的资源
+///
+/// @param r 队列指针
+static void _pool_free(uring* r) {
+	if (r->pool) {
+		pool_group_wait(r->pool, &r->group);
+		thread_pool_destroy(r->pool);
+		pthread_cond_destroy(&r->cond);
+		pthread_mutex_destroy(&r->mut);
+	}
+	free((void*)r->slots);
+	free((void*)r->done);
+	free((void*)r->files);
+}
+
+/// @brief 创建线程池及槽位
+///
+/// @param r 队列指针
+/// @param entries 队列深度
+/// @return `0` 表示成功, 其它值表示失败
+static int _pool_init(uring* r, uint32_t entries) {
+	r->capacity = entries;
+	r->slots = (uring_slot*)calloc(entries, sizeof(uring_slot));
+	r->done = (uring_completion*)calloc(entries, sizeof(uring_completion));
+	if (!r->slots || !r->done) {
+		_pool_free(r);
+		return ENOMEM;
+	}
+
+	for (uint32_t i = 0; i < entries; i++) {
+		r->slots[i].ring = r;
+		r->slots[i].next = i + 1 < entries ? &r->slots[i + 1] : NULL;
+	}
+	r->free_slots = &r->slots[0];
+
+	// IO 请求大部分时间阻塞在内核中, 不绑定 CPU
+	int rc = thread_pool_create(&r->pool, POOL_THREADS, PLACEMENT_NONE);
+	if (rc != 0) {
+		r->pool = NULL;
+		_pool_free(r);
+		return rc;
+	}
+
+	pthread_mutex_init(&r->mut, NULL);
+	pthread_cond_init(&r->cond, NULL);
+	r->group = (pool_group)POOL_GROUP_INIT;
+	return 0;
+}
+
+int uring_create(uring** ring, uint32_t entries, uring_backend backend) {
+	if (entries == 0) {
+		return EINVAL;
+	}
+
+	// 队列深度向上取整为 `2` 的幂, 和内核的处理方式一致
+	uint32_t n = 1;
+	while (n < entries) {
+		n <<= 1;
+	}
+
+	uring* r = (uring*)calloc(1, sizeof(uring));
+	if (!r) {
+		return ENOMEM;
+	}
+	r->fd = -1;
+
+	if (backend == URING_AUTO) {
+		backend = uring_backend_default();
+	}
+
+	// 内核不支持或禁用了 io_uring 时 (例如 `/proc/sys/kernel/io_uring_disabled` 或 seccomp 限制), 改用线程池
+	int rc = EOPNOTSUPP;
+	if (backend == URING_KERNEL) {
+		rc = _kernel_init(r, n);
+	}
+	if (rc == 0) {
+		r->backend = URING_KERNEL;
+	}
+	else {
+		rc = _pool_init(r, n);
+		r->backend = URING_POOL;
+	}
+
+	if (rc != 0) {
+		free((void*)r);
+		return rc;
+	}
+
+	*ring = r;
+	return 0;
+}
+
+void uring_destroy(uring* ring) {
+	if (ring->backend == URING_KERNEL) {
+		// 等待已提交的请求全部完成, 避免内核在调用方释放缓冲区后继续写入; 关闭 io_uring 句柄不会等待进行中的请求,
+		// 故等待出错时不能提前返回, 只能重试
+		uring_completion c[64];
+		size_t count;
+		while (ring->inflight > 0) {
+			if (uring_poll(ring, c, 64, 1, &count) != 0) {
+				sched_yield();
+			}
+		}
+		_kernel_free(ring);
+	}
+	else {
+		_pool_free(ring);
+	}
+	free((void*)ring);
+}
+
+uring_backend uring_backend_of(const uring* ring) {
+	return ring->backend;
+}
+
+int uring_register_buffers(uring* ring, const struct iovec* iovs, uint32_t n) {
+	if (ring->n_buffers > 0) {
+		return EBUSY;
+	}
+	if (ring->backend == URING_KERNEL && _io_uring_register(ring->fd, IORING_REGISTER_BUFFERS, iovs, n) != 0) {
+		return errno;
+	}
+
+	ring->n_buffers = n;
+	return 0;
+}
+
+int uring_register_files(uring* ring, const int* fds, uint32_t n) {
+	if (ring->backend == URING_KERNEL) {
+		return _io_uring_register(ring->fd, IORING_REGISTER_FILES, fds, n) == 0 ? 0 : errno;
+	}
+
+	if (ring->files) {
+		return EBUSY;
+	}
+	ring->files = (int*)malloc(n * sizeof(int));
+	if (!ring->files) {
+		return ENOMEM;
+	}
+	memcpy(ring->files, fds, n * sizeof(int));
+	ring->n_files = n;
+	return 0;
+}
+
+/// @brief 提交请求到内核 io_uring
+///
+/// 未使用 `IORING_SETUP_SQPOLL`, 内核只在 `io_uring_enter` 中读取提交队列; `io_uring_enter` 失败时, 将提交队列尾部
+/// 退回到内核已读取的位置, 未被读取的请求视为未提交, 避免之后的 `io_uring_enter` 提交这些已被调用方视为失败的请求
+///
+/// @param r 队列指针
+/// @param reqs 请求数组
+/// @param n 请求个数, 不超过提交队列的空闲项数
+/// @param submitted 用于保存内核实际读取的请求数的指针, 这些请求都会产生完成结果
+/// @return `0` 表示成功, 其它值表示失败
+static int _kernel_submit(uring* r, const uring_req* reqs, size_t n, size_t* submitted) {
+	// 提交队列尾部只由本进程更新, 直接读取即可
+	uint32_t start = *r->sq_tail;
+	uint32_t tail = start;
+
+	for (size_t i = 0; i < n; i++) {
+		const uring_req* q = &reqs[i];
+		uint32_t index = tail & r->sq_mask;
+		struct io_uring_sqe* sqe = &r->sqes[index];
+
+		memset(sqe, 0, sizeof(*sqe));
+		if (q->buf_index >= 0) {
+			sqe->opcode = q->op == URING_OP_READ ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+			sqe->buf_index = (uint16_t)q->buf_index;
+		}
+		else {
+			sqe->opcode = q->op == URING_OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+		}
+		if (q->fixed_file) {
+			sqe->flags |= IOSQE_FIXED_FILE;
+		}
+		sqe->fd = q->fd;
+		sqe->addr = (uint64_t)(uintptr_t)q->buf;
+		sqe->len = q->len;
+		sqe->off = q->offset;
+		sqe->user_data = q->user_data;
+
+		r->sq_array[index] = index;
+		tail++;
+	}
+
+	// 以 release 语义发布新的尾部, 保证内核读取到完整的提交队列项
+	__atomic_store_n(r->sq_tail, tail, __ATOMIC_RELEASE);
+
+	int rc = 0;
+	uint32_t head = start;
+	while (head != tail) {
+		int ret = _io_uring_enter(r->fd, tail - head, 0, 0);
+		if (ret < 0 && errno != EINTR) {
+			rc = errno;
+		}
+		// 提交队列头部由内核更新, 以 acquire 语义读取
+		head = __atomic_load_n(r->sq_head, __ATOMIC_ACQUIRE);
+		if (rc != 0 || ret == 0) {
+			break;
+		}
+	}
+
+	// 退回未被内核读取的请求
+	if (head != tail) {
+		__atomic_store_n(r->sq_tail, head, __ATOMIC_RELEASE);
+		if (rc == 0) {
+			rc = EAGAIN;
+		}
+	}
+	*submitted = head - start;
+	return rc;
+}
+
+/// @brief 线程池任务函数, 执行一个请求并将结果放入已完成结果队列
+///
+/// @param arg 槽位指针
+static void _pool_run(void* arg) {
+	uring_slot* slot = (uring_slot*)arg;
+	const uring_req* q = &slot->req;
+	uring* r = slot->ring;
+
+	ssize_t n;
+	do {
+		n = q->op == URING_OP_READ ? pread(q->fd, q->buf, q->len, (off_t)q->offset)
+								   : pwrite(q->fd, q->buf, q->len, (off_t)q->offset);
+	} while (n < 0 && errno == EINTR);
+
+	uring_completion c = { q->user_data, n < 0 ? -errno : (int32_t)n };
+
+	pthread_mutex_lock(&r->mut);
+	r->done[(r->done_head + r->done_len) % r->capacity] = c;
+	r->done_len++;
+	slot->next = r->free_slots;
+	r->free_slots = slot;
+	pthread_cond_signal(&r->cond);
+	pthread_mutex_unlock(&r->mut);
+}
+
+/// @brief 提交请求到线程池
+///
+/// @param r 队列指针
+/// @param reqs 请求数组
+/// @param n 请求个数, 不超过空闲槽位数
+/// @param submitted 用于保存实际提交的请求数的指针, 参数检查失败时不提交任何请求
+/// @return `0` 表示成功, 其它值表示失败
+static int _pool_submit(uring* r, const uring_req* reqs, size_t n, size_t* submitted) {
+	*submitted = 0;
+	for (size_t i = 0; i < n; i++) {
+		const uring_req* q = &reqs[i];
+		if (q->fixed_file && (q->fd < 0 || (uint32_t)q->fd >= r->n_files)) {
+			return EBADF;
+		}
+		if (q->buf_index >= 0 && (uint32_t)q->buf_index >= r->n_buffers) {
+			return EFAULT;
+		}
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		pthread_mutex_lock(&r->mut);
+		uring_slot* slot = r->free_slots;
+		r->free_slots = slot->next;
+		pthread_mutex_unlock(&r->mut);
+
+		slot->req = reqs[i];
+		if (slot->req.fixed_file) {
+			slot->req.fd = r->files[slot->req.fd];
+		}
+		slot->task.func = _pool_run;
+		slot->task.arg = slot;
+		thread_pool_submit(r->pool, &slot->task, &r->group);
+	}
+	*submitted = n;
+	return 0;
+}
+
+int uring_submit(uring* ring, const uring_req* reqs, size_t n, size_t* submitted) {
+	size_t room = ring->capacity - ring->inflight;
+	if (n > room) {
+		n = room;
+	}
+
+	*submitted = 0;
+	if (n == 0) {
+		return 0;
+	}
+
+	// 失败时也可能已有部分请求被提交, 这些请求同样需要通过 `uring_poll` 取走结果
+	size_t done = 0;
+	int rc = ring->backend == URING_KERNEL ? _kernel_submit(ring, reqs, n, &done) : _pool_submit(ring, reqs, n, &done);
+
+	ring->inflight += done;
+	*submitted = done;
+	return rc;
+}
+
+/// @brief 从内核完成队列中取走结果
+///
+/// @param r 队列指针
+/// @param out 用于保存结果的数组
+/// @param max `out` 数组的长度
+/// @return 取走的结果数
+static size_t _kernel_reap(uring* r, uring_completion* out, size_t max) {
+	// 完成队列头部只由本进程更新, 尾部以 acquire 语义读取, 保证读取到内核写入的完整结果
+	uint32_t head = *r->cq_head;
+	uint32_t tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+
+	size_t count = 0;
+	while (head != tail && count < max) {
+		const struct io_uring_cqe* cqe = &r->cqes[head & r->cq_mask];
+		out[count].user_data = cqe->user_data;
+		out[count].res = cqe->res;
+		count++;
+		head++;
+	}
+
+	__atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+	return count;
+}
+
+int uring_poll(uring* ring, uring_completion* out, size_t max, size_t min, size_t* count) {
+	if (min > ring->inflight) {
+		min = ring->inflight;
+	}
+	if (min > max) {
+		min = max;
+	}
+
+	size_t got = 0;
+	int rc = 0;
+
+	if (ring->backend == URING_KERNEL) {
+		got = _kernel_reap(ring, out, max);
+		while (got < min) {
+			// 完成队列中的结果不足时, 进入内核等待
+			if (_io_uring_enter(ring->fd, 0, (uint32_t)(min - got), IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+				rc = errno;
+				break;
+			}
+			got += _kernel_reap(ring, out + got, max - got);
+		}
+	}
+	else {
+		pthread_mutex_lock(&ring->mut);
+		while (ring->done_len < min) {
+			pthread_cond_wait(&ring->cond, &ring->mut);
+		}
+		while (ring->done_len > 0 && got < max) {
+			out[got++] = ring->done[ring->done_head];
+			ring->done_head = (ring->done_head + 1) % ring->capacity;
+			ring->done_len--;
+		}
+		pthread_mutex_unlock(&ring->mut);
+	}
+
+	ring->inflight -= got;
+	*count = got;
+	return rc;
+}
+
+size_t uring_inflight(const uring* ring) {
+	return ring->inflight;
+}
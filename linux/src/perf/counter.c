@@ -0,0 +1,189 @@
+#define _GNU_SOURCE
+
+#include "perf.h"
+
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/// @brief 计数器的 `perf_event_attr.type` 和 `perf_event_attr.config` 字段, 以及名称
+static const struct {
+	uint32_t type;
+	uint64_t config;
+	const char* name;
+} COUNTERS[PERF_COUNTER_COUNT] = {
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache-misses" },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch-misses" },
+	{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task-clock" },
+	{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "page-faults" },
+	{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "context-switches" },
+};
+
+/// @brief 计数器的读取格式, 对应 `PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING`
+typedef struct __read_format {
+	uint64_t value;		   // 计数
+	uint64_t time_enabled; // 计数器处于启用状态的时间
+	uint64_t time_running; // 计数器实际占用硬件进行计数的时间
+} read_format;
+
+const char* perf_counter_name(perf_counter_id id) {
+	return id < PERF_COUNTER_COUNT ? COUNTERS[id].name : "unknown";
+}
+
+/// @brief 打开一个计数器
+///
+/// @param id 计数器
+/// @param inherit 是否统计之后创建的子进程和线程
+/// @param exclude_kernel 是否只统计用户态
+/// @return 计数器句柄, 失败时返回 `-1`
+static int _open(perf_counter_id id, bool inherit, bool exclude_kernel) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+
+	attr.size = sizeof(attr);
+	attr.type = COUNTERS[id].type;
+	attr.config = COUNTERS[id].config;
+	attr.disabled = 1;
+	attr.inherit = inherit ? 1 : 0;
+	attr.exclude_kernel = exclude_kernel ? 1 : 0;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	// `pid` 为 `0`, `cpu` 为 `-1` 表示统计当前进程在任意 CPU 上的执行
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+int perf_counters_open(perf_counters* pc, bool inherit) {
+	int rc = ENOENT;
+	bool any = false;
+
+	memset(pc->values, 0, sizeof(pc->values));
+	for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+		// `perf_event_paranoid` 为 `2` 时 (多数发行版的默认值), 非特权进程只能统计用户态
+		int fd = _open((perf_counter_id)i, inherit, false);
+		if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+			fd = _open((perf_counter_id)i, inherit, true);
+		}
+
+		pc->fds[i] = fd;
+		if (fd >= 0) {
+			any = true;
+		}
+		else {
+			rc = errno;
+		}
+	}
+	return any ? 0 : rc;
+}
+
+void perf_counters_close(perf_counters* pc) {
+	for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+		if (pc->fds[i] >= 0) {
+			close(pc->fds[i]);
+			pc->fds[i] = -1;
+		}
+	}
+}
+
+bool perf_counter_available(const perf_counters* pc, perf_counter_id id) {
+	return id < PERF_COUNTER_COUNT && pc->fds[id] >= 0;
+}
+
+void perf_counters_start(perf_counters* pc) {
+	for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+		if (pc->fds[i] >= 0) {
+			ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+void perf_counters_stop(perf_counters* pc) {
+	for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+		if (pc->fds[i] >= 0) {
+			ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+
+	for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+		pc->values[i] = 0;
+		if (pc->fds[i] < 0) {
+			continue;
+		}
+
+		read_format rf;
+		if (read(pc->fds[i], &rf, sizeof(rf)) != (ssize_t)sizeof(rf)) {
+			continue;
+		}
+
+		// 分时复用时, 按实际计数时间占启用时间的比例估算完整计数
+		if (rf.time_running > 0 && rf.time_running < rf.time_enabled) {
+			rf.value = (uint64_t)((double)rf.value * rf.time_enabled / rf.time_running);
+		}
+		pc->values[i] = rf.value;
+	}
+}
+
+/// @brief 向缓冲区追加以空格分隔的格式化文本, 缓冲区不足时只累计所需的字符数
+///
+/// @param buf 输出缓冲区
+/// @param len 输出缓冲区长度
+/// @param total 已输出 (或所需) 的字符数
+/// @param fmt 格式字符串
+/// @return 追加后的字符数
+static int _append(char* buf, size_t len, int total, const char* fmt, ...) {
+	char item[64];
+
+	va_list vl;
+	va_start(vl, fmt);
+	vsnprintf(item, sizeof(item), fmt, vl);
+	va_end(vl);
+
+	size_t used = (size_t)total < len ? (size_t)total : len;
+	return total + snprintf(buf + used, len - used, "%s%s", total ? " " : "", item);
+}
+
+int perf_counters_format(const perf_counters* pc, char* buf, size_t len) {
+	// 软件计数器始终可用, 先输出
+	static const perf_counter_id ORDER[PERF_COUNTER_COUNT] = {
+		PERF_TASK_CLOCK, PERF_PAGE_FAULTS, PERF_CONTEXT_SWITCHES,
+		PERF_CYCLES, PERF_INSTRUCTIONS, PERF_CACHE_MISSES, PERF_BRANCH_MISSES,
+	};
+
+	int total = 0;
+	if (len > 0) {
+		buf[0] = '\0';
+	}
+
+	for (int k = 0; k < PERF_COUNTER_COUNT; k++) {
+		perf_counter_id id = ORDER[k];
+		if (!perf_counter_available(pc, id)) {
+			continue;
+		}
+		if (id == PERF_TASK_CLOCK) {
+			total = _append(buf, len, total, "%s=%.3fms", COUNTERS[id].name, (double)pc->values[id] / 1e6);
+		}
+		else {
+			total = _append(buf, len, total, "%s=%llu", COUNTERS[id].name, (unsigned long long)pc->values[id]);
+		}
+	}
+
+	// 推导指标: IPC 反映计算密集程度, 每千条指令的缓存未命中次数 (MPKI) 反映访存密集程度
+	uint64_t cycles = pc->values[PERF_CYCLES];
+	uint64_t instructions = pc->values[PERF_INSTRUCTIONS];
+	if (perf_counter_available(pc, PERF_CYCLES) && perf_counter_available(pc, PERF_INSTRUCTIONS) && cycles > 0) {
+		total = _append(buf, len, total, "IPC=%.2f", (double)instructions / cycles);
+	}
+	if (perf_counter_available(pc, PERF_CACHE_MISSES) && perf_counter_available(pc, PERF_INSTRUCTIONS)
+		&& instructions > 0) {
+		total = _append(buf, len, total, "cache-MPKI=%.2f", (double)pc->values[PERF_CACHE_MISSES] * 1000 / instructions);
+	}
+	return total;
+}
@@ -1,11 +1,22 @@
+#define _GNU_SOURCE
+
 #include "process.h"
 
 #include <unistd.h>
+#include <spawn.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
 #include <sys/wait.h>
 #include <stdarg.h>
 #include <errno.h>
 #include <stdio.h>
 
+// 当前进程的环境变量, 传递给 `posix_spawn`
+extern char** environ;
+
 /// @brief 定义支持不定参数的 `perrorf` 宏
 ///
 /// 该宏和 `perror` 函数作用类似, 但支持在生成错误文本时, 支持格式化
@@ -48,6 +59,156 @@ int _va_args(const char* out[], size_t len, const char* arg, va_list vl) {
 	return 0;
 }
 
+spawn_backend spawn_backend_default(void) {
+	static spawn_backend backend = SPAWN_AUTO;
+
+	if (backend == SPAWN_AUTO) {
+		const char* env = getenv("LINUX_SPAWN");
+		backend = env && strcmp(env, "fork") == 0 ? SPAWN_FORK : SPAWN_POSIX;
+	}
+	return backend;
+}
+
+/// @brief 创建子进程运行可执行文件, 并可选地将子进程的标准输出和标准错误重定向到指定句柄
+///
+/// @param backend 创建子进程的方式
+/// @param path 可执行文件路径
+/// @param argv 命令行参数列表, 以 `NULL` 结尾
+/// @param out_fd 子进程标准输出的重定向目标, 为 `-1` 时不重定向
+/// @param err_fd 子进程标准错误的重定向目标, 为 `-1` 时不重定向
+/// @param pid 用于保存子进程 ID 的指针
+/// @return `0` 表示成功, 其它值表示失败
+static int _spawn_redirected(spawn_backend backend, const char* path, char* const argv[], int out_fd, int err_fd,
+							 pid_t* pid) {
+	if (backend == SPAWN_AUTO) {
+		backend = spawn_backend_default();
+	}
+
+	if (backend == SPAWN_POSIX) {
+		posix_spawn_file_actions_t fa;
+		posix_spawn_file_actions_t* pfa = NULL;
+
+		// `dup2` 会清除目标句柄的 `FD_CLOEXEC` 标志, 其余以 `O_CLOEXEC` 打开的句柄在 `exec` 时自动关闭
+		if (out_fd >= 0 || err_fd >= 0) {
+			int rc = posix_spawn_file_actions_init(&fa);
+			if (rc != 0) {
+				return rc;
+			}
+			if (out_fd >= 0) {
+				posix_spawn_file_actions_adddup2(&fa, out_fd, STDOUT_FILENO);
+			}
+			if (err_fd >= 0) {
+				posix_spawn_file_actions_adddup2(&fa, err_fd, STDERR_FILENO);
+			}
+			pfa = &fa;
+		}
+
+		// glibc 的 `posix_spawn` 通过 `clone(CLONE_VM | CLONE_VFORK)` 创建子进程, 子进程和父进程共享地址空间,
+		// 无需复制页表, 父进程在子进程执行 `exec` 之前暂停; 故开销和父进程占用的内存大小无关
+		//
+		// `exec` 失败时, `posix_spawn` 直接返回错误值, 不会产生子进程
+		int rc = posix_spawn(pid, path, pfa, NULL, argv, environ);
+
+		if (pfa) {
+			posix_spawn_file_actions_destroy(pfa);
+		}
+		return rc;
+	}
+
+	// 和 `posix_spawn` 相同, 通过以 `O_CLOEXEC` 打开的管道将子进程 `execv` 失败的错误值传回父进程:
+	// `execv` 成功时管道随之关闭, 父进程读到 EOF; 失败时子进程写入 `errno`
+	int efd[2];
+	if (pipe2(efd, O_CLOEXEC) != 0) {
+		return errno;
+	}
+
+	// 启动子进程
+	pid_t child = fork();
+	if (child < 0) {
+		int rc = errno;
+		close(efd[0]);
+		close(efd[1]);
+		return rc;
+	}
+
+	if (child == 0) {
+		// 子进程只调用异步信号安全的函数, 多线程进程中 `fork` 出的子进程只有当前线程, 其它线程持有的锁不会被释放
+		close(efd[0]);
+		if (out_fd >= 0) {
+			dup2(out_fd, STDOUT_FILENO);
+		}
+		if (err_fd >= 0) {
+			dup2(err_fd, STDERR_FILENO);
+		}
+
+		// 在子进程中运行可执行文件
+		execv(path, argv);
+
+		// 无法执行时通过 `_exit` 结束, 不执行父进程注册的 `atexit` 函数, 也不再次输出继承的 `stdio` 缓冲区
+		int err = errno;
+		while (write(efd[1], &err, sizeof(err)) < 0 && errno == EINTR) {
+		}
+		_exit(255);
+	}
+
+	close(efd[1]);
+
+	int err = 0;
+	ssize_t n;
+	while ((n = read(efd[0], &err, sizeof(err))) < 0 && errno == EINTR) {
+	}
+	close(efd[0]);
+
+	if (n == (ssize_t)sizeof(err)) {
+		// 子进程无法执行, 回收子进程, 和 `posix_spawn` 一样不产生子进程
+		while (waitpid(child, NULL, 0) < 0 && errno == EINTR) {
+		}
+		return err;
+	}
+
+	*pid = child;
+	return 0;
+}
+
+int spawn_process(spawn_backend backend, const char* path, char* const argv[], pid_t* pid) {
+	return _spawn_redirected(backend, path, argv, -1, -1, pid);
+}
+
+/// @brief 启动子进程运行可执行文件, 无法执行时输出错误信息
+///
+/// @param path 可执行文件路径
+/// @param argv 命令行参数列表, 以 `NULL` 结尾
+/// @param pid 用于保存子进程 ID 的指针, 无法执行时设置为 `-1`
+/// @return `0` 表示成功, 其它值表示失败
+static int _spawn(const char* path, char* const argv[], pid_t* pid) {
+	*pid = -1;
+
+	int rc = spawn_process(SPAWN_AUTO, path, argv, pid);
+	if (rc != 0) {
+		perrorf(rc, "cannot execv %s", path);
+	}
+	return rc;
+}
+
+/// @brief 等待子进程结束
+///
+/// @param pid 子进程 ID, 为 `-1` 表示可执行文件无法执行
+/// @return 子进程状态值, 可执行文件无法执行时返回 `EXEC_FAILED_STATUS`, 等待失败时返回 `-1`
+static int _wait(pid_t pid) {
+	if (pid < 0) {
+		return EXEC_FAILED_STATUS;
+	}
+
+	int stat = 0;
+	while (waitpid(pid, &stat, 0) < 0) {
+		if (errno != EINTR) {
+			perror("cannot wait for child process");
+			return -1;
+		}
+	}
+	return stat;
+}
+
 int forked_execl(const char* path, const char* arg, ...) {
 	// 获取可变参数序列的起始指针
 	va_list vl;
@@ -62,28 +223,200 @@ int forked_execl(const char* path, const char* arg, ...) {
 
 	va_end(vl);
 
-	// 启动子进程
-	pid_t pid = fork();
-	if (pid < 0) {
-		perror("cannot fork new process");
-		return -1;
+	// 启动子进程, 之后等待子进程执行结束, 返回可执行文件执行结果
+	pid_t pid;
+	_spawn(path, (char* const*)args, &pid);
+	return _wait(pid);
+}
+
+int forked_execv_batch(const exec_cmd* cmds, size_t n, int* stats) {
+	pid_t* pids = (pid_t*)malloc(n * sizeof(pid_t));
+	if (!pids) {
+		return ENOMEM;
 	}
 
-	if (pid == 0) {
-		// 在子进程中运行可执行文件
-		int ret = execv(path, (char* const*)args);
-		if (ret < 0) {
-			perrorf(errno, "cannot execv %s", path);
-			exit(ret);
+	// 先启动全部子进程, 令各命令并发执行
+	int rc = 0;
+	for (size_t i = 0; i < n; i++) {
+		int e = _spawn(cmds[i].path, cmds[i].argv, &pids[i]);
+		if (e != 0 && rc == 0) {
+			rc = e;
 		}
 	}
-	else {
-		// 等待子进程执行结束, 返回可执行文件执行结果
-		int stat = 0;
-		if (waitpid(pid, &stat, 0) < 0) {
-			perror("cannot wait for child process");
-			return -1;
+
+	// 再按顺序等待, 等待的顺序不影响总耗时
+	for (size_t i = 0; i < n; i++) {
+		stats[i] = _wait(pids[i]);
+	}
+
+	free(pids);
+	return rc;
+}
+
+/// @brief 单次从管道读取的最小缓冲区空间
+#define _CAPTURE_READ_SIZE (64 * 1024)
+
+/// @brief 从管道中读取子进程的输出
+typedef struct __capture_stream {
+	int fd;		 // 管道 "读" 句柄, 读到 EOF 后关闭并设置为 `-1`
+	char* data;	 // 已读取的内容, 以 `\0` 结尾
+	size_t len;	 // 已读取的字节数
+	size_t cap;	 // `data` 的容量
+} capture_stream;
+
+/// @brief 读取管道中当前可读的全部数据, 缓冲区空间不足时按倍数扩容
+///
+/// @param cs 指向 `capture_stream` 结构体实例的指针
+/// @return `0` 表示成功, 其它值表示失败
+static int _capture_read(capture_stream* cs) {
+	for (;;) {
+		// 保留一个字节存放 `\0`
+		if (cs->cap - cs->len < _CAPTURE_READ_SIZE + 1) {
+			size_t cap = cs->cap ? cs->cap * 2 : _CAPTURE_READ_SIZE * 2;
+			char* p = (char*)realloc(cs->data, cap);
+			if (!p) {
+				return ENOMEM;
+			}
+			cs->data = p;
+			cs->cap = cap;
+		}
+
+		ssize_t n = read(cs->fd, cs->data + cs->len, cs->cap - cs->len - 1);
+		if (n > 0) {
+			cs->len += (size_t)n;
+			continue;
+		}
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n < 0 && errno == EAGAIN) {
+			return 0;
+		}
+
+		// 读到 EOF (或读取失败), 子进程已不会再输出
+		close(cs->fd);
+		cs->fd = -1;
+		return 0;
+	}
+}
+
+/// @brief 获取单调时钟的当前时间 (毫秒)
+static int64_t _now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int exec_capture(const char* path, char* const argv[], int timeout_ms, exec_output* res) {
+	memset(res, 0, sizeof(exec_output));
+
+	// 子进程的标准输出和标准错误各使用一个管道, 主进程一端设为非阻塞
+	capture_stream streams[2] = { { .fd = -1 }, { .fd = -1 } };
+	int wfds[2] = { -1, -1 };
+	pid_t pid = -1;
+	int64_t deadline = -1;
+	int rc = 0;
+
+	for (int i = 0; i < 2; i++) {
+		int pfds[2];
+		if (pipe2(pfds, O_CLOEXEC) != 0) {
+			rc = errno;
+			goto cleanup;
 		}
-		return stat;
+		fcntl(pfds[0], F_SETFL, fcntl(pfds[0], F_GETFL) | O_NONBLOCK);
+		streams[i].fd = pfds[0];
+		wfds[i] = pfds[1];
 	}
+
+	rc = _spawn_redirected(SPAWN_AUTO, path, argv, wfds[0], wfds[1], &pid);
+
+	// 关闭主进程中的 "写" 句柄, 子进程 (及其后代) 全部退出后管道即读到 EOF
+	for (int i = 0; i < 2; i++) {
+		close(wfds[i]);
+		wfds[i] = -1;
+	}
+	if (rc != 0) {
+		goto cleanup;
+	}
+
+	// 在子进程运行期间同时读取两个管道, 避免任一管道写满导致子进程阻塞
+	deadline = timeout_ms < 0 ? -1 : _now_ms() + timeout_ms;
+	while (streams[0].fd >= 0 || streams[1].fd >= 0) {
+		int wait_ms = -1;
+		if (deadline >= 0) {
+			int64_t rest = deadline - _now_ms();
+			if (rest <= 0) {
+				// 超时, 结束子进程; 子进程的后代可能仍持有管道, 故不再等待 EOF
+				kill(pid, SIGKILL);
+				res->timed_out = true;
+				break;
+			}
+			wait_ms = (int)rest;
+		}
+
+		struct pollfd pfds[2];
+		for (int i = 0; i < 2; i++) {
+			pfds[i].fd = streams[i].fd;
+			pfds[i].events = POLLIN;
+			pfds[i].revents = 0;
+		}
+
+		int n = poll(pfds, 2, wait_ms);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			rc = errno;
+			kill(pid, SIGKILL);
+			break;
+		}
+
+		for (int i = 0; i < 2 && rc == 0; i++) {
+			if (pfds[i].revents) {
+				rc = _capture_read(&streams[i]);
+			}
+		}
+		if (rc != 0) {
+			kill(pid, SIGKILL);
+			break;
+		}
+	}
+
+	while (waitpid(pid, &res->status, 0) < 0 && errno == EINTR) {
+	}
+	if (rc == 0 && res->timed_out) {
+		rc = ETIMEDOUT;
+	}
+
+cleanup:
+	for (int i = 0; i < 2; i++) {
+		if (streams[i].fd >= 0) {
+			close(streams[i].fd);
+		}
+		if (wfds[i] >= 0) {
+			close(wfds[i]);
+		}
+	}
+
+	// 没有任何输出时返回空字符串, 便于调用方统一处理
+	char** outs[2] = { &res->out, &res->err };
+	size_t* lens[2] = { &res->out_len, &res->err_len };
+	for (int i = 0; i < 2; i++) {
+		if (!streams[i].data) {
+			streams[i].data = (char*)calloc(1, 1);
+		}
+		else {
+			streams[i].data[streams[i].len] = '\0';
+		}
+		*outs[i] = streams[i].data;
+		*lens[i] = streams[i].len;
+	}
+	return rc;
+}
+
+void exec_output_free(exec_output* res) {
+	free((void*)res->out);
+	free((void*)res->err);
+	res->out = res->err = NULL;
+	res->out_len = res->err_len = 0;
 }
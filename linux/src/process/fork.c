@@ -1,6 +1,8 @@
 #include "process.h"
+#include "cpu.h"
 
 #include <unistd.h>
+#include <stdbool.h>
 #include <sys/wait.h>
 #include <memory.h>
 
@@ -95,6 +97,34 @@ worker_t execute_worker(worker_func worker, fork_msg* msg) {
 	}
 }
 
+/// @brief `multiple_process_worker` 中单个子进程的消息收集状态
+typedef struct __collect_ctx {
+	worker_t* w;	// 函数返回值
+	fork_msg* msgs; // 消息数组
+	size_t index;	// 子进程的创建顺序
+	size_t received; // 已收到的消息字节数
+} collect_ctx;
+
+/// @brief 收到子进程数据时, 按子进程的创建顺序写入对应的消息, 超过 `MSG_SIZE` 的部分被丢弃
+static void _collect_data(pid_t pid, const char* data, size_t len, void* ctx) {
+	collect_ctx* c = (collect_ctx*)ctx;
+	(void)pid;
+
+	if (c->received < MSG_SIZE) {
+		size_t n = len < MSG_SIZE - c->received ? len : MSG_SIZE - c->received;
+		memcpy((byte_t*)(c->msgs + c->index) + c->received, data, n);
+	}
+	c->received += len;
+}
+
+/// @brief 子进程结束时, 记录其状态值
+static void _collect_exit(pid_t pid, int stat, void* ctx) {
+	collect_ctx* c = (collect_ctx*)ctx;
+	(void)pid;
+
+	c->w->stats[c->index] = stat;
+}
+
 worker_t multiple_process_worker(worker_func worker, size_t proc_n, fork_msg* msgs) {
 	worker_t w = { 0 };
 
@@ -102,90 +132,51 @@ worker_t multiple_process_worker(worker_func worker, size_t proc_n, fork_msg* ms
 		return w;
 	}
 
-	// 定义管道句柄数组, 包含两个管道句柄, 下标 `0` 表示读句柄, 下标 `1` 表示写句柄
-	int pfds[2];
-
-	// 建立管道, 并返回一对管道句柄, 保存到 `pfds` 数组中
-	if (pipe(pfds) != 0) {
+	// 通过事件循环同时收集各子进程的消息并回收子进程, 每个子进程使用独立的管道,
+	// 以免运行较慢的子进程阻塞其它子进程的消息收集
+	reactor* r;
+	if (reactor_create(&r) != 0) {
 		abort();
 	}
 
+	// 读取 CPU 布局, 用于确定各子进程绑定的 CPU; 无法读取时不进行绑定
+	placement_mode mode = placement_default();
+	cpu_layout layout;
+	bool has_layout = cpu_layout_init(&layout) == 0;
+	if (!has_layout) {
+		mode = PLACEMENT_NONE;
+	}
+
+	collect_ctx ctxs[16];
+
 	// 启动 `proc_n` 参数值个子进程
 	for (size_t i = 0; i < proc_n; i++) {
-		pid_t pid = fork();
-		if (pid < 0) {
-			// 如果 `fork` 函数返回负数, 表示子进程创建失败
-			abort();
-		}
-		else if (pid > 0) {
-			// 如果 `fork` 函数返回大于 `0` 的值, 表示子进程创建成功, 且当前代码在父进程中执行
-			// 记录子进程 pid
-			w.pids[i] = pid;
+		ctxs[i] = (collect_ctx){ &w, msgs, i, 0 };
+		child_handler h = { _collect_data, _collect_exit, &ctxs[i] };
 
-			// 设置子进程分组
-			setpgid(pid, w.pids[0]);
+		// 在 `fork` 之前确定第 `i` 个子进程绑定的 CPU, 子进程首次写入的内存将分配在该 CPU 所在的节点上
+		if (reactor_spawn(r, worker, cpu_layout_pick(&layout, mode, i), &h, &w.pids[i]) != 0) {
+			abort();
 		}
-		else {
-			// 如果 `fork` 函数返回等于 `0` 的值, 表示代码在子进程中执行
-			// 则关闭管道 "读" 句柄
-			close(pfds[READ]);
-
-			// 执行子进程入口函数
-			int retcode = worker(pfds[WRITE]);
-
-			// 子进程函数执行完毕, 关闭管道 "写" 句柄
-			close(pfds[WRITE]);
+	}
 
-			// 通过 `exit` 函数和函数返回值结束子进程
-			// `exit` 参数值可以通过 `waitpid` 函数的第二个参数返回, 并通过 `WEXITSTATUS` 宏获取该值
-			exit(retcode);
-		}
+	if (has_layout) {
+		cpu_layout_free(&layout);
 	}
 
-	// 在主进程中关闭管道 "写" 句柄
-	close(pfds[WRITE]);
+	// 等待全部子进程完成
+	if (reactor_run(r, -1) != 0) {
+		abort();
+	}
+	reactor_destroy(r);
 
-	// 遍历所有子进程 PID, 通过管道 "读" 句柄读取子进程发送的消息
+	// 消息不完整的子进程视为发送失败, 和原先读取固定长度消息时的处理一致
 	for (size_t i = 0; i < proc_n; i++) {
-		fork_msg msg;
-
-		// 通过管道 "读" 句柄读取子进程发送的消息
-		ssize_t n = read(pfds[READ], &msg, MSG_SIZE);
-		if (n != MSG_SIZE) {
+		if (ctxs[i].received != MSG_SIZE) {
 			abort();
 		}
-
-		int stat = 0;
-
-		// 等待指定 PID 的子进程结束, 即刚刚发送消息的子进程
-		// if (waitpid(msg.s_pid, &stat, 0) != msg.s_pid) {
-		// 	abort();
-		// }
-
-		// 等待进程组号为 `w.pids[0]` (即第一个子进程 PID) 的子进程组中任意进程结束
-		// 该函数返回等待成功的子进程 ID, 将会是进程组中的随机一个子进程
-		pid_t pid = waitpid(-1 * w.pids[0], &stat, 0);
-
-		// 如下循环中, 最终会将 `w.stats` 数组和 `msgs` 数组的所有元素填充完毕,
-		// 但由于 `waitpid` 函数并不是按子进程 PID 进行等待的, 所以每次获得的 `stat`
-		// 值和 `msg` 并不一定是同一个子进程相关的, 但循环结束后, 所有子进程的 `stat`
-		// 以及 `msg` 都会获取到
-		for (size_t j = 0; j < proc_n; j++) {
-			// 查找等待成功的子进程的创建顺序 (即第 `j` 个创建的子进程)
-			if (w.pids[j] == pid) {
-				w.stats[j] = stat;
-			}
-
-			// 查找发送消息的子进程的创建顺序 (即第 `j` 个创建的子进程)
-			if (w.pids[j] == msg.s_pid) {
-				memcpy(msgs + j, &msg, MSG_SIZE);
-			}
-		}
 	}
 
-	// 在主进程中关闭管道 "读" 句柄
-	close(pfds[READ]);
-
 	// 记录子进程总数
 	w.size = proc_n;
 	return w;
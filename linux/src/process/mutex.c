@@ -1 +1,382 @@
+#define _GNU_SOURCE
+
 #include "process.h"
+
+#include <unistd.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// 等待前自旋检查的次数
+#define SPIN_COUNT 100
+
+// 锁字中表示有等待者的位, 持有者已退出的位, 以及持有者线程 ID 的掩码, 由内核处理 robust 链表时使用
+#define WAITERS_BIT FUTEX_WAITERS
+#define OWNER_DIED_BIT FUTEX_OWNER_DIED
+#define TID_MASK FUTEX_TID_MASK
+
+// 互斥锁的状态
+#define STATE_CONSISTENT 0	   // 正常
+#define STATE_INCONSISTENT 1   // 前一个持有者已退出, 当前持有者尚未调用 `shm_mutex_consistent`
+#define STATE_NOTRECOVERABLE 2 // 不可恢复
+
+/// @brief 在 `addr` 指向的值等于 `val` 时休眠; 等待和唤醒发生在不同进程中, 故不使用 `FUTEX_PRIVATE_FLAG`
+///
+/// @param addr futex 地址
+/// @param val 期望的值
+/// @param timeout_ms 超时时间 (毫秒), 为负数时不超时
+/// @return `0` 表示被唤醒 (或值已改变), `ETIMEDOUT` 表示超时
+inline static int _futex_wait(uint32_t* addr, uint32_t val, int timeout_ms) {
+	struct timespec ts = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000 };
+
+	if (syscall(SYS_futex, addr, FUTEX_WAIT, val, timeout_ms < 0 ? NULL : &ts, NULL, 0) != 0 && errno == ETIMEDOUT) {
+		return ETIMEDOUT;
+	}
+	return 0;
+}
+
+/// @brief 唤醒在 `addr` 上等待的至多 `n` 个线程
+///
+/// @param addr futex 地址
+/// @param n 唤醒的线程数
+inline static void _futex_wake(uint32_t* addr, int n) {
+	syscall(SYS_futex, addr, FUTEX_WAKE, n, NULL, NULL, 0);
+}
+
+/// @brief 提示 CPU 当前处于自旋等待中
+inline static void _cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	__asm__ __volatile__("pause");
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+// 当前线程 ID 的缓存, `fork` 后在子进程中清除
+static __thread pid_t _tid = 0;
+
+// 当前线程的 robust 链表, 链接当前线程持有的全部锁, 线程退出时由内核遍历, 将其中仍被持有的锁标记为持有者已退出,
+// 并唤醒一个等待者. 链表节点为 `shm_mutex` 的 `next` 字段, `futex_offset` 为锁字相对节点的偏移量
+static __thread struct robust_list_head _robust = { { NULL }, 0, NULL };
+
+// 每个线程只能向内核注册一个 robust 链表, 故只在当前线程持有锁期间注册 `_robust`, 链表变为空时恢复原先注册的链表
+// (通常为 glibc 为 `PTHREAD_MUTEX_ROBUST` 互斥锁注册的链表)
+static __thread struct robust_list_head* _saved_head = NULL;
+
+/// @brief `fork` 后在子进程中清除线程 ID 缓存, 子进程未持有任何锁, 且 glibc 已在子进程中重新注册了其 robust 链表
+static void _clear_tid(void) {
+	_tid = 0;
+}
+
+/// @brief 注册 `_clear_tid` 函数
+static void _register_atfork(void) {
+	pthread_atfork(NULL, NULL, _clear_tid);
+}
+
+/// @brief 获取当前线程 ID, 首次调用后缓存, 避免每次加锁都执行系统调用
+///
+/// 首次调用时同时初始化当前线程的 robust 链表, 并记录当前线程已向内核注册的 robust 链表, 以便之后恢复
+///
+/// @return 线程 ID
+static uint32_t _self(void) {
+	static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+	if (_tid == 0) {
+		pthread_once(&once, _register_atfork);
+
+		_robust.list.next = &_robust.list;
+		_robust.futex_offset = (long)(offsetof(shm_mutex, word) - offsetof(shm_mutex, next));
+		_robust.list_op_pending = NULL;
+
+		size_t len;
+		if (syscall(SYS_get_robust_list, 0, &_saved_head, &len) != 0) {
+			_saved_head = NULL;
+		}
+
+		_tid = (pid_t)syscall(SYS_gettid);
+	}
+	return (uint32_t)_tid;
+}
+
+/// @brief 当前线程未持有任何锁时, 向内核注册 `_robust` 链表, 须在修改锁字之前调用
+///
+/// 当前线程持有锁期间, 原先注册的链表不会被内核遍历, 即此期间当前线程持有的 `PTHREAD_MUTEX_ROBUST` 互斥锁
+/// 在线程退出时不会被标记
+static void _attach(void) {
+	if (_robust.list.next == &_robust.list) {
+		syscall(SYS_set_robust_list, &_robust, sizeof(_robust));
+	}
+}
+
+/// @brief 当前线程已不持有任何锁时, 恢复原先注册的 robust 链表, 须在清除 `list_op_pending` 之后调用
+static void _detach(void) {
+	if (_robust.list.next == &_robust.list) {
+		syscall(SYS_set_robust_list, _saved_head, sizeof(_robust));
+	}
+}
+
+/// @brief 记录当前线程正在加锁或解锁的锁, 线程在修改锁字和修改链表之间退出时, 内核同样会检查该锁
+///
+/// 内核只在当前线程退出后读取, 故只需保证编译器不将其和前后的锁操作重排
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针, 为 `NULL` 时清除
+inline static void _set_pending(shm_mutex* m) {
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	_robust.list_op_pending = m ? (struct robust_list*)&m->next : NULL;
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+}
+
+/// @brief 将取得的锁加入当前线程的 robust 链表头部
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+static void _enqueue(shm_mutex* m) {
+	struct robust_list* first = _robust.list.next;
+
+	m->prev = &_robust.list;
+	m->next = first;
+	if (first != &_robust.list) {
+		((shm_mutex*)first)->prev = &m->next;
+	}
+	_robust.list.next = (struct robust_list*)&m->next;
+}
+
+/// @brief 将锁从当前线程的 robust 链表中移除
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+static void _dequeue(shm_mutex* m) {
+	struct robust_list* prev = m->prev;
+	struct robust_list* next = m->next;
+
+	prev->next = next;
+	if (next != &_robust.list) {
+		((shm_mutex*)next)->prev = prev;
+	}
+}
+
+/// @brief 释放锁字, 锁不可恢复时唤醒全部等待者令其返回错误
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+static void _release(shm_mutex* m) {
+	// 前一个持有者退出后, 当前持有者未恢复就解锁, 则锁变为不可恢复
+	// 只有持有者会修改处于 `STATE_INCONSISTENT` 状态的锁, 故无需原子的读-改-写操作, 令无竞争时的解锁只有一次原子交换
+	uint32_t state = __atomic_load_n(&m->state, __ATOMIC_RELAXED);
+	if (state == STATE_INCONSISTENT) {
+		state = STATE_NOTRECOVERABLE;
+		__atomic_store_n(&m->state, state, __ATOMIC_RELAXED);
+	}
+	bool broken = state == STATE_NOTRECOVERABLE;
+
+	uint32_t v = __atomic_exchange_n(&m->word, 0, __ATOMIC_RELEASE);
+	if (v & WAITERS_BIT) {
+		_futex_wake(&m->word, broken ? INT_MAX : 1);
+	}
+}
+
+/// @brief 取得锁之后检查锁的状态, 锁可用时将其加入当前线程的 robust 链表
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+/// @param rc 取得锁时的结果, `0` 或 `EOWNERDEAD`
+/// @return 参见 `shm_mutex_lock` 函数
+static int _acquired(shm_mutex* m, int rc) {
+	if (__atomic_load_n(&m->state, __ATOMIC_ACQUIRE) == STATE_NOTRECOVERABLE) {
+		_release(m);
+		return ENOTRECOVERABLE;
+	}
+	_enqueue(m);
+	return rc;
+}
+
+/// @brief 接管已退出的持有者的锁, 内核已将锁字的持有者清零并设置 `OWNER_DIED_BIT`
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+/// @param v 锁字的当前值
+/// @param self 当前线程 ID
+/// @return 接管成功时返回 `EOWNERDEAD` (或 `ENOTRECOVERABLE`), 锁字已被其它线程修改时返回 `EAGAIN`
+static int _take_over(shm_mutex* m, uint32_t v, uint32_t self) {
+	// 内核只唤醒一个等待者, 接管后可能还有其它等待者, 故总是设置等待者位
+	if (!__atomic_compare_exchange_n(&m->word, &v, self | WAITERS_BIT, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return EAGAIN;
+	}
+
+	// 已不可恢复的锁保持不可恢复, 否则标记为需要恢复
+	uint32_t expected = STATE_CONSISTENT;
+	__atomic_compare_exchange_n(&m->state, &expected, STATE_INCONSISTENT, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	return _acquired(m, EOWNERDEAD);
+}
+
+/// @brief 尝试加锁, 不等待
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+/// @param self 当前线程 ID
+/// @return 参见 `shm_mutex_trylock` 函数, 锁字被并发修改时返回 `EAGAIN`
+static int _trylock(shm_mutex* m, uint32_t self) {
+	uint32_t v = 0;
+
+	if (__atomic_compare_exchange_n(&m->word, &v, self, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return _acquired(m, 0);
+	}
+	if (v & OWNER_DIED_BIT) {
+		return _take_over(m, v, self);
+	}
+	return EBUSY;
+}
+
+/// @brief 加锁, 参见 `shm_mutex_lock` 函数
+///
+/// @param m 指向 `shm_mutex` 结构体实例的指针
+/// @param self 当前线程 ID
+/// @return 参见 `shm_mutex_lock` 函数
+static int _lock(shm_mutex* m, uint32_t self) {
+	uint32_t v = 0;
+
+	// 无竞争时只需一次 CAS
+	if (__atomic_compare_exchange_n(&m->word, &v, self, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return _acquired(m, 0);
+	}
+
+	// 短暂自旋, 持有者通常很快就会解锁, 自旋可以避免休眠和唤醒的系统调用
+	for (int spin = 0; spin < SPIN_COUNT; spin++) {
+		_cpu_relax();
+		v = __atomic_load_n(&m->word, __ATOMIC_RELAXED);
+		if (v == 0 && __atomic_compare_exchange_n(&m->word, &v, self, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return _acquired(m, 0);
+		}
+	}
+
+	for (;;) {
+		v = __atomic_load_n(&m->word, __ATOMIC_RELAXED);
+
+		// 进入休眠流程后不能确定是否还有其它等待者, 故取得锁时总是设置等待者位, 由解锁时唤醒
+		if (v == 0) {
+			if (__atomic_compare_exchange_n(&m->word, &v, self | WAITERS_BIT, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+				return _acquired(m, 0);
+			}
+			continue;
+		}
+
+		// 持有者退出时, 内核清除锁字中的持有者并设置 `OWNER_DIED_BIT`
+		if (v & OWNER_DIED_BIT) {
+			int rc = _take_over(m, v, self);
+			if (rc != EAGAIN) {
+				return rc;
+			}
+			continue;
+		}
+
+		if (!(v & WAITERS_BIT)
+			&& !__atomic_compare_exchange_n(&m->word, &v, v | WAITERS_BIT, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			continue;
+		}
+
+		// 持有者解锁, 或退出后由内核唤醒
+		_futex_wait(&m->word, v | WAITERS_BIT, -1);
+	}
+}
+
+int shm_mutex_trylock(shm_mutex* m) {
+	uint32_t self = _self();
+	int rc;
+
+	// 锁被正常持有时直接返回, 避免注册和恢复 robust 链表的两次系统调用
+	uint32_t v = __atomic_load_n(&m->word, __ATOMIC_RELAXED);
+	if (v != 0 && !(v & OWNER_DIED_BIT)) {
+		return EBUSY;
+	}
+
+	_attach();
+	_set_pending(m);
+	do {
+		rc = _trylock(m, self);
+	} while (rc == EAGAIN);
+	_set_pending(NULL);
+	_detach();
+	return rc;
+}
+
+int shm_mutex_lock(shm_mutex* m) {
+	uint32_t self = _self();
+
+	_attach();
+	_set_pending(m);
+	int rc = _lock(m, self);
+	_set_pending(NULL);
+	_detach();
+	return rc;
+}
+
+int shm_mutex_unlock(shm_mutex* m) {
+	if ((__atomic_load_n(&m->word, __ATOMIC_RELAXED) & TID_MASK) != _self()) {
+		return EPERM;
+	}
+
+	_set_pending(m);
+	_dequeue(m);
+	_release(m);
+	_set_pending(NULL);
+	_detach();
+	return 0;
+}
+
+int shm_mutex_consistent(shm_mutex* m) {
+	if ((__atomic_load_n(&m->word, __ATOMIC_RELAXED) & TID_MASK) != _self()) {
+		return EINVAL;
+	}
+
+	uint32_t expected = STATE_INCONSISTENT;
+	if (!__atomic_compare_exchange_n(&m->state, &expected, STATE_CONSISTENT, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+		return EINVAL;
+	}
+	return 0;
+}
+
+int shm_cond_wait(shm_cond* c, shm_mutex* m) {
+	// 解锁前读取序号, 解锁后到休眠前发出的通知会改变序号, 令 futex 立即返回, 不会丢失
+	uint32_t seq = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+
+	shm_mutex_unlock(m);
+	_futex_wait(&c->seq, seq, -1);
+	return shm_mutex_lock(m);
+}
+
+void shm_cond_signal(shm_cond* c) {
+	__atomic_add_fetch(&c->seq, 1, __ATOMIC_RELEASE);
+	_futex_wake(&c->seq, 1);
+}
+
+void shm_cond_broadcast(shm_cond* c) {
+	__atomic_add_fetch(&c->seq, 1, __ATOMIC_RELEASE);
+	_futex_wake(&c->seq, INT_MAX);
+}
+
+void shm_barrier_init(shm_barrier* b, uint32_t count) {
+	b->count = count;
+	b->arrived = 0;
+	b->generation = 0;
+}
+
+int shm_barrier_wait(shm_barrier* b) {
+	uint32_t gen = __atomic_load_n(&b->generation, __ATOMIC_ACQUIRE);
+
+	// 最后到达的参与者先重置计数, 再推进轮次, 令被唤醒的参与者可以立即进入下一轮
+	if (__atomic_add_fetch(&b->arrived, 1, __ATOMIC_ACQ_REL) == b->count) {
+		__atomic_store_n(&b->arrived, 0, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&b->generation, 1, __ATOMIC_RELEASE);
+		_futex_wake(&b->generation, INT_MAX);
+		return 1;
+	}
+
+	for (int spin = 0; __atomic_load_n(&b->generation, __ATOMIC_ACQUIRE) == gen; spin++) {
+		if (spin < SPIN_COUNT) {
+			_cpu_relax();
+		}
+		else {
+			_futex_wait(&b->generation, gen, -1);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,526 @@
+#include "process.h"
+#include "cpu.h"
+
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <memory.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+
+/// @brief 帧头, 请求帧和响应帧均由帧头和 `len` 字节的内容组成
+typedef struct __frame_header {
+	uint32_t len;	// 帧内容长度
+	int32_t status; // 响应状态值, 请求帧中不使用
+} frame_header;
+
+/// @brief 工作进程
+typedef struct __prefork_worker {
+	pid_t pid; // 工作进程 ID
+	int fd;	   // 主进程一端的通信句柄, 为 `-1` 表示工作进程已退出, 需要重新创建
+	int cpu;   // 工作进程绑定的 CPU, 为 `-1` 表示不绑定
+} prefork_worker;
+
+/// @brief 进程池
+struct __prefork_pool {
+	size_t size;			 // 工作进程数
+	prefork_handler handler; // 处理请求的回调函数
+	void* ctx;				 // 回调函数的上下文指针
+	prefork_worker* workers; // 工作进程数组
+	size_t* idle;			 // 空闲工作进程下标的栈, 最近归还的工作进程最先被选中
+	size_t idle_n;			 // 空闲工作进程数
+	pthread_mutex_t lock;	 // 保护空闲栈以及工作进程的创建
+	pthread_cond_t cond;	 // 有工作进程归还时发出通知
+};
+
+int frame_buf_reserve(frame_buf* buf, size_t cap) {
+	if (cap <= buf->cap) {
+		return 0;
+	}
+
+	// 按倍数扩容, 令反复追加内容的均摊开销为常数
+	size_t n = buf->cap ? buf->cap : 64;
+	while (n < cap) {
+		n *= 2;
+	}
+
+	char* p = (char*)realloc(buf->data, n);
+	if (!p) {
+		return ENOMEM;
+	}
+	buf->data = p;
+	buf->cap = n;
+	return 0;
+}
+
+int frame_buf_append(frame_buf* buf, const void* data, size_t len) {
+	int rc = frame_buf_reserve(buf, buf->len + len);
+	if (rc == 0 && len > 0) {
+		memcpy(buf->data + buf->len, data, len);
+		buf->len += len;
+	}
+	return rc;
+}
+
+void frame_buf_free(frame_buf* buf) {
+	free((void*)buf->data);
+	buf->data = NULL;
+	buf->len = 0;
+	buf->cap = 0;
+}
+
+/// @brief 从句柄中读取恰好 `len` 字节
+///
+/// @param fd 句柄
+/// @param data 保存内容的缓冲区
+/// @param len 要读取的字节数
+/// @return `0` 表示成功, `EPIPE` 表示对端已关闭, 其它值表示失败
+static int _read_full(int fd, void* data, size_t len) {
+	char* p = (char*)data;
+	while (len > 0) {
+		ssize_t n = read(fd, p, len);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return errno == ECONNRESET ? EPIPE : errno;
+		}
+		if (n == 0) {
+			return EPIPE;
+		}
+		p += n;
+		len -= (size_t)n;
+	}
+	return 0;
+}
+
+/// @brief 发送一帧, 帧头和帧内容通过一次 `sendmsg` 调用发送, 对端已关闭时不产生 `SIGPIPE` 信号
+///
+/// @param fd 句柄
+/// @param status 响应状态值
+/// @param data 帧内容
+/// @param len 帧内容长度
+/// @return `0` 表示成功, `EPIPE` 表示对端已关闭, 其它值表示失败
+static int _send_frame(int fd, int status, const void* data, size_t len) {
+	if (len > UINT32_MAX) {
+		return EMSGSIZE;
+	}
+
+	frame_header h = { (uint32_t)len, (int32_t)status };
+
+	struct iovec iov[2] = {
+		{ &h, sizeof(h) },
+		{ (void*)data, len },
+	};
+	struct msghdr msg = { 0 };
+	msg.msg_iov = iov;
+	msg.msg_iovlen = len > 0 ? 2 : 1;
+
+	// 内容较大时 `sendmsg` 可能只发送一部分, 需调整 `iovec` 后继续发送
+	while (msg.msg_iovlen > 0) {
+		ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return errno == ECONNRESET ? EPIPE : errno;
+		}
+		while (msg.msg_iovlen > 0 && (size_t)n >= msg.msg_iov->iov_len) {
+			n -= (ssize_t)msg.msg_iov->iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+		if (msg.msg_iovlen > 0) {
+			msg.msg_iov->iov_base = (char*)msg.msg_iov->iov_base + n;
+			msg.msg_iov->iov_len -= (size_t)n;
+		}
+	}
+	return 0;
+}
+
+/// @brief 接收一帧, 帧内容保存到 `buf` 中 (覆盖原有内容)
+///
+/// @param fd 句柄
+/// @param buf 保存帧内容的缓冲区
+/// @param status 用于保存响应状态值的指针
+/// @return `0` 表示成功, `EPIPE` 表示对端已关闭, 其它值表示失败
+static int _recv_frame(int fd, frame_buf* buf, int* status) {
+	frame_header h;
+
+	int rc = _read_full(fd, &h, sizeof(h));
+	if (rc == 0) {
+		rc = frame_buf_reserve(buf, h.len);
+	}
+	if (rc == 0) {
+		rc = _read_full(fd, buf->data, h.len);
+	}
+	if (rc == 0) {
+		buf->len = h.len;
+		*status = h.status;
+	}
+	return rc;
+}
+
+/// @brief 工作进程入口函数, 循环接收请求帧, 调用回调函数, 并返回响应帧, 直到主进程关闭通信句柄
+///
+/// @param pool 进程池指针 (工作进程中的副本)
+/// @param fd 工作进程一端的通信句柄
+static void _worker_main(prefork_pool* pool, int fd) {
+	frame_buf req = { 0 };
+	frame_buf resp = { 0 };
+	int unused;
+
+	while (_recv_frame(fd, &req, &unused) == 0) {
+		resp.len = 0;
+
+		int status = pool->handler(req.data, req.len, &resp, pool->ctx);
+		if (_send_frame(fd, status, resp.data, resp.len) != 0) {
+			break;
+		}
+	}
+
+	frame_buf_free(&req);
+	frame_buf_free(&resp);
+	close(fd);
+
+	// 使用 `_exit` 结束工作进程, 避免执行从主进程继承的 `atexit` 函数以及重复刷新 `stdio` 缓冲区
+	_exit(0);
+}
+
+/// @brief 创建第 `i` 个工作进程, 调用方需持有 `pool->lock`, 以免其它线程同时创建的句柄泄漏到新的工作进程中
+///
+/// @param pool 进程池指针
+/// @param i 工作进程下标
+/// @return `0` 表示成功, 其它值表示失败
+static int _spawn_worker(prefork_pool* pool, size_t i) {
+	int sv[2];
+
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+		return errno;
+	}
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		int rc = errno;
+		close(sv[0]);
+		close(sv[1]);
+		return rc;
+	}
+
+	if (pid == 0) {
+		// 工作进程中关闭主进程一端的句柄, 以及其它工作进程在主进程一端的句柄,
+		// 否则主进程关闭这些句柄后, 其它工作进程无法读到 EOF
+		close(sv[0]);
+		for (size_t j = 0; j < pool->size; j++) {
+			if (j != i && pool->workers[j].fd >= 0) {
+				close(pool->workers[j].fd);
+			}
+		}
+
+		pin_current(pool->workers[i].cpu);
+		_worker_main(pool, sv[1]);
+	}
+
+	close(sv[1]);
+	pool->workers[i].pid = pid;
+	pool->workers[i].fd = sv[0];
+	return 0;
+}
+
+/// @brief 结束并回收工作进程, 之后该工作进程会在下次被选中时重新创建
+///
+/// @param w 工作进程指针
+static void _retire_worker(prefork_worker* w) {
+	close(w->fd);
+	w->fd = -1;
+
+	// 通信失败时工作进程不一定已经退出 (例如回调函数返回了无法发送的响应), 故先结束该进程再回收
+	kill(w->pid, SIGKILL);
+	while (waitpid(w->pid, NULL, 0) < 0 && errno == EINTR) {
+	}
+}
+
+/// @brief 从空闲栈中取出一个工作进程, 必要时重新创建已退出的工作进程
+///
+/// @param pool 进程池指针
+/// @param wait 没有空闲工作进程时是否等待
+/// @param index 用于保存工作进程下标的指针
+/// @return `0` 表示成功, `EAGAIN` 表示没有空闲工作进程且 `wait` 为 `false`, 其它值表示失败
+static int _acquire_worker(prefork_pool* pool, bool wait, size_t* index) {
+	int rc = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->idle_n == 0 && wait) {
+		pthread_cond_wait(&pool->cond, &pool->lock);
+	}
+
+	if (pool->idle_n == 0) {
+		rc = EAGAIN;
+	}
+	else {
+		size_t i = pool->idle[pool->idle_n - 1];
+		if (pool->workers[i].fd < 0) {
+			rc = _spawn_worker(pool, i);
+		}
+		if (rc == 0) {
+			pool->idle_n--;
+			*index = i;
+		}
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+	return rc;
+}
+
+/// @brief 将工作进程归还到空闲栈中
+///
+/// @param pool 进程池指针
+/// @param i 工作进程下标
+static void _release_worker(prefork_pool* pool, size_t i) {
+	pthread_mutex_lock(&pool->lock);
+	pool->idle[pool->idle_n++] = i;
+	pthread_cond_signal(&pool->cond);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+int prefork_create(prefork_pool** pool, size_t size, prefork_handler handler, void* ctx) {
+	if (size == 0) {
+		size = available_cpus();
+	}
+
+	prefork_pool* p = (prefork_pool*)calloc(1, sizeof(prefork_pool));
+	if (!p) {
+		return ENOMEM;
+	}
+
+	p->size = size;
+	p->handler = handler;
+	p->ctx = ctx;
+	p->workers = (prefork_worker*)calloc(size, sizeof(prefork_worker));
+	p->idle = (size_t*)calloc(size, sizeof(size_t));
+	if (!p->workers || !p->idle) {
+		free((void*)p->workers);
+		free((void*)p->idle);
+		free((void*)p);
+		return ENOMEM;
+	}
+
+	pthread_mutex_init(&p->lock, NULL);
+	pthread_cond_init(&p->cond, NULL);
+
+	// 按默认放置方式为各工作进程选择 CPU, 无法读取 CPU 布局时不进行绑定
+	placement_mode mode = placement_default();
+	cpu_layout layout;
+	bool has_layout = cpu_layout_init(&layout) == 0;
+	if (!has_layout) {
+		mode = PLACEMENT_NONE;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		p->workers[i].fd = -1;
+		p->workers[i].cpu = cpu_layout_pick(&layout, mode, i);
+	}
+	if (has_layout) {
+		cpu_layout_free(&layout);
+	}
+
+	int rc = 0;
+
+	// 工作进程逆序入栈, 令第 `0` 个工作进程最先被选中
+	for (size_t i = 0; i < size && rc == 0; i++) {
+		rc = _spawn_worker(p, i);
+		p->idle[i] = size - 1 - i;
+	}
+	p->idle_n = size;
+
+	if (rc != 0) {
+		prefork_destroy(p);
+		return rc;
+	}
+
+	*pool = p;
+	return 0;
+}
+
+void prefork_destroy(prefork_pool* pool) {
+	// 先关闭全部通信句柄, 令各工作进程同时读到 EOF 并退出, 再逐个回收
+	for (size_t i = 0; i < pool->size; i++) {
+		if (pool->workers[i].fd >= 0) {
+			close(pool->workers[i].fd);
+		}
+	}
+	for (size_t i = 0; i < pool->size; i++) {
+		if (pool->workers[i].fd >= 0) {
+			while (waitpid(pool->workers[i].pid, NULL, 0) < 0 && errno == EINTR) {
+			}
+		}
+	}
+
+	pthread_cond_destroy(&pool->cond);
+	pthread_mutex_destroy(&pool->lock);
+	free((void*)pool->idle);
+	free((void*)pool->workers);
+	free((void*)pool);
+}
+
+size_t prefork_size(const prefork_pool* pool) {
+	return pool->size;
+}
+
+pid_t prefork_pid(const prefork_pool* pool, size_t i) {
+	return pool->workers[i].pid;
+}
+
+int prefork_call(prefork_pool* pool, const void* req, size_t len, frame_buf* resp, int* status) {
+	size_t i;
+
+	int rc = _acquire_worker(pool, true, &i);
+	if (rc != 0) {
+		return rc;
+	}
+
+	prefork_worker* w = &pool->workers[i];
+
+	rc = _send_frame(w->fd, 0, req, len);
+	if (rc == 0) {
+		rc = _recv_frame(w->fd, resp, status);
+	}
+	if (rc != 0) {
+		_retire_worker(w);
+	}
+
+	_release_worker(pool, i);
+	return rc;
+}
+
+/// @brief 在批量调用中向第 `i` 个工作进程发送请求, 发送失败时回收该工作进程, 本批次不再使用
+///
+/// @param pool 进程池指针
+/// @param i 工作进程下标
+/// @param req 请求指针
+/// @param pfd 该工作进程对应的 `poll` 句柄, 发送成功时设置为工作进程的通信句柄, 否则设置为 `-1`
+/// @param rc 批量调用的返回值, 发送失败且其尚为 `0` 时记录错误值
+/// @return 发送成功时返回 `1`, 否则返回 `0`
+static size_t _dispatch(prefork_pool* pool, size_t i, const prefork_req* req, struct pollfd* pfd, int* rc) {
+	prefork_worker* w = &pool->workers[i];
+
+	int e = _send_frame(w->fd, 0, req->data, req->len);
+	if (e != 0) {
+		if (*rc == 0) {
+			*rc = e;
+		}
+		_retire_worker(w);
+		pfd->fd = -1;
+		return 0;
+	}
+
+	pfd->fd = w->fd;
+	return 1;
+}
+
+int prefork_batch(prefork_pool* pool, const prefork_req* reqs, size_t n, frame_buf* resps, int* statuses) {
+	if (n == 0) {
+		return 0;
+	}
+
+	for (size_t k = 0; k < n; k++) {
+		statuses[k] = -1;
+	}
+
+	// 本批次占用的工作进程下标, 正在处理的请求下标, 以及对应的 `poll` 句柄
+	size_t* held = (size_t*)malloc(pool->size * sizeof(size_t));
+	size_t* pending = (size_t*)malloc(pool->size * sizeof(size_t));
+	struct pollfd* pfds = (struct pollfd*)malloc(pool->size * sizeof(struct pollfd));
+	if (!held || !pending || !pfds) {
+		free((void*)held);
+		free((void*)pending);
+		free((void*)pfds);
+		return ENOMEM;
+	}
+
+	// 至少等待一个工作进程, 其余只取当前空闲的, 不和其它调用方争抢
+	size_t nw = 0;
+	int rc = _acquire_worker(pool, true, &held[nw]);
+	if (rc == 0) {
+		nw++;
+		while (nw < pool->size && nw < n && _acquire_worker(pool, false, &held[nw]) == 0) {
+			nw++;
+		}
+	}
+
+	size_t next = 0;   // 下一个待分配的请求
+	size_t active = 0; // 正在处理请求的工作进程数
+
+	for (size_t j = 0; j < nw; j++) {
+		pfds[j].fd = -1;
+		pfds[j].events = POLLIN;
+		if (next < n) {
+			pending[j] = next++;
+			active += _dispatch(pool, held[j], &reqs[pending[j]], &pfds[j], &rc);
+		}
+	}
+
+	while (active > 0) {
+		if (poll(pfds, nw, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			// `poll` 失败时无法确定各工作进程的状态, 回收全部正在处理请求的工作进程
+			if (rc == 0) {
+				rc = errno;
+			}
+			for (size_t j = 0; j < nw; j++) {
+				if (pfds[j].fd >= 0) {
+					_retire_worker(&pool->workers[held[j]]);
+					pfds[j].fd = -1;
+				}
+			}
+			break;
+		}
+
+		for (size_t j = 0; j < nw; j++) {
+			if (pfds[j].fd < 0 || pfds[j].revents == 0) {
+				continue;
+			}
+
+			prefork_worker* w = &pool->workers[held[j]];
+			size_t k = pending[j];
+			active--;
+
+			int e = _recv_frame(w->fd, &resps[k], &statuses[k]);
+			if (e != 0) {
+				if (rc == 0) {
+					rc = e;
+				}
+				_retire_worker(w);
+				pfds[j].fd = -1;
+			}
+			else if (next < n) {
+				// 收到响应后立即分配下一个请求, 各工作进程按自身的处理速度领取请求
+				pending[j] = next++;
+				active += _dispatch(pool, held[j], &reqs[pending[j]], &pfds[j], &rc);
+			}
+			else {
+				pfds[j].fd = -1;
+			}
+		}
+	}
+
+	// 所有工作进程都已失败时, 剩余的请求无法完成
+	if (next < n && rc == 0) {
+		rc = EPIPE;
+	}
+
+	for (size_t j = 0; j < nw; j++) {
+		_release_worker(pool, held[j]);
+	}
+
+	free((void*)held);
+	free((void*)pending);
+	free((void*)pfds);
+	return rc;
+}
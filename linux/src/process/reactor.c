@@ -0,0 +1,355 @@
+#define _GNU_SOURCE
+
+#include "process.h"
+#include "cpu.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+// 单次读取管道数据的缓冲区大小
+#define READ_BUF_SIZE (64 * 1024)
+
+// 单次 `epoll_wait` 处理的最大事件数
+#define MAX_EVENTS 64
+
+// epoll 事件的类型, 保存在 `epoll_data.u64` 的最低位, 其余位保存子进程下标
+#define EV_PIPE 0
+#define EV_PIDFD 1
+
+/// @brief 事件循环中的子进程
+typedef struct __reactor_child {
+	bool used;			   // 该项是否正在使用, 子进程完成后该项可被新的子进程复用
+	pid_t pid;			   // 子进程 ID
+	int rfd;			   // 管道 "读" 句柄, 读到 EOF 后关闭并设置为 `-1`
+	int pidfd;			   // 子进程的 pidfd, 不支持 pidfd 或子进程已回收后为 `-1`
+	bool exited;		   // 子进程是否已被回收
+	int stat;			   // 子进程的状态值
+	child_handler handler; // 事件回调函数
+} reactor_child;
+
+/// @brief 事件循环
+struct __reactor {
+	int epfd;				 // epoll 句柄
+	reactor_child* children; // 子进程数组, 通过下标引用, 以便数组扩容
+	size_t cap;				 // 子进程数组容量
+	size_t pending;			 // 尚未完成的子进程数
+};
+
+/// @brief 打开子进程的 pidfd, 子进程退出时 pidfd 变为可读
+///
+/// @param pid 子进程 ID
+/// @return pidfd, 失败时 (例如内核版本低于 5.3) 返回 `-1`
+static int _pidfd_open(pid_t pid) {
+#ifdef SYS_pidfd_open
+	return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+	(void)pid;
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+/// @brief 回收子进程, 并记录其状态值
+///
+/// @param c 子进程指针
+static void _reap(reactor_child* c) {
+	while (waitpid(c->pid, &c->stat, 0) < 0 && errno == EINTR) {
+	}
+	c->exited = true;
+}
+
+/// @brief 从 epoll 中移除并关闭句柄
+///
+/// @param r 事件循环指针
+/// @param fd 句柄指针, 关闭后设置为 `-1`
+static void _unwatch(reactor* r, int* fd) {
+	epoll_ctl(r->epfd, EPOLL_CTL_DEL, *fd, NULL);
+	close(*fd);
+	*fd = -1;
+}
+
+/// @brief 在子进程的管道已关闭且已被回收时完成该子进程, 调用其 `on_exit` 回调函数
+///
+/// @param r 事件循环指针
+/// @param i 子进程下标
+static void _try_complete(reactor* r, size_t i) {
+	reactor_child* c = &r->children[i];
+	if (c->rfd >= 0 || !c->exited) {
+		return;
+	}
+
+	// 先释放该项再调用回调函数, 回调函数中创建的子进程可以复用该项
+	child_handler h = c->handler;
+	pid_t pid = c->pid;
+	int stat = c->stat;
+
+	c->used = false;
+	r->pending--;
+
+	if (h.on_exit) {
+		h.on_exit(pid, stat, h.ctx);
+	}
+}
+
+/// @brief 读取子进程管道中的数据并传递给 `on_data` 回调函数, 读到 EOF 时关闭管道
+///
+/// @param r 事件循环指针
+/// @param i 子进程下标
+/// @param buf 读取缓冲区
+static void _on_pipe(reactor* r, size_t i, char* buf) {
+	reactor_child* c = &r->children[i];
+
+	ssize_t n = read(c->rfd, buf, READ_BUF_SIZE);
+	if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+		return;
+	}
+
+	if (n > 0) {
+		if (c->handler.on_data) {
+			c->handler.on_data(c->pid, buf, (size_t)n, c->handler.ctx);
+		}
+		return;
+	}
+
+	// 读到 EOF (或读取失败), 子进程已不会再发送数据
+	_unwatch(r, &r->children[i].rfd);
+
+	// 不支持 pidfd 时无法得知子进程何时退出, 关闭管道通常意味着子进程即将退出, 故在此阻塞回收
+	c = &r->children[i];
+	if (c->pidfd < 0 && !c->exited) {
+		_reap(c);
+	}
+	_try_complete(r, i);
+}
+
+/// @brief 子进程退出, 回收该子进程
+///
+/// @param r 事件循环指针
+/// @param i 子进程下标
+static void _on_pidfd(reactor* r, size_t i) {
+	reactor_child* c = &r->children[i];
+
+	// 若该项在同一批事件中已被回调函数创建的新子进程复用, 事件实际属于之前的子进程, 此时新子进程尚未退出, 忽略即可
+	if (waitpid(c->pid, &c->stat, WNOHANG) != c->pid) {
+		return;
+	}
+	c->exited = true;
+
+	_unwatch(r, &c->pidfd);
+	_try_complete(r, i);
+}
+
+int reactor_create(reactor** r) {
+	reactor* p = (reactor*)calloc(1, sizeof(reactor));
+	if (!p) {
+		return ENOMEM;
+	}
+
+	p->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (p->epfd < 0) {
+		int rc = errno;
+		free((void*)p);
+		return rc;
+	}
+
+	*r = p;
+	return 0;
+}
+
+void reactor_destroy(reactor* r) {
+	for (size_t i = 0; i < r->cap; i++) {
+		reactor_child* c = &r->children[i];
+		if (!c->used) {
+			continue;
+		}
+		if (c->rfd >= 0) {
+			close(c->rfd);
+		}
+		if (c->pidfd >= 0) {
+			close(c->pidfd);
+		}
+		if (!c->exited) {
+			kill(c->pid, SIGKILL);
+			_reap(c);
+		}
+	}
+
+	close(r->epfd);
+	free((void*)r->children);
+	free((void*)r);
+}
+
+/// @brief 获取一个空闲的子进程项, 没有空闲项时扩容
+///
+/// @param r 事件循环指针
+/// @param index 用于保存子进程下标的指针
+/// @return `0` 表示成功, `ENOMEM` 表示内存分配失败
+static int _alloc_child(reactor* r, size_t* index) {
+	for (size_t i = 0; i < r->cap; i++) {
+		if (!r->children[i].used) {
+			*index = i;
+			return 0;
+		}
+	}
+
+	size_t cap = r->cap ? r->cap * 2 : 16;
+	reactor_child* p = (reactor_child*)realloc(r->children, cap * sizeof(reactor_child));
+	if (!p) {
+		return ENOMEM;
+	}
+	for (size_t i = r->cap; i < cap; i++) {
+		p[i].used = false;
+	}
+
+	*index = r->cap;
+	r->children = p;
+	r->cap = cap;
+	return 0;
+}
+
+int reactor_spawn(reactor* r, worker_func worker, int cpu, const child_handler* handler, pid_t* pid) {
+	size_t i;
+	int rc = _alloc_child(r, &i);
+	if (rc != 0) {
+		return rc;
+	}
+
+	// 主进程一端的 "读" 句柄设为非阻塞, 避免 epoll 误报就绪时阻塞整个事件循环
+	int pfds[2];
+	if (pipe2(pfds, O_CLOEXEC) != 0) {
+		return errno;
+	}
+	fcntl(pfds[0], F_SETFL, fcntl(pfds[0], F_GETFL) | O_NONBLOCK);
+
+	// 刷新 `stdio` 缓冲区, 否则子进程通过 `exit` 结束时会再次输出从主进程继承的缓冲区内容
+	fflush(NULL);
+
+	pid_t child = fork();
+	if (child < 0) {
+		rc = errno;
+		close(pfds[0]);
+		close(pfds[1]);
+		return rc;
+	}
+
+	if (child == 0) {
+		close(pfds[0]);
+		pin_current(cpu);
+
+		int retcode = worker(pfds[1]);
+
+		close(pfds[1]);
+		exit(retcode);
+	}
+
+	close(pfds[1]);
+
+	// 管道无法加入事件循环时, 子进程的消息和退出都无法被收集, 结束并回收子进程后返回错误
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.u64 = ((uint64_t)i << 1) | EV_PIPE;
+	if (epoll_ctl(r->epfd, EPOLL_CTL_ADD, pfds[0], &ev) != 0) {
+		rc = errno;
+		kill(child, SIGKILL);
+		while (waitpid(child, NULL, 0) < 0 && errno == EINTR) {
+		}
+		close(pfds[0]);
+		return rc;
+	}
+
+	reactor_child* c = &r->children[i];
+	c->used = true;
+	c->pid = child;
+	c->rfd = pfds[0];
+	c->pidfd = _pidfd_open(child);
+	c->exited = false;
+	c->stat = 0;
+	c->handler = *handler;
+
+	if (c->pidfd >= 0) {
+		ev.data.u64 = ((uint64_t)i << 1) | EV_PIDFD;
+		if (epoll_ctl(r->epfd, EPOLL_CTL_ADD, c->pidfd, &ev) != 0) {
+			close(c->pidfd);
+			c->pidfd = -1;
+		}
+	}
+
+	r->pending++;
+	if (pid) {
+		*pid = child;
+	}
+	return 0;
+}
+
+size_t reactor_pending(const reactor* r) {
+	return r->pending;
+}
+
+/// @brief 获取单调时钟的当前时间 (毫秒)
+static int64_t _now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int reactor_run(reactor* r, int timeout_ms) {
+	char* buf = (char*)malloc(READ_BUF_SIZE);
+	if (!buf) {
+		return ENOMEM;
+	}
+
+	int64_t deadline = timeout_ms < 0 ? -1 : _now_ms() + timeout_ms;
+	int rc = 0;
+
+	struct epoll_event events[MAX_EVENTS];
+
+	while (r->pending > 0) {
+		int wait_ms = -1;
+		if (deadline >= 0) {
+			int64_t rest = deadline - _now_ms();
+			if (rest <= 0) {
+				rc = ETIMEDOUT;
+				break;
+			}
+			wait_ms = (int)rest;
+		}
+
+		int n = epoll_wait(r->epfd, events, MAX_EVENTS, wait_ms);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			rc = errno;
+			break;
+		}
+
+		for (int k = 0; k < n; k++) {
+			size_t i = (size_t)(events[k].data.u64 >> 1);
+			reactor_child* c = &r->children[i];
+
+			// 同一批事件中, 之前的事件可能已使该子进程完成, 或已关闭对应的句柄
+			if (!c->used) {
+				continue;
+			}
+			if ((events[k].data.u64 & 1) == EV_PIPE) {
+				if (c->rfd >= 0) {
+					_on_pipe(r, i, buf);
+				}
+			}
+			else if (c->pidfd >= 0) {
+				_on_pidfd(r, i);
+			}
+		}
+	}
+
+	free((void*)buf);
+	return rc;
+}
@@ -1,9 +1,304 @@
+#define _GNU_SOURCE
+
 #include "process.h"
 
 #include <unistd.h>
-#include <sys/ipc.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// 等待前自旋检查的次数, 对方通常很快就会读写, 自旋可以避免多数 futex 调用
+#define SPIN_COUNT 128
+
+/// @brief 获取单调时钟的当前时间 (毫秒)
+static int64_t _now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/// @brief 环形缓冲区头部, 位于共享内存的第一页
+///
+/// 生产者和消费者各自写入的字段分别位于不同的缓存行中, 避免伪共享
+struct __shm_ring_header {
+	// 生产者写入的字段
+	uint64_t head __attribute__((aligned(64))); // 写入位置 (累计写入的字节数)
+	uint32_t data_seq;							// 每次提交或关闭时递增, 作为消费者 futex 等待的地址
+	uint32_t closed;							// 是否已关闭
+
+	// 消费者写入的字段
+	uint64_t tail __attribute__((aligned(64))); // 读取位置 (累计读取的字节数)
+	uint32_t space_seq;							// 每次释放时递增, 作为生产者 futex 等待的地址
+
+	// 双方都会写入的等待者计数
+	uint32_t data_waiters __attribute__((aligned(64)));	 // 等待数据的消费者数
+	uint32_t space_waiters __attribute__((aligned(64))); // 等待空间的生产者数
+};
+
+/// @brief 在 `addr` 指向的值等于 `val` 时休眠; 等待和唤醒发生在不同进程中, 故不使用 `FUTEX_PRIVATE_FLAG`
+///
+/// @param addr futex 地址
+/// @param val 期望的值
+/// @param deadline 截止时间 (`CLOCK_MONOTONIC` 毫秒), 为负数时不超时
+/// @return `0` 表示被唤醒 (或值已改变, 或被信号中断), `ETIMEDOUT` 表示已到截止时间
+inline static int _futex_wait(uint32_t* addr, uint32_t val, int64_t deadline) {
+	if (deadline < 0) {
+		syscall(SYS_futex, addr, FUTEX_WAIT, val, NULL, NULL, 0);
+		return 0;
+	}
+
+	// `FUTEX_WAIT` 的超时时间为相对时间, 每次等待前根据截止时间重新计算
+	int64_t rest = deadline - _now_ms();
+	if (rest <= 0) {
+		return ETIMEDOUT;
+	}
+	struct timespec ts = { (time_t)(rest / 1000), (long)(rest % 1000) * 1000000 };
+	if (syscall(SYS_futex, addr, FUTEX_WAIT, val, &ts, NULL, 0) != 0 && errno == ETIMEDOUT) {
+		return ETIMEDOUT;
+	}
+	return 0;
+}
+
+/// @brief 将超时时间转换为截止时间
+///
+/// @param timeout_ms 超时时间 (毫秒), 为负数表示不超时
+/// @return 截止时间 (`CLOCK_MONOTONIC` 毫秒), 不超时时返回 `-1`
+static int64_t _deadline(int timeout_ms) {
+	return timeout_ms < 0 ? -1 : _now_ms() + timeout_ms;
+}
+
+/// @brief 唤醒在 `addr` 上等待的全部进程
+///
+/// @param addr futex 地址
+inline static void _futex_wake_all(uint32_t* addr) {
+	syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/// @brief 创建指定大小的匿名文件
+///
+/// @param size 文件大小
+/// @return 文件句柄, 失败时返回 `-1`
+static int _anon_file(size_t size) {
+	int fd = (int)syscall(SYS_memfd_create, "linux-shm", MFD_CLOEXEC);
+
+	if (fd < 0 && errno == ENOSYS) {
+		// 内核不支持 `memfd_create` 时, 通过 `shm_open` 创建, 打开后立即删除名称, 只保留句柄
+		static uint32_t counter = 0;
+
+		char name[64];
+		snprintf(name, sizeof(name), "/linux-shm-%d-%u", (int)getpid(), __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED));
+
+		fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+		if (fd >= 0) {
+			shm_unlink(name);
+		}
+	}
+
+	if (fd >= 0 && ftruncate(fd, (off_t)size) != 0) {
+		int rc = errno;
+		close(fd);
+		errno = rc;
+		return -1;
+	}
+	return fd;
+}
+
+int shm_segment_create(shm_segment* seg, size_t size) {
+	int fd = _anon_file(size);
+	if (fd < 0) {
+		return errno;
+	}
+
+	void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED) {
+		int rc = errno;
+		close(fd);
+		return rc;
+	}
+
+	seg->addr = addr;
+	seg->size = size;
+	seg->fd = fd;
+	return 0;
+}
+
+void shm_segment_free(shm_segment* seg) {
+	munmap(seg->addr, seg->size);
+	close(seg->fd);
+	seg->addr = NULL;
+	seg->size = 0;
+	seg->fd = -1;
+}
+
+int shm_ring_create(shm_ring* ring, size_t capacity) {
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+	// 容量为页大小的 `2` 的幂次倍, 以便通过掩码计算位置, 并满足数据区第二次映射的对齐要求
+	size_t cap = page;
+	while (cap < capacity) {
+		cap *= 2;
+	}
+
+	// 文件布局为 `[头部 (1 页)][数据区]`, 映射布局为 `[头部][数据区][数据区]`, 第二个数据区是第一个的镜像
+	int fd = _anon_file(page + cap);
+	if (fd < 0) {
+		return errno;
+	}
+
+	size_t map_size = page + 2 * cap;
+
+	// 先预留整段地址空间, 再在其中固定映射, 保证两个数据区在地址上相邻
+	char* base = (char*)mmap(NULL, map_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED) {
+		int rc = errno;
+		close(fd);
+		return rc;
+	}
+
+	if (mmap(base, page + cap, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+		|| mmap(base + page + cap, cap, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, (off_t)page) == MAP_FAILED) {
+		int rc = errno;
+		munmap(base, map_size);
+		close(fd);
+		return rc;
+	}
+
+	ring->header = (shm_ring_header*)base;
+	ring->data = base + page;
+	ring->capacity = cap;
+	ring->map_size = map_size;
+	ring->fd = fd;
+	return 0;
+}
+
+void shm_ring_free(shm_ring* ring) {
+	munmap((void*)ring->header, ring->map_size);
+	close(ring->fd);
+	ring->header = NULL;
+	ring->data = NULL;
+}
+
+int shm_ring_reserve_timed(shm_ring* ring, size_t len, int timeout_ms, void** out) {
+	*out = NULL;
+	if (len > ring->capacity) {
+		return EINVAL;
+	}
+
+	shm_ring_header* h = ring->header;
+	uint64_t head = __atomic_load_n(&h->head, __ATOMIC_RELAXED);
+	int64_t deadline = -1;
+
+	for (int spin = 0;; spin++) {
+		if (ring->capacity - (head - __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE)) >= len) {
+			*out = ring->data + (head & (ring->capacity - 1));
+			return 0;
+		}
+		if (spin < SPIN_COUNT) {
+			continue;
+		}
+		if (spin == SPIN_COUNT) {
+			deadline = _deadline(timeout_ms);
+		}
+
+		// 先读取序号并登记为等待者, 再重新检查; 消费者在释放空间后若发现有等待者, 会递增序号并唤醒
+		int rc = 0;
+		uint32_t seq = __atomic_load_n(&h->space_seq, __ATOMIC_ACQUIRE);
+		__atomic_add_fetch(&h->space_waiters, 1, __ATOMIC_SEQ_CST);
+		if (ring->capacity - (head - __atomic_load_n(&h->tail, __ATOMIC_SEQ_CST)) < len) {
+			rc = _futex_wait(&h->space_seq, seq, deadline);
+		}
+		__atomic_sub_fetch(&h->space_waiters, 1, __ATOMIC_RELAXED);
+
+		if (rc != 0) {
+			return rc;
+		}
+	}
+}
+
+void* shm_ring_reserve(shm_ring* ring, size_t len) {
+	void* p;
+	shm_ring_reserve_timed(ring, len, -1, &p);
+	return p;
+}
+
+void shm_ring_commit(shm_ring* ring, size_t len) {
+	shm_ring_header* h = ring->header;
+
+	__atomic_store_n(&h->head, h->head + len, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&h->data_waiters, __ATOMIC_SEQ_CST) > 0) {
+		__atomic_add_fetch(&h->data_seq, 1, __ATOMIC_RELEASE);
+		_futex_wake_all(&h->data_seq);
+	}
+}
+
+void shm_ring_close(shm_ring* ring) {
+	shm_ring_header* h = ring->header;
+
+	__atomic_store_n(&h->closed, 1, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&h->data_seq, 1, __ATOMIC_RELEASE);
+	_futex_wake_all(&h->data_seq);
+}
+
+int shm_ring_peek_timed(shm_ring* ring, int timeout_ms, const void** out, size_t* len) {
+	shm_ring_header* h = ring->header;
+	uint64_t tail = __atomic_load_n(&h->tail, __ATOMIC_RELAXED);
+	int64_t deadline = -1;
+
+	*out = NULL;
+	*len = 0;
+	for (int spin = 0;; spin++) {
+		uint64_t head = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE);
+		if (head != tail) {
+			*len = (size_t)(head - tail);
+			*out = ring->data + (tail & (ring->capacity - 1));
+			return 0;
+		}
+
+		// 关闭标志在全部数据提交之后设置, 看到关闭标志后需再检查一次是否有剩余数据
+		if (__atomic_load_n(&h->closed, __ATOMIC_ACQUIRE)) {
+			if (__atomic_load_n(&h->head, __ATOMIC_ACQUIRE) == tail) {
+				return 0;
+			}
+			continue;
+		}
+		if (spin < SPIN_COUNT) {
+			continue;
+		}
+		if (spin == SPIN_COUNT) {
+			deadline = _deadline(timeout_ms);
+		}
+
+		int rc = 0;
+		uint32_t seq = __atomic_load_n(&h->data_seq, __ATOMIC_ACQUIRE);
+		__atomic_add_fetch(&h->data_waiters, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&h->head, __ATOMIC_SEQ_CST) == tail && !__atomic_load_n(&h->closed, __ATOMIC_SEQ_CST)) {
+			rc = _futex_wait(&h->data_seq, seq, deadline);
+		}
+		__atomic_sub_fetch(&h->data_waiters, 1, __ATOMIC_RELAXED);
+
+		if (rc != 0) {
+			return rc;
+		}
+	}
+}
+
+const void* shm_ring_peek(shm_ring* ring, size_t* len) {
+	const void* p;
+	shm_ring_peek_timed(ring, -1, &p, len);
+	return p;
+}
+
+void shm_ring_consume(shm_ring* ring, size_t len) {
+	shm_ring_header* h = ring->header;
 
-void shared_memory(int* result, size_t size) {
-	// 创建 key 对象
-	key_t key = ftok(".", 1);
+	__atomic_store_n(&h->tail, h->tail + len, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&h->space_waiters, __ATOMIC_SEQ_CST) > 0) {
+		__atomic_add_fetch(&h->space_seq, 1, __ATOMIC_RELEASE);
+		_futex_wake_all(&h->space_seq);
+	}
 }
@@ -0,0 +1,572 @@
+#define _GNU_SOURCE
+
+#include "thread.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <memory.h>
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+// 求最大值/最小值的宏
+#define _max(a, b) ((a) > (b) ? (a) : (b))
+#define _min(a, b) ((a) < (b) ? (a) : (b))
+
+// 双端队列的初始容量, 必须为 2 的整数次幂
+#define DEQUE_INIT_CAPACITY 256
+
+// 工作线程每次从全局队列中最多取出的任务数
+#define INJECT_BATCH 32
+
+/// @brief 双端队列的环形数组
+///
+/// 数组扩容后, 旧数组可能仍在被其它线程窃取时读取, 故不能立即释放, 而是通过 `prev` 字段串联, 在线程池销毁时统一释放
+typedef struct __deque_array {
+	int64_t capacity;			// 数组容量, 为 2 的整数次幂
+	struct __deque_array* prev;	// 扩容前的旧数组
+	pool_task* items[];			// 任务指针数组
+} _deque_array;
+
+/// @brief Chase-Lev 双端队列
+///
+/// 只有持有队列的工作线程可以从底部 (`bottom`) 压入和弹出任务, 其它线程只能从顶部 (`top`) 窃取任务
+typedef struct {
+	int64_t top;		  // 队列顶部下标, 由窃取方通过 CAS 递增
+	int64_t bottom;		  // 队列底部下标, 只由持有方修改
+	_deque_array* array;  // 环形数组
+} _deque;
+
+/// @brief 工作线程
+typedef struct {
+	thread_pool* pool;	// 所属线程池
+	size_t index;		// 工作线程下标
+	pthread_t tid;		// 线程 id
+	_deque deque;		// 工作线程持有的双端队列
+	uint64_t seed;		// 用于随机选择窃取目标的随机数种子
+	int cpu;			// 工作线程绑定的 CPU, 为负数时不绑定
+} _worker;
+
+struct __thread_pool {
+	size_t size;			 // 工作线程数
+	_worker* workers;		 // 工作线程数组
+	pthread_mutex_t lock;	 // 全局队列锁
+	pool_task* head;		 // 全局队列头部
+	pool_task* tail;		 // 全局队列尾部
+	size_t injected;		 // 全局队列中的任务数
+	uint32_t epoch;			 // 唤醒计数, 作为工作线程休眠时 futex 等待的地址
+	uint32_t sleepers;		 // 正在休眠 (或准备休眠) 的工作线程数
+	bool stopped;			 // 线程池是否已停止
+};
+
+// 窃取任务时因竞争失败的返回值, 表示需要重试
+#define STEAL_ABORT ((pool_task*)-1)
+
+// 当前线程对应的工作线程, 非工作线程为 `NULL`
+static __thread _worker* _current_worker = NULL;
+
+/// @brief 在 `addr` 指向的值等于 `val` 时休眠, 直到被 `_futex_wake` 函数唤醒
+///
+/// @param addr futex 地址
+/// @param val 期望值
+inline static void _futex_wait(uint32_t* addr, uint32_t val) {
+	syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+/// @brief 唤醒在 `addr` 上休眠的线程
+///
+/// @param addr futex 地址
+/// @param n 最多唤醒的线程数
+inline static void _futex_wake(uint32_t* addr, int n) {
+	syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+}
+
+/// @brief 创建指定容量的环形数组
+///
+/// @param capacity 数组容量
+/// @param prev 扩容前的旧数组
+/// @return 数组指针, 内存分配失败时返回 `NULL`
+static _deque_array* _deque_array_new(int64_t capacity, _deque_array* prev) {
+	_deque_array* a = (_deque_array*)malloc(sizeof(_deque_array) + sizeof(pool_task*) * (size_t)capacity);
+	if (a) {
+		a->capacity = capacity;
+		a->prev = prev;
+	}
+	return a;
+}
+
+/// @brief 初始化双端队列
+///
+/// @param d 双端队列指针
+/// @return `0` 表示成功, 其它值表示失败
+static int _deque_init(_deque* d) {
+	d->top = 0;
+	d->bottom = 0;
+	d->array = _deque_array_new(DEQUE_INIT_CAPACITY, NULL);
+	return d->array ? 0 : ENOMEM;
+}
+
+/// @brief 释放双端队列的全部环形数组
+///
+/// @param d 双端队列指针
+static void _deque_free(_deque* d) {
+	for (_deque_array* a = d->array; a;) {
+		_deque_array* prev = a->prev;
+		free((void*)a);
+		a = prev;
+	}
+	d->array = NULL;
+}
+
+/// @brief 获取双端队列中剩余的空位数, 只能由持有方调用
+///
+/// @param d 双端队列指针
+/// @return 剩余的空位数
+inline static int64_t _deque_space(_deque* d) {
+	int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+	int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+	return d->array->capacity - (b - t);
+}
+
+/// @brief 从底部压入任务, 只能由持有方调用, 数组已满时扩容
+///
+/// @param d 双端队列指针
+/// @param task 任务指针
+/// @return `true` 表示成功, `false` 表示扩容时内存分配失败
+static bool _deque_push(_deque* d, pool_task* task) {
+	int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+	int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+	_deque_array* a = __atomic_load_n(&d->array, __ATOMIC_RELAXED);
+
+	if (b - t >= a->capacity) {
+		// 数组已满, 扩容为原来的 2 倍, 并复制 `[t, b)` 范围内的任务
+		_deque_array* na = _deque_array_new(a->capacity * 2, a);
+		if (!na) {
+			return false;
+		}
+		for (int64_t i = t; i < b; i++) {
+			na->items[i & (na->capacity - 1)] = a->items[i & (a->capacity - 1)];
+		}
+		__atomic_store_n(&d->array, na, __ATOMIC_RELEASE);
+		a = na;
+	}
+
+	// 以 release 语义发布 `bottom`, 令窃取方读取到任务时也能看到任务结构体的内容
+	__atomic_store_n(&a->items[b & (a->capacity - 1)], task, __ATOMIC_RELAXED);
+	__atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+/// @brief 从底部弹出任务, 只能由持有方调用
+///
+/// @param d 双端队列指针
+/// @return 任务指针, 队列为空时返回 `NULL`
+static pool_task* _deque_take(_deque* d) {
+	int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+	_deque_array* a = __atomic_load_n(&d->array, __ATOMIC_RELAXED);
+
+	// 先减小 `bottom` 再读取 `top`, 和窃取方之间需要完整的内存屏障
+	__atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+	if (t > b) {
+		// 队列为空, 恢复 `bottom`
+		__atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	pool_task* task = __atomic_load_n(&a->items[b & (a->capacity - 1)], __ATOMIC_RELAXED);
+	if (t == b) {
+		// 只剩最后一个任务, 和窃取方通过 CAS `top` 竞争
+		if (!__atomic_compare_exchange_n(&d->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+			task = NULL;
+		}
+		__atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+	}
+	return task;
+}
+
+/// @brief 从顶部窃取任务, 可由任意线程调用
+///
+/// @param d 双端队列指针
+/// @return 任务指针, 队列为空时返回 `NULL`, 和其它线程竞争失败时返回 `STEAL_ABORT`
+static pool_task* _deque_steal(_deque* d) {
+	int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+
+	if (t >= b) {
+		return NULL;
+	}
+
+	_deque_array* a = __atomic_load_n(&d->array, __ATOMIC_ACQUIRE);
+	pool_task* task = __atomic_load_n(&a->items[t & (a->capacity - 1)], __ATOMIC_RELAXED);
+	if (!__atomic_compare_exchange_n(&d->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+		return STEAL_ABORT;
+	}
+	return task;
+}
+
+/// @brief 在有工作线程休眠时唤醒其中一个
+///
+/// 和工作线程休眠前的检查配合: 提交方先发布任务再读取 `sleepers`, 工作线程先增加 `sleepers` 再检查任务,
+/// 两者之间均有完整的内存屏障, 故不会出现任务已提交但所有工作线程都在休眠的情况
+///
+/// @param pool 线程池指针
+inline static void _notify(thread_pool* pool) {
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&pool->sleepers, __ATOMIC_SEQ_CST) > 0) {
+		__atomic_add_fetch(&pool->epoch, 1, __ATOMIC_SEQ_CST);
+		_futex_wake(&pool->epoch, 1);
+	}
+}
+
+/// @brief 从全局队列中取出任务
+///
+/// 除返回的任务外, 再按每个工作线程平均应分得的数量取出一批任务放入自身队列, 以减少对全局队列锁的竞争,
+/// 这些任务可以被其它空闲的工作线程窃取
+///
+/// @param pool 线程池指针
+/// @param w 当前工作线程
+/// @return 任务指针, 全局队列为空时返回 `NULL`
+static pool_task* _take_injected(thread_pool* pool, _worker* w) {
+	if (__atomic_load_n(&pool->injected, __ATOMIC_SEQ_CST) == 0) {
+		return NULL;
+	}
+
+	size_t moved = 0;
+
+	pthread_mutex_lock(&pool->lock);
+
+	pool_task* task = pool->head;
+	if (task) {
+		pool->head = task->next;
+
+		size_t n = _min(pool->injected / pool->size, INJECT_BATCH);
+		n = _min(n, (size_t)_deque_space(&w->deque));
+
+		for (; moved < n && pool->head; moved++) {
+			pool_task* t = pool->head;
+			pool->head = t->next;
+			_deque_push(&w->deque, t);
+		}
+
+		if (!pool->head) {
+			pool->tail = NULL;
+		}
+		__atomic_store_n(&pool->injected, pool->injected - moved - 1, __ATOMIC_SEQ_CST);
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+
+	if (moved > 0) {
+		// 自身队列中有了可窃取的任务, 唤醒休眠的工作线程
+		_notify(pool);
+	}
+	return task;
+}
+
+/// @brief 查找一个可执行的任务
+///
+/// 依次尝试: 自身队列底部, 全局队列, 从随机选择的其它工作线程队列顶部窃取
+///
+/// @param pool 线程池指针
+/// @param w 当前工作线程
+/// @return 任务指针, 没有可执行的任务时返回 `NULL`
+static pool_task* _find_task(thread_pool* pool, _worker* w) {
+	pool_task* task = _deque_take(&w->deque);
+	if (task) {
+		return task;
+	}
+
+	task = _take_injected(pool, w);
+	if (task) {
+		return task;
+	}
+
+	// 以 xorshift 随机数选择起始位置, 依次尝试窃取其它工作线程的任务
+	w->seed ^= w->seed << 13;
+	w->seed ^= w->seed >> 7;
+	w->seed ^= w->seed << 17;
+
+	size_t start = (size_t)(w->seed % pool->size);
+	for (size_t i = 0; i < pool->size; i++) {
+		_worker* victim = &pool->workers[(start + i) % pool->size];
+		if (victim == w) {
+			continue;
+		}
+
+		do {
+			task = _deque_steal(&victim->deque);
+		} while (task == STEAL_ABORT);
+
+		if (task) {
+			return task;
+		}
+	}
+	return NULL;
+}
+
+/// @brief 执行任务, 并在任务组的任务全部完成时唤醒等待方
+///
+/// @param task 任务指针
+static void _run_task(pool_task* task) {
+	// 任务执行完毕后, 调用方可能随时释放任务结构体, 故需提前读取任务组
+	pool_group* group = task->group;
+
+	task->func(task->arg);
+
+	if (__atomic_sub_fetch(&group->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+		_futex_wake(&group->pending, INT_MAX);
+	}
+}
+
+/// @brief 工作线程入口函数
+///
+/// @param arg 工作线程参数, 为一个 `_worker*` 类型指针值
+/// @return 总是返回 `NULL`
+static void* _worker_main(void* arg) {
+	_worker* w = (_worker*)arg;
+	thread_pool* pool = w->pool;
+
+	_current_worker = w;
+
+	// 在执行任何任务之前绑定 CPU, 令任务中首次写入的内存分配在本节点上; 绑定失败不影响任务执行
+	pin_current(w->cpu);
+
+	for (;;) {
+		pool_task* task = _find_task(pool, w);
+		if (task) {
+			_run_task(task);
+			continue;
+		}
+
+		// 准备休眠: 先记录唤醒计数并登记为休眠状态, 再检查一次任务, 避免错过休眠前提交的任务
+		uint32_t epoch = __atomic_load_n(&pool->epoch, __ATOMIC_SEQ_CST);
+		__atomic_add_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+
+		task = _find_task(pool, w);
+		if (task) {
+			__atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+			_run_task(task);
+			continue;
+		}
+
+		// 线程池已停止且没有剩余任务, 退出线程
+		if (__atomic_load_n(&pool->stopped, __ATOMIC_SEQ_CST)) {
+			__atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+			break;
+		}
+
+		_futex_wait(&pool->epoch, epoch);
+		__atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+	}
+
+	_current_worker = NULL;
+	return NULL;
+}
+
+/// @brief 停止工作线程
+///
+/// 设置停止标志, 并唤醒所有休眠的工作线程, 工作线程会在执行完剩余任务后退出
+///
+/// @param pool 线程池指针
+/// @param started 已启动的工作线程数
+static void _stop_workers(thread_pool* pool, size_t started) {
+	__atomic_store_n(&pool->stopped, true, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&pool->epoch, 1, __ATOMIC_SEQ_CST);
+	_futex_wake(&pool->epoch, INT_MAX);
+
+	for (size_t i = 0; i < started; i++) {
+		pthread_join(pool->workers[i].tid, NULL);
+	}
+}
+
+/// @brief 释放线程池占用的内存, 调用前所有工作线程必须已经退出
+///
+/// @param pool 线程池指针
+static void _free_pool(thread_pool* pool) {
+	for (size_t i = 0; i < pool->size; i++) {
+		_deque_free(&pool->workers[i].deque);
+	}
+
+	pthread_mutex_destroy(&pool->lock);
+	free((void*)pool->workers);
+	free((void*)pool);
+}
+
+int thread_pool_create(thread_pool** pool, size_t size, placement_mode mode) {
+	if (size == 0) {
+		size = available_cpus();
+	}
+
+	// 读取 CPU 布局, 用于确定各工作线程绑定的 CPU; 无法读取时不进行绑定
+	cpu_layout layout;
+	if (cpu_layout_init(&layout) != 0) {
+		mode = PLACEMENT_NONE;
+	}
+
+	thread_pool* p = (thread_pool*)calloc(1, sizeof(thread_pool));
+	if (!p) {
+		cpu_layout_free(&layout);
+		return ENOMEM;
+	}
+
+	p->workers = (_worker*)calloc(size, sizeof(_worker));
+	if (!p->workers) {
+		cpu_layout_free(&layout);
+		free((void*)p);
+		return ENOMEM;
+	}
+	pthread_mutex_init(&p->lock, NULL);
+
+	int rc = 0;
+	for (size_t i = 0; i < size; i++) {
+		_worker* w = &p->workers[i];
+		w->pool = p;
+		w->index = i;
+		w->seed = 0x9e3779b97f4a7c15ull * (i + 1);
+		w->cpu = cpu_layout_pick(&layout, mode, i);
+
+		rc = _deque_init(&w->deque);
+		if (rc != 0) {
+			break;
+		}
+	}
+
+	cpu_layout_free(&layout);
+
+	// 所有队列初始化完毕后再启动工作线程, 因为工作线程会访问其它线程的队列
+	p->size = size;
+
+	size_t started = 0;
+	for (; rc == 0 && started < size; started++) {
+		rc = pthread_create(&p->workers[started].tid, NULL, _worker_main, &p->workers[started]);
+		if (rc != 0) {
+			break;
+		}
+	}
+
+	if (rc != 0) {
+		// 如果启动失败, 则停止已启动的工作线程并回收资源
+		_stop_workers(p, started);
+		_free_pool(p);
+		return rc;
+	}
+
+	*pool = p;
+	return 0;
+}
+
+void thread_pool_destroy(thread_pool* pool) {
+	_stop_workers(pool, pool->size);
+	_free_pool(pool);
+}
+
+// 默认线程池及保护其创建过程的锁
+static thread_pool* _default_pool = NULL;
+static pthread_mutex_t _default_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t _default_pool_atfork_once = PTHREAD_ONCE_INIT;
+
+/// @brief `fork` 前持有创建锁, 保证子进程中的锁不会处于被其它线程持有的状态
+static void _default_pool_prepare(void) {
+	pthread_mutex_lock(&_default_pool_lock);
+}
+
+/// @brief `fork` 后在父进程中释放创建锁
+static void _default_pool_parent(void) {
+	pthread_mutex_unlock(&_default_pool_lock);
+}
+
+/// @brief `fork` 后在子进程中丢弃继承的默认线程池
+///
+/// 子进程中只有调用 `fork` 的线程, 继承的线程池没有工作线程, 向其提交的任务永远不会执行; 其队列中还可能残留父进程的任务,
+/// 故不销毁 (也无法安全地销毁), 只丢弃指针, 下次调用 `thread_pool_default` 时重新创建
+static void _default_pool_child(void) {
+	_default_pool = NULL;
+	pthread_mutex_init(&_default_pool_lock, NULL);
+}
+
+/// @brief 注册 `fork` 处理函数, 通过 `pthread_once` 保证只注册一次
+static void _register_atfork(void) {
+	pthread_atfork(_default_pool_prepare, _default_pool_parent, _default_pool_child);
+}
+
+thread_pool* thread_pool_default(void) {
+	thread_pool* pool = __atomic_load_n(&_default_pool, __ATOMIC_ACQUIRE);
+	if (pool) {
+		return pool;
+	}
+
+	pthread_once(&_default_pool_atfork_once, _register_atfork);
+
+	pthread_mutex_lock(&_default_pool_lock);
+	if (!_default_pool && thread_pool_create(&pool, 0, placement_default()) == 0) {
+		__atomic_store_n(&_default_pool, pool, __ATOMIC_RELEASE);
+	}
+	pool = _default_pool;
+	pthread_mutex_unlock(&_default_pool_lock);
+	return pool;
+}
+
+size_t thread_pool_size(const thread_pool* pool) {
+	return pool->size;
+}
+
+void thread_pool_submit(thread_pool* pool, pool_task* task, pool_group* group) {
+	task->group = group;
+	task->next = NULL;
+	__atomic_add_fetch(&group->pending, 1, __ATOMIC_RELAXED);
+
+	_worker* w = _current_worker;
+	if (w && w->pool == pool) {
+		// 在工作线程中提交的任务压入自身队列; 队列扩容失败时直接在当前线程执行
+		if (!_deque_push(&w->deque, task)) {
+			_run_task(task);
+			return;
+		}
+	}
+	else {
+		// 在其它线程中提交的任务进入全局队列
+		pthread_mutex_lock(&pool->lock);
+		if (pool->tail) {
+			pool->tail->next = task;
+		}
+		else {
+			pool->head = task;
+		}
+		pool->tail = task;
+		__atomic_store_n(&pool->injected, pool->injected + 1, __ATOMIC_SEQ_CST);
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	_notify(pool);
+}
+
+void pool_group_wait(thread_pool* pool, pool_group* group) {
+	_worker* w = _current_worker;
+
+	if (w && w->pool == pool) {
+		// 在工作线程中等待时, 执行其它任务, 直到任务组完成
+		while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) != 0) {
+			pool_task* task = _find_task(pool, w);
+			if (task) {
+				_run_task(task);
+			}
+			else {
+				sched_yield();
+			}
+		}
+		return;
+	}
+
+	uint32_t pending;
+	while ((pending = __atomic_load_n(&group->pending, __ATOMIC_ACQUIRE)) != 0) {
+		_futex_wait(&group->pending, pending);
+	}
+}
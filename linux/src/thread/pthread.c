@@ -1,4 +1,5 @@
 #include "thread.h"
+#include "alloc.h"
 
 #include <pthread.h>
 #include <unistd.h>
@@ -11,52 +12,178 @@
 #define _max(a, b) ((a) > (b) ? (a) : (b))
 #define _min(a, b) ((a) < (b) ? (a) : (b))
 
-// 每个线程可存储结果的最大数量
-#define MAX_RESULT 100000
+// 结果数组的最小容量
+#define MIN_RESULT_CAPACITY 1024
 
-/// @brief 用于保存每个线程参数和计算结果的结构体
+/// @brief 用于保存每个分组任务参数和计算结果的结构体
 typedef struct
 {
-	pthread_t tid;  // 线程 id
-	bool finished;  // 线程是否结束标记
-	uint32_t begin;	// 要计算质数的起始值
-	uint32_t end;	// 要计算质数的结束值
-	uint32_t result[MAX_RESULT]; // 保存结果的数组
+	pool_task task; // 线程池任务
+	int rc;         // 任务执行结果, `0` 表示成功
+	bool* cancelled; // 各分组共享的取消标记, 任一分组失败时设置
+	uint64_t begin;	// 要计算质数的起始值, 为偶数
+	uint64_t end;	// 要计算质数的结束值
+	const sieve_base* base; // 各线程共享的基础质数表
+	uint32_t* result; // 保存结果的数组, 在找到第一个质数时才分配内存
 	size_t result_count; // 结果数量
+	size_t result_capacity; // 结果数组容量
+	bool borrowed; // 结果数组是否为共享大页内存中的一段, 此时不能单独释放或扩容
+	uint32_t* dest; // 合并结果时, 本分组结果在最终结果数组中的位置
+	pool_group done; // 只包含本分组任务的任务组, 流式输出时用于按顺序等待各分组完成
 } thread_param;
 
-/// @brief 线程入口函数, 计算每个分组中的所有质数
+/// @brief 估算 `[begin, end)` 之间的质数个数
 ///
-/// @param arg 线程参数, 为一个 `thread_param*` 类型指针值
-/// @return 执行结果, `0` 表示执行成功, `-1` 表示执行失败
-void* _calculate_primes_each_group(void* arg) {
+/// 根据素数定理, 整数 `x` 附近的质数密度约为 `1 / ln(x)`, 故区间内的质数个数约为 `(end - begin) / ln(mid)`,
+/// 其中 `mid` 为区间中点; 结果额外预留 `1/8` 的余量, 使大多数分组无需扩容
+///
+/// @param begin 区间起始值
+/// @param end 区间结束值 (不包含)
+/// @return 质数个数的估算值
+inline static size_t _estimate_prime_count(uint64_t begin, uint64_t end) {
+	double mid = _max((double)(begin + end) / 2, 3.0);
+	double n = (double)(end - begin) / log(mid);
+	return _max((size_t)(n + n / 8), MIN_RESULT_CAPACITY);
+}
+
+/// @brief 保证线程的结果数组至少能容纳 `need` 个结果
+///
+/// 首次调用时按估算的质数个数分配, 之后按 `2` 倍扩容
+///
+/// @param param 指向 `thread_param` 结构体实例的指针
+/// @param need 需要的容量
+/// @return `true` 表示成功, `false` 表示内存分配失败
+inline static bool _reserve_result(thread_param* param, size_t need) {
+	if (need <= param->result_capacity) {
+		return true;
+	}
+
+	size_t capacity = param->result_capacity == 0
+		? _estimate_prime_count(param->begin, param->end)
+		: param->result_capacity * 2;
+	capacity = _max(capacity, need);
+
+	// 共享大页内存中的结果数组容量不足时, 改为单独分配, 并复制已有结果
+	uint32_t* result;
+	if (param->borrowed) {
+		result = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+		if (result) {
+			memcpy(result, param->result, param->result_count * sizeof(uint32_t));
+			param->borrowed = false;
+		}
+	}
+	else {
+		result = (uint32_t*)realloc(param->result, capacity * sizeof(uint32_t));
+	}
+	if (!result) {
+		return false;
+	}
+
+	param->result = result;
+	param->result_capacity = capacity;
+	return true;
+}
+
+/// @brief 释放分组的结果数组, 共享大页内存中的结果数组随共享内存一起释放
+///
+/// @param param 指向 `thread_param` 结构体实例的指针
+inline static void _release_result(thread_param* param) {
+	if (!param->borrowed) {
+		free((void*)param->result);
+	}
+	param->result = NULL;
+	param->borrowed = false;
+}
+
+// 各线程分段位图的线程局部存储键, 线程退出时释放位图
+static pthread_key_t _segment_key;
+static pthread_once_t _segment_once = PTHREAD_ONCE_INIT;
+
+/// @brief 线程退出时释放分段位图
+///
+/// @param bits 分段位图指针
+static void _free_segment_bits(void* bits) {
+	free_local(bits, sieve_segment_bytes());
+}
+
+/// @brief 创建分段位图的线程局部存储键, 通过 `pthread_once` 保证只执行一次
+static void _create_segment_key(void) {
+	pthread_key_create(&_segment_key, _free_segment_bits);
+}
+
+/// @brief 获取当前线程的分段位图
+///
+/// 位图在线程首次调用时通过 `alloc_local` 函数分配, 之后被该线程执行的所有分组任务重复使用;
+/// 线程池的工作线程在启动时已绑定 CPU, 故位图位于工作线程所在的 NUMA 节点上
+///
+/// @return 分段位图指针, 内存分配失败时返回 `NULL`
+static uint64_t* _segment_bits(void) {
+	pthread_once(&_segment_once, _create_segment_key);
+
+	uint64_t* bits = (uint64_t*)pthread_getspecific(_segment_key);
+	if (!bits) {
+		bits = (uint64_t*)alloc_local(sieve_segment_bytes());
+		if (bits) {
+			pthread_setspecific(_segment_key, bits);
+		}
+	}
+	return bits;
+}
+
+/// @brief 设置分组任务的执行结果, 执行失败时通知其它分组任务尽快结束
+///
+/// @param params 指向 `thread_param` 结构体实例的指针
+/// @param rc 执行结果
+inline static void _finish_group(thread_param* params, int rc) {
+	params->rc = rc;
+	if (rc != 0) {
+		__atomic_store_n(params->cancelled, true, __ATOMIC_RELAXED);
+	}
+}
+
+/// @brief 线程池任务函数, 计算每个分组中的所有质数
+///
+/// 本函数将分组范围切分为多个分段, 每个分段的位图大小为 `sieve_segment_bytes()` 字节, 依次对各分段执行筛选并收集质数;
+/// 分段位图为执行任务的线程所有 (参见 `_segment_bits` 函数), 在各分段间重复使用
+///
+/// 执行结果保存在 `thread_param` 的 `rc` 字段中, `0` 表示执行成功, `ENOMEM` 表示内存分配失败
+///
+/// @param arg 任务参数, 为一个 `thread_param*` 类型指针值
+void _calculate_primes_each_group(void* arg) {
 	thread_param* params = (thread_param*)arg;
 
-	// 遍历指定范围内的全部整数, 或在线程结束标记为 `true` 时停止循环
-	for (size_t n = params->begin; !params->finished && n < params->end; n++) {
-		bool is_prime = true;
-
-		// 遍历从 `2` 开始到当前整数的所有整数, 或在线程结束标记为 `true` 时停止循环
-		for (size_t k = 2; !params->finished && k * k <= n; k++) {
-			if (n % k == 0) {
-				// 如果 `n` 是否能被 `k` 整除, 则 `n` 不是质数
-				is_prime = false;
-				break;
-			}
+	// 每个分段覆盖的整数个数, 位图中每一位表示一个奇数
+	const size_t seg_bytes = sieve_segment_bytes();
+	const uint64_t seg_span = (uint64_t)seg_bytes * 8 * 2;
+
+	uint64_t* bits = _segment_bits();
+	if (!bits) {
+		_finish_group(params, ENOMEM);
+		return;
+	}
+
+	// 遍历分组内的各个分段, 或在其它分组失败时停止循环
+	for (uint64_t lo = params->begin; lo < params->end; lo += seg_span) {
+		if (__atomic_load_n(params->cancelled, __ATOMIC_RELAXED)) {
+			break;
 		}
 
-		if (is_prime) {
-			// 如果 `n` 为质数, 则记录该质数值
-			if (params->result_count >= MAX_RESULT) {
-				// 如果预留的数组长度不足, 则返回错误值
-				pthread_exit((void*)-1);
-			}
-			params->result[params->result_count++] = n;
+		uint64_t hi = _min(lo + seg_span, params->end);
+
+		// 划去分段内的合数
+		sieve_mark(params->base, lo, hi, bits);
+
+		// 确保结果数组能容纳分段内的全部质数, 再将其追加到结果数组中
+		size_t n = sieve_count(bits, lo, hi);
+		if (!_reserve_result(params, params->result_count + n)) {
+			// 如果内存分配失败, 则返回错误值
+			_finish_group(params, ENOMEM);
+			return;
 		}
+		params->result_count += sieve_collect(bits, lo, hi, params->result + params->result_count, n);
 	}
 
-	params->finished = true;
-	return (void*)0;
+	_finish_group(params, 0);
 }
 
 /// @brief 初始化一个 `thread_param` 类型结构体实例
@@ -66,139 +193,385 @@ void* _calculate_primes_each_group(void* arg) {
 /// @param param 指向一个 `thread_param` 类型实例的指针
 /// @param group_n 当前 `thread_param` 表示的组索引
 /// @param max 要计算质数的上限值
-void _init_thread_arg(thread_param* param, size_t group_n, size_t max) {
-	// 计算当前分组的计算起始值
-	param->begin = _max(group_n * GROUP_SIZE, 2);
+/// @param base 各分组共享的基础质数表
+/// @param cancelled 各分组共享的取消标记
+void _init_thread_arg(thread_param* param, size_t group_n, size_t max, const sieve_base* base, bool* cancelled) {
+	// 计算当前分组的计算起始值, 由于 `GROUP_SIZE` 为偶数, 故起始值也为偶数, 满足分段筛的要求
+	param->begin = (uint64_t)group_n * GROUP_SIZE;
 
 	// 计算当前分组的肌酸结束值
 	param->end = _min((group_n + 1) * GROUP_SIZE, max);
 
-	// 设置线程结束标志, 未结束
-	param->finished = false;
+	// 设置任务函数及其参数
+	param->task.func = _calculate_primes_each_group;
+	param->task.arg = param;
 
-	// 设置结果个数为 `0`, 表示无计算结果
+	// 设置执行结果和共享的取消标记
+	param->rc = 0;
+	param->cancelled = cancelled;
+
+	// 设置结果个数为 `0`, 表示无计算结果, 结果数组在找到第一个质数时才分配
+	param->result = NULL;
 	param->result_count = 0;
+	param->result_capacity = 0;
+	param->borrowed = false;
+	param->dest = NULL;
+	param->done.pending = 0;
 
-	// 设置线程 ID 为 0, 表示尚未启动线程
-	param->tid = 0;
+	// 设置共享的基础质数表
+	param->base = base;
 }
 
-/// @brief 清理已启动的线程
+/// @brief 线程池任务函数, 将一个分组的计算结果复制到最终结果数组中, 并释放分组的结果数组
 ///
-/// @param params 指向 `thread_param` 结构体数组的指针
-/// @param len `thread_param` 结构体数组的长度
-inline static void _clear_threads(thread_param* params, size_t len) {
-	// 遍历结构体数组
-	for (size_t n = 0; n < len; n++) {
-		// 设置对应线程的结束标志, 令线程立即结束
-		params[n].finished = true;
+/// @param arg 任务参数, 为一个 `thread_param*` 类型指针值
+static void _copy_group_result(void* arg) {
+	thread_param* param = (thread_param*)arg;
 
-		// 等待线程结束
-		pthread_join(params[n].tid, NULL);
-	}
+	memcpy(param->dest, param->result, sizeof(uint32_t) * param->result_count);
 
-	// 释放 `thread_param` 数组占用的内存
-	free((void*)params);
+	_release_result(param);
 }
 
-/// @brief 向指定 `prime_result` 结构体中追加结果值
+/// @brief 当计算完毕后, 合并所有分组的计算结果
 ///
-/// 本函数将 `thread_param` 结构体实例中存储的各线程计算结果追加到 `prime_result` 结构体实例中,
-/// 并将 `prime_result` 结构体数组占用的内存进行回收
+/// 若结果数组原本为空且没有分组超出估算值, 则在共享大页内存中原地紧凑各分组结果, 并直接作为最终结果数组;
+/// 否则先对各分组的结果数量求前缀和, 得到每个分组在最终结果数组中的位置和结果总数, 一次性分配最终结果数组,
+/// 再将各分组结果的复制作为任务提交到线程池中并行执行
 ///
-/// @param result 指向 `prime_result` 结构体实例的指针
-/// @param param 指向 `thread_param` 结构体实例的指针
-inline static void _append_result(prime_result* result, thread_param* param) {
-	// 计算新的结果数组长度
-	size_t new_count = result->count + param->result_count;
+/// @param pool 线程池指针
+/// @param result 指向 `prime_result` 结构体实例的指针, 计算结果追加到其原有内容之后
+/// @param params 指向 `thread_param` 结构体数组的指针, 保存各分组计算结果
+/// @param param_count 表示 `thread_param` 结构体数组的长度
+/// @param arena 指向 `_lend_results` 函数分配的大页内存指针的指针, 所有权转移给 `result` 时设置为 `NULL`
+/// @return `0` 表示执行成功, 其它值表示执行失败
+static int _merge_results(thread_pool* pool, prime_result* result, thread_param* params, size_t param_count,
+	uint32_t** arena) {
+	int rc = 0;
+
+	// 计算结果总数; 任一分组失败时记录第一个错误值; 同时检查是否所有分组的结果都仍位于共享大页内存中
+	size_t total = result->count;
+	bool all_borrowed = *arena != NULL;
+	for (size_t i = 0; rc == 0 && i < param_count; i++) {
+		rc = params[i].rc;
+		total += params[i].result_count;
+		all_borrowed = all_borrowed && params[i].borrowed;
+	}
+
+	if (rc == 0 && all_borrowed && result->count == 0) {
+		// 没有分组超出估算值, 且结果数组原本为空时, 各分组的结果已按顺序位于共享大页内存中, 只是之间有估算的余量;
+		// 按顺序将各分组结果前移紧挨前一分组, 即可将共享大页内存直接作为最终结果数组, 无需再分配一块同样大小的内存
+		// 并复制全部结果. 各分组的目标位置不晚于其原位置, 但可能和前一分组的原位置重叠, 故只能按顺序逐个移动
+		uint32_t* dest = *arena;
+		for (size_t i = 0; i < param_count; i++) {
+			memmove(dest, params[i].result, sizeof(uint32_t) * params[i].result_count);
+			dest += params[i].result_count;
+			_release_result(&params[i]);
+		}
 
-	// 按照新长度创建保存结果的数组
-	uint32_t* new_result = (uint32_t*)calloc(new_count, sizeof(uint32_t));
-	if (result->count > 0) {
-		// 将 `prime_result` 结构体实例中原结果数组的内容复制到结果数组中
-		memcpy(new_result, result->data, sizeof(uint32_t) * result->count);
+		huge_free((void*)result->data);
+		result->data = *arena;
+		result->count = total;
+		*arena = NULL;
+		return 0;
 	}
-	// 将 `thread_param` 结构体实例中保存的计算结果追加到结果数组中
-	memcpy(new_result + result->count, param->result, sizeof(uint32_t) * param->result_count);
 
-	// 回收 `prime_result` 结构体实例中原本保存结果的数组内存
-	free((void*)result->data);
+	uint32_t* data = NULL;
+	if (rc == 0 && total > result->count) {
+		// 按结果总数一次性扩大结果数组, 数组原有内容保持不变
+		// 结果数组通常达到数百 MB, 使用大页可将缺页中断次数和 TLB 未命中减少到原来的 1/512
+		data = (uint32_t*)huge_realloc(result->data, sizeof(uint32_t) * total, 0);
+		if (!data) {
+			rc = ENOMEM;
+		}
+	}
+
+	if (rc == 0 && data) {
+		pool_group group = POOL_GROUP_INIT;
+
+		// 按前缀和确定每个分组在最终结果数组中的位置, 各分组的复制任务互不重叠, 可以并行执行
+		uint32_t* dest = data + result->count;
+		for (size_t i = 0; i < param_count; i++) {
+			params[i].dest = dest;
+			dest += params[i].result_count;
+
+			params[i].task.func = _copy_group_result;
+			thread_pool_submit(pool, &params[i].task, &group);
+		}
+		pool_group_wait(pool, &group);
+
+		result->data = data;
+		result->count = total;
+	}
 
-	// 将新结果数组以及数组长度存储到 `prime_result` 结构体实例中
-	result->data = new_result;
-	result->count = new_count;
+	// 释放尚未释放的分组结果数组 (执行失败时)
+	for (size_t i = 0; i < param_count; i++) {
+		_release_result(&params[i]);
+	}
+	return rc;
 }
 
-/// @brief 当计算完毕后, 处理所有线程的计算结果
+/// @brief 计算开始前的准备工作: 计算基础质数表, 获取线程池, 并初始化各分组的参数
 ///
-/// @param result 指向 `prime_result` 结构体实例的指针, 用于存储最终计算结果
-/// @param params 指向 `thread_param` 结构体数组的指针, 保存各线程计算结果
+/// @param max 要求解的最大质数上限
+/// @param base 用于保存基础质数表的指针
+/// @param cancelled 各分组共享的取消标记
+/// @param pool 用于保存线程池指针的指针
+/// @param params 用于保存 `thread_param` 结构体数组的指针
+/// @param group_count 用于保存分组数量的指针
+/// @return `0` 表示成功, 其它值表示失败
+static int _prepare_groups(size_t max, sieve_base* base, bool* cancelled, thread_pool** pool,
+	thread_param** params, size_t* group_count) {
+	// 结果以 `uint32_t` 类型存储, 上限不能超过 `2^32`
+	if ((uint64_t)max > (uint64_t)UINT32_MAX + 1) {
+		return EINVAL;
+	}
+
+	// 根据要计算的数值上限, 计算分组, 最后一组可以不满 `GROUP_SIZE` 个
+	*group_count = (max + GROUP_SIZE - 1) / GROUP_SIZE;
+
+	// 获取执行计算任务的线程池
+	*pool = thread_pool_default();
+	if (!*pool) {
+		return EAGAIN;
+	}
+
+	// 计算各分组共享的基础质数表
+	int rc = sieve_base_init(base, max);
+	if (rc != 0) {
+		return rc;
+	}
+
+	// 创建数组, 用于保存各分组计算参数值和计算结果; 各工作线程频繁访问该数组, 故使用大页
+	*params = (thread_param*)huge_alloc(_max(*group_count, 1) * sizeof(thread_param), 0);
+	if (!*params) {
+		sieve_base_free(base);
+		return ENOMEM;
+	}
+
+	for (size_t n = 0; n < *group_count; n++) {
+		// 初始化 `thread_param` 结构体数组的第 `n` 项
+		_init_thread_arg(&(*params)[n], n, max, base, cancelled);
+	}
+	return 0;
+}
+
+/// @brief 分配一块大页内存, 按各分组估算的质数个数切分, 作为各分组的结果数组
+///
+/// 分组的质数个数超过估算值时, 由 `_reserve_result` 函数改为单独分配
+///
+/// @param params 指向 `thread_param` 结构体数组的指针
 /// @param param_count 表示 `thread_param` 结构体数组的长度
-/// @return `0` 表示执行成功, 其它值表示执行失败
-int _dispose_results(prime_result* result, thread_param* params, size_t param_count) {
-	int rc = 0;
+/// @return 大页内存指针, 分配失败时返回 `NULL`, 此时各分组仍按需单独分配结果数组
+static uint32_t* _lend_results(thread_param* params, size_t param_count) {
+	size_t total = 0;
+	for (size_t i = 0; i < param_count; i++) {
+		total += _estimate_prime_count(params[i].begin, params[i].end);
+	}
 
-	// 遍历 `thread_param` 数组, 获取每个线程的执行结果
+	uint32_t* arena = (uint32_t*)huge_alloc(total * sizeof(uint32_t), 0);
+	if (!arena) {
+		return NULL;
+	}
+
+	uint32_t* p = arena;
 	for (size_t i = 0; i < param_count; i++) {
-		if (rc == 0) {
-			// 如果上一步执行正确, 则继续处理后续线程结果
+		params[i].result = p;
+		params[i].result_capacity = _estimate_prime_count(params[i].begin, params[i].end);
+		params[i].borrowed = true;
+		p += params[i].result_capacity;
+	}
+	return arena;
+}
+
+int calculate_primes(size_t max, prime_result* result) {
+	sieve_base base;
+	bool cancelled = false;
+	thread_pool* pool;
+	thread_param* params;
+	size_t group_count;
+
+	int rc = _prepare_groups(max, &base, &cancelled, &pool, &params, &group_count);
+	if (rc != 0) {
+		return rc;
+	}
+
+	// 按估算的质数个数, 为各分组的结果数组一次性分配一块大页内存, 避免各分组单独分配时逐页产生的缺页中断
+	uint32_t* arena = _lend_results(params, group_count);
+
+	// 将每个分组作为任务提交到线程池中进行计算, 并等待所有分组计算完毕
+	pool_group group = POOL_GROUP_INIT;
+	for (size_t n = 0; n < group_count; n++) {
+		thread_pool_submit(pool, &params[n].task, &group);
+	}
+	pool_group_wait(pool, &group);
+
+	// 合并各分组的计算结果, 可能直接将 `arena` 作为最终结果数组
+	rc = _merge_results(pool, result, params, group_count, &arena);
+
+	// 所有任务均已结束, 回收基础质数表和各分组参数
+	huge_free((void*)arena);
+	huge_free((void*)params);
+	sieve_base_free(&base);
+	return rc;
+}
+
+int calculate_primes_stream(size_t max, prime_callback callback, void* ctx) {
+	sieve_base base;
+	bool cancelled = false;
+	thread_pool* pool;
+	thread_param* params;
+	size_t group_count;
+
+	int rc = _prepare_groups(max, &base, &cancelled, &pool, &params, &group_count);
+	if (rc != 0) {
+		return rc;
+	}
+
+	// 同时提交的分组数, 限制尚未输出的分组结果所占用的内存
+	const size_t window = thread_pool_size(pool) * 2;
+
+	size_t submitted = 0;
+	for (; submitted < _min(window, group_count); submitted++) {
+		thread_pool_submit(pool, &params[submitted].task, &params[submitted].done);
+	}
 
-			int rx = 0;
+	// 按分组顺序等待各分组完成, 将结果交给回调函数后立即释放, 并提交下一个分组
+	size_t n = 0;
+	for (; n < group_count; n++) {
+		thread_param* param = &params[n];
+		pool_group_wait(pool, &param->done);
 
-			// 等待对应线程结束
-			rc = pthread_join(params[i].tid, (void**)&rx);
-			if (rc == 0 && rx == 0) {
-				_append_result(result, &params[i]);
-			}
+		rc = param->rc;
+		if (rc == 0 && param->result_count > 0) {
+			rc = callback(param->result, param->result_count, ctx);
+		}
+
+		_release_result(param);
 
-			// 记录错误值
-			rc = rx == 0 ? rc : rx;
+		if (rc != 0) {
+			break;
 		}
-		else {
-			// 如果上一步执行错误, 则进行线程资源回收工作
 
-			params[i].finished = true;
-			rc = pthread_join(params[i].tid, NULL);
+		if (submitted < group_count) {
+			thread_pool_submit(pool, &params[submitted].task, &params[submitted].done);
+			submitted++;
 		}
 	}
 
-	// 回收保存各线程结果的 `thread_param` 结构体数组
-	free((void*)params);
+	if (rc != 0) {
+		// 执行失败或回调函数要求停止时, 令已提交的分组尽快结束, 并释放其结果
+		__atomic_store_n(&cancelled, true, __ATOMIC_RELAXED);
+		for (n++; n < submitted; n++) {
+			pool_group_wait(pool, &params[n].done);
+			_release_result(&params[n]);
+		}
+	}
+
+	huge_free((void*)params);
+	sieve_base_free(&base);
 	return rc;
 }
 
-int calculate_primes(size_t max, prime_result* result) {
-	// 根据要计算的数值上限, 计算分组
-	const size_t group_count = max / GROUP_SIZE;
+/// @brief 用于保存每个计数任务参数和计算结果的结构体
+typedef struct
+{
+	pool_task task; // 线程池任务
+	int rc;         // 任务执行结果, `0` 表示成功
+	const sieve_base* base; // 各任务共享的基础质数表
+	uint64_t max;   // 计数上限
+	uint64_t* next; // 各任务共享的下一个待领取分组的起始值
+	uint64_t count; // 本任务统计到的质数个数
+} count_param;
+
+/// @brief 线程池任务函数, 不断领取下一个分组, 对其中的各分段执行筛选并统计质数个数, 直到所有分组都被领取
+///
+/// 分组通过原子操作动态领取, 故任务数只需和线程数相同, 占用的内存和计数范围无关
+///
+/// @param arg 任务参数, 为一个 `count_param*` 类型指针值
+static void _count_primes_each_task(void* arg) {
+	count_param* param = (count_param*)arg;
 
-	// 创建数组, 用于保存各分组计算参数值和计算结果
-	thread_param* params = (thread_param*)calloc(group_count, sizeof(thread_param));
+	const size_t seg_bytes = sieve_segment_bytes();
+	const uint64_t seg_span = (uint64_t)seg_bytes * 8 * 2;
 
-	// 循环各个分组, 为每个分组创建线程进行计算
-	for (size_t n = 0; n < group_count; n++) {
-		// 初始化 `thread_param` 结构体数组的第 `n` 项
-		_init_thread_arg(&params[n], n, max);
+	uint64_t* bits = _segment_bits();
+	if (!bits) {
+		param->rc = ENOMEM;
+		return;
+	}
 
-		pthread_t tid;
-		// 启动线程, 用于计算当前分组结果
-		int rc = pthread_create(&tid, NULL, _calculate_primes_each_group, &params[n]);
-		if (rc != 0) {
-			// 如果线程执行失败, 则停止后续执行, 清理已创建线程资源
-			_clear_threads(params, n + 1);
-			return rc;
+	for (;;) {
+		uint64_t begin = __atomic_fetch_add(param->next, GROUP_SIZE, __ATOMIC_RELAXED);
+		if (begin >= param->max) {
+			break;
+		}
+		uint64_t end = _min(begin + GROUP_SIZE, param->max);
+
+		for (uint64_t lo = begin; lo < end; lo += seg_span) {
+			uint64_t hi = _min(lo + seg_span, end);
+
+			sieve_mark(param->base, lo, hi, bits);
+			param->count += sieve_count(bits, lo, hi);
 		}
+	}
+}
+
+int count_primes(uint64_t max, uint64_t* count) {
+	// 基础质数以 `uint32_t` 类型存储, 上限的平方根不能超过 `UINT32_MAX`
+	if (max > (uint64_t)UINT32_MAX * UINT32_MAX) {
+		return EINVAL;
+	}
+
+	thread_pool* pool = thread_pool_default();
+	if (!pool) {
+		return EAGAIN;
+	}
+
+	sieve_base base;
+	int rc = sieve_base_init(&base, max);
+	if (rc != 0) {
+		return rc;
+	}
 
-		// 保存已启动线程的 id
-		params[n].tid = tid;
+	// 每个线程一个任务, 各任务从同一个起始值开始领取分组
+	size_t task_count = thread_pool_size(pool);
+	count_param* params = (count_param*)calloc(task_count, sizeof(count_param));
+	if (!params) {
+		sieve_base_free(&base);
+		return ENOMEM;
 	}
 
-	// 处理各个线程的计算结果
-	return _dispose_results(result, params, group_count);
+	uint64_t next = 0;
+	pool_group group = POOL_GROUP_INIT;
+
+	for (size_t i = 0; i < task_count; i++) {
+		params[i].task.func = _count_primes_each_task;
+		params[i].task.arg = &params[i];
+		params[i].base = &base;
+		params[i].max = max;
+		params[i].next = &next;
+		thread_pool_submit(pool, &params[i].task, &group);
+	}
+	pool_group_wait(pool, &group);
+
+	// 汇总各任务的统计结果, 任一任务失败时返回第一个错误值
+	*count = 0;
+	for (size_t i = 0; i < task_count; i++) {
+		if (rc == 0) {
+			rc = params[i].rc;
+		}
+		*count += params[i].count;
+	}
+
+	free((void*)params);
+	sieve_base_free(&base);
+	return rc;
 }
 
 void free_result(prime_result* result) {
 	// 回收 `prime_result` 结构体实例中保存结果的数组内存
-	free((void*)result->data);
+	huge_free((void*)result->data);
 	result->data = NULL;
 	result->count = 0;
 }
@@ -0,0 +1,234 @@
+#include "thread.h"
+
+#include <unistd.h>
+#include <math.h>
+#include <stdbool.h>
+#include <memory.h>
+#include <errno.h>
+
+// 求最大值/最小值的宏
+#define _max(a, b) ((a) > (b) ? (a) : (b))
+#define _min(a, b) ((a) < (b) ? (a) : (b))
+
+// 默认的分段大小 (字节), 在无法获取 L1 数据缓存大小时使用
+#define DEFAULT_SEGMENT_BYTES (32 * 1024)
+
+// 分段大小的上下限 (字节)
+#define MIN_SEGMENT_BYTES (16 * 1024)
+#define MAX_SEGMENT_BYTES (1024 * 1024)
+
+int sieve_base_init(sieve_base* base, uint64_t max) {
+	base->primes = NULL;
+	base->count = 0;
+	base->max = max;
+
+	// 计算基础质数的上限 `r`, 保证 `r * r >= max`, 即 `[2, max)` 中的合数均有不超过 `r` 的质因子
+	uint64_t r = (uint64_t)sqrt((double)max);
+	while (r * r < max) {
+		r++;
+	}
+	if (r < 3) {
+		return 0;
+	}
+
+	// 在 `[0, r]` 范围内执行朴素的埃氏筛, `composite[i]` 表示奇数 `2i + 1` 是否为合数
+	size_t n = (size_t)(r / 2 + 1);
+	bool* composite = (bool*)calloc(n, sizeof(bool));
+	if (!composite) {
+		return ENOMEM;
+	}
+
+	for (size_t i = 1; (2 * i + 1) * (2 * i + 1) <= r; i++) {
+		if (!composite[i]) {
+			size_t p = 2 * i + 1;
+			for (size_t j = p * p / 2; j < n; j += p) {
+				composite[j] = true;
+			}
+		}
+	}
+
+	// 统计并收集奇质数, 由于 `pi(r) < r / 2`, 按 `n` 分配空间即可
+	base->primes = (uint32_t*)malloc(n * sizeof(uint32_t));
+	if (!base->primes) {
+		free(composite);
+		return ENOMEM;
+	}
+
+	for (size_t i = 1; i < n; i++) {
+		if (!composite[i] && 2 * i + 1 <= r) {
+			base->primes[base->count++] = (uint32_t)(2 * i + 1);
+		}
+	}
+
+	free(composite);
+	return 0;
+}
+
+void sieve_base_free(sieve_base* base) {
+	free((void*)base->primes);
+	base->primes = NULL;
+	base->count = 0;
+}
+
+size_t sieve_segment_bytes(void) {
+	static size_t bytes = 0;
+
+	if (bytes == 0) {
+		// 按 L1 数据缓存大小设置分段, 令标记过程中对分段的随机写入都能命中 L1 缓存
+		long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+		size_t n = l1 > 0 ? (size_t)l1 : DEFAULT_SEGMENT_BYTES;
+
+		n = _min(_max(n, MIN_SEGMENT_BYTES), MAX_SEGMENT_BYTES);
+
+		// 分段必须由整数个 64 位字组成
+		bytes = n / sizeof(uint64_t) * sizeof(uint64_t);
+	}
+	return bytes;
+}
+
+void sieve_mark(const sieve_base* base, uint64_t lo, uint64_t hi, uint64_t* bits) {
+	// 分段内的奇数个数, 即位图的有效位数
+	uint64_t nbits = (hi - lo) / 2;
+	memset(bits, 0, (size_t)(nbits + 63) / 64 * sizeof(uint64_t));
+
+	// 分段内的第一个奇数
+	uint64_t first = lo + 1;
+
+	// `1` 不是质数
+	if (first == 1 && nbits > 0) {
+		bits[0] |= 1;
+	}
+
+	for (size_t k = 0; k < base->count; k++) {
+		uint64_t p = base->primes[k];
+		if (p * p >= hi) {
+			break;
+		}
+
+		// 计算分段内第一个需要划去的 `p` 的奇数倍, 且不小于 `p * p` (更小的倍数已被更小的质因子划去)
+		uint64_t m = (first + p - 1) / p * p;
+		if ((m & 1) == 0) {
+			m += p;
+		}
+		if (m < p * p) {
+			m = p * p;
+		}
+
+		// 相邻两个 `p` 的奇数倍相差 `2p`, 对应位图中相差 `p` 位
+		for (uint64_t i = (m - first) / 2; i < nbits; i += p) {
+			bits[i >> 6] |= (uint64_t)1 << (i & 63);
+		}
+	}
+}
+
+/// @brief 获取位图中第 `w` 个字的有效位掩码, 用于屏蔽最后一个字中超出分段的位
+///
+/// @param w 字下标
+/// @param nbits 位图有效位数
+/// @return 有效位掩码
+inline static uint64_t _valid_mask(uint64_t w, uint64_t nbits) {
+	uint64_t rest = nbits - w * 64;
+	return rest >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << rest) - 1;
+}
+
+size_t sieve_collect(const uint64_t* bits, uint64_t lo, uint64_t hi, uint32_t* out, size_t cap) {
+	size_t n = 0;
+
+	// 偶质数 `2` 不在位图中, 需要单独处理
+	if (lo <= 2 && hi > 2) {
+		if (n < cap) {
+			out[n] = 2;
+		}
+		n++;
+	}
+
+	uint64_t nbits = (hi - lo) / 2;
+	uint64_t first = lo + 1;
+
+	for (uint64_t w = 0; w * 64 < nbits; w++) {
+		// 取反后, 为 `1` 的位表示质数, 通过 `ctz` 依次取出最低位的 `1`
+		uint64_t word = ~bits[w] & _valid_mask(w, nbits);
+		while (word) {
+			if (n < cap) {
+				out[n] = (uint32_t)(first + 2 * (w * 64 + (uint64_t)__builtin_ctzll(word)));
+			}
+			n++;
+			word &= word - 1;
+		}
+	}
+
+	return n;
+}
+
+size_t sieve_count(const uint64_t* bits, uint64_t lo, uint64_t hi) {
+	size_t n = lo <= 2 && hi > 2 ? 1 : 0;
+
+	uint64_t nbits = (hi - lo) / 2;
+	for (uint64_t w = 0; w * 64 < nbits; w++) {
+		n += (size_t)__builtin_popcountll(~bits[w] & _valid_mask(w, nbits));
+	}
+
+	return n;
+}
+
+int for_each_prime(uint64_t lo, uint64_t hi, prime_callback callback, void* ctx) {
+	if (hi > (uint64_t)UINT32_MAX + 1) {
+		return EINVAL;
+	}
+	if (lo >= hi) {
+		return 0;
+	}
+
+	sieve_base base;
+	int rc = sieve_base_init(&base, hi);
+	if (rc != 0) {
+		return rc;
+	}
+
+	const size_t seg_bytes = sieve_segment_bytes();
+	const uint64_t seg_span = (uint64_t)seg_bytes * 8 * 2;
+
+	uint64_t* bits = (uint64_t*)malloc(seg_bytes);
+	uint32_t* batch = NULL;
+	size_t capacity = 0;
+
+	if (!bits) {
+		sieve_base_free(&base);
+		return ENOMEM;
+	}
+
+	// 分段起始值必须为偶数; 向下对齐后, 分段中的奇数均不小于 `lo`, 只有 `2` 需要单独排除
+	for (uint64_t seg_lo = lo & ~(uint64_t)1; rc == 0 && seg_lo < hi; seg_lo += seg_span) {
+		uint64_t seg_hi = _min(seg_lo + seg_span, hi);
+
+		sieve_mark(&base, seg_lo, seg_hi, bits);
+
+		// 按分段的质数个数扩大缓冲区, 缓冲区在各分段间重复使用
+		size_t n = sieve_count(bits, seg_lo, seg_hi);
+		if (n > capacity) {
+			uint32_t* p = (uint32_t*)realloc(batch, n * sizeof(uint32_t));
+			if (!p) {
+				rc = ENOMEM;
+				break;
+			}
+			batch = p;
+			capacity = n;
+		}
+
+		sieve_collect(bits, seg_lo, seg_hi, batch, n);
+
+		const uint32_t* primes = batch;
+		if (n > 0 && primes[0] < lo) {
+			primes++;
+			n--;
+		}
+		if (n > 0) {
+			rc = callback(primes, n, ctx);
+		}
+	}
+
+	free((void*)batch);
+	free((void*)bits);
+	sieve_base_free(&base);
+	return rc;
+}
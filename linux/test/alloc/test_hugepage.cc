@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "alloc.h"
+}
+
+#define TEST_SUITE_NAME test_linux_alloc__hugepage
+
+/// @brief 逐页写入内存, 返回写入期间产生的缺页中断次数
+///
+/// @param p 内存指针
+/// @param size 内存大小
+/// @return 缺页中断次数
+static uint64_t __touch(char* p, size_t size) {
+    page_faults before, after;
+    EXPECT_EQ(page_faults_self(&before), 0);
+    for (size_t off = 0; off < size; off += 4096) {
+        p[off] = (char)off;
+    }
+    EXPECT_EQ(page_faults_self(&after), 0);
+    return after.minor - before.minor;
+}
+
+/// @brief 测试分配不足半个大页的内存, 使用普通页面
+TEST(TEST_SUITE_NAME, small) {
+    char* p = (char*)huge_alloc(1000, 0);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(huge_backing_of(p), HUGE_BACKING_PAGES);
+
+    // 内存已清零
+    for (size_t i = 0; i < 1000; i++) {
+        ASSERT_EQ(p[i], 0);
+    }
+    huge_free(p);
+    huge_free(nullptr);
+}
+
+/// @brief 测试分配大块内存, 使用透明大页时每个大页只产生一次缺页中断
+TEST(TEST_SUITE_NAME, large) {
+    const size_t size = (size_t)64 << 20;
+    const size_t hp = huge_page_size();
+
+    char* p = (char*)huge_alloc(size, HUGE_NO_HUGETLB);
+    ASSERT_NE(p, nullptr);
+    ASSERT_NE(huge_backing_of(p), HUGE_BACKING_HUGETLB);
+
+    // 用户内存即为映射本身, 按大页对齐
+    ASSERT_EQ((uintptr_t)p % hp, 0);
+
+    uint64_t faults = __touch(p, size);
+    ASSERT_LE(faults, size / 4096 + 16);
+    if (huge_backing_of(p) == HUGE_BACKING_THP) {
+        // 内核可能因内存碎片无法分配部分大页, 只要求大部分使用大页
+        ASSERT_LT(faults, size / 4096 / 4);
+    }
+
+    huge_free(p);
+}
+
+/// @brief 测试预先写入全部页面后, 访问内存不再产生缺页中断
+TEST(TEST_SUITE_NAME, prefault) {
+    const size_t size = (size_t)16 << 20;
+
+    for (int flags : { (int)HUGE_PREFAULT, HUGE_PREFAULT | HUGE_NO_HUGETLB }) {
+        char* p = (char*)huge_alloc(size, flags);
+        ASSERT_NE(p, nullptr);
+        ASSERT_LE(__touch(p, size), 4);
+        huge_free(p);
+    }
+
+    char* p = (char*)huge_alloc(4096, HUGE_PREFAULT);
+    ASSERT_NE(p, nullptr);
+    ASSERT_LE(__touch(p, 4096), 1);
+    huge_free(p);
+}
+
+/// @brief 测试调整内存大小, 原有内容保持不变
+TEST(TEST_SUITE_NAME, realloc) {
+    char* p = (char*)huge_realloc(nullptr, 100, 0);
+    ASSERT_NE(p, nullptr);
+    memcpy(p, "Hello World", 12);
+
+    // 映射足够容纳时原地调整
+    char* q = (char*)huge_realloc(p, 200, 0);
+    ASSERT_EQ(q, p);
+
+    // 超出映射时重新分配
+    q = (char*)huge_realloc(p, (size_t)8 << 20, 0);
+    ASSERT_NE(q, nullptr);
+    ASSERT_STREQ(q, "Hello World");
+    ASSERT_EQ(q[(8 << 20) - 1], 0);
+
+    huge_free(q);
+}
+
+/// @brief 测试恰好为整数个大页的请求不多占用大页, 且多块内存可按任意顺序释放
+TEST(TEST_SUITE_NAME, exact_huge_pages) {
+    const size_t hp = huge_page_size();
+
+    // 映射恰好为请求的大小, 故紧随其后的一页不属于该映射, 原地调整到大页大小之外会重新分配
+    char* p = (char*)huge_alloc(hp, HUGE_NO_HUGETLB);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ((uintptr_t)p % hp, 0);
+    ASSERT_EQ(huge_realloc(p, hp, 0), p);
+    p[hp - 1] = 1;
+
+    char* q = (char*)huge_realloc(p, hp + 1, HUGE_NO_HUGETLB);
+    ASSERT_NE(q, nullptr);
+    ASSERT_NE(q, p);
+    ASSERT_EQ(q[hp - 1], 1);
+
+    // 分配足够多的内存, 触发内存信息表的扩容, 再按交错顺序释放
+    std::vector<char*> ptrs;
+    for (int i = 0; i < 200; i++) {
+        ptrs.push_back((char*)huge_alloc(4096 * (i % 4 + 1), 0));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+    for (size_t i = 0; i < ptrs.size(); i += 2) {
+        huge_free(ptrs[i]);
+    }
+    for (size_t i = 1; i < ptrs.size(); i += 2) {
+        ASSERT_EQ(huge_backing_of(ptrs[i]), HUGE_BACKING_PAGES);
+        ASSERT_EQ(huge_realloc(ptrs[i], 4096, 0), ptrs[i]);
+        huge_free(ptrs[i]);
+    }
+
+    huge_free(q);
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "coro.h"
+
+#define TEST_SUITE_NAME test_linux_coro__executor
+
+using namespace std::chrono_literals;
+
+/// @brief 返回参数之和的协程
+static coro::task<int> __add(int a, int b) {
+    co_return a + b;
+}
+
+/// @brief 抛出异常的协程
+static coro::task<int> __fail() {
+    throw std::runtime_error("failed");
+    co_return 0;
+}
+
+/// @brief 递归等待子协程的协程
+static coro::task<int> __chain(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    co_return co_await __chain(depth - 1) + 1;
+}
+
+/// @brief 测试协程之间的返回值和异常传递
+TEST(TEST_SUITE_NAME, task) {
+    coro::executor ex;
+
+    ASSERT_EQ(ex.block_on(__add(1, 2)), 3);
+    ASSERT_EQ(ex.block_on(__chain(1000)), 1000);
+
+    // 子协程的异常在等待者中重新抛出
+    auto catcher = []() -> coro::task<bool> {
+        try {
+            co_await __fail();
+        }
+        catch (const std::runtime_error&) {
+            co_return true;
+        }
+        co_return false;
+    };
+    ASSERT_TRUE(ex.block_on(catcher()));
+
+    // 未捕获的异常由 `run` 重新抛出
+    ASSERT_THROW(ex.block_on(__fail()), std::runtime_error);
+    ASSERT_EQ(ex.pending(), 0);
+}
+
+/// @brief 测试定时器按到期时刻恢复协程
+TEST(TEST_SUITE_NAME, sleep) {
+    coro::executor ex;
+    std::vector<int> order;
+
+    auto sleeper = [&](int id, std::chrono::milliseconds d) -> coro::task<void> {
+        co_await ex.sleep_for(d);
+        order.push_back(id);
+    };
+
+    auto start = coro::executor::clock::now();
+    ex.spawn(sleeper(3, 30ms));
+    ex.spawn(sleeper(1, 10ms));
+    ex.spawn(sleeper(2, 20ms));
+    ex.spawn(sleeper(0, 0ms));
+    ex.run();
+
+    ASSERT_EQ(order, (std::vector<int>{ 0, 1, 2, 3 }));
+    ASSERT_GE(coro::executor::clock::now() - start, 30ms);
+}
+
+/// @brief 测试通过管道在协程之间传递数据
+TEST(TEST_SUITE_NAME, pipe) {
+    coro::executor ex;
+
+    int fds[2];
+    ASSERT_EQ(pipe2(fds, O_NONBLOCK | O_CLOEXEC), 0);
+
+    // 写入方分多次写入, 每次写入之间等待一段时间, 读取方需要多次挂起
+    // 协程中不能使用 `ASSERT_*` 宏 (其中包含 `return` 语句), 故记录写入的字节数, 最后统一检查
+    ssize_t written = 0;
+    auto writer = [&]() -> coro::task<void> {
+        for (int i = 0; i < 5; i++) {
+            co_await ex.sleep_for(2ms);
+            co_await ex.writable(fds[1]);
+            written += write(fds[1], "hello", 5);
+        }
+        close(fds[1]);
+    };
+
+    std::string data;
+    auto reader = [&]() -> coro::task<void> {
+        data = co_await ex.read_all(fds[0]);
+        close(fds[0]);
+    };
+
+    ex.spawn(reader());
+    ex.spawn(writer());
+    ex.run();
+
+    ASSERT_EQ(written, 25);
+    ASSERT_EQ(data, "hellohellohellohellohello");
+}
+
+/// @brief 测试所有协程都在等待, 但没有任何事件能够恢复协程的情况
+TEST(TEST_SUITE_NAME, deadlock) {
+    coro::executor ex;
+
+    // 协程等待一个从未被 `spawn` 的任务的结果, 没有被监视的句柄和定时器
+    struct never {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) const noexcept { }
+        void await_resume() const noexcept { }
+    };
+
+    auto stuck = []() -> coro::task<void> { co_await never{}; };
+    ASSERT_THROW(ex.block_on(stuck()), std::logic_error);
+}
+
+/// @brief 测试等待子进程退出
+TEST(TEST_SUITE_NAME, wait_exit) {
+    coro::executor ex;
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        usleep(10000);
+        _exit(7);
+    }
+
+    int status = ex.block_on(ex.wait_exit(pid));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 7);
+}
+
+/// @brief 测试在一个线程中同时运行上千个子进程, 并读取各自的标准输出
+TEST(TEST_SUITE_NAME, exec_concurrent) {
+    const int n = 1000;
+
+    coro::executor ex;
+    std::vector<coro::child_result> results(n);
+
+    auto job = [&](int i) -> coro::task<void> {
+        std::string arg = std::to_string(i);
+        char* argv[] = { (char*)"echo", (char*)"-n", arg.data(), nullptr };
+        results[i] = co_await ex.exec("/bin/echo", argv);
+    };
+
+    for (int i = 0; i < n; i++) {
+        ex.spawn(job(i));
+    }
+    ex.run();
+
+    for (int i = 0; i < n; i++) {
+        ASSERT_TRUE(WIFEXITED(results[i].status));
+        ASSERT_EQ(WEXITSTATUS(results[i].status), 0);
+        ASSERT_EQ(results[i].out, std::to_string(i));
+    }
+
+    // 无法创建子进程时抛出异常
+    char* argv[] = { (char*)"missing", nullptr };
+    ASSERT_THROW(ex.block_on(ex.exec("/nonexistent/missing", argv)), std::system_error);
+}
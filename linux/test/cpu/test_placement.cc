@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "cpu.h"
+}
+
+#define TEST_SUITE_NAME test_linux_cpu__placement
+
+/// @brief 测试获取可用 CPU 数量, 不超过 `sched_getaffinity` 返回的 CPU 数量
+TEST(TEST_SUITE_NAME, available_cpus) {
+    cpu_set_t set;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+
+    ASSERT_GE(available_cpus(), 1);
+    ASSERT_LE(available_cpus(), (size_t)CPU_COUNT(&set));
+}
+
+/// @brief 测试读取 CPU 布局, 紧凑和分散两种放置方式都应使用可用 CPU 中的前 `usable` 个
+TEST(TEST_SUITE_NAME, cpu_layout) {
+    cpu_set_t set;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+
+    cpu_layout layout;
+    ASSERT_EQ(cpu_layout_init(&layout), 0);
+    ASSERT_EQ(layout.count, (size_t)CPU_COUNT(&set));
+    ASSERT_EQ(layout.usable, available_cpus());
+
+    // 布局中的 CPU 均在当前进程的 CPU 集合中
+    for (size_t i = 0; i < layout.count; i++) {
+        ASSERT_TRUE(CPU_ISSET(layout.cpus[i].cpu, &set));
+    }
+
+    std::vector<int> compact, scatter;
+    for (size_t i = 0; i < layout.usable; i++) {
+        compact.push_back(cpu_layout_pick(&layout, PLACEMENT_COMPACT, i));
+        scatter.push_back(cpu_layout_pick(&layout, PLACEMENT_SCATTER, i));
+    }
+
+    // 前 `usable` 个工作者使用的 CPU 互不相同
+    std::sort(compact.begin(), compact.end());
+    std::sort(scatter.begin(), scatter.end());
+    ASSERT_EQ(std::unique(compact.begin(), compact.end()), compact.end());
+    ASSERT_EQ(std::unique(scatter.begin(), scatter.end()), scatter.end());
+
+    // 工作者数超过 `usable` 时循环使用, 不绑定时返回 `-1`
+    ASSERT_EQ(cpu_layout_pick(&layout, PLACEMENT_COMPACT, layout.usable), cpu_layout_pick(&layout, PLACEMENT_COMPACT, 0));
+    ASSERT_EQ(cpu_layout_pick(&layout, PLACEMENT_NONE, 0), -1);
+
+    cpu_layout_free(&layout);
+}
+
+/// @brief 测试将当前线程绑定到指定 CPU
+TEST(TEST_SUITE_NAME, pin_current) {
+    cpu_set_t saved;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(saved), &saved), 0);
+
+    cpu_layout layout;
+    ASSERT_EQ(cpu_layout_init(&layout), 0);
+
+    int cpu = cpu_layout_pick(&layout, PLACEMENT_SCATTER, 0);
+    ASSERT_EQ(pin_current(cpu), 0);
+
+    cpu_set_t set;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+    ASSERT_EQ(CPU_COUNT(&set), 1);
+    ASSERT_TRUE(CPU_ISSET(cpu, &set));
+
+    // 不绑定时直接返回
+    ASSERT_EQ(pin_current(-1), 0);
+
+    // 恢复当前线程原本的 CPU 集合
+    ASSERT_EQ(sched_setaffinity(0, sizeof(saved), &saved), 0);
+    cpu_layout_free(&layout);
+}
+
+/// @brief 测试分配本地内存, 分配的内存已清零且可以读写
+TEST(TEST_SUITE_NAME, alloc_local) {
+    const size_t size = 1 << 20;
+
+    char* p = (char*)alloc_local(size);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(std::count(p, p + size, 0), (long)size);
+
+    p[size - 1] = 1;
+    ASSERT_EQ(p[size - 1], 1);
+
+    free_local(p, size);
+}
+
+/// @brief 测试两种放置方式在 2 节点, 每节点 2 个物理核心, 每核心 2 个超线程的拓扑上的 CPU 顺序
+///
+/// CPU 编号按 Linux 常见的方式排列: 先依次排列各物理核心的第一个超线程, 再排列第二个超线程
+TEST(TEST_SUITE_NAME, cpu_layout_build) {
+    const cpu_info cpus[] = {
+        { 0, 0, 0, 0 }, { 1, 0, 0, 1 }, { 2, 1, 1, 0 }, { 3, 1, 1, 1 },
+        { 4, 0, 0, 0 }, { 5, 0, 0, 1 }, { 6, 1, 1, 0 }, { 7, 1, 1, 1 },
+    };
+
+    cpu_layout layout;
+    ASSERT_EQ(cpu_layout_build(&layout, cpus, 8, 0), 0);
+    ASSERT_EQ(layout.usable, 8);
+
+    // 紧凑放置: 同一物理核心的超线程相邻, 先占满节点 0
+    const int compact[] = { 0, 4, 1, 5, 2, 6, 3, 7 };
+    for (size_t i = 0; i < 8; i++) {
+        ASSERT_EQ(cpu_layout_pick(&layout, PLACEMENT_COMPACT, i), compact[i]);
+    }
+
+    // 分散放置: 轮流使用两个节点, 先占满物理核心再使用超线程
+    const int scatter[] = { 0, 2, 1, 3, 4, 6, 5, 7 };
+    for (size_t i = 0; i < 8; i++) {
+        ASSERT_EQ(cpu_layout_pick(&layout, PLACEMENT_SCATTER, i), scatter[i]);
+    }
+    cpu_layout_free(&layout);
+
+    // cgroup 配额为 3 时, 只循环使用前 3 个 CPU
+    ASSERT_EQ(cpu_layout_build(&layout, cpus, 8, 3), 0);
+    ASSERT_EQ(layout.usable, 3);
+    ASSERT_EQ(cpu_layout_pick(&layout, PLACEMENT_SCATTER, 3), 0);
+    ASSERT_EQ(cpu_layout_pick(&layout, PLACEMENT_COMPACT, 4), 4);
+    cpu_layout_free(&layout);
+}
+
+/// @brief 测试默认放置方式, 未设置环境变量 `LINUX_PLACEMENT` 时不绑定 CPU
+TEST(TEST_SUITE_NAME, placement_default) {
+    const char* saved = getenv("LINUX_PLACEMENT");
+    std::string old = saved ? saved : "";
+
+    unsetenv("LINUX_PLACEMENT");
+    ASSERT_EQ(placement_default(), PLACEMENT_NONE);
+
+    setenv("LINUX_PLACEMENT", "compact", 1);
+    ASSERT_EQ(placement_default(), PLACEMENT_COMPACT);
+    setenv("LINUX_PLACEMENT", "scatter", 1);
+    ASSERT_EQ(placement_default(), PLACEMENT_SCATTER);
+    setenv("LINUX_PLACEMENT", "unknown", 1);
+    ASSERT_EQ(placement_default(), PLACEMENT_NONE);
+
+    if (saved) {
+        setenv("LINUX_PLACEMENT", old.c_str(), 1);
+    }
+    else {
+        unsetenv("LINUX_PLACEMENT");
+    }
+}
+
+/// @brief 在临时目录中构造的 cgroup 文件系统, 析构时删除
+struct fake_cgroup {
+    std::filesystem::path root;
+
+    fake_cgroup() {
+        char tmpl[] = "/tmp/test_cgroup_XXXXXX";
+        root = mkdtemp(tmpl);
+    }
+    ~fake_cgroup() { std::filesystem::remove_all(root); }
+
+    /// @brief 写入 `root` 下的文件, 自动创建所在目录
+    void write(const std::string& rel, const std::string& content) {
+        std::filesystem::path p = root / rel;
+        std::filesystem::create_directories(p.parent_path());
+        std::ofstream(p) << content;
+    }
+
+    /// @brief 以 `content` 作为 `/proc/self/cgroup` 的内容读取配额
+    size_t quota(const std::string& content) {
+        write("self_cgroup", content);
+        return cgroup_cpu_quota_at(root.c_str(), (root / "self_cgroup").c_str());
+    }
+};
+
+/// @brief 测试从进程所在的 cgroup 及其各级父目录读取配额, 取最小值
+TEST(TEST_SUITE_NAME, cgroup_cpu_quota_at) {
+    {
+        // cgroup v2: 挂载点没有 `cpu.max`, 配额设置在 slice 和服务的目录中
+        fake_cgroup cg;
+        cg.write("system.slice/cpu.max", "250000 100000\n");
+        cg.write("system.slice/app.service/cpu.max", "150000 100000\n");
+        ASSERT_EQ(cg.quota("0::/system.slice/app.service\n"), 2);
+
+        // 父级的配额更小
+        cg.write("system.slice/app.service/cpu.max", "max 100000\n");
+        ASSERT_EQ(cg.quota("0::/system.slice/app.service\n"), 3);
+
+        // 各级都未设置配额
+        cg.write("system.slice/cpu.max", "max 100000\n");
+        ASSERT_EQ(cg.quota("0::/system.slice/app.service\n"), 0);
+
+        // 不在受限的 cgroup 中
+        cg.write("system.slice/cpu.max", "100000 100000\n");
+        ASSERT_EQ(cg.quota("0::/user.slice\n"), 0);
+        ASSERT_EQ(cg.quota("0::/\n"), 0);
+    }
+    {
+        // cgroup v1: `cpu` 控制器和其它控制器挂载在同一层级
+        fake_cgroup cg;
+        cg.write("cpu/docker/abc/cpu.cfs_quota_us", "300000\n");
+        cg.write("cpu/docker/abc/cpu.cfs_period_us", "100000\n");
+        cg.write("cpu/docker/cpu.cfs_quota_us", "-1\n");
+        cg.write("cpu/docker/cpu.cfs_period_us", "100000\n");
+        ASSERT_EQ(cg.quota("5:memory:/docker/abc\n3:cpu,cpuacct:/docker/abc\n"), 3);
+
+        // 只有 `cpuacct` 控制器的层级不影响配额
+        ASSERT_EQ(cg.quota("3:cpuacct:/docker/abc\n"), 0);
+    }
+
+    // 文件不存在时视为未设置配额
+    ASSERT_EQ(cgroup_cpu_quota_at("/nonexistent", "/nonexistent/cgroup"), 0);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "io.h"
+}
+
+#define TEST_SUITE_NAME test_linux_io__mapped
+
+/// @brief 创建内容为 `content` 的临时文件
+///
+/// @param content 文件内容
+/// @return 文件路径, 需在测试结束时删除
+static std::string __temp_file(const std::string& content) {
+    char path[] = "/tmp/test_mapped_XXXXXX";
+    int fd = mkstemp(path);
+    EXPECT_GE(fd, 0);
+    EXPECT_EQ(write(fd, content.data(), content.size()), (ssize_t)content.size());
+    close(fd);
+    return path;
+}
+
+/// @brief 生成若干长度不等的行, 最后一行没有 `\n`
+static std::string __lines(size_t n) {
+    std::string s;
+    for (size_t i = 0; i < n; i++) {
+        s.append(i * 7 % 300, (char)('a' + i % 26));
+        s.push_back('\n');
+    }
+    s.append("tail");
+    return s;
+}
+
+/// @brief 测试按行边界切分文件, 分别映射整个文件和按窗口映射
+///
+/// 各块依次拼接后应和文件内容相同, 且除最后一块外, 每块都以 `\n` 结尾
+TEST(TEST_SUITE_NAME, iter_lines) {
+    std::string content = __lines(2000);
+    std::string path = __temp_file(content);
+
+    long page = sysconf(_SC_PAGESIZE);
+    for (size_t window : { (size_t)0, (size_t)page * 2, (size_t)page * 5 }) {
+        mapped_file mf;
+        ASSERT_EQ(mapped_open(&mf, path.c_str(), window, MAPPED_SEQUENTIAL | MAPPED_WILLNEED), 0);
+        ASSERT_EQ(mf.size, content.size());
+        if (window) {
+            ASSERT_EQ(mf.window, window);
+        }
+
+        mapped_iter it;
+        mapped_iter_init(&it, &mf, 1000);
+
+        std::string joined;
+        size_t chunks = 0;
+        for (;;) {
+            const char* data = nullptr;
+            size_t len = 0;
+            ASSERT_EQ(mapped_iter_next(&it, &data, &len), 0);
+            if (len == 0) {
+                break;
+            }
+
+            joined.append(data, len);
+            chunks++;
+            if (joined.size() < content.size()) {
+                ASSERT_EQ(data[len - 1], '\n');
+            }
+        }
+
+        ASSERT_GT(chunks, 1);
+        ASSERT_TRUE(joined == content);
+
+        mapped_close(&mf);
+    }
+
+    unlink(path.c_str());
+}
+
+/// @brief 测试行长度超过期望块大小和窗口大小的情况
+TEST(TEST_SUITE_NAME, long_lines) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    // 行长度超过期望的块大小但不超过窗口时, 块延长到行尾
+    std::string content = std::string(page, 'x') + "\n" + "end\n";
+    std::string path = __temp_file(content);
+
+    mapped_file mf;
+    ASSERT_EQ(mapped_open(&mf, path.c_str(), page * 2, 0), 0);
+
+    mapped_iter it;
+    mapped_iter_init(&it, &mf, 100);
+
+    const char* data = nullptr;
+    size_t len = 0;
+    ASSERT_EQ(mapped_iter_next(&it, &data, &len), 0);
+    ASSERT_EQ(len, (size_t)page + 1);
+    ASSERT_EQ(mapped_iter_next(&it, &data, &len), 0);
+    ASSERT_EQ(std::string(data, len), "end\n");
+    ASSERT_EQ(mapped_iter_next(&it, &data, &len), 0);
+    ASSERT_EQ(len, 0);
+
+    mapped_close(&mf);
+    unlink(path.c_str());
+
+    // 行长度超过窗口大小
+    content = std::string(page * 3, 'x') + "\n";
+    path = __temp_file(content);
+
+    ASSERT_EQ(mapped_open(&mf, path.c_str(), page * 2, 0), 0);
+    mapped_iter_init(&it, &mf, 100);
+    ASSERT_EQ(mapped_iter_next(&it, &data, &len), E2BIG);
+
+    mapped_close(&mf);
+    unlink(path.c_str());
+}
+
+/// @brief 测试按窗口映射时访问任意范围
+TEST(TEST_SUITE_NAME, view) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    std::string content;
+    for (long i = 0; i < page * 8; i++) {
+        content.push_back((char)('a' + i % 26 + i / page % 2));
+    }
+    std::string path = __temp_file(content);
+
+    mapped_file mf;
+    ASSERT_EQ(mapped_open(&mf, path.c_str(), page * 2, MAPPED_POPULATE | MAPPED_HUGEPAGE), 0);
+
+    // 依次访问各个位置, 包括跨越页边界以及倒序访问
+    const char* data = nullptr;
+    for (uint64_t off : { (uint64_t)0, (uint64_t)page * 5 - 10, (uint64_t)page * 7, (uint64_t)page + 3 }) {
+        ASSERT_EQ(mapped_view(&mf, off, 100, &data), 0);
+        ASSERT_EQ(std::string(data, 100), content.substr(off, 100));
+    }
+
+    // 范围超过窗口大小, 或超出文件末尾
+    ASSERT_EQ(mapped_view(&mf, 10, page * 2, &data), E2BIG);
+    ASSERT_EQ(mapped_view(&mf, page * 8 - 10, 11, &data), EINVAL);
+
+    mapped_close(&mf);
+    unlink(path.c_str());
+
+    // 空文件
+    path = __temp_file("");
+    ASSERT_EQ(mapped_open(&mf, path.c_str(), 0, MAPPED_POPULATE), 0);
+
+    mapped_iter it;
+    mapped_iter_init(&it, &mf, 100);
+    size_t len = 1;
+    ASSERT_EQ(mapped_iter_next(&it, &data, &len), 0);
+    ASSERT_EQ(len, 0);
+
+    mapped_close(&mf);
+    unlink(path.c_str());
+}
@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
 
 // 引入 C 语言头文件
 extern "C" {
@@ -36,3 +42,224 @@ TEST(TEST_SUITE_NAME, fd_redirect_to_memory) {
 
     free((void*)res);
 }
+
+/// @brief 向文件描述符写入 `total` 字节, 第 `i` 个字节为 `'a' + i % 26`
+///
+/// @param fd 文件描述符
+/// @param total 写入的总字节数
+/// @return 是否全部写入成功
+static bool __write_pattern(int fd, size_t total) {
+    char buf[4096];
+    for (size_t off = 0; off < total;) {
+        size_t n = total - off < sizeof(buf) ? total - off : sizeof(buf);
+        for (size_t i = 0; i < n; i++) {
+            buf[i] = (char)('a' + (off + i) % 26);
+        }
+        if (write(STDOUT_FILENO, buf, n) != (ssize_t)n) {
+            return false;
+        }
+        off += n;
+    }
+    return true;
+}
+
+/// @brief 读取文件描述符指向文件的全部内容
+static std::string __read_file(int fd) {
+    std::string s;
+    char buf[65536];
+    ssize_t n;
+    for (off_t off = 0; (n = pread(fd, buf, sizeof(buf), off)) > 0; off += n) {
+        s.append(buf, (size_t)n);
+    }
+    return s;
+}
+
+/// @brief 生成 `total` 字节的期望内容, 和 `__write_pattern` 写入的内容一致
+static std::string __pattern(size_t total) {
+    std::string s(total, 0);
+    for (size_t i = 0; i < total; i++) {
+        s[i] = (char)('a' + i % 26);
+    }
+    return s;
+}
+
+/// @brief 测试由后台线程持续读取的重定向, 输出内容远大于管道容量时写入方不会阻塞
+TEST(TEST_SUITE_NAME, fd_redirect_to_memory_async) {
+    const size_t total = 32 << 20;
+
+    fflush(stdout);
+    void* hfd = fd_redirect_to_memory_async_begin(STDOUT_FILENO);
+    ASSERT_NE(hfd, nullptr);
+
+    bool ok = __write_pattern(STDOUT_FILENO, total);
+
+    size_t res_len = 0;
+    char* res = fd_redirect_to_memory_end(hfd, &res_len);
+
+    ASSERT_TRUE(ok);
+    ASSERT_NE(res, nullptr);
+    ASSERT_EQ(res_len, total);
+    ASSERT_TRUE(std::string(res, res_len) == __pattern(total));
+    ASSERT_EQ(res[total], 0);
+
+    free(res);
+}
+
+/// @brief 测试没有任何输出时得到空字符串
+TEST(TEST_SUITE_NAME, fd_redirect_to_memory_empty) {
+    fflush(stdout);
+
+    for (bool async : { false, true }) {
+        void* hfd = async ? fd_redirect_to_memory_async_begin(STDOUT_FILENO) : fd_redirect_to_memory_begin(STDOUT_FILENO);
+        ASSERT_NE(hfd, nullptr);
+
+        size_t res_len = 1;
+        char* res = fd_redirect_to_memory_end(hfd, &res_len);
+        ASSERT_NE(res, nullptr);
+        ASSERT_EQ(res_len, 0);
+        ASSERT_STREQ(res, "");
+        free(res);
+    }
+}
+
+/// @brief 测试重定向到匿名内存文件, 输出内容通过只读映射返回
+TEST(TEST_SUITE_NAME, fd_redirect_to_memfd) {
+    const size_t total = 32 << 20;
+
+    fflush(stdout);
+    void* hfd = fd_redirect_to_memfd_begin(STDOUT_FILENO);
+    ASSERT_NE(hfd, nullptr);
+
+    // 通过 `stdio` 和直接写入文件描述符两种方式输出
+    printf("Hello World\n");
+    fflush(stdout);
+    bool ok = __write_pattern(STDOUT_FILENO, total);
+
+    size_t res_len = 0;
+    char* res = fd_redirect_to_memfd_end(hfd, &res_len);
+
+    ASSERT_TRUE(ok);
+    ASSERT_NE(res, nullptr);
+    ASSERT_EQ(res_len, total + 12);
+    ASSERT_TRUE(std::string(res, res_len) == "Hello World\n" + __pattern(total));
+    fd_redirect_memfd_free(res, res_len);
+
+    // 没有任何输出时得到空内容
+    hfd = fd_redirect_to_memfd_begin(STDOUT_FILENO);
+    res = fd_redirect_to_memfd_end(hfd, &res_len);
+    ASSERT_NE(res, nullptr);
+    ASSERT_EQ(res_len, 0);
+    fd_redirect_memfd_free(res, res_len);
+}
+
+/// @brief 测试通过 `splice` 将输出重定向到文件, 包括不支持 `splice` 的 `O_APPEND` 文件
+TEST(TEST_SUITE_NAME, fd_redirect_to_file) {
+    const size_t total = 8 << 20;
+
+    for (int flags : { 0, O_APPEND }) {
+        char path[] = "/tmp/test_redirect_XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        unlink(path);
+        if (flags) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | flags);
+        }
+
+        fflush(stdout);
+        void* h = fd_redirect_to_file_begin(STDOUT_FILENO, fd);
+        ASSERT_NE(h, nullptr);
+
+        bool ok = __write_pattern(STDOUT_FILENO, total);
+
+        fd_splice_stats stats;
+        ASSERT_EQ(fd_redirect_to_file_end(h, &stats), 0);
+        ASSERT_TRUE(ok);
+        ASSERT_EQ(stats.bytes, total);
+        ASSERT_GT(stats.bytes_per_sec, 0);
+
+        ASSERT_TRUE(__read_file(fd) == __pattern(total));
+        close(fd);
+    }
+}
+
+/// @brief 测试通过 `tee` 将输出同时转发到文件和另一个管道
+TEST(TEST_SUITE_NAME, fd_tee) {
+    const size_t total = 8 << 20;
+
+    char path[] = "/tmp/test_redirect_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    unlink(path);
+
+    int tap[2];
+    ASSERT_EQ(pipe(tap), 0);
+
+    // 第二个消费者在独立线程中读取管道
+    std::string tapped;
+    std::thread reader([&] {
+        char buf[65536];
+        ssize_t n;
+        while ((n = read(tap[0], buf, sizeof(buf))) > 0) {
+            tapped.append(buf, (size_t)n);
+        }
+    });
+
+    // `tap_fd` 必须为管道
+    ASSERT_EQ(fd_tee_begin(STDOUT_FILENO, fd, fd), nullptr);
+
+    fflush(stdout);
+    void* h = fd_tee_begin(STDOUT_FILENO, fd, tap[1]);
+    ASSERT_NE(h, nullptr);
+
+    bool ok = __write_pattern(STDOUT_FILENO, total);
+
+    fd_splice_stats stats;
+    ASSERT_EQ(fd_redirect_to_file_end(h, &stats), 0);
+    close(tap[1]);
+    reader.join();
+    close(tap[0]);
+
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(stats.bytes, total);
+
+    std::string expect = __pattern(total);
+    ASSERT_TRUE(__read_file(fd) == expect);
+    ASSERT_TRUE(tapped == expect);
+    close(fd);
+}
+
+/// @brief 测试第二个消费者中途关闭管道后, 停止复制, 其余数据仍完整转发到文件
+TEST(TEST_SUITE_NAME, fd_tee_tap_closed) {
+    const size_t total = 8 << 20;
+
+    char path[] = "/tmp/test_redirect_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    unlink(path);
+
+    int tap[2];
+    ASSERT_EQ(pipe(tap), 0);
+
+    // 第二个消费者只读取一部分数据后关闭读端, 之后转发线程的 `tee` 返回 `EPIPE`
+    std::thread reader([&] {
+        char buf[65536];
+        ASSERT_GT(read(tap[0], buf, sizeof(buf)), 0);
+        close(tap[0]);
+    });
+
+    fflush(stdout);
+    void* h = fd_tee_begin(STDOUT_FILENO, fd, tap[1]);
+    ASSERT_NE(h, nullptr);
+
+    bool ok = __write_pattern(STDOUT_FILENO, total);
+
+    fd_splice_stats stats;
+    ASSERT_EQ(fd_redirect_to_file_end(h, &stats), 0);
+    reader.join();
+    close(tap[1]);
+
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(stats.bytes, total);
+    ASSERT_TRUE(__read_file(fd) == __pattern(total));
+    close(fd);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "io.h"
+}
+
+#define TEST_SUITE_NAME test_linux_io__uring
+
+/// @brief 块大小
+static const uint32_t BLOCK = 4096;
+
+/// @brief 块数
+static const uint32_t N_BLOCKS = 64;
+
+/// @brief 创建临时文件
+///
+/// @return 文件描述符, 文件在关闭后自动删除
+static int __temp_file() {
+    char path[] = "/tmp/test_uring_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        unlink(path);
+    }
+    return fd;
+}
+
+/// @brief 提交全部请求, 并等待全部请求完成
+///
+/// @param ring 队列指针
+/// @param reqs 请求数组
+/// @return 按 `user_data` 排列的各请求结果
+static std::vector<int32_t> __run_all(uring* ring, const std::vector<uring_req>& reqs) {
+    std::vector<int32_t> res(reqs.size(), 0);
+    std::vector<uring_completion> cs(reqs.size());
+
+    size_t next = 0, done = 0;
+    while (done < reqs.size()) {
+        size_t submitted = 0;
+        EXPECT_EQ(uring_submit(ring, reqs.data() + next, reqs.size() - next, &submitted), 0);
+        next += submitted;
+
+        size_t count = 0;
+        EXPECT_EQ(uring_poll(ring, cs.data(), cs.size(), 1, &count), 0);
+        for (size_t i = 0; i < count; i++) {
+            res[cs[i].user_data] = cs[i].res;
+        }
+        done += count;
+    }
+    return res;
+}
+
+/// @brief 测试两种实现方式下, 批量写入再批量读取文件
+///
+/// 写入请求使用普通缓冲区和文件句柄, 读取请求使用已注册的缓冲区和文件
+TEST(TEST_SUITE_NAME, read_write) {
+    for (uring_backend backend : { URING_KERNEL, URING_POOL }) {
+        int fd = __temp_file();
+        ASSERT_GE(fd, 0);
+
+        // 队列深度小于请求数, 需分多批提交
+        uring* ring = nullptr;
+        ASSERT_EQ(uring_create(&ring, 16, backend), 0);
+        if (backend == URING_POOL) {
+            ASSERT_EQ(uring_backend_of(ring), URING_POOL);
+        }
+
+        std::string data(BLOCK * N_BLOCKS, '\0');
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = (char)('a' + i % 26 + i / BLOCK % 3);
+        }
+
+        // 倒序写入各块
+        std::vector<uring_req> reqs;
+        for (uint32_t i = 0; i < N_BLOCKS; i++) {
+            uint32_t b = N_BLOCKS - 1 - i;
+            reqs.push_back(uring_req{ URING_OP_WRITE, fd, false, -1, &data[b * BLOCK], BLOCK, (uint64_t)b * BLOCK, i });
+        }
+        for (int32_t r : __run_all(ring, reqs)) {
+            ASSERT_EQ(r, (int32_t)BLOCK);
+        }
+        ASSERT_EQ(uring_inflight(ring), 0);
+
+        // 通过已注册的缓冲区和文件读取
+        std::string out(data.size(), '\0');
+        struct iovec iov = { &out[0], out.size() };
+        ASSERT_EQ(uring_register_buffers(ring, &iov, 1), 0);
+        ASSERT_EQ(uring_register_files(ring, &fd, 1), 0);
+
+        reqs.clear();
+        for (uint32_t i = 0; i < N_BLOCKS; i++) {
+            reqs.push_back(uring_req{ URING_OP_READ, 0, true, 0, &out[i * BLOCK], BLOCK, (uint64_t)i * BLOCK, i });
+        }
+        for (int32_t r : __run_all(ring, reqs)) {
+            ASSERT_EQ(r, (int32_t)BLOCK);
+        }
+        ASSERT_TRUE(out == data);
+
+        uring_destroy(ring);
+        close(fd);
+    }
+}
+
+/// @brief 测试请求失败和读到文件末尾时的结果
+TEST(TEST_SUITE_NAME, errors) {
+    for (uring_backend backend : { URING_KERNEL, URING_POOL }) {
+        int fd = __temp_file();
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(write(fd, "Hello", 5), 5);
+
+        uring* ring = nullptr;
+        ASSERT_EQ(uring_create(&ring, 4, backend), 0);
+
+        char buf[16];
+        std::vector<uring_req> reqs = {
+            { URING_OP_READ, fd, false, -1, buf, sizeof(buf), 0, 0 },   // 只能读到 `5` 字节
+            { URING_OP_READ, fd, false, -1, buf, sizeof(buf), 100, 1 }, // 超过文件末尾
+            { URING_OP_READ, -1, false, -1, buf, sizeof(buf), 0, 2 },   // 无效的文件句柄
+        };
+
+        std::vector<int32_t> res = __run_all(ring, reqs);
+        ASSERT_EQ(res[0], 5);
+        ASSERT_EQ(res[1], 0);
+        ASSERT_EQ(res[2], -EBADF);
+
+        // 超过队列深度的请求不会被提交
+        std::vector<uring_req> many(8, reqs[0]);
+        size_t submitted = 0;
+        ASSERT_EQ(uring_submit(ring, many.data(), many.size(), &submitted), 0);
+        ASSERT_EQ(submitted, 4);
+        ASSERT_EQ(uring_inflight(ring), 4);
+
+        // 销毁队列时等待未完成的请求
+        uring_destroy(ring);
+        close(fd);
+    }
+}
+
+/// @brief 测试内核在一批请求中途停止读取提交队列 (前一个请求初始化失败) 时, 其余请求仍被提交, 且计数和完成结果一致
+TEST(TEST_SUITE_NAME, kernel_partial_submit) {
+    int fd = __temp_file();
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, "Hello", 5), 5);
+
+    uring* ring = nullptr;
+    ASSERT_EQ(uring_create(&ring, 4, URING_KERNEL), 0);
+    if (uring_backend_of(ring) != URING_KERNEL) {
+        uring_destroy(ring);
+        close(fd);
+        GTEST_SKIP() << "io_uring is not available";
+    }
+
+    char buf[3][16];
+    std::vector<uring_req> reqs = {
+        { URING_OP_READ, fd, false, -1, buf[0], sizeof(buf[0]), 0, 0 },
+        { URING_OP_READ, fd, false, 0, buf[1], sizeof(buf[1]), 0, 1 }, // 未注册缓冲区, 初始化失败
+        { URING_OP_READ, fd, false, -1, buf[2], sizeof(buf[2]), 0, 2 },
+    };
+
+    size_t submitted = 0;
+    ASSERT_EQ(uring_submit(ring, reqs.data(), reqs.size(), &submitted), 0);
+    ASSERT_EQ(submitted, 3);
+    ASSERT_EQ(uring_inflight(ring), 3);
+
+    // 每个已提交的请求恰好产生一个完成结果
+    uring_completion cs[4];
+    size_t got = 0;
+    while (got < 3) {
+        size_t count = 0;
+        ASSERT_EQ(uring_poll(ring, cs + got, 4 - got, 1, &count), 0);
+        got += count;
+    }
+    ASSERT_EQ(uring_inflight(ring), 0);
+
+    int32_t res[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < got; i++) {
+        res[cs[i].user_data] = cs[i].res;
+    }
+    ASSERT_EQ(res[0], 5);
+    ASSERT_LT(res[1], 0);
+    ASSERT_EQ(res[2], 5);
+
+    uring_destroy(ring);
+    close(fd);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <string>
+#include <vector>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "perf.h"
+}
+
+#define TEST_SUITE_NAME test_linux_perf__counter
+
+/// @brief 测试通过性能计数器统计一段代码的执行
+///
+/// 环境中不允许使用 `perf_event_open` 时 (例如 seccomp 限制) 跳过该测试
+TEST(TEST_SUITE_NAME, scope) {
+    perf_counters pc;
+    int rc = perf_counters_open(&pc, false);
+    if (rc != 0) {
+        GTEST_SKIP() << "perf_event_open unavailable: " << strerror(rc);
+    }
+
+    // 逐页写入新分配的内存, 每个页面产生一次缺页中断
+    const size_t size = 16 << 20;
+    perf_counters_start(&pc);
+
+    std::vector<char>* mem = new std::vector<char>(size, 1);
+    volatile uint64_t sum = 0;
+    for (size_t i = 0; i < size; i += 64) {
+        sum = sum + (*mem)[i];
+    }
+
+    perf_counters_stop(&pc);
+    delete mem;
+
+    ASSERT_EQ(sum, size / 64);
+
+    if (perf_counter_available(&pc, PERF_TASK_CLOCK)) {
+        ASSERT_GT(pc.values[PERF_TASK_CLOCK], 0);
+    }
+    if (perf_counter_available(&pc, PERF_PAGE_FAULTS)) {
+        ASSERT_GE(pc.values[PERF_PAGE_FAULTS], size / 4096 / 2);
+    }
+    if (perf_counter_available(&pc, PERF_INSTRUCTIONS)) {
+        ASSERT_GT(pc.values[PERF_INSTRUCTIONS], size / 64);
+    }
+
+    // 格式化结果, 确认包含可用计数器的名称
+    char buf[512];
+    int n = perf_counters_format(&pc, buf, sizeof(buf));
+    ASSERT_EQ((size_t)n, strlen(buf));
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        const char* name = perf_counter_name((perf_counter_id)i);
+        ASSERT_EQ(strstr(buf, name) != nullptr, perf_counter_available(&pc, (perf_counter_id)i)) << name;
+    }
+
+    // 缓冲区不足时, 返回值为完整输出所需的字符数
+    char small[8];
+    ASSERT_EQ(perf_counters_format(&pc, small, sizeof(small)), n);
+    ASSERT_EQ(strlen(small), sizeof(small) - 1);
+
+    // 停止计数后, 计数不再变化
+    uint64_t before = pc.values[PERF_TASK_CLOCK];
+    for (size_t i = 0; i < size; i += 64) {
+        sum = sum + 1;
+    }
+    ASSERT_EQ(pc.values[PERF_TASK_CLOCK], before);
+
+    perf_counters_close(&pc);
+}
+
+/// @brief 测试设置 `inherit` 后, 统计之后创建的子进程
+TEST(TEST_SUITE_NAME, inherit) {
+    perf_counters pc;
+    int rc = perf_counters_open(&pc, true);
+    if (rc != 0) {
+        GTEST_SKIP() << "perf_event_open unavailable: " << strerror(rc);
+    }
+    if (!perf_counter_available(&pc, PERF_TASK_CLOCK)) {
+        perf_counters_close(&pc);
+        GTEST_SKIP() << "task-clock unavailable";
+    }
+
+    perf_counters_start(&pc);
+
+    // 子进程占用约 50 毫秒的 CPU 时间
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t0);
+        do {
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t1);
+        } while ((t1.tv_sec - t0.tv_sec) * 1000000000L + (t1.tv_nsec - t0.tv_nsec) < 50000000L);
+        _exit(0);
+    }
+    waitpid(pid, nullptr, 0);
+
+    perf_counters_stop(&pc);
+
+    // 子进程退出时, 其计数累加到主进程的计数器中
+    ASSERT_GE(pc.values[PERF_TASK_CLOCK], 40000000u);
+
+    perf_counters_close(&pc);
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
 #include <sys/wait.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
 
 // 引入 C 语言头文件
 extern "C" {
@@ -308,6 +312,7 @@ TEST(TEST_SUITE_NAME, forked_execl) {
     r = forked_execl("/usr/bin/fake-sh", "-c", "echo -n \"Hello World\"", NULL);
     ASSERT_TRUE(WIFEXITED(r));
     EXPECT_EQ(WEXITSTATUS(r), (uint8_t)-1);
+    EXPECT_EQ(r, EXEC_FAILED_STATUS);
 
     fflush(stdout);
 
@@ -320,3 +325,132 @@ TEST(TEST_SUITE_NAME, forked_execl) {
 
     free((void*)res);
 }
+
+/// @brief 测试通过 `spawn_process` 函数以不同方式启动子进程
+///
+/// 可执行文件无法执行时, 两种方式都返回 `execv` 的错误值, 不产生子进程
+TEST(TEST_SUITE_NAME, spawn_process) {
+    const char* const argv[] = { "/usr/bin/sh", "-c", "exit 3", NULL };
+
+    for (spawn_backend backend : { SPAWN_FORK, SPAWN_POSIX, SPAWN_AUTO }) {
+        pid_t pid = -1;
+        ASSERT_EQ(spawn_process(backend, argv[0], (char* const*)argv, &pid), 0);
+        ASSERT_GT(pid, 0);
+
+        int stat = 0;
+        ASSERT_EQ(waitpid(pid, &stat, 0), pid);
+        ASSERT_TRUE(WIFEXITED(stat));
+        ASSERT_EQ(WEXITSTATUS(stat), 3);
+    }
+
+    // 可执行文件不存在, 两种方式都直接返回错误值, 不产生子进程
+    const char* const fake[] = { "/usr/bin/fake-sh", NULL };
+    for (spawn_backend backend : { SPAWN_FORK, SPAWN_POSIX }) {
+        pid_t pid = -1;
+        ASSERT_EQ(spawn_process(backend, fake[0], (char* const*)fake, &pid), ENOENT);
+        ASSERT_EQ(pid, -1);
+    }
+}
+
+/// @brief 测试通过 `forked_execv_batch` 函数同时执行多条命令
+TEST(TEST_SUITE_NAME, forked_execv_batch) {
+    const char* const ok[] = { "/usr/bin/sh", "-c", "sleep 0.2", NULL };
+    const char* const fail[] = { "/usr/bin/sh", "-c", "exit 7", NULL };
+    const char* const fake[] = { "/usr/bin/fake-sh", NULL };
+
+    const exec_cmd cmds[] = {
+        { ok[0], (char* const*)ok },
+        { fail[0], (char* const*)fail },
+        { fake[0], (char* const*)fake },
+        { ok[0], (char* const*)ok },
+    };
+    int stats[4] = { 0 };
+
+    // 无法执行的命令不影响其余命令, 返回值为其错误值
+    ASSERT_EQ(forked_execv_batch(cmds, 4, stats), ENOENT);
+
+    for (int i : { 0, 3 }) {
+        ASSERT_TRUE(WIFEXITED(stats[i]));
+        ASSERT_EQ(WEXITSTATUS(stats[i]), 0);
+    }
+    ASSERT_TRUE(WIFEXITED(stats[1]));
+    ASSERT_EQ(WEXITSTATUS(stats[1]), 7);
+
+    // 无法执行的命令, 状态值和 `forked_execl` 相同
+    ASSERT_EQ(stats[2], EXEC_FAILED_STATUS);
+}
+
+/// @brief 测试通过 `exec_capture` 函数执行命令, 并分别获取标准输出和标准错误
+TEST(TEST_SUITE_NAME, exec_capture) {
+    const char* const argv[] = { "/usr/bin/sh", "-c", "echo -n Hello; echo -n World >&2; exit 5", NULL };
+
+    exec_output res;
+    ASSERT_EQ(exec_capture(argv[0], (char* const*)argv, -1, &res), 0);
+
+    ASSERT_STREQ(res.out, "Hello");
+    ASSERT_EQ(res.out_len, 5);
+    ASSERT_STREQ(res.err, "World");
+    ASSERT_EQ(res.err_len, 5);
+
+    ASSERT_FALSE(res.timed_out);
+    ASSERT_TRUE(WIFEXITED(res.status));
+    ASSERT_EQ(WEXITSTATUS(res.status), 5);
+
+    exec_output_free(&res);
+
+    // 没有任何输出时, 结果为空字符串
+    const char* const quiet[] = { "/usr/bin/true", NULL };
+    ASSERT_EQ(exec_capture(quiet[0], (char* const*)quiet, -1, &res), 0);
+    ASSERT_STREQ(res.out, "");
+    ASSERT_STREQ(res.err, "");
+    exec_output_free(&res);
+}
+
+/// @brief 测试子进程在标准输出和标准错误上交替输出大量内容时不会阻塞
+///
+/// 每次输出都远大于管道容量, 若主进程只读取其中一个管道, 子进程将阻塞在另一个管道上
+TEST(TEST_SUITE_NAME, exec_capture_large) {
+    const char* const argv[] = {
+        "/usr/bin/sh", "-c",
+        "for i in 1 2 3 4; do head -c 4194304 /dev/zero; head -c 4194304 /dev/zero >&2; done",
+        NULL,
+    };
+
+    exec_output res;
+    ASSERT_EQ(exec_capture(argv[0], (char* const*)argv, 30000, &res), 0);
+
+    ASSERT_EQ(res.out_len, (size_t)16 << 20);
+    ASSERT_EQ(res.err_len, (size_t)16 << 20);
+    ASSERT_TRUE(WIFEXITED(res.status));
+    ASSERT_EQ(WEXITSTATUS(res.status), 0);
+
+    exec_output_free(&res);
+}
+
+/// @brief 测试 `exec_capture` 函数超时后结束子进程, 并保留超时前的输出
+TEST(TEST_SUITE_NAME, exec_capture_timeout) {
+    const char* const argv[] = { "/usr/bin/sh", "-c", "echo -n started; exec sleep 10", NULL };
+
+    exec_output res;
+    ASSERT_EQ(exec_capture(argv[0], (char* const*)argv, 200, &res), ETIMEDOUT);
+
+    ASSERT_TRUE(res.timed_out);
+    ASSERT_STREQ(res.out, "started");
+    ASSERT_TRUE(WIFSIGNALED(res.status));
+    ASSERT_EQ(WTERMSIG(res.status), SIGKILL);
+
+    exec_output_free(&res);
+}
+
+/// @brief 测试 `exec_capture` 函数执行不存在的可执行文件
+TEST(TEST_SUITE_NAME, exec_capture_missing) {
+    const char* const argv[] = { "/usr/bin/fake-sh", NULL };
+
+    exec_output res;
+    int rc = exec_capture(argv[0], (char* const*)argv, -1, &res);
+
+    // 两种创建子进程的方式都直接返回 `execv` 的错误值
+    ASSERT_EQ(rc, ENOENT);
+
+    exec_output_free(&res);
+}
@@ -0,0 +1,346 @@
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define TEST_SUITE_NAME test_linux_process__mutex
+
+/// @brief 测试使用的共享数据, 放置在共享内存中
+struct shared_state {
+    shm_mutex mutex;
+    shm_cond cond;
+    shm_barrier barrier;
+    uint64_t counter;
+    int ready;
+    int value;
+    int slots[8];
+    int serial;
+};
+
+/// @brief 创建共享内存段, 并返回其中的 `shared_state` 实例
+static shared_state* __create_state(shm_segment* seg) {
+    if (shm_segment_create(seg, sizeof(shared_state)) != 0) {
+        return nullptr;
+    }
+    return (shared_state*)seg->addr;
+}
+
+/// @brief 等待全部子进程正常结束
+static void __wait_all(const std::vector<pid_t>& pids) {
+    for (pid_t pid : pids) {
+        int stat;
+        ASSERT_EQ(waitpid(pid, &stat, 0), pid);
+        ASSERT_TRUE(WIFEXITED(stat));
+        ASSERT_EQ(WEXITSTATUS(stat), 0);
+    }
+}
+
+/// @brief 测试多个进程通过互斥锁保护同一计数器
+TEST(TEST_SUITE_NAME, mutex_counter) {
+    shm_segment seg;
+    shared_state* s = __create_state(&seg);
+    ASSERT_NE(s, nullptr);
+
+    const int n_procs = 4;
+    const int n_loops = 20000;
+
+    std::vector<pid_t> pids;
+    for (int i = 0; i < n_procs; i++) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            for (int k = 0; k < n_loops; k++) {
+                if (shm_mutex_lock(&s->mutex) != 0) {
+                    _exit(1);
+                }
+                s->counter++;
+                shm_mutex_unlock(&s->mutex);
+            }
+            _exit(0);
+        }
+        pids.push_back(pid);
+    }
+
+    __wait_all(pids);
+    ASSERT_EQ(s->counter, (uint64_t)n_procs * n_loops);
+
+    // 非持有者不能解锁
+    ASSERT_EQ(shm_mutex_unlock(&s->mutex), EPERM);
+
+    ASSERT_EQ(shm_mutex_trylock(&s->mutex), 0);
+    ASSERT_EQ(shm_mutex_unlock(&s->mutex), 0);
+
+    shm_segment_free(&seg);
+}
+
+/// @brief 测试子进程通过条件变量等待父进程的通知
+TEST(TEST_SUITE_NAME, cond_wait) {
+    shm_segment seg;
+    shared_state* s = __create_state(&seg);
+    ASSERT_NE(s, nullptr);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        shm_mutex_lock(&s->mutex);
+        while (!s->ready) {
+            shm_cond_wait(&s->cond, &s->mutex);
+        }
+        s->value *= 2;
+        s->ready = 0;
+        shm_cond_signal(&s->cond);
+        shm_mutex_unlock(&s->mutex);
+        _exit(0);
+    }
+
+    // 等待一段时间, 令子进程进入等待状态
+    usleep(20 * 1000);
+
+    shm_mutex_lock(&s->mutex);
+    s->value = 21;
+    s->ready = 1;
+    shm_cond_signal(&s->cond);
+    while (s->ready) {
+        ASSERT_EQ(shm_cond_wait(&s->cond, &s->mutex), 0);
+    }
+    ASSERT_EQ(s->value, 42);
+    shm_mutex_unlock(&s->mutex);
+
+    __wait_all({ pid });
+    shm_segment_free(&seg);
+}
+
+/// @brief 测试多个进程多轮通过屏障同步
+TEST(TEST_SUITE_NAME, barrier) {
+    shm_segment seg;
+    shared_state* s = __create_state(&seg);
+    ASSERT_NE(s, nullptr);
+
+    const int n_procs = 4;
+    const int n_rounds = 50;
+
+    // 父进程也参与同步
+    shm_barrier_init(&s->barrier, n_procs + 1);
+
+    std::vector<pid_t> pids;
+    for (int i = 0; i < n_procs; i++) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            for (int r = 1; r <= n_rounds; r++) {
+                s->slots[i] = r;
+                if (shm_barrier_wait(&s->barrier)) {
+                    __atomic_add_fetch(&s->serial, 1, __ATOMIC_RELAXED);
+                }
+                // 第二个屏障保证父进程检查完毕后才进入下一轮
+                shm_barrier_wait(&s->barrier);
+            }
+            _exit(0);
+        }
+        pids.push_back(pid);
+    }
+
+    int serial = 0;
+    for (int r = 1; r <= n_rounds; r++) {
+        serial += shm_barrier_wait(&s->barrier);
+
+        // 通过第一个屏障后, 全部参与者都已写入本轮的值
+        for (int i = 0; i < n_procs; i++) {
+            ASSERT_EQ(s->slots[i], r);
+        }
+        shm_barrier_wait(&s->barrier);
+    }
+
+    __wait_all(pids);
+
+    // 每轮第一个屏障恰有一个参与者返回 `1`
+    ASSERT_EQ(serial + s->serial, n_rounds);
+    shm_segment_free(&seg);
+}
+
+/// @brief 子进程加锁后不解锁直接退出, 模拟持有者崩溃
+static pid_t __lock_and_die(shared_state* s) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        shm_mutex_lock(&s->mutex);
+        s->counter = 12345;
+        _exit(0);
+    }
+    return pid;
+}
+
+/// @brief 测试持有者退出后, 等待者接管锁并恢复
+TEST(TEST_SUITE_NAME, owner_dead) {
+    shm_segment seg;
+    shared_state* s = __create_state(&seg);
+    ASSERT_NE(s, nullptr);
+
+    pid_t pid = __lock_and_die(s);
+    ASSERT_GT(pid, 0);
+
+    // 等待子进程退出, 但不回收, 僵尸进程同样视为已退出
+    while (__atomic_load_n(&s->counter, __ATOMIC_ACQUIRE) != 12345) {
+        usleep(1000);
+    }
+    usleep(20 * 1000);
+
+    ASSERT_EQ(shm_mutex_lock(&s->mutex), EOWNERDEAD);
+    ASSERT_EQ(shm_mutex_consistent(&s->mutex), 0);
+    ASSERT_EQ(shm_mutex_unlock(&s->mutex), 0);
+
+    // 恢复后锁可正常使用
+    ASSERT_EQ(shm_mutex_lock(&s->mutex), 0);
+    ASSERT_EQ(shm_mutex_consistent(&s->mutex), EINVAL);
+    ASSERT_EQ(shm_mutex_unlock(&s->mutex), 0);
+
+    __wait_all({ pid });
+    shm_segment_free(&seg);
+}
+
+/// @brief 测试接管锁后未恢复就解锁, 锁变为不可恢复
+TEST(TEST_SUITE_NAME, not_recoverable) {
+    shm_segment seg;
+    shared_state* s = __create_state(&seg);
+    ASSERT_NE(s, nullptr);
+
+    pid_t pid = __lock_and_die(s);
+    ASSERT_GT(pid, 0);
+    __wait_all({ pid });
+
+    ASSERT_EQ(shm_mutex_lock(&s->mutex), EOWNERDEAD);
+    ASSERT_EQ(shm_mutex_unlock(&s->mutex), 0);
+
+    ASSERT_EQ(shm_mutex_lock(&s->mutex), ENOTRECOVERABLE);
+    ASSERT_EQ(shm_mutex_trylock(&s->mutex), ENOTRECOVERABLE);
+
+    shm_segment_free(&seg);
+}
+
+/// @brief 测试持有者退出后, `shm_mutex_trylock` 接管锁并返回 `EOWNERDEAD`
+TEST(TEST_SUITE_NAME, trylock_owner_dead) {
+    shm_segment seg;
+    shared_state* s = __create_state(&seg);
+    ASSERT_NE(s, nullptr);
+
+    pid_t pid = __lock_and_die(s);
+    ASSERT_GT(pid, 0);
+    __wait_all({ pid });
+
+    ASSERT_EQ(shm_mutex_trylock(&s->mutex), EOWNERDEAD);
+    ASSERT_EQ(shm_mutex_trylock(&s->mutex), EBUSY);
+    ASSERT_EQ(shm_mutex_consistent(&s->mutex), 0);
+    ASSERT_EQ(shm_mutex_unlock(&s->mutex), 0);
+
+    ASSERT_EQ(shm_mutex_trylock(&s->mutex), 0);
+    ASSERT_EQ(shm_mutex_unlock(&s->mutex), 0);
+
+    shm_segment_free(&seg);
+}
+
+/// @brief 测试持有者被杀死时, 内核唤醒正在休眠的等待者
+TEST(TEST_SUITE_NAME, owner_killed_wakes_waiter) {
+    shm_segment seg;
+    shared_state* s = __create_state(&seg);
+    ASSERT_NE(s, nullptr);
+
+    fflush(stdout);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        shm_mutex_lock(&s->mutex);
+        __atomic_store_n(&s->ready, 1, __ATOMIC_RELEASE);
+        for (;;) {
+            pause();
+        }
+    }
+
+    while (!__atomic_load_n(&s->ready, __ATOMIC_ACQUIRE)) {
+        usleep(1000);
+    }
+
+    // 等待者在另一个线程中休眠, 持有者被杀死后由内核唤醒
+    int rc = -1;
+    std::thread waiter([&] {
+        rc = shm_mutex_lock(&s->mutex);
+        if (rc == EOWNERDEAD) {
+            shm_mutex_consistent(&s->mutex);
+        }
+        shm_mutex_unlock(&s->mutex);
+    });
+    usleep(20 * 1000);
+
+    kill(pid, SIGKILL);
+    waiter.join();
+    ASSERT_EQ(rc, EOWNERDEAD);
+
+    int stat;
+    ASSERT_EQ(waitpid(pid, &stat, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(stat));
+
+    ASSERT_EQ(shm_mutex_lock(&s->mutex), 0);
+    ASSERT_EQ(shm_mutex_unlock(&s->mutex), 0);
+    shm_segment_free(&seg);
+}
+
+/// @brief 测试同一进程中的线程持有锁退出, 以及线程持有多把锁时按任意顺序解锁
+TEST(TEST_SUITE_NAME, thread_exit) {
+    static shm_mutex m[3] = { SHM_MUTEX_INIT, SHM_MUTEX_INIT, SHM_MUTEX_INIT };
+
+    std::thread([] {
+        for (auto& x : m) {
+            shm_mutex_lock(&x);
+        }
+        // 解锁中间的锁后退出, 其余两把锁仍在线程的 robust 链表中
+        shm_mutex_unlock(&m[1]);
+    }).join();
+
+    ASSERT_EQ(shm_mutex_lock(&m[0]), EOWNERDEAD);
+    ASSERT_EQ(shm_mutex_lock(&m[1]), 0);
+    ASSERT_EQ(shm_mutex_lock(&m[2]), EOWNERDEAD);
+    for (auto& x : m) {
+        shm_mutex_consistent(&x);
+        ASSERT_EQ(shm_mutex_unlock(&x), 0);
+    }
+}
+
+/// @brief 测试线程使用过本锁后, 其持有的 `PTHREAD_MUTEX_ROBUST` 互斥锁在线程退出时仍会被内核标记
+TEST(TEST_SUITE_NAME, pthread_robust_after_use) {
+    static shm_mutex m = SHM_MUTEX_INIT;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+
+    pthread_mutex_t pm;
+    ASSERT_EQ(pthread_mutex_init(&pm, &attr), 0);
+    pthread_mutexattr_destroy(&attr);
+
+    std::thread([&] {
+        shm_mutex_lock(&m);
+        shm_mutex_unlock(&m);
+        ASSERT_EQ(shm_mutex_trylock(&m), 0);
+        shm_mutex_unlock(&m);
+
+        pthread_mutex_lock(&pm);
+    }).join();
+
+    // 若 glibc 的 robust 链表未恢复, 锁仍被已退出的线程持有, 此处返回 `EBUSY`
+    ASSERT_EQ(pthread_mutex_trylock(&pm), EOWNERDEAD);
+    ASSERT_EQ(pthread_mutex_consistent(&pm), 0);
+    ASSERT_EQ(pthread_mutex_unlock(&pm), 0);
+    pthread_mutex_destroy(&pm);
+
+    ASSERT_EQ(shm_mutex_lock(&m), 0);
+    ASSERT_EQ(shm_mutex_unlock(&m), 0);
+}
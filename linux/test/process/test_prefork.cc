@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define TEST_SUITE_NAME test_linux_process__prefork
+
+/// @brief 工作进程的请求处理函数
+///
+/// - 请求内容为 `pid` 时, 以工作进程 ID 作为状态值返回;
+/// - 请求内容为 `exit` 时, 直接结束工作进程, 模拟工作进程崩溃;
+/// - 其它请求按原样返回, 状态值为请求长度;
+static int __echo(const char* req, size_t len, frame_buf* resp, void* ctx) {
+    std::string s(req, len);
+    if (s == "pid") {
+        return getpid();
+    }
+    if (s == "exit") {
+        _exit(1);
+    }
+
+    // 在响应前加上 `ctx` 指向的前缀, 以验证上下文指针被传递到工作进程中
+    const char* prefix = (const char*)ctx;
+    if (frame_buf_append(resp, prefix, strlen(prefix)) != 0 || frame_buf_append(resp, req, len) != 0) {
+        return -1;
+    }
+    return (int)len;
+}
+
+/// @brief 测试不同长度的请求和响应, 包括空请求和超过 socket 缓冲区大小的请求
+TEST(TEST_SUITE_NAME, call) {
+    prefork_pool* pool = NULL;
+    ASSERT_EQ(prefork_create(&pool, 2, __echo, (void*)"> "), 0);
+    ASSERT_EQ(prefork_size(pool), 2);
+
+    frame_buf resp = {};
+
+    for (size_t len : { 0, 1, 100, 4096, 1 << 20 }) {
+        std::string req(len, 'a' + len % 26);
+
+        int status = -1;
+        ASSERT_EQ(prefork_call(pool, req.data(), req.size(), &resp, &status), 0);
+        ASSERT_EQ(status, (int)len);
+        ASSERT_EQ(std::string(resp.data, resp.len), "> " + req);
+    }
+
+    frame_buf_free(&resp);
+    prefork_destroy(pool);
+}
+
+/// @brief 测试工作进程在多次调用之间被重复使用, 而不是每次调用都创建新进程
+TEST(TEST_SUITE_NAME, reuse_workers) {
+    prefork_pool* pool = NULL;
+    ASSERT_EQ(prefork_create(&pool, 3, __echo, (void*)""), 0);
+
+    frame_buf resp = {};
+
+    for (int i = 0; i < 100; i++) {
+        int status = -1;
+        ASSERT_EQ(prefork_call(pool, "pid", 3, &resp, &status), 0);
+
+        // 串行调用时总是选中最近归还的工作进程, 即第 `0` 个工作进程
+        ASSERT_EQ(status, prefork_pid(pool, 0));
+        ASSERT_NE(status, getpid());
+    }
+
+    frame_buf_free(&resp);
+    prefork_destroy(pool);
+}
+
+/// @brief 测试批量调用, 请求数多于工作进程数
+TEST(TEST_SUITE_NAME, batch) {
+    prefork_pool* pool = NULL;
+    ASSERT_EQ(prefork_create(&pool, 4, __echo, (void*)"# "), 0);
+
+    const size_t n = 100;
+
+    std::vector<std::string> data(n);
+    std::vector<prefork_req> reqs(n);
+    std::vector<frame_buf> resps(n, frame_buf{});
+    std::vector<int> statuses(n);
+
+    for (size_t i = 0; i < n; i++) {
+        data[i] = std::to_string(i * i);
+        reqs[i] = { data[i].data(), data[i].size() };
+    }
+
+    ASSERT_EQ(prefork_batch(pool, reqs.data(), n, resps.data(), statuses.data()), 0);
+
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(statuses[i], (int)data[i].size());
+        ASSERT_EQ(std::string(resps[i].data, resps[i].len), "# " + data[i]);
+        frame_buf_free(&resps[i]);
+    }
+
+    prefork_destroy(pool);
+}
+
+/// @brief 测试工作进程在处理请求期间退出时返回 `EPIPE`, 且该工作进程在下次被选中时重新创建
+TEST(TEST_SUITE_NAME, respawn) {
+    prefork_pool* pool = NULL;
+    ASSERT_EQ(prefork_create(&pool, 1, __echo, (void*)""), 0);
+
+    pid_t old = prefork_pid(pool, 0);
+
+    frame_buf resp = {};
+    int status = -1;
+
+    ASSERT_EQ(prefork_call(pool, "exit", 4, &resp, &status), EPIPE);
+
+    ASSERT_EQ(prefork_call(pool, "pid", 3, &resp, &status), 0);
+    ASSERT_EQ(status, prefork_pid(pool, 0));
+    ASSERT_NE(status, old);
+
+    ASSERT_EQ(prefork_call(pool, "ok", 2, &resp, &status), 0);
+    ASSERT_EQ(std::string(resp.data, resp.len), "ok");
+
+    frame_buf_free(&resp);
+    prefork_destroy(pool);
+}
+
+/// @brief 测试多个线程同时调用, 线程数多于工作进程数
+TEST(TEST_SUITE_NAME, concurrent_calls) {
+    prefork_pool* pool = NULL;
+    ASSERT_EQ(prefork_create(&pool, 2, __echo, (void*)""), 0);
+
+    const int n_threads = 6;
+    const int n_calls = 200;
+
+    std::vector<int> failed(n_threads, 0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t] {
+            frame_buf resp = {};
+            for (int i = 0; i < n_calls; i++) {
+                std::string req = std::to_string(t) + ":" + std::to_string(i);
+                int status = -1;
+                if (prefork_call(pool, req.data(), req.size(), &resp, &status) != 0
+                    || std::string(resp.data, resp.len) != req) {
+                    failed[t]++;
+                }
+            }
+            frame_buf_free(&resp);
+        });
+    }
+
+    for (auto& th : threads) {
+        th.join();
+    }
+    for (int t = 0; t < n_threads; t++) {
+        ASSERT_EQ(failed[t], 0);
+    }
+
+    prefork_destroy(pool);
+}
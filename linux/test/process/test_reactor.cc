@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define TEST_SUITE_NAME test_linux_process__reactor
+
+using clock_type = std::chrono::steady_clock;
+
+/// @brief 子进程的收集结果
+struct child_result {
+    pid_t pid = 0;            // 子进程 ID
+    std::string data;         // 收到的全部数据
+    int stat = -1;            // 子进程状态值
+    bool done = false;        // 是否已完成
+    clock_type::time_point t; // 完成时间
+};
+
+static void __on_data(pid_t pid, const char* data, size_t len, void* ctx) {
+    child_result* r = (child_result*)ctx;
+    r->pid = pid;
+    r->data.append(data, len);
+}
+
+static void __on_exit(pid_t pid, int stat, void* ctx) {
+    child_result* r = (child_result*)ctx;
+    r->pid = pid;
+    r->stat = stat;
+    r->done = true;
+    r->t = clock_type::now();
+}
+
+/// @brief 子进程入口函数, 发送自身的进程 ID, 并以进程 ID 的低 7 位作为退出状态值
+static int __send_pid(int pwfd) {
+    std::string s = std::to_string(getpid());
+    if (write(pwfd, s.data(), s.size()) != (ssize_t)s.size()) {
+        return 255;
+    }
+    return getpid() & 0x7f;
+}
+
+/// @brief 子进程入口函数, 发送较多数据, 超过管道缓冲区大小
+static int __send_large(int pwfd) {
+    std::string s(256 * 1024, 'z');
+    for (size_t off = 0; off < s.size();) {
+        ssize_t n = write(pwfd, s.data() + off, s.size() - off);
+        if (n <= 0) {
+            return 1;
+        }
+        off += (size_t)n;
+    }
+    return 0;
+}
+
+/// @brief 子进程入口函数, 先休眠再发送数据, 模拟运行较慢的子进程
+static int __slow(int pwfd) {
+    usleep(800 * 1000);
+    return __send_pid(pwfd);
+}
+
+/// @brief 测试收集多个子进程的数据, 并在子进程结束后得到其状态值
+TEST(TEST_SUITE_NAME, collect) {
+    reactor* r = NULL;
+    ASSERT_EQ(reactor_create(&r), 0);
+
+    const size_t n = 32;
+    std::vector<child_result> results(n + 1);
+    std::vector<pid_t> pids(n + 1);
+
+    for (size_t i = 0; i < n; i++) {
+        child_handler h = { __on_data, __on_exit, &results[i] };
+        ASSERT_EQ(reactor_spawn(r, __send_pid, -1, &h, &pids[i]), 0);
+    }
+
+    child_handler h = { __on_data, __on_exit, &results[n] };
+    ASSERT_EQ(reactor_spawn(r, __send_large, -1, &h, &pids[n]), 0);
+    ASSERT_EQ(reactor_pending(r), n + 1);
+
+    ASSERT_EQ(reactor_run(r, -1), 0);
+    ASSERT_EQ(reactor_pending(r), 0);
+
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_TRUE(results[i].done);
+        ASSERT_EQ(results[i].pid, pids[i]);
+        ASSERT_EQ(results[i].data, std::to_string(pids[i]));
+        ASSERT_TRUE(WIFEXITED(results[i].stat));
+        ASSERT_EQ(WEXITSTATUS(results[i].stat), pids[i] & 0x7f);
+    }
+    ASSERT_EQ(results[n].data, std::string(256 * 1024, 'z'));
+
+    reactor_destroy(r);
+}
+
+/// @brief 测试运行时间差异较大的子进程: 较快的子进程应在较慢的子进程结束之前完成, 不被其阻塞
+TEST(TEST_SUITE_NAME, skewed_latency) {
+    reactor* r = NULL;
+    ASSERT_EQ(reactor_create(&r), 0);
+
+    const size_t n = 8;
+    std::vector<child_result> results(n);
+
+    auto start = clock_type::now();
+
+    // 第 `0` 个子进程较慢, 且最先创建
+    for (size_t i = 0; i < n; i++) {
+        child_handler h = { __on_data, __on_exit, &results[i] };
+        ASSERT_EQ(reactor_spawn(r, i == 0 ? __slow : __send_pid, -1, &h, NULL), 0);
+    }
+
+    // 超时前, 除较慢的子进程外均已完成
+    ASSERT_EQ(reactor_run(r, 400), ETIMEDOUT);
+    ASSERT_EQ(reactor_pending(r), 1);
+    ASSERT_FALSE(results[0].done);
+
+    for (size_t i = 1; i < n; i++) {
+        ASSERT_TRUE(results[i].done);
+        ASSERT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(results[i].t - start).count(), 400);
+    }
+
+    ASSERT_EQ(reactor_run(r, -1), 0);
+    ASSERT_TRUE(results[0].done);
+    ASSERT_EQ(results[0].data, std::to_string(results[0].pid));
+
+    for (size_t i = 1; i < n; i++) {
+        ASSERT_LT(results[i].t, results[0].t);
+    }
+
+    reactor_destroy(r);
+}
+
+/// @brief 在 `on_exit` 回调函数中创建子进程的上下文
+struct chain_ctx {
+    reactor* r;     // 事件循环指针
+    int remaining;  // 还需创建的子进程数
+    int completed;  // 已完成的子进程数
+};
+
+static void __chain_exit(pid_t, int, void* ctx) {
+    chain_ctx* c = (chain_ctx*)ctx;
+    c->completed++;
+    if (c->remaining > 0) {
+        c->remaining--;
+        child_handler h = { NULL, __chain_exit, c };
+        reactor_spawn(c->r, __send_pid, -1, &h, NULL);
+    }
+}
+
+/// @brief 测试在回调函数中创建新的子进程, 事件循环应持续运行直到新子进程也完成
+TEST(TEST_SUITE_NAME, spawn_in_callback) {
+    chain_ctx c = { NULL, 20, 0 };
+    ASSERT_EQ(reactor_create(&c.r), 0);
+
+    child_handler h = { NULL, __chain_exit, &c };
+    ASSERT_EQ(reactor_spawn(c.r, __send_pid, -1, &h, NULL), 0);
+
+    ASSERT_EQ(reactor_run(c.r, -1), 0);
+    ASSERT_EQ(c.completed, 21);
+
+    reactor_destroy(c.r);
+}
+
+/// @brief 测试销毁事件循环时结束尚未完成的子进程
+TEST(TEST_SUITE_NAME, destroy_pending) {
+    reactor* r = NULL;
+    ASSERT_EQ(reactor_create(&r), 0);
+
+    child_result result;
+    child_handler h = { __on_data, __on_exit, &result };
+    pid_t pid;
+    ASSERT_EQ(reactor_spawn(r, __slow, -1, &h, &pid), 0);
+
+    reactor_destroy(r);
+
+    // 子进程已被回收, 且不再调用回调函数
+    ASSERT_EQ(waitpid(pid, NULL, WNOHANG), -1);
+    ASSERT_FALSE(result.done);
+}
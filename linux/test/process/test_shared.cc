@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "process.h"
+}
+
+#define TEST_SUITE_NAME test_linux_process__shared
+
+/// @brief 测试共享内存段在 `fork` 后由父子进程共享
+TEST(TEST_SUITE_NAME, shm_segment) {
+    shm_segment seg;
+    ASSERT_EQ(shm_segment_create(&seg, 1 << 20), 0);
+
+    int* data = (int*)seg.addr;
+    size_t n = seg.size / sizeof(int);
+    ASSERT_EQ(data[0], 0);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+
+    if (pid == 0) {
+        // 子进程写入的结果直接对父进程可见, 无需经过管道
+        for (size_t i = 0; i < n; i++) {
+            data[i] = (int)(i * 3);
+        }
+        _exit(0);
+    }
+
+    int stat;
+    ASSERT_EQ(waitpid(pid, &stat, 0), pid);
+    ASSERT_TRUE(WIFEXITED(stat));
+
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(data[i], (int)(i * 3));
+    }
+
+    shm_segment_free(&seg);
+}
+
+/// @brief 测试环形缓冲区在回绕位置预留的空间在地址上连续
+TEST(TEST_SUITE_NAME, shm_ring_wrap) {
+    shm_ring ring;
+    ASSERT_EQ(shm_ring_create(&ring, 1), 0);
+
+    size_t cap = ring.capacity;
+    ASSERT_GE(cap, 4096);
+    ASSERT_EQ(cap & (cap - 1), 0);
+    ASSERT_EQ(shm_ring_reserve(&ring, cap + 1), nullptr);
+
+    // 先写入并读取 `cap - 10` 字节, 令读写位置接近数据区末尾
+    shm_ring_commit(&ring, cap - 10);
+
+    size_t len = 0;
+    ASSERT_NE(shm_ring_peek(&ring, &len), nullptr);
+    ASSERT_EQ(len, cap - 10);
+    shm_ring_consume(&ring, len);
+
+    // 跨越末尾写入 `100` 字节, 通过同一指针连续写入, 读取时也应连续
+    char* p = (char*)shm_ring_reserve(&ring, 100);
+    ASSERT_NE(p, nullptr);
+    for (int i = 0; i < 100; i++) {
+        p[i] = (char)i;
+    }
+    shm_ring_commit(&ring, 100);
+
+    const char* q = (const char*)shm_ring_peek(&ring, &len);
+    ASSERT_EQ(len, 100);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(q[i], (char)i);
+    }
+    shm_ring_consume(&ring, len);
+
+    // 回绕部分实际位于数据区开头
+    ASSERT_EQ(ring.data[0], (char)10);
+
+    shm_ring_close(&ring);
+    ASSERT_EQ(shm_ring_peek(&ring, &len), nullptr);
+    ASSERT_EQ(len, 0);
+
+    shm_ring_free(&ring);
+}
+
+/// @brief 子进程通过环形缓冲区发送 `total` 字节, 第 `i` 个字节为 `i % 251`, 每次写入的长度不同
+static void __produce(shm_ring* ring, size_t total) {
+    size_t sent = 0;
+    for (size_t k = 1; sent < total; k++) {
+        size_t n = (k * 7919) % 20000 + 1;
+        if (n > total - sent) {
+            n = total - sent;
+        }
+        unsigned char* p = (unsigned char*)shm_ring_reserve(ring, n);
+        for (size_t i = 0; i < n; i++) {
+            p[i] = (unsigned char)((sent + i) % 251);
+        }
+        shm_ring_commit(ring, n);
+        sent += n;
+    }
+    shm_ring_close(ring);
+}
+
+/// @brief 读取环形缓冲区中的全部数据并校验, 返回读取的字节数, 校验失败时返回 `0`
+static size_t __consume(shm_ring* ring) {
+    size_t received = 0;
+    size_t len;
+    const unsigned char* p;
+
+    while ((p = (const unsigned char*)shm_ring_peek(ring, &len)) != nullptr) {
+        for (size_t i = 0; i < len; i++) {
+            if (p[i] != (unsigned char)((received + i) % 251)) {
+                return 0;
+            }
+        }
+        received += len;
+        shm_ring_consume(ring, len);
+    }
+    return received;
+}
+
+/// @brief 测试多个子进程各自通过独立的环形缓冲区向父进程发送大量数据, 数据量远大于缓冲区容量
+TEST(TEST_SUITE_NAME, shm_ring_per_worker) {
+    const size_t n_workers = 4;
+    const size_t total = 8 << 20;
+
+    std::vector<shm_ring> rings(n_workers);
+    std::vector<pid_t> pids(n_workers);
+
+    for (size_t i = 0; i < n_workers; i++) {
+        ASSERT_EQ(shm_ring_create(&rings[i], 64 * 1024), 0);
+    }
+
+    for (size_t i = 0; i < n_workers; i++) {
+        pids[i] = fork();
+        ASSERT_GE(pids[i], 0);
+        if (pids[i] == 0) {
+            __produce(&rings[i], total);
+            _exit(0);
+        }
+    }
+
+    // 依次读取各子进程的缓冲区, 其它子进程在缓冲区写满后等待
+    for (size_t i = 0; i < n_workers; i++) {
+        ASSERT_EQ(__consume(&rings[i]), total);
+
+        int stat;
+        ASSERT_EQ(waitpid(pids[i], &stat, 0), pids[i]);
+        ASSERT_TRUE(WIFEXITED(stat));
+        shm_ring_free(&rings[i]);
+    }
+}
+
+/// @brief 测试生产者被 `SIGKILL` 结束 (未调用 `shm_ring_close`) 后, 消费者通过带超时的等待发现并放弃
+TEST(TEST_SUITE_NAME, shm_ring_producer_killed) {
+    shm_ring ring;
+    ASSERT_EQ(shm_ring_create(&ring, 1), 0);
+
+    fflush(stdout);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // 写入一块数据后暂停, 模拟正在处理时被结束
+        void* p = shm_ring_reserve(&ring, 16);
+        memset(p, 'x', 16);
+        shm_ring_commit(&ring, 16);
+        for (;;) {
+            pause();
+        }
+    }
+
+    const void* data = nullptr;
+    size_t len = 0;
+    ASSERT_EQ(shm_ring_peek_timed(&ring, 5000, &data, &len), 0);
+    ASSERT_EQ(len, 16);
+    ASSERT_EQ(memcmp(data, "xxxxxxxxxxxxxxxx", 16), 0);
+    shm_ring_consume(&ring, len);
+
+    kill(pid, SIGKILL);
+    int stat;
+    ASSERT_EQ(waitpid(pid, &stat, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(stat));
+
+    // 生产者已退出且未关闭缓冲区, 不带超时的 `shm_ring_peek` 将永远等待
+    ASSERT_EQ(shm_ring_peek_timed(&ring, 50, &data, &len), ETIMEDOUT);
+    ASSERT_EQ(data, nullptr);
+    ASSERT_EQ(len, 0);
+
+    shm_ring_free(&ring);
+}
+
+/// @brief 测试缓冲区已满且没有消费者时, 生产者等待空间超时
+TEST(TEST_SUITE_NAME, shm_ring_reserve_timeout) {
+    shm_ring ring;
+    ASSERT_EQ(shm_ring_create(&ring, 1), 0);
+
+    void* p = nullptr;
+    ASSERT_EQ(shm_ring_reserve_timed(&ring, ring.capacity + 1, 0, &p), EINVAL);
+    ASSERT_EQ(shm_ring_reserve_timed(&ring, ring.capacity, 0, &p), 0);
+    ASSERT_NE(p, nullptr);
+    shm_ring_commit(&ring, ring.capacity);
+
+    ASSERT_EQ(shm_ring_reserve_timed(&ring, 1, 50, &p), ETIMEDOUT);
+    ASSERT_EQ(p, nullptr);
+
+    // 关闭后消费者读取完剩余数据, 之后得到结束标志
+    shm_ring_close(&ring);
+    const void* data = nullptr;
+    size_t len = 0;
+    ASSERT_EQ(shm_ring_peek_timed(&ring, 0, &data, &len), 0);
+    ASSERT_EQ(len, ring.capacity);
+    shm_ring_consume(&ring, len);
+    ASSERT_EQ(shm_ring_peek_timed(&ring, 0, &data, &len), 0);
+    ASSERT_EQ(data, nullptr);
+
+    shm_ring_free(&ring);
+}
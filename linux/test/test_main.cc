@@ -1,10 +1,63 @@
 #include <gtest/gtest.h>
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "perf.h"
+}
+
+/// @brief 为每个测试输出性能计数器的事件监听器
+///
+/// 计数器在打开时设置了 `inherit`, 故测试中创建的子进程和线程也计入该测试
+class PerfListener : public testing::EmptyTestEventListener {
+public:
+    explicit PerfListener(perf_counters* pc) : _pc(pc) {}
+
+    void OnTestStart(const testing::TestInfo&) override { perf_counters_start(_pc); }
+
+    void OnTestEnd(const testing::TestInfo& info) override {
+        perf_counters_stop(_pc);
+
+        char buf[512];
+        perf_counters_format(_pc, buf, sizeof(buf));
+        printf("[   PERF   ] %s.%s: %s\n", info.test_suite_name(), info.name(), buf);
+    }
+
+private:
+    perf_counters* _pc;
+};
+
 /// @brief 主函数, 执行 gtest 测试套件
+///
+/// 设置环境变量 `LINUX_TEST_PERF=1` 时, 在每个测试结束后输出该测试的性能计数器
 int main(int argc, char* argv[]) {
     // 初始化测试套件
     testing::InitGoogleTest(&argc, argv);
 
+    perf_counters pc;
+    const char* env = getenv("LINUX_TEST_PERF");
+    bool perf = env && strcmp(env, "1") == 0;
+
+    if (perf) {
+        int rc = perf_counters_open(&pc, true);
+        if (rc == 0) {
+            // 监听器由 gtest 负责释放
+            testing::UnitTest::GetInstance()->listeners().Append(new PerfListener(&pc));
+        }
+        else {
+            fprintf(stderr, "cannot open perf counters: %s\n", strerror(rc));
+            perf = false;
+        }
+    }
+
     // 执行所有测试
-    return RUN_ALL_TESTS();
+    int ret = RUN_ALL_TESTS();
+
+    if (perf) {
+        perf_counters_close(&pc);
+    }
+    return ret;
 }
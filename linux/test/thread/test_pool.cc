@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "thread.h"
+}
+
+#define TEST_SUITE_NAME test_linux_thread__pool
+
+/// @brief 累加任务的参数
+struct add_arg {
+    uint64_t* sum; // 累加结果
+    uint64_t value; // 要累加的值
+};
+
+/// @brief 累加任务函数
+static void __add(void* arg) {
+    add_arg* a = (add_arg*)arg;
+    __atomic_add_fetch(a->sum, a->value, __ATOMIC_RELAXED);
+}
+
+/// @brief 测试在工作线程以外提交任务, 并等待任务组完成
+TEST(TEST_SUITE_NAME, submit_and_wait) {
+    thread_pool* pool = NULL;
+    ASSERT_EQ(thread_pool_create(&pool, 4, PLACEMENT_SCATTER), 0);
+    ASSERT_EQ(thread_pool_size(pool), 4);
+
+    const size_t n = 10000;
+    uint64_t sum = 0;
+
+    std::vector<add_arg> args(n);
+    std::vector<pool_task> tasks(n);
+    pool_group group = POOL_GROUP_INIT;
+
+    for (size_t i = 0; i < n; i++) {
+        args[i] = { &sum, i + 1 };
+        tasks[i].func = __add;
+        tasks[i].arg = &args[i];
+        thread_pool_submit(pool, &tasks[i], &group);
+    }
+
+    pool_group_wait(pool, &group);
+    ASSERT_EQ(group.pending, 0);
+    ASSERT_EQ(sum, n * (n + 1) / 2);
+
+    thread_pool_destroy(pool);
+}
+
+/// @brief 递归求和任务的参数, 每个任务将区间一分为二, 在工作线程中提交子任务并等待其完成
+struct range_arg {
+    thread_pool* pool; // 线程池
+    uint64_t lo;       // 区间起始值
+    uint64_t hi;       // 区间结束值 (不包含)
+    uint64_t sum;      // 区间求和结果
+};
+
+/// @brief 递归求和任务函数
+static void __range_sum(void* arg) {
+    range_arg* a = (range_arg*)arg;
+
+    if (a->hi - a->lo <= 64) {
+        for (uint64_t v = a->lo; v < a->hi; v++) {
+            a->sum += v;
+        }
+        return;
+    }
+
+    uint64_t mid = (a->lo + a->hi) / 2;
+    range_arg left{ a->pool, a->lo, mid, 0 }, right{ a->pool, mid, a->hi, 0 };
+    pool_task tl{ __range_sum, &left, NULL, NULL }, tr{ __range_sum, &right, NULL, NULL };
+
+    // 子任务进入当前工作线程的双端队列, 可被其它工作线程窃取
+    pool_group group = POOL_GROUP_INIT;
+    thread_pool_submit(a->pool, &tl, &group);
+    thread_pool_submit(a->pool, &tr, &group);
+    pool_group_wait(a->pool, &group);
+
+    a->sum = left.sum + right.sum;
+}
+
+/// @brief 测试在工作线程中提交任务, 以及工作线程等待任务组时不会死锁
+TEST(TEST_SUITE_NAME, nested_tasks) {
+    thread_pool* pool = NULL;
+    ASSERT_EQ(thread_pool_create(&pool, 3, PLACEMENT_COMPACT), 0);
+
+    const uint64_t n = 1 << 20;
+    range_arg root{ pool, 0, n, 0 };
+    pool_task task{ __range_sum, &root, NULL, NULL };
+
+    pool_group group = POOL_GROUP_INIT;
+    thread_pool_submit(pool, &task, &group);
+    pool_group_wait(pool, &group);
+
+    ASSERT_EQ(root.sum, n * (n - 1) / 2);
+
+    thread_pool_destroy(pool);
+}
+
+/// @brief 测试默认线程池只创建一次
+TEST(TEST_SUITE_NAME, thread_pool_default) {
+    thread_pool* pool = thread_pool_default();
+    ASSERT_NE(pool, nullptr);
+    ASSERT_EQ(pool, thread_pool_default());
+    ASSERT_EQ(thread_pool_size(pool), available_cpus());
+}
@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <cerrno>
+#include <cstdio>
+
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
 // 引入 C 语言头文件
 extern "C" {
 #include "thread.h"
@@ -24,4 +31,136 @@ TEST(TEST_SUITE_NAME, calculate_primes) {
 
     // 释放保存结果的内存
     free_result(&result);
-}
\ No newline at end of file
+}
+/// @brief 测试上限很小时的计算结果, 此时只有一个分组, 且结果数组按最小容量分配
+TEST(TEST_SUITE_NAME, calculate_primes_small) {
+    prime_result result{ NULL, 0 };
+
+    // `[2, 2)` 中没有质数
+    ASSERT_EQ(calculate_primes(2, &result), 0);
+    ASSERT_EQ(result.count, 0);
+    free_result(&result);
+
+    ASSERT_EQ(calculate_primes(30, &result), 0);
+    ASSERT_EQ(result.count, 10);
+    ASSERT_EQ(result.data[0], 2);
+    ASSERT_EQ(result.data[9], 29);
+    free_result(&result);
+}
+
+/// @brief 测试上限超过 `2^32` 时返回错误
+TEST(TEST_SUITE_NAME, calculate_primes_out_of_range) {
+    prime_result result{ NULL, 0 };
+
+    ASSERT_EQ(calculate_primes((size_t)UINT32_MAX + 2, &result), EINVAL);
+    ASSERT_EQ(result.count, 0);
+}
+
+/// @brief 流式计算时回调函数的上下文
+struct stream_ctx {
+    size_t count;  // 已接收的质数个数
+    uint32_t last; // 上一个接收到的质数
+    bool ordered;  // 是否按升序接收
+    size_t limit;  // 接收到的质数个数超过该值时停止计算
+};
+
+/// @brief 流式计算的回调函数, 统计质数个数并检查顺序
+static int __on_primes(const uint32_t* primes, size_t count, void* arg) {
+    stream_ctx* ctx = (stream_ctx*)arg;
+    for (size_t i = 0; i < count; i++) {
+        if (primes[i] <= ctx->last) {
+            ctx->ordered = false;
+        }
+        ctx->last = primes[i];
+    }
+    ctx->count += count;
+    return ctx->count > ctx->limit ? 1 : 0;
+}
+
+/// @brief 测试流式计算质数, 结果按升序分批交给回调函数
+TEST(TEST_SUITE_NAME, calculate_primes_stream) {
+    stream_ctx ctx{ 0, 0, true, SIZE_MAX };
+
+    int rc = calculate_primes_stream(10000000, __on_primes, &ctx);
+    ASSERT_EQ(rc, 0);
+
+    ASSERT_TRUE(ctx.ordered);
+    ASSERT_EQ(ctx.count, 664579);
+    ASSERT_EQ(ctx.last, 9999991);
+}
+
+/// @brief 测试回调函数返回非 `0` 值时停止计算, 且该值作为计算函数的返回值
+TEST(TEST_SUITE_NAME, calculate_primes_stream_stop) {
+    stream_ctx ctx{ 0, 0, true, 100000 };
+
+    int rc = calculate_primes_stream(100000000, __on_primes, &ctx);
+    ASSERT_EQ(rc, 1);
+
+    // 每个分组的质数个数少于 `100000`, 故在接收到第 2 个分组的结果后停止
+    ASSERT_TRUE(ctx.ordered);
+    ASSERT_GT(ctx.count, 100000);
+    ASSERT_LT(ctx.count, 300000);
+}
+
+/// @brief 测试计算结果追加到 `prime_result` 原有内容之后
+TEST(TEST_SUITE_NAME, calculate_primes_append) {
+    prime_result result{ NULL, 0 };
+
+    ASSERT_EQ(calculate_primes(10, &result), 0);
+    ASSERT_EQ(calculate_primes(GROUP_SIZE * 2, &result), 0);
+
+    // `10` 以内有 `4` 个质数, `2000000` 以内有 `148933` 个质数
+    ASSERT_EQ(result.count, 4 + 148933);
+    ASSERT_EQ(result.data[3], 7);
+    ASSERT_EQ(result.data[4], 2);
+    ASSERT_EQ(result.data[result.count - 1], 1999993);
+
+    free_result(&result);
+}
+
+/// @brief 测试统计质数个数
+TEST(TEST_SUITE_NAME, count_primes) {
+    uint64_t count = 0;
+
+    ASSERT_EQ(count_primes(2, &count), 0);
+    ASSERT_EQ(count, 0);
+
+    ASSERT_EQ(count_primes(30, &count), 0);
+    ASSERT_EQ(count, 10);
+
+    ASSERT_EQ(count_primes(GROUP_SIZE + 100, &count), 0);
+    ASSERT_EQ(count, 78498 + 6);
+
+    ASSERT_EQ(count_primes(100000000, &count), 0);
+    ASSERT_EQ(count, 5761455);
+}
+
+/// @brief 测试父进程使用过默认线程池后, `fork` 产生的子进程仍可以计算质数
+///
+/// 子进程中不存在父进程的工作线程, 需要丢弃继承的线程池并重新创建, 否则计算会永远阻塞; 子进程通过 `alarm` 限制执行时间
+TEST(TEST_SUITE_NAME, calculate_primes_after_fork) {
+    prime_result result{ NULL, 0 };
+    ASSERT_EQ(calculate_primes(10000000, &result), 0);
+    ASSERT_EQ(result.count, 664579);
+    free_result(&result);
+
+    fflush(stdout);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+
+    if (pid == 0) {
+        alarm(10);
+
+        prime_result r{ NULL, 0 };
+        uint64_t count = 0;
+        bool ok = calculate_primes(10000000, &r) == 0 && r.count == 664579
+            && count_primes(10000000, &count) == 0 && count == 664579;
+        free_result(&r);
+        _exit(ok ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status)) << "child killed by signal " << WTERMSIG(status);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+}
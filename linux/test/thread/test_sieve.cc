@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <vector>
+
+// 引入 C 语言头文件
+extern "C" {
+#include "thread.h"
+}
+
+#define TEST_SUITE_NAME test_linux_thread__sieve
+
+/// @brief 通过试除法判断一个整数是否为质数, 作为测试的对照
+///
+/// @param n 整数值
+/// @return 是否为质数
+static bool __is_prime(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint64_t k = 2; k * k <= n; k++) {
+        if (n % k == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief 测试计算基础质数表
+TEST(TEST_SUITE_NAME, sieve_base_init) {
+    sieve_base base;
+
+    // `sqrt(100) = 10`, 基础质数为 `10` 以内的奇质数
+    ASSERT_EQ(sieve_base_init(&base, 100), 0);
+    ASSERT_EQ(base.count, 3);
+    ASSERT_EQ(base.primes[0], 3);
+    ASSERT_EQ(base.primes[1], 5);
+    ASSERT_EQ(base.primes[2], 7);
+    sieve_base_free(&base);
+
+    // `121 = 11 * 11`, 需要 `11` 作为基础质数才能将其划去
+    ASSERT_EQ(sieve_base_init(&base, 122), 0);
+    ASSERT_EQ(base.count, 4);
+    ASSERT_EQ(base.primes[3], 11);
+    sieve_base_free(&base);
+
+    // 上限很小时不需要基础质数
+    ASSERT_EQ(sieve_base_init(&base, 4), 0);
+    ASSERT_EQ(base.count, 0);
+    sieve_base_free(&base);
+}
+
+/// @brief 测试对多个分段执行筛选, 并和试除法的结果进行对比
+TEST(TEST_SUITE_NAME, sieve_mark_and_collect) {
+    const uint64_t max = 100000;
+    const uint64_t span = 1000;
+
+    sieve_base base;
+    ASSERT_EQ(sieve_base_init(&base, max), 0);
+
+    std::vector<uint64_t> bits(span / 2 / 64 + 1);
+    std::vector<uint32_t> primes(span);
+
+    for (uint64_t lo = 0; lo < max; lo += span) {
+        uint64_t hi = lo + span;
+        sieve_mark(&base, lo, hi, bits.data());
+
+        size_t n = sieve_collect(bits.data(), lo, hi, primes.data(), primes.size());
+        ASSERT_EQ(n, sieve_count(bits.data(), lo, hi));
+
+        // 收集到的质数应和试除法的结果一一对应
+        size_t k = 0;
+        for (uint64_t v = lo; v < hi; v++) {
+            if (__is_prime(v)) {
+                ASSERT_LT(k, n);
+                ASSERT_EQ(primes[k++], v);
+            }
+        }
+        ASSERT_EQ(k, n);
+    }
+
+    sieve_base_free(&base);
+}
+
+/// @brief 测试 `out` 数组容量不足时, 返回值仍为实际的质数个数
+TEST(TEST_SUITE_NAME, sieve_collect_overflow) {
+    sieve_base base;
+    ASSERT_EQ(sieve_base_init(&base, 100), 0);
+
+    uint64_t bits[1];
+    sieve_mark(&base, 0, 100, bits);
+
+    uint32_t primes[5];
+    ASSERT_EQ(sieve_collect(bits, 0, 100, primes, 5), 25);
+    ASSERT_EQ(primes[0], 2);
+    ASSERT_EQ(primes[4], 11);
+
+    sieve_base_free(&base);
+}
+
+/// @brief 测试上限不是 `GROUP_SIZE` 整数倍时, 最后一个不满的分组也会被计算
+TEST(TEST_SUITE_NAME, calculate_primes_partial_group) {
+    prime_result result{ NULL, 0 };
+
+    int rc = calculate_primes(GROUP_SIZE + 100, &result);
+    ASSERT_EQ(rc, 0);
+
+    // `1000000` 以内有 `78498` 个质数, `[1000000, 1000100)` 之间有 `6` 个质数
+    ASSERT_EQ(result.count, 78498 + 6);
+    ASSERT_EQ(result.data[result.count - 1], 1000099);
+
+    free_result(&result);
+}
+
+/// @brief `for_each_prime` 回调函数的上下文
+struct each_ctx {
+    std::vector<uint32_t> primes; // 接收到的质数
+    size_t batches;               // 回调次数
+    size_t limit;                 // 接收到的质数个数达到该值时停止
+};
+
+/// @brief `for_each_prime` 的回调函数, 保存接收到的质数
+static int __collect(const uint32_t* primes, size_t count, void* arg) {
+    each_ctx* ctx = (each_ctx*)arg;
+    ctx->primes.insert(ctx->primes.end(), primes, primes + count);
+    ctx->batches++;
+    return ctx->primes.size() >= ctx->limit ? -1 : 0;
+}
+
+/// @brief 测试遍历指定范围内的质数, 范围的起止值可以为奇数或偶数
+TEST(TEST_SUITE_NAME, for_each_prime) {
+    const uint64_t ranges[][2] = { { 0, 100 }, { 2, 3 }, { 3, 50 }, { 4, 4 }, { 97, 1000 }, { 999000, 1200001 } };
+
+    for (const auto& r : ranges) {
+        each_ctx ctx{ {}, 0, SIZE_MAX };
+        ASSERT_EQ(for_each_prime(r[0], r[1], __collect, &ctx), 0);
+
+        std::vector<uint32_t> expected;
+        for (uint64_t v = r[0]; v < r[1]; v++) {
+            if (__is_prime(v)) {
+                expected.push_back((uint32_t)v);
+            }
+        }
+        ASSERT_EQ(ctx.primes, expected);
+    }
+}
+
+/// @brief 测试质数按分段分批交给回调函数, 且回调函数返回非 `0` 值时停止
+TEST(TEST_SUITE_NAME, for_each_prime_batches) {
+    each_ctx ctx{ {}, 0, SIZE_MAX };
+
+    // 每个分段覆盖 `sieve_segment_bytes() * 16` 个整数
+    uint64_t span = sieve_segment_bytes() * 16;
+    ASSERT_EQ(for_each_prime(0, span * 3, __collect, &ctx), 0);
+    ASSERT_EQ(ctx.batches, 3);
+
+    each_ctx stop{ {}, 0, 1 };
+    ASSERT_EQ(for_each_prime(0, span * 3, __collect, &stop), -1);
+    ASSERT_EQ(stop.batches, 1);
+
+    // 上限超过 `2^32` 时返回错误
+    ASSERT_EQ(for_each_prime(0, (uint64_t)UINT32_MAX + 2, __collect, &ctx), EINVAL);
+}